@@ -60,9 +60,22 @@ public:
 
 	/**
 	 * Queries whether the channel is still playing or not.
+	 * Only used by the mixer callback.
 	 */
 	bool isFinished() const { return _stream->endOfStream(); }
 
+	/**
+	 * Marks the channel as finished. This is done by the mixer callback,
+	 * right before it hands the channel back to be deleted.
+	 */
+	void retire() { Common::atomicStore(&_retired, 1); }
+
+	/**
+	 * Queries whether the mixer callback is done with the channel
+	 * because it finished playing.
+	 */
+	bool isRetired() const { return Common::atomicLoad(&_retired) != 0; }
+
 	/**
 	 * Queries whether the channel is a permanent channel.
 	 * A permanent channel is not affected by a Mixer::stopAll
@@ -88,6 +101,11 @@ public:
 	 */
 	bool isPaused() const { return (_pauseLevel != 0); }
 
+	/**
+	 * Queries whether the mixer callback should skip the channel.
+	 */
+	bool isMixingPaused() const { return Common::atomicLoad(&_mixingPaused) != 0; }
+
 	/**
 	 * Sets the channel's own volume.
 	 *
@@ -155,13 +173,23 @@ private:
 	int8 _balance;
 
 	void updateChannelVolumes();
-	st_volume_t _volL, _volR;
+
+	/** The left and right volume for the mixer callback, packed as (left << 16) | right */
+	Common::AtomicInt32 _mixingVolumes;
+	Common::AtomicInt32 _mixingPaused;
+	Common::AtomicInt32 _retired;
 
 	Mixer *_mixer;
 
+	/**
+	 * The mixer callback updates _samplesConsumed and _mixerTimeStamp
+	 * together, incrementing _timeSequence before and after. The engine
+	 * side reads them again while _timeSequence is odd or has changed.
+	 */
+	Common::AtomicInt32 _timeSequence;
 	uint32 _samplesConsumed;
-	uint32 _samplesDecoded;
 	uint32 _mixerTimeStamp;
+	uint32 _samplesDecoded;
 	uint32 _pauseStartTime;
 	uint32 _pauseTime;
 
@@ -175,15 +203,22 @@ private:
 
 // TODO: parameter "system" is unused
 MixerImpl::MixerImpl(OSystem *system, uint sampleRate)
-	: _mutex(), _sampleRate(sampleRate), _mixerReady(false), _handleSeed(0), _soundTypeSettings() {
+	: _mutex(), _sampleRate(sampleRate), _mixerReady(false), _handleSeed(0), _soundTypeSettings(), _mixState(kMixStateIdle) {
 
 	assert(sampleRate > 0);
 
-	for (int i = 0; i != NUM_CHANNELS; i++)
+	for (int i = 0; i != NUM_CHANNELS; i++) {
 		_channels[i] = 0;
+		_mixChannels[i] = 0;
+	}
 }
 
 MixerImpl::~MixerImpl() {
+	// The backend does not invoke mixCallback() anymore at this point, so
+	// bring both views of the channels in sync before deleting them.
+	processCommands();
+	reclaimFinishedChannels();
+
 	for (int i = 0; i != NUM_CHANNELS; i++)
 		delete _channels[i];
 }
@@ -219,6 +254,90 @@ void MixerImpl::insertChannel(SoundHandle *handle, Channel *chan) {
 	_handleSeed++;
 	if (handle)
 		*handle = chanHandle;
+
+	pushCommand(Command::kAddChannel, index, chan);
+}
+
+void MixerImpl::pushCommand(Command::Type type, int index, Channel *chan) {
+	Command cmd;
+	cmd.type = type;
+	cmd.index = index;
+	cmd.channel = chan;
+
+	if (_commands.push(cmd))
+		return;
+
+	// The queue only overflows when the mixer callback has not run for a
+	// while, e.g. because the audio device is paused or not present. Take
+	// over the mixing state for a moment and apply the commands ourselves.
+	while (!Common::atomicCompareAndSwap(&_mixState, kMixStateIdle, kMixStateEngine))
+		g_system->delayMillis(0);
+
+	processCommands();
+	Common::atomicStore(&_mixState, kMixStateIdle);
+
+	_commands.push(cmd);
+}
+
+void MixerImpl::processCommands() {
+	Command cmd;
+	while (_commands.pop(cmd)) {
+		switch (cmd.type) {
+		case Command::kAddChannel:
+			_mixChannels[cmd.index] = cmd.channel;
+			break;
+
+		case Command::kRemoveChannel:
+			// The engine side deletes removed channels itself. Note that the
+			// channel may have been deleted already, so only compare it.
+			if (_mixChannels[cmd.index] == cmd.channel)
+				_mixChannels[cmd.index] = 0;
+			break;
+		}
+	}
+}
+
+void MixerImpl::reclaimFinishedChannels() {
+	Channel *chan;
+	while (_finishedChannels.pop(chan)) {
+		const int index = chan->getHandle()._val % NUM_CHANNELS;
+		if (_channels[index] == chan)
+			_channels[index] = 0;
+		delete chan;
+	}
+}
+
+void MixerImpl::removeChannel(int index) {
+	Channel *chan = _channels[index];
+	_channels[index] = 0;
+
+	// Channels which finished on their own are on their way back from the
+	// mixer callback, reclaimFinishedChannels() will delete them.
+	if (chan->isRetired())
+		return;
+
+	pushCommand(Command::kRemoveChannel, index, chan);
+
+	// Any mixer callback starting from now on drops the channel before
+	// mixing, so once a running one has returned, nobody uses it anymore.
+	waitForCallback();
+
+	if (!chan->isRetired())
+		delete chan;
+}
+
+void MixerImpl::waitForCallback() {
+	while (Common::atomicLoad(&_mixState) == kMixStateCallback)
+		g_system->delayMillis(0);
+}
+
+Channel *MixerImpl::findChannel(SoundHandle handle) {
+	const int index = handle._val % NUM_CHANNELS;
+	Channel *chan = _channels[index];
+	if (!chan || chan->getHandle()._val != handle._val || chan->isRetired())
+		return 0;
+
+	return chan;
 }
 
 void MixerImpl::playStream(
@@ -236,13 +355,15 @@ void MixerImpl::playStream(
 		return;
 	}
 
+	reclaimFinishedChannels();
+
 
 	assert(_mixerReady);
 
 	// Prevent duplicate sounds
 	if (id != -1) {
 		for (int i = 0; i != NUM_CHANNELS; i++)
-			if (_channels[i] != 0 && _channels[i]->getId() == id) {
+			if (_channels[i] != 0 && !_channels[i]->isRetired() && _channels[i]->getId() == id) {
 				// Delete the stream if were asked to auto-dispose it.
 				// Note: This could cause trouble if the client code does not
 				// yet expect the stream to be gone. The primary example to
@@ -269,8 +390,6 @@ void MixerImpl::playStream(
 int MixerImpl::mixCallback(byte *samples, uint len) {
 	assert(samples);
 
-	Common::StackLock lock(_mutex);
-
 	int16 *buf = (int16 *)samples;
 	// we store stereo, 16-bit samples
 	assert(len % 4 == 0);
@@ -282,58 +401,76 @@ int MixerImpl::mixCallback(byte *samples, uint len) {
 	//  zero the buf
 	memset(buf, 0, 2 * len * sizeof(int16));
 
+	// The engine side only holds the mixing state while it is applying an
+	// overflowing command queue. Rather than waiting, output silence.
+	if (!Common::atomicCompareAndSwap(&_mixState, kMixStateIdle, kMixStateCallback))
+		return 0;
+
+	processCommands();
+
 	// mix all channels
 	int res = 0, tmp;
-	for (int i = 0; i != NUM_CHANNELS; i++)
-		if (_channels[i]) {
-			if (_channels[i]->isFinished()) {
-				delete _channels[i];
-				_channels[i] = 0;
-			} else if (!_channels[i]->isPaused()) {
-				tmp = _channels[i]->mix(buf, len);
-
-				if (tmp > res)
-					res = tmp;
+	for (int i = 0; i != NUM_CHANNELS; i++) {
+		Channel *chan = _mixChannels[i];
+		if (!chan)
+			continue;
+
+		if (chan->isFinished()) {
+			// Hand the channel back for deletion, so that the stream is not
+			// destroyed from the audio thread
+			if (!_finishedChannels.full()) {
+				_mixChannels[i] = 0;
+				chan->retire();
+				_finishedChannels.push(chan);
 			}
+		} else if (!chan->isMixingPaused()) {
+			tmp = chan->mix(buf, len);
+
+			if (tmp > res)
+				res = tmp;
 		}
+	}
+
+	Common::atomicStore(&_mixState, kMixStateIdle);
 
 	return res;
 }
 
 void MixerImpl::stopAll() {
 	Common::StackLock lock(_mutex);
+	reclaimFinishedChannels();
 	for (int i = 0; i != NUM_CHANNELS; i++) {
 		if (_channels[i] != 0 && !_channels[i]->isPermanent()) {
-			delete _channels[i];
-			_channels[i] = 0;
+			removeChannel(i);
 		}
 	}
 }
 
 void MixerImpl::stopID(int id) {
 	Common::StackLock lock(_mutex);
+	reclaimFinishedChannels();
 	for (int i = 0; i != NUM_CHANNELS; i++) {
 		if (_channels[i] != 0 && _channels[i]->getId() == id) {
-			delete _channels[i];
-			_channels[i] = 0;
+			removeChannel(i);
 		}
 	}
 }
 
 void MixerImpl::stopHandle(SoundHandle handle) {
 	Common::StackLock lock(_mutex);
+	reclaimFinishedChannels();
 
 	// Simply ignore stop requests for handles of sounds that already terminated
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	if (!findChannel(handle))
 		return;
 
-	delete _channels[index];
-	_channels[index] = 0;
+	removeChannel(handle._val % NUM_CHANNELS);
 }
 
 void MixerImpl::muteSoundType(SoundType type, bool mute) {
 	assert(0 <= (int)type && (int)type < ARRAYSIZE(_soundTypeSettings));
+
+	Common::StackLock lock(_mutex);
 	_soundTypeSettings[type].mute = mute;
 
 	for (int i = 0; i != NUM_CHANNELS; ++i) {
@@ -350,37 +487,41 @@ bool MixerImpl::isSoundTypeMuted(SoundType type) const {
 void MixerImpl::setChannelVolume(SoundHandle handle, byte volume) {
 	Common::StackLock lock(_mutex);
 
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	Channel *chan = findChannel(handle);
+	if (!chan)
 		return;
 
-	_channels[index]->setVolume(volume);
+	chan->setVolume(volume);
 }
 
 byte MixerImpl::getChannelVolume(SoundHandle handle) {
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	Common::StackLock lock(_mutex);
+
+	Channel *chan = findChannel(handle);
+	if (!chan)
 		return 0;
 
-	return _channels[index]->getVolume();
+	return chan->getVolume();
 }
 
 void MixerImpl::setChannelBalance(SoundHandle handle, int8 balance) {
 	Common::StackLock lock(_mutex);
 
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	Channel *chan = findChannel(handle);
+	if (!chan)
 		return;
 
-	_channels[index]->setBalance(balance);
+	chan->setBalance(balance);
 }
 
 int8 MixerImpl::getChannelBalance(SoundHandle handle) {
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	Common::StackLock lock(_mutex);
+
+	Channel *chan = findChannel(handle);
+	if (!chan)
 		return 0;
 
-	return _channels[index]->getBalance();
+	return chan->getBalance();
 }
 
 uint32 MixerImpl::getSoundElapsedTime(SoundHandle handle) {
@@ -390,11 +531,11 @@ uint32 MixerImpl::getSoundElapsedTime(SoundHandle handle) {
 Timestamp MixerImpl::getElapsedTime(SoundHandle handle) {
 	Common::StackLock lock(_mutex);
 
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	Channel *chan = findChannel(handle);
+	if (!chan)
 		return Timestamp(0, _sampleRate);
 
-	return _channels[index]->getElapsedTime();
+	return chan->getElapsedTime();
 }
 
 void MixerImpl::pauseAll(bool paused) {
@@ -409,7 +550,7 @@ void MixerImpl::pauseAll(bool paused) {
 void MixerImpl::pauseID(int id, bool paused) {
 	Common::StackLock lock(_mutex);
 	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] != 0 && _channels[i]->getId() == id) {
+		if (_channels[i] != 0 && !_channels[i]->isRetired() && _channels[i]->getId() == id) {
 			_channels[i]->pause(paused);
 			return;
 		}
@@ -420,11 +561,11 @@ void MixerImpl::pauseHandle(SoundHandle handle, bool paused) {
 	Common::StackLock lock(_mutex);
 
 	// Simply ignore (un)pause requests for sounds that already terminated
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	Channel *chan = findChannel(handle);
+	if (!chan)
 		return;
 
-	_channels[index]->pause(paused);
+	chan->pause(paused);
 }
 
 bool MixerImpl::isSoundIDActive(int id) {
@@ -435,16 +576,16 @@ bool MixerImpl::isSoundIDActive(int id) {
 #endif
 
 	for (int i = 0; i != NUM_CHANNELS; i++)
-		if (_channels[i] && _channels[i]->getId() == id)
+		if (_channels[i] && !_channels[i]->isRetired() && _channels[i]->getId() == id)
 			return true;
 	return false;
 }
 
 int MixerImpl::getSoundID(SoundHandle handle) {
 	Common::StackLock lock(_mutex);
-	const int index = handle._val % NUM_CHANNELS;
-	if (_channels[index] && _channels[index]->getHandle()._val == handle._val)
-		return _channels[index]->getId();
+	Channel *chan = findChannel(handle);
+	if (chan)
+		return chan->getId();
 	return 0;
 }
 
@@ -455,14 +596,13 @@ bool MixerImpl::isSoundHandleActive(SoundHandle handle) {
 	g_eventRec.updateSubsystems();
 #endif
 
-	const int index = handle._val % NUM_CHANNELS;
-	return _channels[index] && _channels[index]->getHandle()._val == handle._val;
+	return findChannel(handle) != 0;
 }
 
 bool MixerImpl::hasActiveChannelOfType(SoundType type) {
 	Common::StackLock lock(_mutex);
 	for (int i = 0; i != NUM_CHANNELS; i++)
-		if (_channels[i] && _channels[i]->getType() == type)
+		if (_channels[i] && !_channels[i]->isRetired() && _channels[i]->getType() == type)
 			return true;
 	return false;
 }
@@ -502,9 +642,9 @@ int MixerImpl::getVolumeForSoundType(SoundType type) const {
 Channel::Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream,
                  DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent)
     : _type(type), _mixer(mixer), _id(id), _permanent(permanent), _volume(Mixer::kMaxChannelVolume),
-      _balance(0), _pauseLevel(0), _samplesConsumed(0), _samplesDecoded(0), _mixerTimeStamp(0),
-      _pauseStartTime(0), _pauseTime(0), _converter(0), _volL(0), _volR(0),
-      _stream(stream, autofreeStream) {
+      _balance(0), _pauseLevel(0), _mixingVolumes(0), _mixingPaused(0), _retired(0), _timeSequence(0),
+      _samplesConsumed(0), _mixerTimeStamp(0), _samplesDecoded(0), _pauseStartTime(0), _pauseTime(0),
+      _converter(0), _stream(stream, autofreeStream) {
 	assert(mixer);
 	assert(stream);
 
@@ -543,22 +683,26 @@ void Channel::updateChannelVolumes() {
 	// volume is in the range 0 - kMaxMixerVolume.
 	// Hence, the vol_l/vol_r values will be in that range, too
 
+	st_volume_t volL, volR;
+
 	if (!_mixer->isSoundTypeMuted(_type)) {
 		int vol = _mixer->getVolumeForSoundType(_type) * _volume;
 
 		if (_balance == 0) {
-			_volL = vol / Mixer::kMaxChannelVolume;
-			_volR = vol / Mixer::kMaxChannelVolume;
+			volL = vol / Mixer::kMaxChannelVolume;
+			volR = vol / Mixer::kMaxChannelVolume;
 		} else if (_balance < 0) {
-			_volL = vol / Mixer::kMaxChannelVolume;
-			_volR = ((127 + _balance) * vol) / (Mixer::kMaxChannelVolume * 127);
+			volL = vol / Mixer::kMaxChannelVolume;
+			volR = ((127 + _balance) * vol) / (Mixer::kMaxChannelVolume * 127);
 		} else {
-			_volL = ((127 - _balance) * vol) / (Mixer::kMaxChannelVolume * 127);
-			_volR = vol / Mixer::kMaxChannelVolume;
+			volL = ((127 - _balance) * vol) / (Mixer::kMaxChannelVolume * 127);
+			volR = vol / Mixer::kMaxChannelVolume;
 		}
 	} else {
-		_volL = _volR = 0;
+		volL = volR = 0;
 	}
+
+	Common::atomicStore(&_mixingVolumes, (volL << 16) | volR);
 }
 
 void Channel::pause(bool paused) {
@@ -567,14 +711,16 @@ void Channel::pause(bool paused) {
 	if (paused) {
 		_pauseLevel++;
 
-		if (_pauseLevel == 1)
+		if (_pauseLevel == 1) {
 			_pauseStartTime = g_system->getMillis(true);
+			Common::atomicStore(&_mixingPaused, 1);
+		}
 	} else if (_pauseLevel > 0) {
 		_pauseLevel--;
 
 		if (!_pauseLevel) {
 			_pauseTime = (g_system->getMillis(true) - _pauseStartTime);
-			_pauseStartTime = 0;
+			Common::atomicStore(&_mixingPaused, 0);
 		}
 	}
 }
@@ -585,17 +731,31 @@ Timestamp Channel::getElapsedTime() {
 
 	Audio::Timestamp ts(0, rate);
 
-	if (_mixerTimeStamp == 0)
+	uint32 samplesConsumed, mixerTimeStamp;
+	int32 sequence;
+	do {
+		sequence = Common::atomicLoad(&_timeSequence);
+		samplesConsumed = _samplesConsumed;
+		mixerTimeStamp = _mixerTimeStamp;
+	} while ((sequence & 1) || Common::atomicLoad(&_timeSequence) != sequence);
+
+	if (mixerTimeStamp == 0)
 		return ts;
 
-	if (isPaused())
-		delta = _pauseStartTime - _mixerTimeStamp;
-	else
-		delta = g_system->getMillis(true) - _mixerTimeStamp - _pauseTime;
+	// A mixer callback which was already running when the channel got
+	// paused may have mixed it once more, after the pause started.
+	if (isPaused()) {
+		if (_pauseStartTime > mixerTimeStamp)
+			delta = _pauseStartTime - mixerTimeStamp;
+	} else {
+		delta = g_system->getMillis(true) - mixerTimeStamp;
+		if (mixerTimeStamp <= _pauseStartTime)
+			delta -= _pauseTime;
+	}
 
 	// Convert the number of samples into a time duration.
 
-	ts = ts.addFrames(_samplesConsumed);
+	ts = ts.addFrames(samplesConsumed);
 	ts = ts.addMsecs(delta);
 
 	// In theory it would seem like a good idea to limit the approximation
@@ -615,10 +775,14 @@ int Channel::mix(int16 *data, uint len) {
 		// TODO: call drain method
 	} else {
 		assert(_converter);
+
+		Common::atomicAdd(&_timeSequence, 1);
 		_samplesConsumed = _samplesDecoded;
 		_mixerTimeStamp = g_system->getMillis(true);
-		_pauseTime = 0;
-		res = _converter->flow(*_stream, data, len, _volL, _volR);
+		Common::atomicAdd(&_timeSequence, 1);
+
+		const uint32 volumes = Common::atomicLoad(&_mixingVolumes);
+		res = _converter->flow(*_stream, data, len, volumes >> 16, volumes & 0xFFFF);
 		_samplesDecoded += res;
 	}
 
@@ -24,6 +24,7 @@
 #define AUDIO_MIXER_INTERN_H
 
 #include "common/scummsys.h"
+#include "common/atomic.h"
 #include "common/mutex.h"
 #include "audio/mixer.h"
 
@@ -46,12 +47,83 @@ namespace Audio {
  * (partial) alternative implementations of the mixer, e.g. to make
  * better use of native sound mixing support on low-end devices.
  *
+ * The mixer callback never waits on the engine: _mutex only serializes the
+ * engine side calls against each other. Starting and stopping channels is
+ * passed to the callback through a lock-free command queue, which it drains
+ * before mixing, and finished channels are handed back through a second
+ * queue, so that they get deleted on the engine side. Volume, balance and
+ * pause changes are published to the channels through atomic variables.
+ *
  * @see OSystem::getMixer()
  */
 class MixerImpl : public Mixer {
 private:
 	enum {
-		NUM_CHANNELS = 16
+		NUM_CHANNELS = 16,
+		QUEUE_SIZE = 64
+	};
+
+	/**
+	 * Fixed size single-producer/single-consumer queue, which needs no
+	 * locking as long as there is exactly one thread on each end.
+	 */
+	template<class T>
+	class LockFreeQueue {
+	public:
+		LockFreeQueue() : _head(0), _tail(0) {}
+
+		bool empty() const { return Common::atomicLoad(&_head) == Common::atomicLoad(&_tail); }
+		bool full() const { return Common::atomicLoad(&_tail) - Common::atomicLoad(&_head) == QUEUE_SIZE; }
+
+		/** Append an element. Must only be called from the producer thread. */
+		bool push(const T &item) {
+			const int32 tail = Common::atomicLoad(&_tail);
+			if (tail - Common::atomicLoad(&_head) == QUEUE_SIZE)
+				return false;
+			_items[tail & (QUEUE_SIZE - 1)] = item;
+			Common::atomicStore(&_tail, tail + 1);
+			return true;
+		}
+
+		/** Remove the oldest element. Must only be called from the consumer thread. */
+		bool pop(T &item) {
+			const int32 head = Common::atomicLoad(&_head);
+			if (head == Common::atomicLoad(&_tail))
+				return false;
+			item = _items[head & (QUEUE_SIZE - 1)];
+			Common::atomicStore(&_head, head + 1);
+			return true;
+		}
+
+	private:
+		T _items[QUEUE_SIZE];
+		Common::AtomicInt32 _head;
+		Common::AtomicInt32 _tail;
+	};
+
+	/**
+	 * A request from the engine side to add a channel to or remove a
+	 * channel from the set of channels being mixed.
+	 */
+	struct Command {
+		enum Type {
+			kAddChannel,
+			kRemoveChannel
+		};
+
+		Type type;
+		int index;
+		Channel *channel;
+	};
+
+	/**
+	 * Who currently owns the mixing state (_mixChannels and the consumer
+	 * ends of the queues).
+	 */
+	enum MixState {
+		kMixStateIdle = 0,
+		kMixStateCallback = 1,
+		kMixStateEngine = 2
 	};
 
 	Common::Mutex _mutex;
@@ -68,8 +140,17 @@ private:
 	};
 
 	SoundTypeSettings _soundTypeSettings[4];
+
+	/** The channels as seen by the engine side, guarded by _mutex. */
 	Channel *_channels[NUM_CHANNELS];
 
+	/** The channels as seen by the mixer callback. */
+	Channel *_mixChannels[NUM_CHANNELS];
+
+	LockFreeQueue<Command> _commands;
+	LockFreeQueue<Channel *> _finishedChannels;
+	Common::AtomicInt32 _mixState;
+
 
 public:
 
@@ -121,6 +202,25 @@ public:
 protected:
 	void insertChannel(SoundHandle *handle, Channel *chan);
 
+private:
+	/** Queue a command for the mixer callback. Engine side only. */
+	void pushCommand(Command::Type type, int index, Channel *chan);
+
+	/** Apply all queued commands. Only called by the owner of the mixing state. */
+	void processCommands();
+
+	/** Delete the channels handed back by the mixer callback. Engine side only. */
+	void reclaimFinishedChannels();
+
+	/** Stop and delete the channel in the given slot. Engine side only. */
+	void removeChannel(int index);
+
+	/** Wait until a mixer callback running concurrently has returned. */
+	void waitForCallback();
+
+	/** Look up an active channel by its handle. Engine side only. */
+	Channel *findChannel(SoundHandle handle);
+
 public:
 	/**
 	 * The mixer callback function, to be called at regular intervals by
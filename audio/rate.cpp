@@ -31,10 +31,29 @@
 #include "audio/audiostream.h"
 #include "audio/rate.h"
 #include "audio/mixer.h"
+#include "common/config-manager.h"
+#include "common/cpudetect.h"
 #include "common/frac.h"
+#include "common/mutex.h"
 #include "common/textconsole.h"
 #include "common/util.h"
 
+#include <math.h>
+
+#if defined(OUTPUT_UNSIGNED_AUDIO)
+// The vector mixers only implement signed saturation.
+#undef SCUMMVM_SSE2
+#undef SCUMMVM_NEON
+#endif
+
+#if defined(SCUMMVM_SSE2)
+#include <emmintrin.h>
+#endif
+
+#if defined(SCUMMVM_NEON)
+#include <arm_neon.h>
+#endif
+
 namespace Audio {
 
 
@@ -57,6 +76,202 @@ enum {
 	FRAC_HALF_LOW = (1L << (FRAC_BITS_LOW-1))
 };
 
+#pragma mark -
+
+
+/*
+ * Volume and mixing stage shared by all rate converters.
+ *
+ * The converters produce plain (volume-less) samples into an intermediate
+ * buffer, which the functions below then scale by the channel volumes and
+ * add to the output buffer with saturation. The plain C++ loops are the
+ * reference; the SSE2 and NEON versions produce exactly the same output.
+ * Note that the scaling has to round towards zero, like the integer
+ * division used by the reference code, and not towards minus infinity like
+ * a plain arithmetic shift would.
+ */
+
+#if defined(SCUMMVM_SSE2)
+
+static inline __m128i scaleSamplesSSE2(__m128i samples, __m128i vol) {
+	const __m128i lo = _mm_mullo_epi16(samples, vol);
+	const __m128i hi = _mm_mulhi_epi16(samples, vol);
+	__m128i p0 = _mm_unpacklo_epi16(lo, hi);
+	__m128i p1 = _mm_unpackhi_epi16(lo, hi);
+
+	// Add 255 to negative products, so that the shift rounds towards zero
+	p0 = _mm_add_epi32(p0, _mm_srli_epi32(_mm_srai_epi32(p0, 31), 24));
+	p1 = _mm_add_epi32(p1, _mm_srli_epi32(_mm_srai_epi32(p1, 31), 24));
+
+	return _mm_packs_epi32(_mm_srai_epi32(p0, 8), _mm_srai_epi32(p1, 8));
+}
+
+static void mixStereoSSE2(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t len, st_volume_t vol_l, st_volume_t vol_r, bool reverseStereo) {
+	const __m128i vol = _mm_set_epi16(vol_r, vol_l, vol_r, vol_l, vol_r, vol_l, vol_r, vol_l);
+
+	for (; len >= 4; len -= 4) {
+		__m128i samples = scaleSamplesSSE2(_mm_loadu_si128((const __m128i *)ibuf), vol);
+		if (reverseStereo) {
+			samples = _mm_shufflelo_epi16(samples, _MM_SHUFFLE(2, 3, 0, 1));
+			samples = _mm_shufflehi_epi16(samples, _MM_SHUFFLE(2, 3, 0, 1));
+		}
+
+		_mm_storeu_si128((__m128i *)obuf, _mm_adds_epi16(_mm_loadu_si128((const __m128i *)obuf), samples));
+
+		ibuf += 8;
+		obuf += 8;
+	}
+}
+
+static void mixMonoSSE2(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t len, st_volume_t vol_l, st_volume_t vol_r) {
+	const __m128i vol = _mm_set_epi16(vol_r, vol_l, vol_r, vol_l, vol_r, vol_l, vol_r, vol_l);
+
+	for (; len >= 8; len -= 8) {
+		const __m128i samples = _mm_loadu_si128((const __m128i *)ibuf);
+		const __m128i s0 = scaleSamplesSSE2(_mm_unpacklo_epi16(samples, samples), vol);
+		const __m128i s1 = scaleSamplesSSE2(_mm_unpackhi_epi16(samples, samples), vol);
+
+		_mm_storeu_si128((__m128i *)obuf, _mm_adds_epi16(_mm_loadu_si128((const __m128i *)obuf), s0));
+		_mm_storeu_si128((__m128i *)(obuf + 8), _mm_adds_epi16(_mm_loadu_si128((const __m128i *)(obuf + 8)), s1));
+
+		ibuf += 8;
+		obuf += 16;
+	}
+}
+
+#endif // SCUMMVM_SSE2
+
+#if defined(SCUMMVM_NEON)
+
+static inline int32x4_t roundTowardsZeroNEON(int32x4_t p) {
+	const uint32x4_t bias = vshrq_n_u32(vreinterpretq_u32_s32(vshrq_n_s32(p, 31)), 24);
+	return vshrq_n_s32(vaddq_s32(p, vreinterpretq_s32_u32(bias)), 8);
+}
+
+static inline int16x8_t scaleSamplesNEON(int16x8_t samples, int16x8_t vol) {
+	const int32x4_t p0 = vmull_s16(vget_low_s16(samples), vget_low_s16(vol));
+	const int32x4_t p1 = vmull_s16(vget_high_s16(samples), vget_high_s16(vol));
+
+	return vcombine_s16(vqmovn_s32(roundTowardsZeroNEON(p0)), vqmovn_s32(roundTowardsZeroNEON(p1)));
+}
+
+static void mixStereoNEON(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t len, st_volume_t vol_l, st_volume_t vol_r, bool reverseStereo) {
+	const int16_t volPair[8] = { (int16_t)vol_l, (int16_t)vol_r, (int16_t)vol_l, (int16_t)vol_r,
+	                             (int16_t)vol_l, (int16_t)vol_r, (int16_t)vol_l, (int16_t)vol_r };
+	const int16x8_t vol = vld1q_s16(volPair);
+
+	for (; len >= 4; len -= 4) {
+		int16x8_t samples = scaleSamplesNEON(vld1q_s16(ibuf), vol);
+		if (reverseStereo)
+			samples = vrev32q_s16(samples);
+
+		vst1q_s16(obuf, vqaddq_s16(vld1q_s16(obuf), samples));
+
+		ibuf += 8;
+		obuf += 8;
+	}
+}
+
+static void mixMonoNEON(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t len, st_volume_t vol_l, st_volume_t vol_r) {
+	const int16_t volPair[8] = { (int16_t)vol_l, (int16_t)vol_r, (int16_t)vol_l, (int16_t)vol_r,
+	                             (int16_t)vol_l, (int16_t)vol_r, (int16_t)vol_l, (int16_t)vol_r };
+	const int16x8_t vol = vld1q_s16(volPair);
+
+	for (; len >= 8; len -= 8) {
+		const int16x8x2_t samples = vzipq_s16(vld1q_s16(ibuf), vld1q_s16(ibuf));
+
+		vst1q_s16(obuf, vqaddq_s16(vld1q_s16(obuf), scaleSamplesNEON(samples.val[0], vol)));
+		vst1q_s16(obuf + 8, vqaddq_s16(vld1q_s16(obuf + 8), scaleSamplesNEON(samples.val[1], vol)));
+
+		ibuf += 8;
+		obuf += 16;
+	}
+}
+
+#endif // SCUMMVM_NEON
+
+/**
+ * Mix interleaved stereo samples into the output buffer.
+ *
+ * @param obuf          output buffer, interleaved stereo
+ * @param ibuf          input samples, interleaved stereo
+ * @param len           number of sample *pairs* to mix
+ * @param vol_l         volume applied to the left input channel
+ * @param vol_r         volume applied to the right input channel
+ * @param reverseStereo whether to swap the channels on output
+ */
+static void mixStereo(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t len, st_volume_t vol_l, st_volume_t vol_r, bool reverseStereo) {
+	st_size_t done = 0;
+
+#if defined(SCUMMVM_SSE2)
+	if (Common::hasCPUFeature(Common::kCPUFeatureSSE2)) {
+		done = len & ~3;
+		mixStereoSSE2(obuf, ibuf, done, vol_l, vol_r, reverseStereo);
+	}
+#elif defined(SCUMMVM_NEON)
+	if (Common::hasCPUFeature(Common::kCPUFeatureNEON)) {
+		done = len & ~3;
+		mixStereoNEON(obuf, ibuf, done, vol_l, vol_r, reverseStereo);
+	}
+#endif
+
+	obuf += done * 2;
+	ibuf += done * 2;
+
+	for (len -= done; len > 0; --len) {
+		// output left channel
+		clampedAdd(obuf[reverseStereo    ], (ibuf[0] * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
+
+		// output right channel
+		clampedAdd(obuf[reverseStereo ^ 1], (ibuf[1] * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
+
+		obuf += 2;
+		ibuf += 2;
+	}
+}
+
+/**
+ * Mix mono samples into both channels of the output buffer.
+ *
+ * @param obuf          output buffer, interleaved stereo
+ * @param ibuf          input samples
+ * @param len           number of samples to mix
+ * @param vol_l         volume for the left output channel
+ * @param vol_r         volume for the right output channel
+ */
+static void mixMono(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t len, st_volume_t vol_l, st_volume_t vol_r) {
+	st_size_t done = 0;
+
+#if defined(SCUMMVM_SSE2)
+	if (Common::hasCPUFeature(Common::kCPUFeatureSSE2)) {
+		done = len & ~7;
+		mixMonoSSE2(obuf, ibuf, done, vol_l, vol_r);
+	}
+#elif defined(SCUMMVM_NEON)
+	if (Common::hasCPUFeature(Common::kCPUFeatureNEON)) {
+		done = len & ~7;
+		mixMonoNEON(obuf, ibuf, done, vol_l, vol_r);
+	}
+#endif
+
+	obuf += done * 2;
+	ibuf += done;
+
+	for (len -= done; len > 0; --len) {
+		const st_sample_t out = *ibuf++;
+
+		// output left channel
+		clampedAdd(obuf[0], (out * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
+
+		// output right channel
+		clampedAdd(obuf[1], (out * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
+
+		obuf += 2;
+	}
+}
+
+#pragma mark -
+
 /**
  * Audio rate converter based on simple resampling. Used when no
  * interpolation is required.
@@ -67,6 +282,7 @@ template<bool stereo, bool reverseStereo>
 class SimpleRateConverter : public RateConverter {
 protected:
 	st_sample_t inBuf[INTERMEDIATE_BUFFER_SIZE];
+	st_sample_t outBuf[INTERMEDIATE_BUFFER_SIZE];
 	const st_sample_t *inPtr;
 	int inLen;
 
@@ -119,37 +335,48 @@ int SimpleRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_samp
 	oend = obuf + osamp * 2;
 
 	while (obuf < oend) {
+		// Resample as much as fits into the intermediate output buffer
+		st_sample_t *tmp = outBuf;
+		st_sample_t *tmpEnd = outBuf + MIN<int>(oend - obuf, ARRAYSIZE(outBuf));
+		bool endOfInput = false;
+
+		while (tmp < tmpEnd && !endOfInput) {
+
+			// read enough input samples so that opos >= 0
+			do {
+				// Check if we have to refill the buffer
+				if (inLen == 0) {
+					inPtr = inBuf;
+					inLen = input.readBuffer(inBuf, ARRAYSIZE(inBuf));
+					if (inLen <= 0) {
+						endOfInput = true;
+						break;
+					}
+				}
+				inLen -= (stereo ? 2 : 1);
+				opos--;
+				if (opos >= 0) {
+					inPtr += (stereo ? 2 : 1);
+				}
+			} while (opos >= 0);
+
+			if (endOfInput)
+				break;
+
+			tmp[0] = *inPtr++;
+			tmp[1] = (stereo ? *inPtr++ : tmp[0]);
+			tmp += 2;
 
-		// read enough input samples so that opos >= 0
-		do {
-			// Check if we have to refill the buffer
-			if (inLen == 0) {
-				inPtr = inBuf;
-				inLen = input.readBuffer(inBuf, ARRAYSIZE(inBuf));
-				if (inLen <= 0)
-					return (obuf - ostart) / 2;
-			}
-			inLen -= (stereo ? 2 : 1);
-			opos--;
-			if (opos >= 0) {
-				inPtr += (stereo ? 2 : 1);
-			}
-		} while (opos >= 0);
-
-		st_sample_t out0, out1;
-		out0 = *inPtr++;
-		out1 = (stereo ? *inPtr++ : out0);
-
-		// Increment output position
-		opos += opos_inc;
-
-		// output left channel
-		clampedAdd(obuf[reverseStereo    ], (out0 * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
+			// Increment output position
+			opos += opos_inc;
+		}
 
-		// output right channel
-		clampedAdd(obuf[reverseStereo ^ 1], (out1 * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
+		const int len = (tmp - outBuf) / 2;
+		mixStereo(obuf, outBuf, len, vol_l, vol_r, reverseStereo);
+		obuf += len * 2;
 
-		obuf += 2;
+		if (endOfInput)
+			break;
 	}
 	return (obuf - ostart) / 2;
 }
@@ -169,6 +396,7 @@ template<bool stereo, bool reverseStereo>
 class LinearRateConverter : public RateConverter {
 protected:
 	st_sample_t inBuf[INTERMEDIATE_BUFFER_SIZE];
+	st_sample_t outBuf[INTERMEDIATE_BUFFER_SIZE];
 	const st_sample_t *inPtr;
 	int inLen;
 
@@ -228,47 +456,401 @@ int LinearRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_samp
 	oend = obuf + osamp * 2;
 
 	while (obuf < oend) {
-
-		// read enough input samples so that opos < 0
-		while ((frac_t)FRAC_ONE_LOW <= opos) {
-			// Check if we have to refill the buffer
-			if (inLen == 0) {
-				inPtr = inBuf;
-				inLen = input.readBuffer(inBuf, ARRAYSIZE(inBuf));
-				if (inLen <= 0)
-					return (obuf - ostart) / 2;
+		// Interpolate as much as fits into the intermediate output buffer
+		st_sample_t *tmp = outBuf;
+		st_sample_t *tmpEnd = outBuf + MIN<int>(oend - obuf, ARRAYSIZE(outBuf));
+		bool endOfInput = false;
+
+		while (tmp < tmpEnd && !endOfInput) {
+
+			// read enough input samples so that opos < 0
+			while ((frac_t)FRAC_ONE_LOW <= opos) {
+				// Check if we have to refill the buffer
+				if (inLen == 0) {
+					inPtr = inBuf;
+					inLen = input.readBuffer(inBuf, ARRAYSIZE(inBuf));
+					if (inLen <= 0) {
+						endOfInput = true;
+						break;
+					}
+				}
+				inLen -= (stereo ? 2 : 1);
+				ilast0 = icur0;
+				icur0 = *inPtr++;
+				if (stereo) {
+					ilast1 = icur1;
+					icur1 = *inPtr++;
+				}
+				opos -= FRAC_ONE_LOW;
 			}
-			inLen -= (stereo ? 2 : 1);
-			ilast0 = icur0;
-			icur0 = *inPtr++;
-			if (stereo) {
-				ilast1 = icur1;
-				icur1 = *inPtr++;
+
+			// Loop as long as the outpos trails behind, and as long as there is
+			// still space in the output buffer.
+			while (!endOfInput && opos < (frac_t)FRAC_ONE_LOW && tmp < tmpEnd) {
+				// interpolate
+				tmp[0] = (st_sample_t)(ilast0 + (((icur0 - ilast0) * opos + FRAC_HALF_LOW) >> FRAC_BITS_LOW));
+				tmp[1] = (stereo ?
+							  (st_sample_t)(ilast1 + (((icur1 - ilast1) * opos + FRAC_HALF_LOW) >> FRAC_BITS_LOW)) :
+							  tmp[0]);
+				tmp += 2;
+
+				// Increment output position
+				opos += opos_inc;
 			}
-			opos -= FRAC_ONE_LOW;
 		}
 
-		// Loop as long as the outpos trails behind, and as long as there is
-		// still space in the output buffer.
-		while (opos < (frac_t)FRAC_ONE_LOW && obuf < oend) {
-			// interpolate
-			st_sample_t out0, out1;
-			out0 = (st_sample_t)(ilast0 + (((icur0 - ilast0) * opos + FRAC_HALF_LOW) >> FRAC_BITS_LOW));
-			out1 = (stereo ?
-						  (st_sample_t)(ilast1 + (((icur1 - ilast1) * opos + FRAC_HALF_LOW) >> FRAC_BITS_LOW)) :
-						  out0);
+		const int len = (tmp - outBuf) / 2;
+		mixStereo(obuf, outBuf, len, vol_l, vol_r, reverseStereo);
+		obuf += len * 2;
 
-			// output left channel
-			clampedAdd(obuf[reverseStereo    ], (out0 * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
+		if (endOfInput)
+			break;
+	}
+	return (obuf - ostart) / 2;
+}
 
-			// output right channel
-			clampedAdd(obuf[reverseStereo ^ 1], (out1 * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
 
-			obuf += 2;
+#pragma mark -
+
+
+/**
+ * Number of fractional bits of the windowed-sinc filter coefficients.
+ */
+#define SINC_COEF_BITS 14
+
+/**
+ * Upper limit for the number of filter phases. For rate pairs which would
+ * need more, every output sample uses the nearest phase. This only jitters
+ * the sample positions by up to 1/1024 of an input sample; the rate itself
+ * stays exact.
+ */
+#define SINC_MAX_PHASES 512
+
+/**
+ * Upper limit for the number of filter taps per phase. Must be a multiple
+ * of 8.
+ */
+#define SINC_MAX_TAPS 64
+
+/**
+ * Windowed-sinc filter coefficients for one in/out rate pair. Filter banks
+ * are shared between all converters for the same rate pair.
+ */
+struct SincFilterBank {
+	st_rate_t inrate;
+	st_rate_t outrate;
+	int refCount;
+
+	/** Number of output positions between two input samples */
+	uint positions;
+
+	/** Input position increment per output sample, in 1/positions units */
+	uint step;
+
+	/** Number of phases, at most SINC_MAX_PHASES */
+	uint phases;
+
+	/** Number of taps per phase, a multiple of 8 */
+	uint taps;
+
+	/**
+	 * (phases + 1) * taps coefficients, in oldest-to-newest input order. The
+	 * last phase is the first one, moved a whole input sample ahead, for
+	 * positions which are rounded up to the next input sample.
+	 */
+	int16 *coefs;
+
+	SincFilterBank *next;
+};
+
+/** The cached filter banks, as a singly linked list */
+static SincFilterBank *s_sincFilterBanks = 0;
+
+static uint gcd(uint a, uint b) {
+	while (b) {
+		const uint t = a % b;
+		a = b;
+		b = t;
+	}
+	return a;
+}
+
+static SincFilterBank *createSincFilterBank(st_rate_t inrate, st_rate_t outrate) {
+	SincFilterBank *bank = new SincFilterBank;
+	bank->inrate = inrate;
+	bank->outrate = outrate;
+	bank->refCount = 0;
+
+	const uint divisor = gcd(inrate, outrate);
+	bank->positions = outrate / divisor;
+	bank->step = inrate / divisor;
+	bank->phases = MIN<uint>(bank->positions, SINC_MAX_PHASES);
+
+	// When downsampling, the cutoff frequency drops below the input Nyquist
+	// frequency, so more taps are needed for the same transition width.
+	const double ratio = MIN<double>(1.0, (double)outrate / inrate);
+	bank->taps = MIN<uint>(SINC_MAX_TAPS, ((uint)ceil(16 / ratio) + 7) & ~7);
+	bank->coefs = new int16[(bank->phases + 1) * bank->taps];
+
+	const double cutoff = 0.95 * ratio;
+	const double halfWidth = bank->taps / 2.0;
+
+	for (uint phase = 0; phase <= bank->phases; ++phase) {
+		int16 *coefs = bank->coefs + phase * bank->taps;
+		const double offset = (double)phase / bank->phases;
+
+		double values[SINC_MAX_TAPS];
+		double sum = 0;
+		for (uint k = 0; k < bank->taps; ++k) {
+			// Distance of the tap from the output position, in input samples
+			const double t = k + 1 - halfWidth - offset;
+			const double x = M_PI * cutoff * t;
+			const double sinc = (t == 0) ? 1.0 : sin(x) / x;
+			const double u = t / halfWidth;
+			const double window = (fabs(u) >= 1.0) ? 0.0 : 0.42 + 0.5 * cos(M_PI * u) + 0.08 * cos(2 * M_PI * u);
+
+			values[k] = sinc * window;
+			sum += values[k];
+		}
+
+		// Normalize every phase to unity gain, so that DC passes unchanged
+		int total = 0;
+		uint center = 0;
+		for (uint k = 0; k < bank->taps; ++k) {
+			coefs[k] = (int16)floor(values[k] / sum * (1 << SINC_COEF_BITS) + 0.5);
+			total += coefs[k];
+			if (coefs[k] > coefs[center])
+				center = k;
+		}
+		coefs[center] += (1 << SINC_COEF_BITS) - total;
+	}
+
+	return bank;
+}
+
+/**
+ * Get the mutex guarding the cached filter banks. It is created on first
+ * use and never destroyed, as g_system does not exist during static
+ * initialization and destruction.
+ */
+static Common::Mutex &getSincFilterBanksMutex() {
+	static Common::Mutex *mutex = new Common::Mutex();
+	return *mutex;
+}
+
+/**
+ * Get the filter bank for the given rate pair, creating it if it is not
+ * cached yet. Must be paired with a call to releaseSincFilterBank().
+ */
+static SincFilterBank *acquireSincFilterBank(st_rate_t inrate, st_rate_t outrate) {
+	Common::StackLock lock(getSincFilterBanksMutex());
+
+	SincFilterBank *bank = s_sincFilterBanks;
+	while (bank && (bank->inrate != inrate || bank->outrate != outrate))
+		bank = bank->next;
+
+	if (!bank) {
+		bank = createSincFilterBank(inrate, outrate);
+		bank->next = s_sincFilterBanks;
+		s_sincFilterBanks = bank;
+	}
+
+	bank->refCount++;
+	return bank;
+}
+
+static void releaseSincFilterBank(SincFilterBank *bank) {
+	Common::StackLock lock(getSincFilterBanksMutex());
+
+	if (--bank->refCount == 0) {
+		SincFilterBank **link = &s_sincFilterBanks;
+		while (*link != bank)
+			link = &(*link)->next;
+		*link = bank->next;
+
+		delete[] bank->coefs;
+		delete bank;
+	}
+}
+
+#if defined(SCUMMVM_SSE2)
+static int32 sincDotProductSSE2(const st_sample_t *samples, const int16 *coefs, uint taps) {
+	__m128i sum = _mm_setzero_si128();
+	for (uint k = 0; k < taps; k += 8) {
+		const __m128i s = _mm_loadu_si128((const __m128i *)(samples + k));
+		const __m128i c = _mm_loadu_si128((const __m128i *)(coefs + k));
+		sum = _mm_add_epi32(sum, _mm_madd_epi16(s, c));
+	}
+
+	sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+	sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+	return _mm_cvtsi128_si32(sum);
+}
+#endif
+
+#if defined(SCUMMVM_NEON)
+static int32 sincDotProductNEON(const st_sample_t *samples, const int16 *coefs, uint taps) {
+	int32x4_t sum = vdupq_n_s32(0);
+	for (uint k = 0; k < taps; k += 8) {
+		const int16x8_t s = vld1q_s16(samples + k);
+		const int16x8_t c = vld1q_s16(coefs + k);
+		sum = vmlal_s16(sum, vget_low_s16(s), vget_low_s16(c));
+		sum = vmlal_s16(sum, vget_high_s16(s), vget_high_s16(c));
+	}
+
+	const int32x2_t pair = vadd_s32(vget_low_s32(sum), vget_high_s32(sum));
+	return vget_lane_s32(vpadd_s32(pair, pair), 0);
+}
+#endif
+
+/**
+ * Apply one phase of the filter to the input history of one channel.
+ */
+static st_sample_t sincFilter(const st_sample_t *samples, const int16 *coefs, uint taps) {
+	int32 sum;
+
+#if defined(SCUMMVM_SSE2)
+	if (Common::hasCPUFeature(Common::kCPUFeatureSSE2)) {
+		sum = sincDotProductSSE2(samples, coefs, taps);
+	} else
+#elif defined(SCUMMVM_NEON)
+	if (Common::hasCPUFeature(Common::kCPUFeatureNEON)) {
+		sum = sincDotProductNEON(samples, coefs, taps);
+	} else
+#endif
+	{
+		sum = 0;
+		for (uint k = 0; k < taps; ++k)
+			sum += samples[k] * coefs[k];
+	}
+
+	sum = (sum + (1 << (SINC_COEF_BITS - 1))) >> SINC_COEF_BITS;
+	return (st_sample_t)CLIP<int32>(sum, ST_SAMPLE_MIN, ST_SAMPLE_MAX);
+}
+
+/**
+ * Audio rate converter based on a polyphase windowed-sinc filter. This
+ * avoids most of the aliasing the linear interpolation produces, at the
+ * cost of 16 (when upsampling) to 64 (when downsampling heavily)
+ * multiplications per output sample and channel.
+ */
+template<bool stereo, bool reverseStereo>
+class SincRateConverter : public RateConverter {
+protected:
+	st_sample_t inBuf[INTERMEDIATE_BUFFER_SIZE];
+	st_sample_t outBuf[INTERMEDIATE_BUFFER_SIZE];
+	const st_sample_t *inPtr;
+	int inLen;
+
+	SincFilterBank *_bank;
+
+	/**
+	 * Fractional part of the input position of the next output sample, in
+	 * 1/positions of an input sample
+	 */
+	uint _position;
+
+	/** number of input samples to read before the next output sample */
+	uint _inputNeeded;
+
+	/**
+	 * The last input samples of each channel. Every sample is stored twice,
+	 * taps apart, so that the newest taps samples are always contiguous.
+	 */
+	st_sample_t _history[2][SINC_MAX_TAPS * 2];
+	uint _historyPos;
+
+public:
+	SincRateConverter(st_rate_t inrate, st_rate_t outrate);
+	~SincRateConverter();
+	int flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r);
+	int drain(st_sample_t *obuf, st_size_t osamp, st_volume_t vol) {
+		return ST_SUCCESS;
+	}
+};
+
+template<bool stereo, bool reverseStereo>
+SincRateConverter<stereo, reverseStereo>::SincRateConverter(st_rate_t inrate, st_rate_t outrate) {
+	_bank = acquireSincFilterBank(inrate, outrate);
+
+	// The output position lies half a filter length before the newest
+	// sample of the history. Prime it with one more sample than that, so
+	// that the first output sample is the first input sample, and the output
+	// is not delayed against the input.
+	_position = 0;
+	_inputNeeded = _bank->taps / 2 + 1;
+
+	memset(_history, 0, sizeof(_history));
+	_historyPos = 0;
+
+	inLen = 0;
+}
+
+template<bool stereo, bool reverseStereo>
+SincRateConverter<stereo, reverseStereo>::~SincRateConverter() {
+	releaseSincFilterBank(_bank);
+}
+
+template<bool stereo, bool reverseStereo>
+int SincRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
+	st_sample_t *ostart, *oend;
+
+	ostart = obuf;
+	oend = obuf + osamp * 2;
+
+	const uint taps = _bank->taps;
+
+	while (obuf < oend) {
+		// Filter as much as fits into the intermediate output buffer
+		st_sample_t *tmp = outBuf;
+		st_sample_t *tmpEnd = outBuf + MIN<int>(oend - obuf, ARRAYSIZE(outBuf));
+		bool endOfInput = false;
+
+		while (tmp < tmpEnd) {
+
+			// read the input samples the next output sample depends on
+			while (_inputNeeded > 0) {
+				// Check if we have to refill the buffer
+				if (inLen == 0) {
+					inPtr = inBuf;
+					inLen = input.readBuffer(inBuf, ARRAYSIZE(inBuf));
+					if (inLen <= 0) {
+						endOfInput = true;
+						break;
+					}
+				}
+				inLen -= (stereo ? 2 : 1);
+
+				_historyPos = (_historyPos + 1) % taps;
+				_history[0][_historyPos] = _history[0][_historyPos + taps] = *inPtr++;
+				if (stereo)
+					_history[1][_historyPos] = _history[1][_historyPos + taps] = *inPtr++;
+
+				_inputNeeded--;
+			}
+
+			if (endOfInput)
+				break;
+
+			// Use the phase nearest to the exact output position
+			const uint phase = (_position * _bank->phases + _bank->positions / 2) / _bank->positions;
+			const int16 *coefs = _bank->coefs + phase * taps;
+			tmp[0] = sincFilter(&_history[0][_historyPos + 1], coefs, taps);
+			tmp[1] = (stereo ? sincFilter(&_history[1][_historyPos + 1], coefs, taps) : tmp[0]);
+			tmp += 2;
 
 			// Increment output position
-			opos += opos_inc;
+			_position += _bank->step;
+			_inputNeeded = _position / _bank->positions;
+			_position %= _bank->positions;
 		}
+
+		const int len = (tmp - outBuf) / 2;
+		mixStereo(obuf, outBuf, len, vol_l, vol_r, reverseStereo);
+		obuf += len * 2;
+
+		if (endOfInput)
+			break;
 	}
 	return (obuf - ostart) / 2;
 }
@@ -293,11 +875,8 @@ public:
 	virtual int flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
 		assert(input.isStereo() == stereo);
 
-		st_sample_t *ptr;
 		st_size_t len;
 
-		st_sample_t *ostart = obuf;
-
 		if (stereo)
 			osamp *= 2;
 
@@ -315,21 +894,13 @@ public:
 		len = input.readBuffer(_buffer, osamp);
 
 		// Mix the data into the output buffer
-		ptr = _buffer;
-		for (; len > 0; len -= (stereo ? 2 : 1)) {
-			st_sample_t out0, out1;
-			out0 = *ptr++;
-			out1 = (stereo ? *ptr++ : out0);
-
-			// output left channel
-			clampedAdd(obuf[reverseStereo    ], (out0 * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
-
-			// output right channel
-			clampedAdd(obuf[reverseStereo ^ 1], (out1 * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
-
-			obuf += 2;
+		if (stereo) {
+			len /= 2;
+			mixStereo(obuf, _buffer, len, vol_l, vol_r, reverseStereo);
+		} else {
+			mixMono(obuf, _buffer, len, vol_l, vol_r);
 		}
-		return (obuf - ostart) / 2;
+		return len;
 	}
 
 	virtual int drain(st_sample_t *obuf, st_size_t osamp, st_volume_t vol) {
@@ -343,7 +914,9 @@ public:
 template<bool stereo, bool reverseStereo>
 RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate) {
 	if (inrate != outrate) {
-		if ((inrate % outrate) == 0 && (inrate < 65536)) {
+		if (ConfMan.get("resampler") == "sinc") {
+			return new SincRateConverter<stereo, reverseStereo>(inrate, outrate);
+		} else if ((inrate % outrate) == 0 && (inrate < 65536)) {
 			return new SimpleRateConverter<stereo, reverseStereo>(inrate, outrate);
 		} else {
 			return new LinearRateConverter<stereo, reverseStereo>(inrate, outrate);
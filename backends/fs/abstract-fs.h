@@ -183,6 +183,19 @@ public:
 	 */
 	virtual Common::SeekableReadStream *createReadStream() = 0;
 
+	/**
+	 * Creates a SeekableReadStream instance for a file which is only read
+	 * while it is open, like the data files of a game. Backends may map
+	 * such files into memory instead of reading them, so that
+	 * SeekableReadStream::getDataPointer() gives access to their contents.
+	 * Truncating a mapped file while it is open makes accessing the lost
+	 * part crash (with SIGBUS on POSIX systems), so this must not be used
+	 * for files which may be written to, like savefiles.
+	 *
+	 * @return pointer to the stream object, 0 in case of a failure
+	 */
+	virtual Common::SeekableReadStream *createGameDataReadStream() { return createReadStream(); }
+
 	/**
 	 * Creates a WriteStream instance corresponding to the file
 	 * referred by this node. This assumes that the node actually refers
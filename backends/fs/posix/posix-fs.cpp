@@ -32,6 +32,9 @@
 
 #include "backends/fs/posix/posix-fs.h"
 #include "backends/fs/stdiostream.h"
+#if defined(POSIX)
+#include "backends/fs/posix/posix-mmapstream.h"
+#endif
 #include "common/algorithm.h"
 
 #include <sys/param.h>
@@ -248,6 +251,16 @@ Common::SeekableReadStream *POSIXFilesystemNode::createReadStream() {
 	return StdioStream::makeFromPath(getPath(), false);
 }
 
+Common::SeekableReadStream *POSIXFilesystemNode::createGameDataReadStream() {
+#if defined(POSIX)
+	// Large files are mapped, so that engines can use their data in place
+	Common::SeekableReadStream *stream = PosixMmapStream::makeFromPath(getPath());
+	if (stream)
+		return stream;
+#endif
+	return createReadStream();
+}
+
 Common::WriteStream *POSIXFilesystemNode::createWriteStream() {
 	return StdioStream::makeFromPath(getPath(), true);
 }
@@ -72,6 +72,7 @@ public:
 	virtual AbstractFSNode *getParent() const;
 
 	virtual Common::SeekableReadStream *createReadStream();
+	virtual Common::SeekableReadStream *createGameDataReadStream();
 	virtual Common::WriteStream *createWriteStream();
 
 private:
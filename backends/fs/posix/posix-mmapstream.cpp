@@ -0,0 +1,106 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#if defined(POSIX)
+
+// Disable symbol overrides so that we can use open, mmap etc.
+#define FORBIDDEN_SYMBOL_ALLOW_ALL
+
+#include "backends/fs/posix/posix-mmapstream.h"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+PosixMmapStream::PosixMmapStream(void *mapping, uint32 size)
+	: _mapping((const byte *)mapping), _size(size), _pos(0), _eos(false) {
+}
+
+PosixMmapStream::~PosixMmapStream() {
+	munmap(const_cast<byte *>(_mapping), _size);
+}
+
+uint32 PosixMmapStream::read(void *dataPtr, uint32 dataSize) {
+	const uint32 left = (uint32)_pos < _size ? _size - _pos : 0;
+	if (dataSize > left) {
+		dataSize = left;
+		_eos = true;
+	}
+	if (dataSize) {
+		memcpy(dataPtr, _mapping + _pos, dataSize);
+		_pos += dataSize;
+	}
+	return dataSize;
+}
+
+bool PosixMmapStream::seek(int32 offs, int whence) {
+	int32 newPos;
+	switch (whence) {
+	case SEEK_END:
+		newPos = (int32)_size + offs;
+		break;
+	case SEEK_CUR:
+		newPos = _pos + offs;
+		break;
+	case SEEK_SET:
+		newPos = offs;
+		break;
+	default:
+		return false;
+	}
+
+	// Like fseek(), the position may lie past the end, but not before the
+	// start. Overflows are caught as well, since the size is below 2 GB.
+	if (newPos < 0)
+		return false;
+
+	_pos = newPos;
+	_eos = false;
+	return true;
+}
+
+PosixMmapStream *PosixMmapStream::makeFromPath(const Common::String &path) {
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0)
+		return 0;
+
+	// Streams are limited to 2 GB, and it takes more than a mapping to
+	// handle files which are not regular
+	struct stat st;
+	if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size < (off_t)kMinimumSize || st.st_size > 0x7FFFFFFF) {
+		close(fd);
+		return 0;
+	}
+
+	const uint32 size = (uint32)st.st_size;
+	void *mapping = mmap(0, size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+	// The mapping stays valid after closing the file
+	close(fd);
+
+	if (mapping == MAP_FAILED)
+		return 0;
+	return new PosixMmapStream(mapping, size);
+}
+
+#endif
@@ -0,0 +1,82 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef BACKENDS_FS_POSIX_MMAPSTREAM_H
+#define BACKENDS_FS_POSIX_MMAPSTREAM_H
+
+#include "common/scummsys.h"
+#include "common/noncopyable.h"
+#include "common/str.h"
+#include "common/stream.h"
+
+/**
+ * A read stream over a file mapped into memory. Reading copies from the
+ * mapping, and getDataPointer() gives access to the mapped bytes without
+ * copying them at all. Only the pages which are touched are read from
+ * disk, and they are shared with the page cache of the system instead of
+ * taking up memory of their own.
+ *
+ * Seeking behaves like it does for a StdioStream: seeking before the start
+ * fails, seeking past the end succeeds and the next read hits the end.
+ */
+class PosixMmapStream : public Common::SeekableReadStream, public Common::NonCopyable {
+protected:
+	const byte *_mapping;
+	uint32 _size;
+	int32 _pos;
+	bool _eos;
+
+	PosixMmapStream(void *mapping, uint32 size);
+
+public:
+	enum {
+		/**
+		 * Files smaller than this are not worth mapping, since they are
+		 * usually read in one go anyway.
+		 */
+		kMinimumSize = 256 * 1024
+	};
+
+	/**
+	 * Maps the file at the given path into memory. Only use this for files
+	 * which are not written to while the stream exists: if the file gets
+	 * truncated, accessing the part of the mapping past its new end raises
+	 * SIGBUS, which crashes ScummVM.
+	 * @return the stream, or 0 if the file could not be mapped, in which
+	 *         case it is to be read with a StdioStream instead
+	 */
+	static PosixMmapStream *makeFromPath(const Common::String &path);
+
+	virtual ~PosixMmapStream();
+
+	virtual uint32 read(void *dataPtr, uint32 dataSize);
+	virtual bool eos() const { return _eos; }
+	virtual void clearErr() { _eos = false; }
+
+	virtual int32 pos() const { return _pos; }
+	virtual int32 size() const { return _size; }
+	virtual bool seek(int32 offs, int whence = SEEK_SET);
+
+	virtual const byte *getDataPointer() const { return _mapping; }
+};
+
+#endif
@@ -290,6 +290,8 @@ void DINGUXSdlGraphicsManager::internUpdateScreen() {
 	if (_mouseNeedsRedraw)
 		undrawMouse();
 
+	mergeDirtyRects(width, height);
+
 	// Force a full redraw if requested
 	if (_forceFull) {
 		_numDirtyRects = 1;
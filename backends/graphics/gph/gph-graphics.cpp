@@ -319,6 +319,8 @@ void GPHGraphicsManager::internUpdateScreen() {
 	if (_mouseNeedsRedraw)
 		undrawMouse();
 
+	mergeDirtyRects(width, height);
+
 	// Force a full redraw if requested
 	if (_forceFull) {
 		_numDirtyRects = 1;
@@ -331,6 +331,8 @@ void LinuxmotoSdlGraphicsManager::internUpdateScreen() {
 	if (_mouseNeedsRedraw)
 		undrawMouse();
 
+	mergeDirtyRects(width, height);
+
 	// Force a full redraw if requested
 	if (_forceFull) {
 		_numDirtyRects = 1;
@@ -146,6 +146,8 @@ SurfaceSdlGraphicsManager::SurfaceSdlGraphicsManager(SdlEventSource *sdlEventSou
 	_screenIsLocked(false),
 	_graphicsMutex(0),
 	_displayDisabled(false),
+	_numDirtyRects(0), _dirtyRectDebug(false),
+	_dirtyRectStatsStart(0), _dirtyRectStatsFrames(0), _dirtyRectStatsMerged(0), _dirtyRectStatsPixels(0),
 #ifdef USE_SDL_DEBUG_FOCUSRECT
 	_enableFocusRectDebugCode(false), _enableFocusRect(false), _focusRect(),
 #endif
@@ -908,6 +910,8 @@ bool SurfaceSdlGraphicsManager::loadGFXMode() {
 	else
 		InitScalers(565);
 
+	SetScalerThreads(ConfMan.getInt("scaler_threads"));
+
 	return true;
 }
 
@@ -1099,6 +1103,8 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 	if (_mouseNeedsRedraw)
 		undrawMouse();
 
+	mergeDirtyRects(width, height);
+
 	// Force a full redraw if requested
 	if (_forceFull) {
 		_numDirtyRects = 1;
@@ -1152,7 +1158,7 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 					dst_y = real2Aspect(dst_y);
 
 				assert(scalerProc != NULL);
-				scalerProc((byte *)srcSurf->pixels + (r->x * 2 + 2) + (r->y + 1) * srcPitch, srcPitch,
+				ScaleInBands(scalerProc, scale1, (byte *)srcSurf->pixels + (r->x * 2 + 2) + (r->y + 1) * srcPitch, srcPitch,
 					(byte *)_hwscreen->pixels + rx1 * 2 + dst_y * dstPitch, dstPitch, r->w, dst_h);
 			}
 
@@ -1176,6 +1182,9 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 			_dirtyRectList[0].h = effectiveScreenHeight();
 		}
 
+		if (_dirtyRectDebug)
+			drawDirtyRectOutlines();
+
 		drawMouse();
 
 #ifdef USE_OSD
@@ -1267,6 +1276,135 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 	_mouseNeedsRedraw = false;
 }
 
+void SurfaceSdlGraphicsManager::mergeDirtyRects(int width, int height) {
+	// The dirty rects are collected in the coordinates of the surface shown
+	if (_dirtyRects.getWidth() != width || _dirtyRects.getHeight() != height) {
+		_dirtyRects.setSize(width, height);
+		_forceFull = true;
+	}
+
+	if (_dirtyRectDebug)
+		updateDirtyRectDebug(width, height);
+
+	// Merge the dirty rects into as few as possible before scaling them. If
+	// there are still too many, a full redraw is cheaper anyway. One entry
+	// is kept free for the mouse cursor.
+	if (!_forceFull) {
+		const Common::Array<Common::Rect> &rects = _dirtyRects.getRects();
+		if (_numDirtyRects + (int)rects.size() >= NUM_DIRTY_RECT) {
+			_forceFull = true;
+		} else {
+			for (uint i = 0; i < rects.size(); ++i) {
+				int x = rects[i].left, y = rects[i].top;
+				int w = rects[i].width(), h = rects[i].height();
+
+#ifdef USE_SCALERS
+				// Merging lines the rects up with the tiles of the dirty
+				// rect list, so they have to be made stretchable again
+				if (_videoMode.aspectRatioCorrection && !_overlayVisible)
+					makeRectStretchable(x, y, w, h);
+#endif
+
+				SDL_Rect *r = &_dirtyRectList[_numDirtyRects++];
+				r->x = x;
+				r->y = y;
+				r->w = w;
+				r->h = h;
+			}
+
+			if (_dirtyRectDebug)
+				_dirtyRectOutlines = rects;
+		}
+	}
+
+	if (_forceFull && _dirtyRectDebug) {
+		_dirtyRectOutlines.clear();
+		_dirtyRectOutlines.push_back(Common::Rect(width, height));
+	}
+
+	_dirtyRects.clear();
+}
+
+void SurfaceSdlGraphicsManager::updateDirtyRectDebug(int width, int height) {
+	// Count what is scaled without the debug view, i.e. before the outlines
+	// of the last frame are added for repainting
+	_dirtyRectStatsFrames++;
+	if (_forceFull) {
+		_dirtyRectStatsMerged++;
+		_dirtyRectStatsPixels += width * height;
+	} else {
+		_dirtyRectStatsMerged += _dirtyRects.getRects().size();
+		_dirtyRectStatsPixels += _dirtyRects.getArea();
+
+		for (uint i = 0; i < _dirtyRectOutlines.size(); ++i) {
+			const Common::Rect &r = _dirtyRectOutlines[i];
+			addDirtyRect(r.left, r.top, r.width(), 1);
+			addDirtyRect(r.left, r.bottom - 1, r.width(), 1);
+			addDirtyRect(r.left, r.top, 1, r.height());
+			addDirtyRect(r.right - 1, r.top, 1, r.height());
+		}
+	}
+
+	const uint32 now = SDL_GetTicks();
+	if (now - _dirtyRectStatsStart >= 1000) {
+		const uint32 pixels = _dirtyRectStatsPixels / _dirtyRectStatsFrames;
+		debug("Dirty rects: %d merged rects, %d of %d pixels scaled per frame (%d%%)",
+		      _dirtyRectStatsMerged / _dirtyRectStatsFrames,
+		      pixels, width * height, pixels * 100 / (width * height));
+
+		_dirtyRectStatsStart = now;
+		_dirtyRectStatsFrames = 0;
+		_dirtyRectStatsMerged = 0;
+		_dirtyRectStatsPixels = 0;
+	}
+}
+
+void SurfaceSdlGraphicsManager::drawDirtyRectOutlines() {
+	const int bpp = _hwscreen->format->BytesPerPixel;
+	if (bpp != 2 && bpp != 4)
+		return;
+
+	const Uint32 color = SDL_MapRGB(_hwscreen->format, 0x00, 0xFF, 0x00);
+
+	SDL_LockSurface(_hwscreen);
+
+	for (int i = 0; i < _numDirtyRects; ++i) {
+		Common::Rect r(_dirtyRectList[i].x, _dirtyRectList[i].y, _dirtyRectList[i].x + _dirtyRectList[i].w, _dirtyRectList[i].y + _dirtyRectList[i].h);
+		r.clip(Common::Rect(_hwscreen->w, _hwscreen->h));
+		if (r.isEmpty())
+			continue;
+
+		byte *top = (byte *)_hwscreen->pixels + r.top * _hwscreen->pitch + r.left * bpp;
+		byte *bottom = (byte *)_hwscreen->pixels + (r.bottom - 1) * _hwscreen->pitch + r.left * bpp;
+		for (int x = 0; x < r.width(); ++x) {
+			if (bpp == 2) {
+				((uint16 *)top)[x] = color;
+				((uint16 *)bottom)[x] = color;
+			} else {
+				((uint32 *)top)[x] = color;
+				((uint32 *)bottom)[x] = color;
+			}
+		}
+
+		byte *left = top;
+		byte *right = top + (r.width() - 1) * bpp;
+		for (int y = 0; y < r.height(); ++y) {
+			if (bpp == 2) {
+				*(uint16 *)left = color;
+				*(uint16 *)right = color;
+			} else {
+				*(uint32 *)left = color;
+				*(uint32 *)right = color;
+			}
+
+			left += _hwscreen->pitch;
+			right += _hwscreen->pitch;
+		}
+	}
+
+	SDL_UnlockSurface(_hwscreen);
+}
+
 bool SurfaceSdlGraphicsManager::saveScreenshot(const char *filename) {
 	assert(_hwscreen != NULL);
 
@@ -1403,7 +1541,7 @@ void SurfaceSdlGraphicsManager::addDirtyRect(int x, int y, int w, int h, bool re
 	if (_forceFull)
 		return;
 
-	if (_numDirtyRects == NUM_DIRTY_RECT) {
+	if (realCoordinates && _numDirtyRects == NUM_DIRTY_RECT) {
 		_forceFull = true;
 		return;
 	}
@@ -1457,13 +1595,19 @@ void SurfaceSdlGraphicsManager::addDirtyRect(int x, int y, int w, int h, bool re
 		return;
 	}
 
-	if (w > 0 && h > 0) {
+	if (w <= 0 || h <= 0)
+		return;
+
+	if (realCoordinates) {
+		// Already scaled, e.g. the mouse cursor
 		SDL_Rect *r = &_dirtyRectList[_numDirtyRects++];
 
 		r->x = x;
 		r->y = y;
 		r->w = w;
 		r->h = h;
+	} else {
+		_dirtyRects.addRect(Common::Rect(x, y, x + w, y + h));
 	}
 }
 
@@ -2228,6 +2372,22 @@ bool SurfaceSdlGraphicsManager::handleScalerHotkeys(Common::KeyCode key) {
 		return true;
 	}
 
+	// Ctrl-Alt-d toggles the dirty rect debug view
+	if (key == 'd') {
+		_dirtyRectDebug = !_dirtyRectDebug;
+		_dirtyRectOutlines.clear();
+		_dirtyRectStatsStart = SDL_GetTicks();
+		_dirtyRectStatsFrames = 0;
+		_dirtyRectStatsMerged = 0;
+		_dirtyRectStatsPixels = 0;
+		debug("Dirty rect debug view %s", _dirtyRectDebug ? "enabled" : "disabled");
+
+		// Get rid of any outlines
+		_forceFull = true;
+		internUpdateScreen();
+		return true;
+	}
+
 	int newMode = -1;
 	int factor = _videoMode.scaleFactor - 1;
 	SDLKey sdlKey = (SDLKey)key;
@@ -2302,7 +2462,7 @@ bool SurfaceSdlGraphicsManager::isScalerHotkey(const Common::Event &event) {
 			if (keyValue >= ARRAYSIZE(s_gfxModeSwitchTable))
 				return false;
 		}
-		return (isScaleKey || event.kbd.keycode == 'a');
+		return (isScaleKey || event.kbd.keycode == 'a' || event.kbd.keycode == 'd');
 	}
 	return false;
 }
@@ -25,6 +25,7 @@
 
 #include "backends/graphics/graphics.h"
 #include "backends/graphics/sdl/sdl-graphics.h"
+#include "graphics/dirtyrects.h"
 #include "graphics/pixelformat.h"
 #include "graphics/scaler.h"
 #include "common/events.h"
@@ -288,10 +289,24 @@ protected:
 		MAX_SCALING = 3
 	};
 
-	// Dirty rect management
+	// Dirty rect management. Rects in game or overlay coordinates are merged
+	// in _dirtyRects and copied to _dirtyRectList before scaling, which
+	// then holds the rects to be updated in hardware coordinates.
+	Graphics::DirtyRectList _dirtyRects;
 	SDL_Rect _dirtyRectList[NUM_DIRTY_RECT];
 	int _numDirtyRects;
 
+	/**
+	 * Debug view of the dirty rect merging, toggled by Ctrl-Alt-d: outlines
+	 * the merged rects on screen and logs how many pixels are scaled.
+	 */
+	bool _dirtyRectDebug;
+	Common::Array<Common::Rect> _dirtyRectOutlines;
+	uint32 _dirtyRectStatsStart;
+	uint32 _dirtyRectStatsFrames;
+	uint32 _dirtyRectStatsMerged;
+	uint32 _dirtyRectStatsPixels;
+
 	struct MousePos {
 		// The mouse position, using either virtual (game) or real
 		// (overlay) coordinates.
@@ -360,6 +375,15 @@ protected:
 
 	virtual void addDirtyRect(int x, int y, int w, int h, bool realCoordinates = false);
 
+	/**
+	 * Merge the dirty rects added for a surface of the given size and
+	 * append them to _dirtyRectList, or set _forceFull if that is cheaper.
+	 * To be called by internUpdateScreen() before scaling.
+	 */
+	void mergeDirtyRects(int width, int height);
+	void drawDirtyRectOutlines();
+	void updateDirtyRectDebug(int width, int height);
+
 	virtual void drawMouse();
 	virtual void undrawMouse();
 	virtual void blitCursor();
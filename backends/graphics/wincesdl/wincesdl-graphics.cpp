@@ -531,6 +531,11 @@ void WINCESdlGraphicsManager::internUpdateScreen() {
 		update_scalers();
 	}
 
+	if (!_overlayVisible)
+		mergeDirtyRects(_videoMode.screenWidth, _videoMode.screenHeight);
+	else
+		mergeDirtyRects(_videoMode.overlayWidth, _videoMode.overlayHeight);
+
 	// Force a full redraw if requested
 	if (_forceFull) {
 		_numDirtyRects = 1;
@@ -147,6 +147,8 @@ static Common::Error runGame(const EnginePlugin *plugin, OSystem &system, const
 	}
 #endif
 
+	YUVToRGBMan.setThreads(ConfMan.getInt("video_threads"));
+
 	// Verify that the game path refers to an actual directory
 	if (!(dir.exists() && dir.isDirectory()))
 		err = Common::kPathNotDirectory;
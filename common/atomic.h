@@ -0,0 +1,124 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef COMMON_ATOMIC_H
+#define COMMON_ATOMIC_H
+
+#include "common/scummsys.h"
+
+#if defined(_MSC_VER)
+// Pulls in intrin.h, working around its use of setjmp
+#include "common/math.h"
+#endif
+
+namespace Common {
+
+/**
+ * @defgroup atomic Atomic operations
+ *
+ * Minimal set of atomic operations on 32 bit integers, as needed for
+ * lock-free data exchange between two threads. All operations act as full
+ * memory barriers.
+ *
+ * Compilers without atomic builtins fall back to plain volatile accesses
+ * with a compiler barrier, which is only correct on single core targets.
+ * @{
+ */
+
+typedef volatile int32 AtomicInt32;
+
+/**
+ * Issue a full memory barrier.
+ */
+inline void atomicBarrier() {
+#if defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 1))
+	__sync_synchronize();
+#elif defined(_MSC_VER)
+	long barrier = 0;
+	_InterlockedExchange(&barrier, 0);
+#elif defined(__GNUC__)
+	__asm__ __volatile__("" ::: "memory");
+#endif
+}
+
+/**
+ * Read an atomic value, ordered after all preceding memory accesses.
+ */
+inline int32 atomicLoad(const AtomicInt32 *ptr) {
+	atomicBarrier();
+	const int32 value = *ptr;
+	atomicBarrier();
+	return value;
+}
+
+/**
+ * Write an atomic value, ordered after all preceding memory accesses.
+ */
+inline void atomicStore(AtomicInt32 *ptr, int32 value) {
+	atomicBarrier();
+	*ptr = value;
+	atomicBarrier();
+}
+
+/**
+ * Add a value to an atomic value.
+ *
+ * @return the new value
+ */
+inline int32 atomicAdd(AtomicInt32 *ptr, int32 value) {
+#if defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 1))
+	return __sync_add_and_fetch(ptr, value);
+#elif defined(_MSC_VER)
+	return _InterlockedExchangeAdd((volatile long *)ptr, value) + value;
+#else
+	atomicBarrier();
+	const int32 result = (*ptr += value);
+	atomicBarrier();
+	return result;
+#endif
+}
+
+/**
+ * Replace an atomic value, but only if it still holds the expected value.
+ *
+ * @return true if the value was replaced
+ */
+inline bool atomicCompareAndSwap(AtomicInt32 *ptr, int32 expected, int32 desired) {
+#if defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 1))
+	return __sync_bool_compare_and_swap(ptr, expected, desired);
+#elif defined(_MSC_VER)
+	return _InterlockedCompareExchange((volatile long *)ptr, desired, expected) == expected;
+#else
+	atomicBarrier();
+	if (*ptr != expected)
+		return false;
+	*ptr = desired;
+	atomicBarrier();
+	return true;
+#endif
+}
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
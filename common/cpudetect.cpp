@@ -0,0 +1,89 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "common/cpudetect.h"
+
+#if defined(SCUMMVM_AVX2)
+#include <cpuid.h>
+#endif
+
+namespace Common {
+
+static bool s_probed = false;
+static uint32 s_cpuFeatures = 0;
+static uint32 s_cpuFeatureMask = kCPUFeatureAll;
+
+#if defined(SCUMMVM_AVX2)
+static bool probeAVX2() {
+	unsigned int eax, ebx, ecx, edx;
+
+	if (__get_cpuid_max(0, 0) < 7)
+		return false;
+
+	// The OS has to save the YMM registers on context switches, which is
+	// signalled through OSXSAVE and the XCR0 register.
+	__cpuid(1, eax, ebx, ecx, edx);
+	if (!(ecx & (1 << 27)) || !(ecx & (1 << 28)))
+		return false;
+
+	unsigned int xcr0Low, xcr0High;
+	__asm__ __volatile__("xgetbv" : "=a" (xcr0Low), "=d" (xcr0High) : "c" (0));
+	if ((xcr0Low & 6) != 6)
+		return false;
+
+	__cpuid_count(7, 0, eax, ebx, ecx, edx);
+	return (ebx & (1 << 5)) != 0;
+}
+#endif
+
+static void probeCPUFeatures() {
+	s_cpuFeatures = 0;
+
+#if defined(SCUMMVM_SSE2)
+	// The whole build already requires SSE2 in this case.
+	s_cpuFeatures |= kCPUFeatureSSE2;
+#endif
+
+#if defined(SCUMMVM_AVX2)
+	if (probeAVX2())
+		s_cpuFeatures |= kCPUFeatureAVX2;
+#endif
+
+#if defined(SCUMMVM_NEON)
+	s_cpuFeatures |= kCPUFeatureNEON;
+#endif
+
+	s_probed = true;
+}
+
+bool hasCPUFeature(CPUFeature feature) {
+	if (!s_probed)
+		probeCPUFeatures();
+
+	return (s_cpuFeatures & s_cpuFeatureMask & feature) != 0;
+}
+
+void setCPUFeatureMask(uint32 mask) {
+	s_cpuFeatureMask = mask;
+}
+
+} // End of namespace Common
@@ -0,0 +1,95 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef COMMON_CPUDETECT_H
+#define COMMON_CPUDETECT_H
+
+#include "common/scummsys.h"
+
+/**
+ * @def SCUMMVM_SSE2
+ * Defined when the compiler can emit SSE2 code for the whole build, i.e.
+ * on x86_64 or when building for i686 with -msse2.
+ *
+ * @def SCUMMVM_AVX2
+ * Defined when single functions can be compiled for AVX2 through
+ * SCUMMVM_TARGET_AVX2, independently of the global build flags.
+ *
+ * @def SCUMMVM_NEON
+ * Defined when the compiler can emit NEON code for the whole build, i.e.
+ * on AArch64 or when building for ARMv7 with -mfpu=neon.
+ *
+ * Code using any of these must additionally check hasCPUFeature() before
+ * taking the vector path, so that it can be disabled at runtime.
+ */
+#if !defined(DISABLE_SIMD)
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SCUMMVM_SSE2
+#endif
+
+#if defined(SCUMMVM_SSE2) && (defined(__clang__) || (defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))))
+#define SCUMMVM_AVX2
+#define SCUMMVM_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define SCUMMVM_NEON
+#endif
+
+#endif // !DISABLE_SIMD
+
+namespace Common {
+
+/**
+ * Instruction set extensions which may be queried through hasCPUFeature().
+ */
+enum CPUFeature {
+	kCPUFeatureSSE2 = 1 << 0,
+	kCPUFeatureAVX2 = 1 << 1,
+	kCPUFeatureNEON = 1 << 2,
+
+	kCPUFeatureAll = kCPUFeatureSSE2 | kCPUFeatureAVX2 | kCPUFeatureNEON
+};
+
+/**
+ * Check whether the given instruction set extension may be used. This is
+ * true when the host CPU supports it, the build was able to compile code
+ * for it and it was not masked out through setCPUFeatureMask().
+ *
+ * The CPU is only probed once, so this is cheap enough to be called per
+ * buffer or per blit.
+ */
+bool hasCPUFeature(CPUFeature feature);
+
+/**
+ * Restrict the features reported by hasCPUFeature() to the given mask.
+ * Passing 0 forces all callers onto their plain C++ reference code, which
+ * is useful for debugging and for comparing the vector paths against it.
+ *
+ * @param mask	combination of CPUFeature values which may be reported
+ */
+void setCPUFeatureMask(uint32 mask);
+
+} // End of namespace Common
+
+#endif
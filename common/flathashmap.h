@@ -0,0 +1,597 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+// The open addressing scheme in this file follows the ideas of the
+// SwissTable hash tables from Abseil: one control byte per slot, holding
+// either a marker for empty and deleted slots or seven bits of the hash.
+// Lookups test the control bytes of eight slots at once, with plain 64 bit
+// arithmetic.
+
+#ifndef COMMON_FLATHASHMAP_H
+#define COMMON_FLATHASHMAP_H
+
+#include "common/endian.h"
+#include "common/func.h"
+
+namespace Common {
+
+/**
+ * FlatHashMap<Key,Val> is a drop-in alternative to HashMap<Key,Val>, which
+ * stores the keys and values inline in a single array, together with their
+ * cached hash, instead of allocating a node for each of them. A separate
+ * array of control bytes lets lookups skip most non-matching slots without
+ * touching them, eight at a time. This saves one cache miss per lookup, and the memory pool.
+ *
+ * It offers the same interface as HashMap, so code can switch between the
+ * two by changing a typedef. There is one important difference, though:
+ * inserting a new key may move all elements, which invalidates references
+ * to values and all iterators. Erasing elements keeps iterators valid, just
+ * like with HashMap.
+ */
+template<class Key, class Val, class HashFunc = Hash<Key>, class EqualFunc = EqualTo<Key> >
+class FlatHashMap {
+public:
+	typedef uint size_type;
+
+	struct Node {
+		const Key _key;
+		Val _value;
+		explicit Node(const Key &key) : _key(key), _value() {}
+	};
+
+private:
+
+	typedef FlatHashMap<Key, Val, HashFunc, EqualFunc> HM_t;
+
+	struct Slot {
+		size_type _hash;
+		Node _node;
+		Slot(const Key &key, size_type hash) : _hash(hash), _node(key) {}
+	};
+
+	enum {
+		FLATHASHMAP_MIN_CAPACITY = 16,
+
+		// The quotient of the next two constants controls how much the
+		// internal storage may fill up, including deleted slots, before
+		// it is rebuilt.
+		FLATHASHMAP_LOADFACTOR_NUMERATOR = 3,
+		FLATHASHMAP_LOADFACTOR_DENOMINATOR = 4
+	};
+
+	/**
+	 * Values of the control bytes. Used slots hold the lowest seven bits
+	 * of the mixed hash instead.
+	 */
+	enum {
+		kCtrlEmpty = 0x80,
+		kCtrlDeleted = 0xFE
+	};
+
+	/**
+	 * Number of control bytes tested at once. The first kGroupWidth - 1
+	 * control bytes are mirrored behind the last one, so that a group can
+	 * always be loaded with a single read, even when it wraps around.
+	 */
+	enum {
+		kGroupWidth = 8
+	};
+
+	static const size_type NONE_FOUND = (size_type)-1;
+
+	Slot *_slots;	///< Uninitialized memory for _mask+1 slots
+	byte *_ctrl;	///< One control byte per slot, plus the mirrored ones
+	size_type _mask;	///< Capacity minus one; the capacity is a power of two
+	size_type _shift;	///< Shift to get a slot index out of a mixed hash
+	size_type _size;
+	size_type _deleted;	///< Number of slots marked kCtrlDeleted
+
+	HashFunc _hash;
+	EqualFunc _equal;
+
+	/** Default value, returned by the const getVal. */
+	const Val _defaultVal;
+
+	/**
+	 * Spread the bits of the hash, so that hash functions which only vary
+	 * in the upper or lower bits still produce few collisions. Fibonacci
+	 * hashing; the slot index is taken from the upper bits.
+	 */
+	static uint32 mixHash(size_type hash) {
+		return (uint32)hash * 0x9E3779B9U;
+	}
+
+	static bool isFull(byte ctrl) {
+		return (ctrl & 0x80) == 0;
+	}
+
+	static uint64 lowBits() {
+		return ((uint64)0x01010101 << 32) | 0x01010101;
+	}
+
+	static uint64 highBits() {
+		return ((uint64)0x80808080 << 32) | 0x80808080;
+	}
+
+	/**
+	 * Find the control bytes in a group which hold the given tag. This may
+	 * report false positives next to real matches, which is fine, since the
+	 * hash and the key are compared afterwards anyway.
+	 *
+	 * @return the top bit of each matching byte
+	 */
+	static uint64 matchTag(uint64 group, byte tag) {
+		const uint64 x = group ^ (lowBits() * tag);
+		return (x - lowBits()) & ~x & highBits();
+	}
+
+	/** @return the top bit of each byte in a group which is kCtrlEmpty */
+	static uint64 matchEmpty(uint64 group) {
+		return group & ~(group << 6) & highBits();
+	}
+
+	/** @return the top bit of each byte in a group which is not full */
+	static uint64 matchEmptyOrDeleted(uint64 group) {
+		return group & highBits();
+	}
+
+	/** @return the position of the lowest byte reported by a match function */
+	static size_type firstMatch(uint64 match) {
+#if defined(__GNUC__)
+		return __builtin_ctzll(match) >> 3;
+#else
+		size_type pos = 0;
+		while (!(match & 0x80)) {
+			match >>= 8;
+			pos++;
+		}
+		return pos;
+#endif
+	}
+
+	uint64 loadGroup(size_type pos) const {
+		return READ_LE_UINT64(_ctrl + pos);
+	}
+
+	void setCtrl(size_type ctr, byte ctrl) {
+		_ctrl[ctr] = ctrl;
+		_ctrl[((ctr - (kGroupWidth - 1)) & _mask) + (kGroupWidth - 1)] = ctrl;
+	}
+
+	void allocStorage(size_type capacity);
+	void freeStorage();
+	void assign(const HM_t &map);
+	size_type lookup(const Key &key) const;
+	size_type lookupAndCreateIfMissing(const Key &key);
+	size_type findFreeSlot(size_type hash) const;
+	void rehash(size_type newCapacity);
+
+	template<class NodeType>
+	class IteratorImpl {
+		friend class FlatHashMap;
+		template<class T> friend class IteratorImpl;
+	protected:
+		typedef const FlatHashMap hashmap_t;
+
+		size_type _idx;
+		hashmap_t *_hashmap;
+
+	protected:
+		IteratorImpl(size_type idx, hashmap_t *hashmap) : _idx(idx), _hashmap(hashmap) {}
+
+		NodeType *deref() const {
+			assert(_hashmap != 0);
+			assert(_idx <= _hashmap->_mask);
+			assert(isFull(_hashmap->_ctrl[_idx]));
+			return &_hashmap->_slots[_idx]._node;
+		}
+
+	public:
+		IteratorImpl() : _idx(0), _hashmap(0) {}
+		template<class T>
+		IteratorImpl(const IteratorImpl<T> &c) : _idx(c._idx), _hashmap(c._hashmap) {}
+
+		NodeType &operator*() const { return *deref(); }
+		NodeType *operator->() const { return deref(); }
+
+		bool operator==(const IteratorImpl &iter) const { return _idx == iter._idx && _hashmap == iter._hashmap; }
+		bool operator!=(const IteratorImpl &iter) const { return !(*this == iter); }
+
+		IteratorImpl &operator++() {
+			assert(_hashmap);
+			do {
+				_idx++;
+			} while (_idx <= _hashmap->_mask && !isFull(_hashmap->_ctrl[_idx]));
+			if (_idx > _hashmap->_mask)
+				_idx = NONE_FOUND;
+
+			return *this;
+		}
+
+		IteratorImpl operator++(int) {
+			IteratorImpl old = *this;
+			operator ++();
+			return old;
+		}
+	};
+
+public:
+	typedef IteratorImpl<Node> iterator;
+	typedef IteratorImpl<const Node> const_iterator;
+
+	FlatHashMap();
+	FlatHashMap(const HM_t &map);
+	~FlatHashMap();
+
+	HM_t &operator=(const HM_t &map) {
+		if (this == &map)
+			return *this;
+
+		// Remove the previous content and ...
+		freeStorage();
+		// ... copy the new stuff.
+		assign(map);
+		return *this;
+	}
+
+	bool contains(const Key &key) const;
+
+	Val &operator[](const Key &key);
+	const Val &operator[](const Key &key) const;
+
+	Val &getVal(const Key &key);
+	const Val &getVal(const Key &key) const;
+	const Val &getVal(const Key &key, const Val &defaultVal) const;
+	void setVal(const Key &key, const Val &val);
+
+	void clear(bool shrinkArray = 0);
+
+	void erase(iterator entry);
+	void erase(const Key &key);
+
+	size_type size() const { return _size; }
+
+	iterator	begin() {
+		// Find and return the first non-empty entry
+		for (size_type ctr = 0; ctr <= _mask; ++ctr) {
+			if (isFull(_ctrl[ctr]))
+				return iterator(ctr, this);
+		}
+		return end();
+	}
+	iterator	end() {
+		return iterator(NONE_FOUND, this);
+	}
+
+	const_iterator	begin() const {
+		// Find and return the first non-empty entry
+		for (size_type ctr = 0; ctr <= _mask; ++ctr) {
+			if (isFull(_ctrl[ctr]))
+				return const_iterator(ctr, this);
+		}
+		return end();
+	}
+	const_iterator	end() const {
+		return const_iterator(NONE_FOUND, this);
+	}
+
+	iterator	find(const Key &key) {
+		return iterator(lookup(key), this);
+	}
+
+	const_iterator	find(const Key &key) const {
+		return const_iterator(lookup(key), this);
+	}
+
+	bool empty() const {
+		return (_size == 0);
+	}
+};
+
+//-------------------------------------------------------
+// FlatHashMap functions
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+FlatHashMap<Key, Val, HashFunc, EqualFunc>::FlatHashMap() : _defaultVal() {
+	allocStorage(FLATHASHMAP_MIN_CAPACITY);
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+FlatHashMap<Key, Val, HashFunc, EqualFunc>::FlatHashMap(const HM_t &map) : _defaultVal() {
+	assign(map);
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+FlatHashMap<Key, Val, HashFunc, EqualFunc>::~FlatHashMap() {
+	freeStorage();
+}
+
+/**
+ * Internal method for allocating empty storage of the given capacity,
+ * which must be a power of two. Any previous storage must have been
+ * freed already.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::allocStorage(size_type capacity) {
+	_mask = capacity - 1;
+	_shift = 32;
+	for (size_type c = capacity; c > 1; c >>= 1)
+		_shift--;
+
+	_slots = (Slot *)malloc(capacity * sizeof(Slot));
+	assert(_slots != NULL);
+	_ctrl = new byte[capacity + kGroupWidth - 1];
+	memset(_ctrl, kCtrlEmpty, capacity + kGroupWidth - 1);
+
+	_size = 0;
+	_deleted = 0;
+}
+
+/**
+ * Internal method for destroying all elements and freeing the storage.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::freeStorage() {
+	for (size_type ctr = 0; ctr <= _mask; ++ctr) {
+		if (isFull(_ctrl[ctr]))
+			_slots[ctr].~Slot();
+	}
+
+	free(_slots);
+	delete[] _ctrl;
+}
+
+/**
+ * Internal method for assigning the content of another FlatHashMap
+ * to this one.
+ *
+ * @note We do *not* deallocate the previous storage here -- the caller is
+ *       responsible for doing that!
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::assign(const HM_t &map) {
+	allocStorage(map._mask + 1);
+
+	// Keep the exact layout, including deleted slots, so that no hash has
+	// to be computed again.
+	memcpy(_ctrl, map._ctrl, _mask + kGroupWidth);
+	for (size_type ctr = 0; ctr <= _mask; ++ctr) {
+		if (isFull(_ctrl[ctr]))
+			new (&_slots[ctr]) Slot(map._slots[ctr]);
+	}
+	_size = map._size;
+	_deleted = map._deleted;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::clear(bool shrinkArray) {
+	if (shrinkArray && _mask + 1 > FLATHASHMAP_MIN_CAPACITY) {
+		freeStorage();
+		allocStorage(FLATHASHMAP_MIN_CAPACITY);
+		return;
+	}
+
+	for (size_type ctr = 0; ctr <= _mask; ++ctr) {
+		if (isFull(_ctrl[ctr]))
+			_slots[ctr].~Slot();
+	}
+	memset(_ctrl, kCtrlEmpty, _mask + kGroupWidth);
+
+	_size = 0;
+	_deleted = 0;
+}
+
+/**
+ * Internal method for finding the first slot a new element with the given
+ * hash may be stored in.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+typename FlatHashMap<Key, Val, HashFunc, EqualFunc>::size_type FlatHashMap<Key, Val, HashFunc, EqualFunc>::findFreeSlot(size_type hash) const {
+	for (size_type pos = mixHash(hash) >> _shift; ; pos = (pos + kGroupWidth) & _mask) {
+		const uint64 free = matchEmptyOrDeleted(loadGroup(pos));
+		if (free)
+			return (pos + firstMatch(free)) & _mask;
+	}
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::rehash(size_type newCapacity) {
+	assert(newCapacity > _size);
+
+#ifndef NDEBUG
+	const size_type old_size = _size;
+#endif
+	const size_type old_mask = _mask;
+	Slot *old_slots = _slots;
+	byte *old_ctrl = _ctrl;
+
+	allocStorage(newCapacity);
+
+	// Reinsert all the old elements. Since we know that no key exists twice
+	// in the old table, and the hashes are cached, this neither needs to
+	// call _hash() nor _equal().
+	for (size_type ctr = 0; ctr <= old_mask; ++ctr) {
+		if (!isFull(old_ctrl[ctr]))
+			continue;
+
+		const size_type idx = findFreeSlot(old_slots[ctr]._hash);
+		new (&_slots[idx]) Slot(old_slots[ctr]);
+		setCtrl(idx, old_ctrl[ctr]);
+		_size++;
+
+		old_slots[ctr].~Slot();
+	}
+
+	// Perform a sanity check: Old number of elements should match the new one!
+	// This check will fail if some previous operation corrupted this hashmap.
+	assert(_size == old_size);
+
+	free(old_slots);
+	delete[] old_ctrl;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+typename FlatHashMap<Key, Val, HashFunc, EqualFunc>::size_type FlatHashMap<Key, Val, HashFunc, EqualFunc>::lookup(const Key &key) const {
+	const size_type hash = _hash(key);
+	const uint32 mixed = mixHash(hash);
+	const byte tag = mixed & 0x7F;
+
+	// There is always at least one empty slot, which ends the search
+	for (size_type pos = mixed >> _shift; ; pos = (pos + kGroupWidth) & _mask) {
+		const uint64 group = loadGroup(pos);
+		for (uint64 match = matchTag(group, tag); match; match &= match - 1) {
+			const size_type ctr = (pos + firstMatch(match)) & _mask;
+			if (_slots[ctr]._hash == hash && _equal(_slots[ctr]._node._key, key))
+				return ctr;
+		}
+		if (matchEmpty(group))
+			return NONE_FOUND;
+	}
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+typename FlatHashMap<Key, Val, HashFunc, EqualFunc>::size_type FlatHashMap<Key, Val, HashFunc, EqualFunc>::lookupAndCreateIfMissing(const Key &key) {
+	const size_type hash = _hash(key);
+	const uint32 mixed = mixHash(hash);
+	const byte tag = mixed & 0x7F;
+
+	size_type ctr = NONE_FOUND;
+	for (size_type pos = mixed >> _shift; ; pos = (pos + kGroupWidth) & _mask) {
+		const uint64 group = loadGroup(pos);
+		for (uint64 match = matchTag(group, tag); match; match &= match - 1) {
+			const size_type idx = (pos + firstMatch(match)) & _mask;
+			if (_slots[idx]._hash == hash && _equal(_slots[idx]._node._key, key))
+				return idx;
+		}
+
+		// Remember the first slot the key may be stored in
+		const uint64 free = matchEmptyOrDeleted(group);
+		if (ctr == NONE_FOUND && free)
+			ctr = (pos + firstMatch(free)) & _mask;
+
+		if (matchEmpty(group))
+			break;
+	}
+
+	if (_ctrl[ctr] == kCtrlDeleted) {
+		// Reusing a deleted slot does not change the load
+		_deleted--;
+	} else if ((_size + _deleted + 1) * FLATHASHMAP_LOADFACTOR_DENOMINATOR > (_mask + 1) * FLATHASHMAP_LOADFACTOR_NUMERATOR) {
+		// Keep the load factor below a certain threshold. Deleted slots
+		// are counted too, and dropped while rebuilding the storage, which
+		// may already be enough to make room.
+		size_type capacity = _mask + 1;
+		if ((_size + 1) * FLATHASHMAP_LOADFACTOR_DENOMINATOR * 2 > capacity * FLATHASHMAP_LOADFACTOR_NUMERATOR)
+			capacity *= 2;
+		rehash(capacity);
+		ctr = findFreeSlot(hash);
+	}
+
+	new (&_slots[ctr]) Slot(key, hash);
+	setCtrl(ctr, tag);
+	_size++;
+
+	return ctr;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+bool FlatHashMap<Key, Val, HashFunc, EqualFunc>::contains(const Key &key) const {
+	return lookup(key) != NONE_FOUND;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::operator[](const Key &key) {
+	return getVal(key);
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::operator[](const Key &key) const {
+	return getVal(key);
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getVal(const Key &key) {
+	size_type ctr = lookupAndCreateIfMissing(key);
+	return _slots[ctr]._node._value;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getVal(const Key &key) const {
+	return getVal(key, _defaultVal);
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getVal(const Key &key, const Val &defaultVal) const {
+	size_type ctr = lookup(key);
+	if (ctr != NONE_FOUND)
+		return _slots[ctr]._node._value;
+	else
+		return defaultVal;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::setVal(const Key &key, const Val &val) {
+	size_type ctr = lookupAndCreateIfMissing(key);
+	_slots[ctr]._node._value = val;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::erase(iterator entry) {
+	// Check whether we have a valid iterator
+	assert(entry._hashmap == this);
+	const size_type ctr = entry._idx;
+	assert(ctr <= _mask);
+	assert(isFull(_ctrl[ctr]));
+
+	_slots[ctr].~Slot();
+	_size--;
+
+	// Count the used slots around this one. If together they are fewer
+	// than a group, every group covering this slot also contains an empty
+	// one. No lookup ever went past such a group, so this slot may become
+	// empty instead of deleted.
+	size_type before = 0, after = 0;
+	while (before < kGroupWidth && _ctrl[(ctr - before - 1) & _mask] != kCtrlEmpty)
+		before++;
+	while (after < kGroupWidth && _ctrl[(ctr + after + 1) & _mask] != kCtrlEmpty)
+		after++;
+
+	if (before + after < kGroupWidth - 1) {
+		setCtrl(ctr, kCtrlEmpty);
+	} else {
+		setCtrl(ctr, kCtrlDeleted);
+		_deleted++;
+	}
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::erase(const Key &key) {
+	size_type ctr = lookup(key);
+	if (ctr == NONE_FOUND)
+		return;
+
+	erase(iterator(ctr, this));
+}
+
+} // End of namespace Common
+
+#endif
@@ -140,6 +140,21 @@ SeekableReadStream *FSNode::createReadStream() const {
 	return _realNode->createReadStream();
 }
 
+SeekableReadStream *FSNode::createGameDataReadStream() const {
+	if (_realNode == 0)
+		return 0;
+
+	if (!_realNode->exists()) {
+		warning("FSNode::createGameDataReadStream: '%s' does not exist", getName().c_str());
+		return 0;
+	} else if (_realNode->isDirectory()) {
+		warning("FSNode::createGameDataReadStream: '%s' is a directory", getName().c_str());
+		return 0;
+	}
+
+	return _realNode->createGameDataReadStream();
+}
+
 WriteStream *FSNode::createWriteStream() const {
 	if (_realNode == 0)
 		return 0;
@@ -230,7 +245,8 @@ SeekableReadStream *FSDirectory::createReadStreamForMember(const String &name) c
 	FSNode *node = lookupCache(_fileCache, name);
 	if (!node)
 		return 0;
-	SeekableReadStream *stream = node->createReadStream();
+	// The search paths hold the game data, which is only ever read
+	SeekableReadStream *stream = node->createGameDataReadStream();
 	if (!stream)
 		warning("FSDirectory::createReadStreamForMember: Can't create stream for file '%s'", name.c_str());
 
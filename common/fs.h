@@ -222,6 +222,17 @@ public:
 	 */
 	virtual SeekableReadStream *createReadStream() const;
 
+	/**
+	 * Creates a SeekableReadStream instance for a file which is only read
+	 * while it is open, like the data files of a game. The file may be
+	 * mapped into memory instead of being read, so it must not be written
+	 * to or truncated while the stream exists. Savefiles and other files
+	 * which may change have to use createReadStream() instead.
+	 *
+	 * @return pointer to the stream object, 0 in case of a failure
+	 */
+	SeekableReadStream *createGameDataReadStream() const;
+
 	/**
 	 * Creates a WriteStream instance corresponding to the file
 	 * referred by this node. This assumes that the node actually refers
@@ -4,6 +4,7 @@ MODULE_OBJS := \
 	archive.o \
 	config-manager.o \
 	coroutines.o \
+	cpudetect.o \
 	dcl.o \
 	debug.o \
 	error.o \
@@ -31,6 +32,7 @@ MODULE_OBJS := \
 	stream.o \
 	system.o \
 	textconsole.o \
+	thread.o \
 	tokenizer.o \
 	translation.o \
 	unarj.o \
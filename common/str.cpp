@@ -30,6 +30,21 @@ namespace Common {
 
 MemoryPool *g_refCountPool = 0; // FIXME: This is never freed right now
 
+static String::AllocationHook s_allocationHook = 0;
+
+void String::setAllocationHook(AllocationHook hook) {
+	s_allocationHook = hook;
+}
+
+char *String::allocStorage(uint32 capacity) {
+	if (s_allocationHook)
+		(*s_allocationHook)(capacity);
+
+	char *storage = new char[capacity];
+	assert(storage != 0);
+	return storage;
+}
+
 static uint32 computeCapacity(uint32 len) {
 	// By default, for the capacity we use the next multiple of 32
 	return ((len + 32 - 1) & ~0x1F);
@@ -65,8 +80,7 @@ void String::initWithCStr(const char *str, uint32 len) {
 		// Not enough internal storage, so allocate more
 		_extern._capacity = computeCapacity(len+1);
 		_extern._refCount = 0;
-		_str = new char[_extern._capacity];
-		assert(_str != 0);
+		_str = allocStorage(_extern._capacity);
 	}
 
 	// Copy the string into the storage area
@@ -90,6 +104,33 @@ String::String(const String &str)
 	assert(_str != 0);
 }
 
+#if __cplusplus >= 201103L
+String::String(String &&str)
+    : _size(0), _str(_storage) {
+	takeStorage(str);
+}
+
+/**
+ * Take over the storage of another string and leave that one empty. Any
+ * storage of this string must have been released already.
+ */
+void String::takeStorage(String &str) {
+	_size = str._size;
+	if (str.isStorageIntern()) {
+		memcpy(_storage, str._storage, _size + 1);
+		_str = _storage;
+	} else {
+		_extern._refCount = str._extern._refCount;
+		_extern._capacity = str._extern._capacity;
+		_str = str._str;
+		str._str = str._storage;
+	}
+
+	str._size = 0;
+	str._storage[0] = 0;
+}
+#endif
+
 String::String(char c)
     : _size(0), _str(_storage) {
 
@@ -147,8 +188,7 @@ void String::ensureCapacity(uint32 new_size, bool keep_old) {
 			newCapacity = MAX(curCapacity * 2, computeCapacity(new_size+1));
 
 		// Allocate new storage
-		newStorage = new char[newCapacity];
-		assert(newStorage);
+		newStorage = allocStorage(newCapacity);
 	}
 
 	// Copy old data if needed, elsewise reset the new storage.
@@ -242,6 +282,17 @@ String &String::operator=(const String &str) {
 	return *this;
 }
 
+#if __cplusplus >= 201103L
+String &String::operator=(String &&str) {
+	if (&str == this)
+		return *this;
+
+	decRefCount(_extern._refCount);
+	takeStorage(str);
+	return *this;
+}
+#endif
+
 String &String::operator=(char c) {
 	decRefCount(_extern._refCount);
 	_str = _storage;
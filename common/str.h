@@ -27,6 +27,24 @@
 
 #include <stdarg.h>
 
+/**
+ * @def SCUMMVM_STRING_SIZE
+ * Size of the length, the string pointer and the inline storage of a
+ * String in bytes. Whatever is left after the length and the pointer is
+ * used for storing short strings inline. Ports with plenty of memory may
+ * raise this, e.g. by adding -DSCUMMVM_STRING_SIZE=64 to the DEFINES, to
+ * avoid heap allocations for longer strings; ports with little stack space
+ * may lower it.
+ *
+ * A String object may be larger than this: the inline storage is shared
+ * with the reference count pointer and capacity of heap strings, and the
+ * members are aligned. With 64 bit pointers, a String takes 40 bytes by
+ * default and no less than 32, whatever the value.
+ */
+#ifndef SCUMMVM_STRING_SIZE
+#define SCUMMVM_STRING_SIZE 32
+#endif
+
 namespace Common {
 
 /**
@@ -46,6 +64,22 @@ namespace Common {
 class String {
 public:
 	static const uint32 npos = 0xFFFFFFFF;
+
+	/**
+	 * Function called whenever a String allocates storage on the heap.
+	 *
+	 * @param bytes	size of the allocated block
+	 */
+	typedef void (*AllocationHook)(uint32 bytes);
+
+	/**
+	 * Install a function to be called on each heap allocation done by any
+	 * String, e.g. for collecting statistics in a debugger. The hook is
+	 * called from whichever thread allocates, so it has to be thread safe.
+	 * Pass 0 to remove it again.
+	 */
+	static void setAllocationHook(AllocationHook hook);
+
 protected:
 	/**
 	 * The size of the internal storage. Increasing this means less heap
@@ -57,8 +91,10 @@ protected:
 	 * while 16 seems to be the lowest you want to go... Anything lower
 	 * than 8 makes no sense, since that's the size of member _extern
 	 * (on 32 bit machines; 12 bytes on systems with 64bit pointers).
+	 *
+	 * The value is derived from SCUMMVM_STRING_SIZE, see above.
 	 */
-	static const uint32 _builtinCapacity = 32 - sizeof(uint32) - sizeof(char *);
+	static const uint32 _builtinCapacity = SCUMMVM_STRING_SIZE - sizeof(uint32) - sizeof(char *);
 
 	/**
 	 * Length of the string. Stored to avoid having to call strlen
@@ -109,6 +145,15 @@ public:
 	/** Construct a copy of the given string. */
 	String(const String &str);
 
+#if __cplusplus >= 201103L
+	/**
+	 * Construct a string by taking over the storage of the given one, which
+	 * is left empty. Unlike copying, this never allocates or touches a
+	 * reference count.
+	 */
+	String(String &&str);
+#endif
+
 	/** Construct a string consisting of the given character. */
 	explicit String(char c);
 
@@ -116,6 +161,9 @@ public:
 
 	String &operator=(const char *str);
 	String &operator=(const String &str);
+#if __cplusplus >= 201103L
+	String &operator=(String &&str);
+#endif
 	String &operator=(char c);
 	String &operator+=(const char *str);
 	String &operator+=(const String &str);
@@ -276,6 +324,10 @@ protected:
 	void incRefCount() const;
 	void decRefCount(int *oldRefCount);
 	void initWithCStr(const char *str, uint32 len);
+#if __cplusplus >= 201103L
+	void takeStorage(String &str);
+#endif
+	static char *allocStorage(uint32 capacity);
 };
 
 // Append two strings to form a new (temp) string
@@ -240,6 +240,11 @@ bool SeekableSubReadStream::seek(int32 offset, int whence) {
 	return ret;
 }
 
+const byte *SeekableSubReadStream::getDataPointer() const {
+	const byte *data = _parentStream->getDataPointer();
+	return data ? data + _begin : 0;
+}
+
 uint32 SafeSeekableSubReadStream::read(void *dataPtr, uint32 dataSize) {
 	// Make sure the parent stream is at the right position
 	seek(0, SEEK_CUR);
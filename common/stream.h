@@ -453,6 +453,17 @@ public:
 	 */
 	virtual bool skip(uint32 offset) { return seek(offset, SEEK_CUR); }
 
+	/**
+	 * Gives access to the whole contents of the stream without copying
+	 * them, if the stream has them in memory, e.g. because it wraps a
+	 * memory buffer or a file mapped into memory. The data stays valid as
+	 * long as the stream exists, and must not be modified. Callers need to
+	 * fall back to read() when this returns 0.
+	 *
+	 * @return a pointer to size() bytes, or 0 if they are not in memory
+	 */
+	virtual const byte *getDataPointer() const { return 0; }
+
 	/**
 	 * Reads at most one less than the number of characters specified
 	 * by bufSize from the and stores them in the string buf. Reading
@@ -0,0 +1,241 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#define FORBIDDEN_SYMBOL_ALLOW_ALL
+
+#include "common/thread.h"
+#include "common/textconsole.h"
+#include "common/util.h"
+
+#ifdef USE_PTHREADS
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+namespace Common {
+
+#ifdef USE_PTHREADS
+
+bool hasThreads() {
+	return true;
+}
+
+int getProcessorCount() {
+#ifdef _SC_NPROCESSORS_ONLN
+	const long count = sysconf(_SC_NPROCESSORS_ONLN);
+	if (count > 1)
+		return (int)count;
+#endif
+	return 1;
+}
+
+struct Semaphore::Impl {
+	pthread_mutex_t mutex;
+	pthread_cond_t cond;
+	int count;
+};
+
+Semaphore::Semaphore(int count) : _impl(new Impl) {
+	pthread_mutex_init(&_impl->mutex, 0);
+	pthread_cond_init(&_impl->cond, 0);
+	_impl->count = count;
+}
+
+Semaphore::~Semaphore() {
+	pthread_cond_destroy(&_impl->cond);
+	pthread_mutex_destroy(&_impl->mutex);
+	delete _impl;
+}
+
+void Semaphore::post() {
+	pthread_mutex_lock(&_impl->mutex);
+	_impl->count++;
+	pthread_cond_signal(&_impl->cond);
+	pthread_mutex_unlock(&_impl->mutex);
+}
+
+void Semaphore::wait() {
+	pthread_mutex_lock(&_impl->mutex);
+	while (_impl->count <= 0)
+		pthread_cond_wait(&_impl->cond, &_impl->mutex);
+	_impl->count--;
+	pthread_mutex_unlock(&_impl->mutex);
+}
+
+struct Thread::Impl {
+	pthread_t thread;
+	Proc proc;
+	void *param;
+
+	static void *run(void *param) {
+		Impl *impl = (Impl *)param;
+		impl->proc(impl->param);
+		return 0;
+	}
+};
+
+bool Thread::start(Proc proc, void *param) {
+	assert(!_impl);
+
+	_impl = new Impl;
+	_impl->proc = proc;
+	_impl->param = param;
+	if (pthread_create(&_impl->thread, 0, Impl::run, _impl) != 0) {
+		warning("Could not create thread");
+		delete _impl;
+		_impl = 0;
+		return false;
+	}
+	return true;
+}
+
+void Thread::join() {
+	if (!_impl)
+		return;
+
+	pthread_join(_impl->thread, 0);
+	delete _impl;
+	_impl = 0;
+}
+
+#else
+
+bool hasThreads() {
+	return false;
+}
+
+int getProcessorCount() {
+	return 1;
+}
+
+// Without threads nobody could ever post while we wait, so the semaphore
+// degenerates to a counter.
+struct Semaphore::Impl {
+	int count;
+};
+
+Semaphore::Semaphore(int count) : _impl(new Impl) {
+	_impl->count = count;
+}
+
+Semaphore::~Semaphore() {
+	delete _impl;
+}
+
+void Semaphore::post() {
+	_impl->count++;
+}
+
+void Semaphore::wait() {
+	assert(_impl->count > 0);
+	_impl->count--;
+}
+
+struct Thread::Impl {
+};
+
+bool Thread::start(Proc proc, void *param) {
+	return false;
+}
+
+void Thread::join() {
+}
+
+#endif
+
+Thread::Thread() : _impl(0) {
+}
+
+Thread::~Thread() {
+	join();
+}
+
+
+WorkerPool::WorkerPool(int threads) : _threadCount(1), _threads(0), _quit(false),
+	_proc(0), _param(0), _count(0), _nextJob(0) {
+
+	if (threads <= 0)
+		threads = getProcessorCount();
+	if (threads <= 1 || !hasThreads())
+		return;
+
+	_threads = new Thread[threads - 1];
+	for (int i = 0; i < threads - 1; ++i) {
+		if (!_threads[i].start(workerProc, this))
+			break;
+		_threadCount++;
+	}
+}
+
+WorkerPool::~WorkerPool() {
+	_quit = true;
+	for (int i = 1; i < _threadCount; ++i)
+		_start.post();
+	delete[] _threads;
+}
+
+void WorkerPool::run(JobProc proc, void *param, int count) {
+	if (count <= 0)
+		return;
+
+	// Not worth waking up anybody for a single job
+	if (_threadCount == 1 || count == 1) {
+		for (int i = 0; i < count; ++i)
+			proc(param, i);
+		return;
+	}
+
+	_proc = proc;
+	_param = param;
+	_count = count;
+	atomicStore(&_nextJob, 0);
+
+	const int helpers = MIN(_threadCount, count) - 1;
+	for (int i = 0; i < helpers; ++i)
+		_start.post();
+
+	work();
+
+	for (int i = 0; i < helpers; ++i)
+		_done.wait();
+}
+
+void WorkerPool::workerProc(void *param) {
+	WorkerPool *pool = (WorkerPool *)param;
+
+	while (true) {
+		pool->_start.wait();
+		if (pool->_quit)
+			break;
+
+		pool->work();
+		pool->_done.post();
+	}
+}
+
+void WorkerPool::work() {
+	int job;
+	while ((job = atomicAdd(&_nextJob, 1) - 1) < _count)
+		_proc(_param, job);
+}
+
+} // End of namespace Common
@@ -0,0 +1,170 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef COMMON_THREAD_H
+#define COMMON_THREAD_H
+
+#include "common/scummsys.h"
+#include "common/atomic.h"
+#include "common/noncopyable.h"
+
+namespace Common {
+
+/**
+ * @defgroup thread Threads
+ *
+ * Minimal threading support for code which wants to spread work over
+ * several cores, like scalers and decoders. Threads are only available
+ * when the build was configured with POSIX threads (USE_PTHREADS). On all
+ * other platforms Thread::start() fails and WorkerPool runs every job on
+ * the calling thread, so callers always have to cope with that.
+ *
+ * Code running on these threads must not call into OSystem, unless the
+ * backend documents the method as thread safe.
+ * @{
+ */
+
+/**
+ * Check whether threads can be created in this build.
+ */
+bool hasThreads();
+
+/**
+ * Return the number of processors available to ScummVM, or 1 if this can
+ * not be determined or threads are not supported.
+ */
+int getProcessorCount();
+
+/**
+ * A counting semaphore, for handing work between threads.
+ */
+class Semaphore : NonCopyable {
+public:
+	explicit Semaphore(int count = 0);
+	~Semaphore();
+
+	/** Increment the count, waking up one waiting thread. */
+	void post();
+
+	/** Wait until the count is positive, then decrement it. */
+	void wait();
+
+private:
+	struct Impl;
+	Impl *_impl;
+};
+
+/**
+ * A single thread running a function.
+ */
+class Thread : NonCopyable {
+public:
+	typedef void (*Proc)(void *param);
+
+	Thread();
+
+	/** Waits for the thread to finish if it is still running. */
+	~Thread();
+
+	/**
+	 * Start running proc(param) on a new thread.
+	 *
+	 * @return false if the thread could not be created, e.g. because
+	 *         threads are not supported
+	 */
+	bool start(Proc proc, void *param);
+
+	/**
+	 * Wait for the thread function to return. Does nothing if the thread
+	 * was never started.
+	 */
+	void join();
+
+	/** Check whether the thread was started and not joined yet. */
+	bool isStarted() const { return _impl != 0; }
+
+private:
+	struct Impl;
+	Impl *_impl;
+};
+
+/**
+ * A fixed set of threads for running a number of independent jobs in
+ * parallel. The calling thread takes part in the work as well, so a pool
+ * with n threads creates n - 1 additional threads.
+ */
+class WorkerPool : NonCopyable {
+public:
+	/**
+	 * Function running one job.
+	 *
+	 * @param param	the parameter passed to run()
+	 * @param job	index of the job, from 0 to count - 1
+	 */
+	typedef void (*JobProc)(void *param, int job);
+
+	/**
+	 * Create a pool.
+	 *
+	 * @param threads	total number of threads working on the jobs, or 0 to
+	 *                  use one per processor
+	 */
+	explicit WorkerPool(int threads = 0);
+	~WorkerPool();
+
+	/**
+	 * Return the number of threads working on the jobs, including the
+	 * calling thread. This may be less than requested if threads could not
+	 * be created.
+	 */
+	int getThreadCount() const { return _threadCount; }
+
+	/**
+	 * Run proc(param, job) for all jobs from 0 to count - 1, and wait for
+	 * all of them to finish. Jobs are picked up in order, but may finish
+	 * in any order.
+	 *
+	 * Must only be called from one thread at a time.
+	 */
+	void run(JobProc proc, void *param, int count);
+
+private:
+	static void workerProc(void *param);
+	void work();
+
+	int _threadCount;
+	Thread *_threads;
+	Semaphore _start;
+	Semaphore _done;
+	bool _quit;
+
+	JobProc _proc;
+	void *_param;
+	int _count;
+	AtomicInt32 _nextJob;
+};
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
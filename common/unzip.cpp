@@ -106,6 +106,12 @@ typedef struct {
 #include "common/fs.h"
 #include "common/unzip.h"
 #include "common/memstream.h"
+#include "common/mutex.h"
+#include "common/ptr.h"
+#include "common/substream.h"
+#include "common/array.h"
+#include "common/textconsole.h"
+#include "common/zlib.h"
 
 #include "common/hashmap.h"
 #include "common/hash-str.h"
@@ -1419,14 +1425,116 @@ int unzGetGlobalComment(unzFile file, char *szComment, uLong uSizeBuf) {
 
 namespace Common {
 
+namespace {
 
+struct ZipBufferDeleter {
+	void operator()(byte *buffer) { delete[] buffer; }
+};
+
+/**
+ * A member of a ZIP archive which is in memory as a whole, either in a
+ * buffer shared with the cache of the archive, or as part of the archive
+ * itself. The stream keeps the memory alive, even after the archive has
+ * been closed.
+ */
+class ZipMemoryReadStream : public MemoryReadStream {
+	SharedPtr<byte> _buffer;
+	SharedPtr<SeekableReadStream> _archive;
+
+public:
+	ZipMemoryReadStream(const byte *data, uint32 size, const SharedPtr<byte> &buffer, const SharedPtr<SeekableReadStream> &archive)
+		: MemoryReadStream(data, size), _buffer(buffer), _archive(archive) {
+	}
+};
+
+/**
+ * A member of a ZIP archive which is read from the archive stream as it is
+ * needed. The archive stream is shared by all members and may be read from
+ * several threads, e.g. by the mixer, so every access to it is done under
+ * the mutex of the archive. The stream keeps the archive stream alive, even
+ * after the archive has been closed.
+ */
+class ZipSubReadStream : public SafeSeekableSubReadStream {
+	SharedPtr<SeekableReadStream> _archive;
+	SharedPtr<Mutex> _mutex;
+
+public:
+	/** Must be called with the mutex locked, as it seeks the archive stream */
+	ZipSubReadStream(const SharedPtr<SeekableReadStream> &archive, const SharedPtr<Mutex> &mutex, uint32 begin, uint32 end)
+		: SafeSeekableSubReadStream(archive.get(), begin, end), _archive(archive), _mutex(mutex) {
+	}
+
+	virtual bool eos() const { return _eos; }
+
+	virtual bool seek(int32 offset, int whence = SEEK_SET) {
+		StackLock lock(*_mutex);
+		return SafeSeekableSubReadStream::seek(offset, whence);
+	}
+
+	virtual uint32 read(void *dataPtr, uint32 dataSize) {
+		StackLock lock(*_mutex);
+		const uint32 wanted = MIN(dataSize, _end - _pos);
+		const uint32 actual = SafeSeekableSubReadStream::read(dataPtr, dataSize);
+		if (actual < wanted)
+			_eos = true;
+		return actual;
+	}
+};
+
+} // End of anonymous namespace
+
+/**
+ * The archive keeps an index of the central directory, so that looking up
+ * a member takes a single hash lookup. Small members are decompressed into
+ * a buffer which is kept in a size-bounded cache, since games tend to open
+ * the same small files again and again. Large members are streamed from the
+ * archive and decompressed while they are read. Members are used in place
+ * when the archive is in memory, e.g. because the file is mapped.
+ *
+ * Member streams may be read from other threads than the one opening
+ * members, so the archive stream is only accessed under _mutex.
+ */
 class ZipArchive : public Archive {
-	unzFile _zipFile;
+	struct Entry {
+		String name;
+		uint32 headerOffset;	///< Offset of the local header in the stream
+		uint32 dataOffset;		///< Offset of the data, or 0 if not known yet
+		uint32 compressedSize;
+		uint32 uncompressedSize;
+		uint32 crc;
+		uint16 method;
+
+		SharedPtr<byte> cached;	///< The decompressed data, if it is in the cache
+		int cachePrev;			///< Links of the cache LRU list, or -1
+		int cacheNext;
+	};
+
+	typedef HashMap<String, uint, IgnoreCase_Hash, IgnoreCase_EqualTo> EntryIndex;
+
+	enum {
+		/** Members larger than this are decompressed while they are read */
+		kStreamThreshold = 256 * 1024,
+		/** Amount of decompressed members to keep in memory */
+		kCacheSize = 2 * 1024 * 1024
+	};
+
+	SharedPtr<SeekableReadStream> _stream;
+	SharedPtr<Mutex> _mutex;	///< Guards _stream, shared with the member streams
+	mutable Array<Entry> _entries;
+	EntryIndex _index;
+
+	mutable int _cacheFirst;	///< Most recently used member in the cache
+	mutable int _cacheLast;
+	mutable uint32 _cacheMemory;
+
+	bool findDataOffset(Entry &entry) const;
+	SharedPtr<byte> readMember(Entry &entry) const;
+	void linkCached(int index) const;
+	void unlinkCached(int index) const;
 
 public:
 	ZipArchive(unzFile zipFile);
 
-
 	~ZipArchive();
 
 	virtual bool hasFile(const String &name) const;
@@ -1435,47 +1543,47 @@ public:
 	virtual SeekableReadStream *createReadStreamForMember(const String &name) const;
 };
 
-/*
-class ZipArchiveMember : public ArchiveMember {
-	unzFile _zipFile;
-
-public:
-	ZipArchiveMember(FSNode &node) : _node(node) {
-	}
-
-	String getName() const {
-		...
-	}
-
-	SeekableReadStream *open() {
-		...
+ZipArchive::ZipArchive(unzFile zipFile) : _cacheFirst(-1), _cacheLast(-1), _cacheMemory(0) {
+	assert(zipFile);
+	unz_s *archive = (unz_s *)zipFile;
+
+	_entries.reserve(archive->_hash.size());
+	for (ZipHash::const_iterator i = archive->_hash.begin(); i != archive->_hash.end(); ++i) {
+		const cached_file_in_zip &fe = i->_value;
+
+		Entry entry;
+		entry.name = i->_key;
+		entry.headerOffset = fe.cur_file_info_internal.offset_curfile + archive->byte_before_the_zipfile;
+		entry.dataOffset = 0;
+		entry.compressedSize = fe.cur_file_info.compressed_size;
+		entry.uncompressedSize = fe.cur_file_info.uncompressed_size;
+		entry.crc = fe.cur_file_info.crc;
+		entry.method = fe.cur_file_info.compression_method;
+		entry.cachePrev = entry.cacheNext = -1;
+
+		_index[entry.name] = _entries.size();
+		_entries.push_back(entry);
 	}
-};
-*/
 
-ZipArchive::ZipArchive(unzFile zipFile) : _zipFile(zipFile) {
-	assert(_zipFile);
+	// The index replaces the directory of minizip, only the stream is kept
+	_stream = SharedPtr<SeekableReadStream>(archive->_stream);
+	_mutex = SharedPtr<Mutex>(new Mutex());
+	archive->_stream = 0;
+	unzClose(zipFile);
 }
 
 ZipArchive::~ZipArchive() {
-	unzClose(_zipFile);
 }
 
 bool ZipArchive::hasFile(const String &name) const {
-	return (unzLocateFile(_zipFile, name.c_str(), 2) == UNZ_OK);
+	return _index.contains(name);
 }
 
 int ZipArchive::listMembers(ArchiveMemberList &list) const {
-	int members = 0;
-
-	const unz_s *const archive = (const unz_s *)_zipFile;
-	for (ZipHash::const_iterator i = archive->_hash.begin(), end = archive->_hash.end();
-	     i != end; ++i) {
-		list.push_back(ArchiveMemberList::value_type(new GenericArchiveMember(i->_key, this)));
-		++members;
-	}
+	for (uint i = 0; i < _entries.size(); ++i)
+		list.push_back(ArchiveMemberList::value_type(new GenericArchiveMember(_entries[i].name, this)));
 
-	return members;
+	return _entries.size();
 }
 
 const ArchiveMemberPtr ZipArchive::getMember(const String &name) const {
@@ -1485,36 +1593,145 @@ const ArchiveMemberPtr ZipArchive::getMember(const String &name) const {
 	return ArchiveMemberPtr(new GenericArchiveMember(name, this));
 }
 
+bool ZipArchive::findDataOffset(Entry &entry) const {
+	if (entry.dataOffset)
+		return true;
+
+	// The data follows the local header, whose name and extra field may
+	// differ in size from the ones in the central directory
+	_stream->seek(entry.headerOffset, SEEK_SET);
+	if (_stream->readUint32LE() != 0x04034b50)
+		return false;
+	_stream->skip(22);
+	const uint16 nameSize = _stream->readUint16LE();
+	const uint16 extraSize = _stream->readUint16LE();
+	if (_stream->err() || _stream->eos())
+		return false;
+
+	entry.dataOffset = entry.headerOffset + SIZEZIPLOCALHEADER + nameSize + extraSize;
+	return true;
+}
+
+SharedPtr<byte> ZipArchive::readMember(Entry &entry) const {
+	byte *buffer = new byte[entry.uncompressedSize];
+	SharedPtr<byte> member(buffer, ZipBufferDeleter());
+
+	const byte *archiveData = _stream->getDataPointer();
+	if (entry.method == 0) {
+		_stream->seek(entry.dataOffset, SEEK_SET);
+		if (_stream->read(buffer, entry.uncompressedSize) != entry.uncompressedSize)
+			return SharedPtr<byte>();
+	} else {
+#ifdef USE_ZLIB
+		// Inflate straight from the archive if it is in memory
+		const byte *compressed = archiveData ? archiveData + entry.dataOffset : 0;
+		byte *compressedBuffer = 0;
+		if (!compressed) {
+			compressedBuffer = new byte[entry.compressedSize];
+			_stream->seek(entry.dataOffset, SEEK_SET);
+			if (_stream->read(compressedBuffer, entry.compressedSize) != entry.compressedSize) {
+				delete[] compressedBuffer;
+				return SharedPtr<byte>();
+			}
+			compressed = compressedBuffer;
+		}
+
+		const bool success = inflateZlibHeaderless(buffer, entry.uncompressedSize, compressed, entry.compressedSize);
+		delete[] compressedBuffer;
+		if (!success)
+			return SharedPtr<byte>();
+#else
+		return SharedPtr<byte>();
+#endif
+	}
+
+#ifdef USE_ZLIB
+	if (crc32(0, buffer, entry.uncompressedSize) != entry.crc) {
+		warning("ZipArchive: CRC error in '%s'", entry.name.c_str());
+		return SharedPtr<byte>();
+	}
+#endif
+
+	return member;
+}
+
+void ZipArchive::linkCached(int index) const {
+	Entry &entry = _entries[index];
+	entry.cachePrev = -1;
+	entry.cacheNext = _cacheFirst;
+	if (_cacheFirst != -1)
+		_entries[_cacheFirst].cachePrev = index;
+	else
+		_cacheLast = index;
+	_cacheFirst = index;
+}
+
+void ZipArchive::unlinkCached(int index) const {
+	Entry &entry = _entries[index];
+	if (entry.cachePrev != -1)
+		_entries[entry.cachePrev].cacheNext = entry.cacheNext;
+	else
+		_cacheFirst = entry.cacheNext;
+	if (entry.cacheNext != -1)
+		_entries[entry.cacheNext].cachePrev = entry.cachePrev;
+	else
+		_cacheLast = entry.cachePrev;
+	entry.cachePrev = entry.cacheNext = -1;
+}
+
 SeekableReadStream *ZipArchive::createReadStreamForMember(const String &name) const {
-	if (unzLocateFile(_zipFile, name.c_str(), 2) != UNZ_OK)
+	EntryIndex::const_iterator i = _index.find(name);
+	if (i == _index.end())
 		return 0;
 
-	unz_file_info fileInfo;
-	if (unzOpenCurrentFile(_zipFile) != UNZ_OK)
-		return 0;
+	const int index = i->_value;
+	Entry &entry = _entries[index];
 
-	if (unzGetCurrentFileInfo(_zipFile, &fileInfo, NULL, 0, NULL, 0, NULL, 0) != UNZ_OK)
+	if (entry.method != 0 && entry.method != Z_DEFLATED)
 		return 0;
 
-	byte *buffer = (byte *)malloc(fileInfo.uncompressed_size);
-	assert(buffer);
+	StackLock lock(*_mutex);
 
-	if (unzReadCurrentFile(_zipFile, buffer, fileInfo.uncompressed_size) != (int)fileInfo.uncompressed_size) {
-		free(buffer);
+	if (!findDataOffset(entry))
 		return 0;
+
+	const byte *archiveData = _stream->getDataPointer();
+	if (entry.method == 0 && archiveData)
+		return new ZipMemoryReadStream(archiveData + entry.dataOffset, entry.uncompressedSize, SharedPtr<byte>(), _stream);
+
+	if (entry.uncompressedSize > kStreamThreshold) {
+		SeekableReadStream *data;
+		if (archiveData)
+			data = new ZipMemoryReadStream(archiveData + entry.dataOffset, entry.compressedSize, SharedPtr<byte>(), _stream);
+		else
+			data = new ZipSubReadStream(_stream, _mutex, entry.dataOffset, entry.dataOffset + entry.compressedSize);
+
+		if (entry.method == 0)
+			return data;
+		return wrapDeflateReadStream(data, entry.uncompressedSize);
 	}
 
-	if (unzCloseCurrentFile(_zipFile) != UNZ_OK) {
-		free(buffer);
-		return 0;
+	if (entry.cached) {
+		unlinkCached(index);
+	} else {
+		entry.cached = readMember(entry);
+		if (!entry.cached)
+			return 0;
+		_cacheMemory += entry.uncompressedSize;
 	}
+	linkCached(index);
 
-	return new MemoryReadStream(buffer, fileInfo.uncompressed_size, DisposeAfterUse::YES);
+	SeekableReadStream *stream = new ZipMemoryReadStream(entry.cached.get(), entry.uncompressedSize, entry.cached, SharedPtr<SeekableReadStream>());
+
+	// Streams keep their members alive, the cache merely lets go of them
+	while (_cacheMemory > kCacheSize && _cacheLast != index) {
+		Entry &goner = _entries[_cacheLast];
+		_cacheMemory -= goner.uncompressedSize;
+		goner.cached.reset();
+		unlinkCached(_cacheLast);
+	}
 
-	// FIXME: instead of reading all into a memory stream, we could
-	// instead create a new ZipStream class. But then we have to be
-	// careful to handle the case where the client code opens multiple
-	// files in the archive and tries to use them independently.
+	return stream;
 }
 
 Archive *makeZipArchive(const String &name) {
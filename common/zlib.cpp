@@ -51,6 +51,14 @@ bool uncompress(byte *dst, unsigned long *dstLen, const byte *src, unsigned long
 	return Z_OK == ::uncompress(dst, dstLen, src, srcLen);
 }
 
+bool compress(byte *dst, unsigned long *dstLen, const byte *src, unsigned long srcLen, int level) {
+	return Z_OK == ::compress2(dst, dstLen, src, srcLen, level);
+}
+
+unsigned long compressBound(unsigned long srcLen) {
+	return ::compressBound(srcLen);
+}
+
 bool inflateZlibHeaderless(byte *dst, uint dstLen, const byte *src, uint srcLen, const byte *dict, uint dictLen) {
 	if (!dst || !dstLen || !src || !srcLen)
 		return false;
@@ -148,7 +156,8 @@ static bool _shownBackwardSeekingWarning = false;
 /**
  * A simple wrapper class which can be used to wrap around an arbitrary
  * other SeekableReadStream and will then provide on-the-fly decompression support.
- * Assumes the compressed data to be in gzip format.
+ * Assumes the compressed data to be in gzip format, or to be raw deflate data
+ * of the known size.
  */
 class GZipReadStream : public SeekableReadStream {
 protected:
@@ -164,12 +173,26 @@ protected:
 	uint32 _pos;
 	uint32 _origSize;
 	bool _eos;
+	bool _raw;
 
 public:
 
-	GZipReadStream(SeekableReadStream *w, uint32 knownSize = 0) : _wrapped(w), _stream() {
+	GZipReadStream(SeekableReadStream *w, uint32 knownSize = 0, bool raw = false) : _wrapped(w), _stream(), _raw(raw) {
 		assert(w != 0);
 
+		if (raw) {
+			// There is neither a header nor a trailer
+			_origSize = knownSize;
+			_pos = 0;
+			w->seek(0, SEEK_SET);
+			_eos = false;
+
+			_zlibErr = inflateInit2(&_stream, -MAX_WBITS);
+			_stream.next_in = _buf;
+			_stream.avail_in = 0;
+			return;
+		}
+
 		// Verify file header is correct
 		w->seek(0, SEEK_SET);
 		uint16 header = w->readUint16BE();
@@ -214,6 +237,14 @@ public:
 	}
 
 	uint32 read(void *dataPtr, uint32 dataSize) {
+		// Raw data does not tell where it ends, before zlib has to look
+		// at the (possibly missing) bytes after it
+		bool atEnd = false;
+		if (_raw && dataSize >= _origSize - _pos) {
+			dataSize = _origSize - _pos;
+			atEnd = true;
+		}
+
 		_stream.next_out = (byte *)dataPtr;
 		_stream.avail_out = dataSize;
 
@@ -232,6 +263,8 @@ public:
 
 		if (_zlibErr == Z_STREAM_END && _stream.avail_out > 0)
 			_eos = true;
+		if (atEnd && _stream.avail_out == 0)
+			_eos = true;
 
 		return dataSize - _stream.avail_out;
 	}
@@ -428,6 +461,18 @@ SeekableReadStream *wrapCompressedReadStream(SeekableReadStream *toBeWrapped, ui
 	return toBeWrapped;
 }
 
+SeekableReadStream *wrapDeflateReadStream(SeekableReadStream *toBeWrapped, uint32 size) {
+	if (!toBeWrapped)
+		return 0;
+
+#if defined(USE_ZLIB)
+	return new GZipReadStream(toBeWrapped, size, true);
+#else
+	delete toBeWrapped;
+	return 0;
+#endif
+}
+
 WriteStream *wrapCompressedWriteStream(WriteStream *toBeWrapped) {
 #if defined(USE_ZLIB)
 	if (toBeWrapped)
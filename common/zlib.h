@@ -53,6 +53,30 @@ class WriteStream;
  */
 bool uncompress(byte *dst, unsigned long *dstLen, const byte *src, unsigned long srcLen);
 
+/**
+ * Thin wrapper around zlib's compress2() function, the counterpart of
+ * uncompress().
+ *
+ * Upon entry, dstLen is the total size of the destination buffer, which
+ * should be at least compressBound(srcLen) bytes. Upon exit, dstLen is the
+ * actual size of the compressed data.
+ *
+ * @param dst       the buffer to store into.
+ * @param dstLen    a pointer to the size of the destination buffer.
+ * @param src       the data to be compressed.
+ * @param srcLen    the size of the data.
+ * @param level     the compression level, from 1 (fastest) to 9 (smallest).
+ *
+ * @return true on success (i.e. Z_OK), false otherwise.
+ */
+bool compress(byte *dst, unsigned long *dstLen, const byte *src, unsigned long srcLen, int level);
+
+/**
+ * Return an upper bound on the size of the data compress() produces from
+ * srcLen bytes.
+ */
+unsigned long compressBound(unsigned long srcLen);
+
 /**
  * Wrapper around zlib's inflate functions. This function will call the
  * necessary inflate functions to uncompress data compressed with deflate
@@ -120,6 +144,17 @@ bool inflateZlibInstallShield(byte *dst, uint dstLen, const byte *src, uint srcL
  */
 SeekableReadStream *wrapCompressedReadStream(SeekableReadStream *toBeWrapped, uint32 knownSize = 0);
 
+/**
+ * Take a SeekableReadStream of raw deflate data, as found in ZIP archives,
+ * and wrap it in a custom stream which provides transparent on-the-fly
+ * decompression. Without ZLIB support, the stream is destroyed and NULL is
+ * returned.
+ *
+ * @param toBeWrapped	the stream to be wrapped
+ * @param size			the size of the decompressed data
+ */
+SeekableReadStream *wrapDeflateReadStream(SeekableReadStream *toBeWrapped, uint32 size);
+
 /**
  * Take an arbitrary WriteStream and wrap it in a custom stream which provides
  * transparent on-the-fly compression. The compressed data is written in the
@@ -112,6 +112,8 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	registerCmd("resource_id",		WRAP_METHOD(Console, cmdResourceId));
 	registerCmd("resource_info",		WRAP_METHOD(Console, cmdResourceInfo));
 	registerCmd("resource_types",		WRAP_METHOD(Console, cmdResourceTypes));
+	registerCmd("resource_cache",		WRAP_METHOD(Console, cmdResourceCache));
+	registerCmd("room_stats",			WRAP_METHOD(Console, cmdRoomStats));
 	registerCmd("list",				WRAP_METHOD(Console, cmdList));
 	registerCmd("hexgrep",			WRAP_METHOD(Console, cmdHexgrep));
 	registerCmd("verify_scripts",		WRAP_METHOD(Console, cmdVerifyScripts));
@@ -158,6 +160,7 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	registerCmd("gc_reachable",		WRAP_METHOD(Console, cmdGCShowReachable));
 	registerCmd("gc_freeable",		WRAP_METHOD(Console, cmdGCShowFreeable));
 	registerCmd("gc_normalize",		WRAP_METHOD(Console, cmdGCNormalize));
+	registerCmd("gc_stats",			WRAP_METHOD(Console, cmdGCStats));
 	// Music/SFX
 	registerCmd("songlib",			WRAP_METHOD(Console, cmdSongLib));
 	registerCmd("songinfo",			WRAP_METHOD(Console, cmdSongInfo));
@@ -225,6 +228,8 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	registerCmd("vm_vars",			WRAP_METHOD(Console, cmdVMVars));
 	registerCmd("vmvars",				WRAP_METHOD(Console, cmdVMVars));					// alias
 	registerCmd("vv",					WRAP_METHOD(Console, cmdVMVars));					// alias
+	registerCmd("vm_stats",			WRAP_METHOD(Console, cmdVMStats));
+	registerCmd("avoidpath_bench",	WRAP_METHOD(Console, cmdAvoidPathBench));
 	registerCmd("stack",				WRAP_METHOD(Console, cmdStack));
 	registerCmd("value_type",			WRAP_METHOD(Console, cmdValueType));
 	registerCmd("view_listnode",		WRAP_METHOD(Console, cmdViewListNode));
@@ -362,6 +367,8 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	debugPrintf(" resource_id - Identifies a resource number by splitting it up in resource type and resource number\n");
 	debugPrintf(" resource_info - Shows info about a resource\n");
 	debugPrintf(" resource_types - Shows the valid resource types\n");
+	debugPrintf(" resource_cache - Shows the memory use and hit rates of the resource cache\n");
+	debugPrintf(" room_stats - Shows how long room changes take\n");
 	debugPrintf(" list - Lists all the resources of a given type\n");
 	debugPrintf(" hexgrep - Searches some resources for a particular sequence of bytes, represented as hexadecimal numbers\n");
 	debugPrintf(" verify_scripts - Performs sanity checks on SCI1.1-SCI2.1 game scripts (e.g. if they're up to 64KB in total)\n");
@@ -403,6 +410,7 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	debugPrintf(" gc_reachable - Lists all addresses directly reachable from a given memory object\n");
 	debugPrintf(" gc_freeable - Lists all addresses freeable in a given segment\n");
 	debugPrintf(" gc_normalize - Prints the \"normal\" address of a given address\n");
+	debugPrintf(" gc_stats - Shows the pause times of the garbage collector\n");
 	debugPrintf("\n");
 	debugPrintf("Music/SFX:\n");
 	debugPrintf(" songlib - Shows the song library\n");
@@ -446,6 +454,8 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	debugPrintf(" script_steps - Shows the number of executed SCI operations\n");
 	debugPrintf(" vm_varlist / vmvarlist / vl - Shows the addresses of variables in the VM\n");
 	debugPrintf(" vm_vars / vmvars / vv - Displays or changes variables in the VM\n");
+	debugPrintf(" vm_stats - Shows the decoded instruction cache, or measures its speed\n");
+	debugPrintf(" avoidpath_bench - Records kAvoidPath calls and replays them to compare the pathfinders\n");
 	debugPrintf(" stack - Lists the specified number of stack elements\n");
 	debugPrintf(" value_type - Determines the type of a value\n");
 	debugPrintf(" view_listnode - Examines the list node at the given address\n");
@@ -968,6 +978,67 @@ bool Console::cmdResourceTypes(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdResourceCache(int argc, const char **argv) {
+	ResourceManager *resMan = _engine->getResMan();
+
+	if (argc > 1) {
+		if (!strcmp(argv[1], "reset")) {
+			for (int i = 0; i < kResourceCacheClassCount; i++)
+				resMan->getCacheStatistics((ResourceCacheClass)i).reset();
+			debugPrintf("Resource cache statistics reset\n");
+		} else {
+			debugPrintf("Shows the memory use and hit rates of the resource cache\n");
+			debugPrintf("Usage: %s [reset]\n", argv[0]);
+		}
+		return true;
+	}
+
+	debugPrintf("Resources not in use: %d of %d KB\n", resMan->getMemoryLRU() / 1024, resMan->getMaxMemoryLRU() / 1024);
+	debugPrintf("Prefetching rooms: %s\n", resMan->isPrefetchingRooms() ? "on" : "off");
+	if (resMan->isPrefetchThreadRunning())
+		debugPrintf("Prefetch thread: on, %d resources being decompressed\n", resMan->getPendingPrefetchJobs());
+	else
+		debugPrintf("Prefetch thread: off\n");
+	debugPrintf("%-8s %8s %8s %6s %6s %6s %8s %8s\n", "Class", "KB", "Budget", "Hits", "Misses", "Evict", "Prefetch", "Used");
+
+	for (int i = 0; i < kResourceCacheClassCount; i++) {
+		const ResourceCacheClass cacheClass = (ResourceCacheClass)i;
+		const ResourceCacheStatistics &stats = resMan->getCacheStatistics(cacheClass);
+		const int budget = resMan->getLRUBudget(cacheClass);
+		debugPrintf("%-8s %8d %8s %6d %6d %6d %8d %8d\n", ResourceManager::getCacheClassName(cacheClass),
+			resMan->getLRUMemory(cacheClass) / 1024,
+			budget ? Common::String::format("%d", budget / 1024).c_str() : "-",
+			stats.hits, stats.misses, stats.evictions, stats.prefetches, stats.prefetchHits);
+	}
+
+	return true;
+}
+
+bool Console::cmdRoomStats(int argc, const char **argv) {
+	RoomChangeStatistics &stats = _engine->_gamestate->_roomChangeStatistics;
+
+	if (argc > 1) {
+		if (!strcmp(argv[1], "reset")) {
+			stats.reset();
+			debugPrintf("Room change statistics reset\n");
+		} else {
+			debugPrintf("Shows how long room changes take\n");
+			debugPrintf("Usage: %s [reset]\n", argv[0]);
+		}
+		return true;
+	}
+
+	debugPrintf("Room changes: %d\n", stats.changes);
+	if (stats.changes) {
+		debugPrintf("Time: last %d ms, average %d ms, maximum %d ms\n",
+			stats.lastTime, stats.totalTime / stats.changes, stats.maxTime);
+		debugPrintf("Last change to room %d: %d resources loaded, %d prefetched ones used\n",
+			stats.lastRoom, stats.lastLoads, stats.lastPrefetched);
+	}
+
+	return true;
+}
+
 bool Console::cmdHexgrep(int argc, const char **argv) {
 	if (argc < 4) {
 		debugPrintf("Searches some resources for a particular sequence of bytes, represented as decimal or hexadecimal numbers.\n");
@@ -2518,6 +2589,34 @@ bool Console::cmdGCNormalize(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdGCStats(int argc, const char **argv) {
+	GCStatistics &stats = _engine->_gamestate->_gcStatistics;
+
+	if (argc > 1) {
+		if (!strcmp(argv[1], "reset")) {
+			stats.reset();
+			debugPrintf("Garbage collector statistics reset\n");
+		} else {
+			debugPrintf("Shows the pause times of the garbage collector\n");
+			debugPrintf("Usage: %s [reset]\n", argv[0]);
+		}
+		return true;
+	}
+
+	debugPrintf("Collections: %u, %u of them right after a frame was shown\n", stats.runs, stats.frameEndRuns);
+	if (stats.runs) {
+		debugPrintf("Pause time: last %u ms, average %u ms, maximum %u ms, total %u ms\n",
+			stats.lastTime, stats.totalTime / stats.runs, stats.maxTime, stats.totalTime);
+		debugPrintf("Objects freed: %u\n", stats.freed);
+	}
+	if (_engine->_gamestate->gcCountDown < 0)
+		debugPrintf("A collection is due when the game shows its next frame\n");
+	else
+		debugPrintf("Kernel calls until the next collection: %d\n", _engine->_gamestate->gcCountDown);
+
+	return true;
+}
+
 bool Console::cmdVMVarlist(int argc, const char **argv) {
 	EngineState *s = _engine->_gamestate;
 	const char *varnames[] = {"global", "local", "temp", "param"};
@@ -2533,6 +2632,134 @@ bool Console::cmdVMVarlist(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdVMStats(int argc, const char **argv) {
+	if (argc > 3 || (argc > 1 && strcmp(argv[1], "decode"))) {
+		debugPrintf("Shows how many instructions of the loaded scripts have been decoded\n");
+		debugPrintf("Usage: %s [decode [<passes>]]\n", argv[0]);
+		debugPrintf("With decode, all decoded instructions are decoded again and fetched from\n");
+		debugPrintf("the cache the given number of times (default: 1000), and the speed of\n");
+		debugPrintf("both is shown. This only compares instruction decoding, the instructions\n");
+		debugPrintf("are not executed\n");
+		return true;
+	}
+
+	SegManager *segMan = _engine->_gamestate->_segMan;
+	uint32 scriptCount = 0;
+	uint32 instructionCount = 0;
+	uint32 memorySize = 0;
+	Common::Array<Script *> scripts;
+	Common::Array<uint32> offsets;
+
+	for (uint i = 0; i < segMan->_heap.size(); i++) {
+		SegmentObj *mobj = segMan->_heap[i];
+		if (!mobj || mobj->getType() != SEG_TYPE_SCRIPT)
+			continue;
+
+		Script *scr = (Script *)mobj;
+		scriptCount++;
+		instructionCount += scr->getDecodedInstructionCount();
+		memorySize += scr->getDecodedMemorySize();
+
+		if (argc > 1) {
+			for (uint32 offset = 0; offset < scr->getBufSize(); offset++) {
+				if (scr->isInstructionDecoded(offset)) {
+					scripts.push_back(scr);
+					offsets.push_back(offset);
+				}
+			}
+		}
+	}
+
+	debugPrintf("%u instructions of %u scripts decoded, using %u KB\n", instructionCount, scriptCount, memorySize / 1024);
+	debugPrintf("%d instructions executed\n", _engine->_gamestate->scriptStepCounter);
+
+	if (argc > 1 && !offsets.empty()) {
+		const int passes = (argc > 2) ? atoi(argv[2]) : 1000;
+		byte extOpcode;
+		int16 opparams[4];
+		uint32 checksum = 0;
+
+		uint32 startTime = g_system->getMillis();
+		for (int pass = 0; pass < passes; pass++) {
+			for (uint i = 0; i < offsets.size(); i++)
+				checksum += readPMachineInstruction(scripts[i]->getBuf(offsets[i]), extOpcode, opparams);
+		}
+		const uint32 decodeTime = MAX<uint32>(g_system->getMillis() - startTime, 1);
+
+		startTime = g_system->getMillis();
+		for (int pass = 0; pass < passes; pass++) {
+			for (uint i = 0; i < offsets.size(); i++)
+				checksum -= scripts[i]->getInstruction(offsets[i]).size;
+		}
+		const uint32 cacheTime = MAX<uint32>(g_system->getMillis() - startTime, 1);
+
+		const double total = (double)offsets.size() * passes / 1000.0;
+		debugPrintf("Decoding: %.1f million instructions per second\n", total / decodeTime);
+		debugPrintf("Fetching from the cache: %.1f million instructions per second\n", total / cacheTime);
+		if (checksum)
+			debugPrintf("Warning: cached instructions differ from the script data\n");
+	}
+
+	return true;
+}
+
+bool Console::cmdAvoidPathBench(int argc, const char **argv) {
+	if (argc > 1 && !strcmp(argv[1], "record")) {
+		clearRecordedAvoidPathCalls();
+		setAvoidPathRecording(true);
+		debugPrintf("Recording kAvoidPath calls\n");
+		return true;
+	}
+
+	if (argc > 1 && !strcmp(argv[1], "stop")) {
+		setAvoidPathRecording(false);
+		debugPrintf("%d kAvoidPath calls recorded\n", getRecordedAvoidPathCalls());
+		return true;
+	}
+
+	if (argc > 1 && !strcmp(argv[1], "reset")) {
+		resetAvoidPathStatistics();
+		debugPrintf("kAvoidPath statistics reset\n");
+		return true;
+	}
+
+	if (argc > 1 && !strcmp(argv[1], "replay")) {
+		const int passes = (argc > 2) ? atoi(argv[2]) : 100;
+		uint32 referenceTime, cachedTime;
+
+		if (!getRecordedAvoidPathCalls()) {
+			debugPrintf("No kAvoidPath calls recorded\n");
+			return true;
+		}
+
+		const bool match = replayAvoidPathCalls(_engine->_gamestate, passes, referenceTime, cachedTime);
+		debugPrintf("Replayed %d kAvoidPath calls %d times\n", getRecordedAvoidPathCalls(), passes);
+		debugPrintf("Original search: %d ms, cached visibility and heap: %d ms\n", referenceTime, cachedTime);
+		if (match)
+			debugPrintf("Both found the same paths\n");
+		else
+			debugPrintf("Warning: the paths differ\n");
+		return true;
+	}
+
+	if (argc > 1) {
+		debugPrintf("Shows how often kAvoidPath found the visibility of its polygons in the cache\n");
+		debugPrintf("Usage: %s [record | stop | replay [<passes>] | reset]\n", argv[0]);
+		debugPrintf("record starts recording the input of kAvoidPath calls, stop stops it.\n");
+		debugPrintf("replay searches the recorded paths the given number of times (default: 100),\n");
+		debugPrintf("with and without the cache, and compares the speed and the results.\n");
+		debugPrintf("Replay in the room the calls were recorded in, as some rooms need workarounds\n");
+		return true;
+	}
+
+	const AvoidPathStatistics &stats = getAvoidPathStatistics();
+	debugPrintf("Path searches: %d, visibility cached: %d, new polygon sets: %d, uncached: %d\n",
+		stats.calls, stats.cacheHits, stats.cacheMisses, stats.uncached);
+	debugPrintf("%d calls recorded%s\n", getRecordedAvoidPathCalls(), isAvoidPathRecording() ? ", recording" : "");
+
+	return true;
+}
+
 bool Console::cmdVMVars(int argc, const char **argv) {
 	if (argc < 2) {
 		debugPrintf("Displays or changes variables in the VM\n");
@@ -273,6 +273,60 @@ private:
 	const Common::String _invalid;
 };
 
+/******************** Pathfinding ********************/
+
+struct AvoidPathStatistics {
+	// Number of kAvoidPath calls which searched a path
+	uint calls;
+	// Calls which found the visibility graph of their polygons in the cache
+	uint cacheHits;
+	// Calls which had to start a new visibility graph
+	uint cacheMisses;
+	// Calls which could not use a visibility graph, because the start or
+	// end point split an edge of the polygons
+	uint uncached;
+
+	AvoidPathStatistics() {
+		reset();
+	}
+
+	void reset() {
+		calls = 0;
+		cacheHits = 0;
+		cacheMisses = 0;
+		uncached = 0;
+	}
+};
+
+const AvoidPathStatistics &getAvoidPathStatistics();
+void resetAvoidPathStatistics();
+
+/**
+ * Records the input of kAvoidPath calls for replayAvoidPathCalls(). At
+ * most 1000 calls are recorded.
+ */
+void setAvoidPathRecording(bool enable);
+bool isAvoidPathRecording();
+uint getRecordedAvoidPathCalls();
+void clearRecordedAvoidPathCalls();
+
+/**
+ * Searches the paths of the recorded kAvoidPath calls the given number of
+ * times, once with the original search and once with the cached visibility
+ * graphs and the heap based search.
+ * @param s				the game state
+ * @param passes		the number of times to search each path
+ * @param referenceTime	set to the time taken by the original search in ms
+ * @param cachedTime	set to the time taken by the current search in ms
+ * @return true if both found the same paths
+ */
+bool replayAvoidPathCalls(EngineState *s, int passes, uint32 &referenceTime, uint32 &cachedTime);
+
+/**
+ * Frees the visibility graphs and recorded calls of kAvoidPath.
+ */
+void freePathfindingCache();
+
 /******************** Kernel functions ********************/
 
 reg_t kStrLen(EngineState *s, int argc, reg_t *argv);
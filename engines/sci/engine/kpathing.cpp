@@ -111,10 +111,26 @@ struct Vertex {
 	// Previous vertex in shortest path
 	Vertex *path_prev;
 
+	// Position in the open set of the A* search, -1 if not in the set
+	int heapIndex;
+	// When the vertex was added to the open set
+	uint32 openOrder;
+	// Whether the shortest path to the vertex is known
+	bool closed;
+
+	// Number of the vertex in the polygon set before the start and end
+	// points were merged into it, -1 for vertices added by the merge
+	int index;
+
 public:
 	Vertex(const Common::Point &p) : v(p) {
+		costF = HUGE_DISTANCE;
 		costG = HUGE_DISTANCE;
 		path_prev = NULL;
+		heapIndex = -1;
+		openOrder = 0;
+		closed = false;
+		index = -1;
 	}
 };
 
@@ -236,6 +252,77 @@ public:
 
 typedef Common::List<Polygon *> PolygonList;
 
+struct PathfindingState;
+
+/**
+ * The visibility between the vertices of a polygon set. Rooms hardly ever
+ * change their polygons while the actors in them keep calling kAvoidPath, so
+ * this is kept between calls, and is computed one vertex at a time as the
+ * search needs it.
+ */
+struct VisibilityGraph {
+	// The polygon set: for each polygon its number of vertices followed by
+	// their coordinates, in list order
+	Common::Array<int16> key;
+
+	// Number of vertices in the polygon set
+	int vertices;
+
+	// Whether the visibility of a vertex has been computed
+	Common::Array<bool> known;
+
+	// Visibility bits, one row of vertices bits per vertex
+	Common::Array<uint32> visible;
+
+	// Value of the usage counter at the last lookup
+	uint32 lastUse;
+
+	VisibilityGraph() : vertices(0), lastUse(0) {}
+
+	void reset(const Common::Array<int16> &newKey, int count);
+	bool isVisible(PathfindingState *s, Vertex *from, Vertex *to);
+};
+
+/**
+ * Visibility graphs of the most recently used polygon sets, and the
+ * kAvoidPath calls recorded for the avoidpath_bench console command.
+ */
+struct PathfindingCache {
+	enum {
+		kGraphs = 4,
+		kMaxRecordedCalls = 1000
+	};
+
+	// A recorded kAvoidPath call
+	struct Call {
+		// For each polygon its type and number of vertices, followed by
+		// their coordinates, in list order
+		Common::Array<int16> polygons;
+		Common::Point start, end;
+		int width, height, opt;
+	};
+
+	VisibilityGraph graphs[kGraphs];
+	uint32 useCounter;
+
+	bool recording;
+	Common::Array<Call> calls;
+
+	AvoidPathStatistics stats;
+
+	PathfindingCache() : useCounter(0), recording(false) {}
+
+	VisibilityGraph *lookup(const Common::Array<int16> &key, int count);
+};
+
+static PathfindingCache *s_pathfindingCache = NULL;
+
+static PathfindingCache *getPathfindingCache() {
+	if (!s_pathfindingCache)
+		s_pathfindingCache = new PathfindingCache();
+	return s_pathfindingCache;
+}
+
 // Pathfinding state
 struct PathfindingState {
 	// List of all polygons
@@ -257,12 +344,16 @@ struct PathfindingState {
 	// Screen size
 	int _width, _height;
 
+	// Cached visibility of the polygon set, or NULL
+	VisibilityGraph *_visibility;
+
 	PathfindingState(int width, int height) : _width(width), _height(height) {
 		vertex_start = NULL;
 		vertex_end = NULL;
 		vertex_index = NULL;
 		_prependPoint = NULL;
 		_appendPoint = NULL;
+		_visibility = NULL;
 		vertices = 0;
 	}
 
@@ -659,6 +750,88 @@ static int inside(const Common::Point &p, Vertex *vertex) {
 	return 0;
 }
 
+/**
+ * Determines whether a vertex is visible from another one.
+ * @param s				the pathfinding state
+ * @param vertex_cur	the vertex to look from
+ * @param vertex		the vertex to look at
+ * @return true if vertex is visible from vertex_cur
+ */
+static bool vertex_visible(PathfindingState *s, Vertex *vertex_cur, Vertex *vertex) {
+	// Make sure we don't intersect a polygon locally at the vertices
+	if ((vertex == vertex_cur) || (inside(vertex->v, vertex_cur)) || (inside(vertex_cur->v, vertex)))
+		return false;
+
+	// Check for intersecting edges
+	for (int j = 0; j < s->vertices; j++) {
+		Vertex *edge = s->vertex_index[j];
+		if (VERTEX_HAS_EDGES(edge)) {
+			if (between(vertex_cur->v, vertex->v, edge->v)) {
+				// If we hit a vertex, make sure we can pass through it without intersecting its polygon
+				if ((inside(vertex_cur->v, edge)) || (inside(vertex->v, edge)))
+					return false;
+
+				// This edge won't properly intersect, so we continue
+				continue;
+			}
+
+			if (intersect_proper(vertex_cur->v, vertex->v, edge->v, CLIST_NEXT(edge)->v))
+				return false;
+		}
+	}
+
+	return true;
+}
+
+void VisibilityGraph::reset(const Common::Array<int16> &newKey, int count) {
+	key = newKey;
+	vertices = count;
+	known.clear();
+	known.resize(count);
+	visible.clear();
+	visible.resize((count * count + 31) / 32);
+}
+
+bool VisibilityGraph::isVisible(PathfindingState *s, Vertex *from, Vertex *to) {
+	const int row = from->index * vertices;
+
+	if (!known[from->index]) {
+		// The start and end points only ever add vertices without edges,
+		// which cannot block the view between the others
+		for (int i = 0; i < s->vertices; i++) {
+			Vertex *vertex = s->vertex_index[i];
+			if (vertex->index >= 0 && vertex_visible(s, from, vertex))
+				visible[(row + vertex->index) / 32] |= 1U << ((row + vertex->index) % 32);
+		}
+		known[from->index] = true;
+	}
+
+	return visible[(row + to->index) / 32] & (1U << ((row + to->index) % 32));
+}
+
+VisibilityGraph *PathfindingCache::lookup(const Common::Array<int16> &key, int count) {
+	VisibilityGraph *graph = &graphs[0];
+
+	useCounter++;
+
+	for (int i = 0; i < kGraphs; i++) {
+		if (graphs[i].vertices == count && graphs[i].key == key) {
+			stats.cacheHits++;
+			graphs[i].lastUse = useCounter;
+			return &graphs[i];
+		}
+
+		// Replace the least recently used graph
+		if (graphs[i].lastUse < graph->lastUse)
+			graph = &graphs[i];
+	}
+
+	stats.cacheMisses++;
+	graph->reset(key, count);
+	graph->lastUse = useCounter;
+	return graph;
+}
+
 /**
  * Returns a list of all vertices that are visible from a particular vertex.
  * @param s				the pathfinding state
@@ -667,34 +840,18 @@ static int inside(const Common::Point &p, Vertex *vertex) {
  */
 static VertexList *visible_vertices(PathfindingState *s, Vertex *vertex_cur) {
 	VertexList *visVerts = new VertexList();
+	const bool cached = s->_visibility && vertex_cur->index >= 0;
 
 	for (int i = 0; i < s->vertices; i++) {
 		Vertex *vertex = s->vertex_index[i];
+		bool visible;
 
-		// Make sure we don't intersect a polygon locally at the vertices
-		if ((vertex == vertex_cur) || (inside(vertex->v, vertex_cur)) || (inside(vertex_cur->v, vertex)))
-			continue;
-
-		// Check for intersecting edges
-		int j;
-		for (j = 0; j < s->vertices; j++) {
-			Vertex *edge = s->vertex_index[j];
-			if (VERTEX_HAS_EDGES(edge)) {
-				if (between(vertex_cur->v, vertex->v, edge->v)) {
-					// If we hit a vertex, make sure we can pass through it without intersecting its polygon
-					if ((inside(vertex_cur->v, edge)) || (inside(vertex->v, edge)))
-						break;
-
-					// This edge won't properly intersect, so we continue
-					continue;
-				}
-
-				if (intersect_proper(vertex_cur->v, vertex->v, edge->v, CLIST_NEXT(edge)->v))
-					break;
-			}
-		}
+		if (cached && vertex->index >= 0)
+			visible = s->_visibility->isVisible(s, vertex_cur, vertex);
+		else
+			visible = vertex_visible(s, vertex_cur, vertex);
 
-		if (j == s->vertices)
+		if (visible)
 			visVerts->push_front(vertex);
 	}
 
@@ -1186,40 +1343,44 @@ static void change_polygons_opt_0(PathfindingState *s) {
 }
 
 /**
- * Converts the SCI input data for pathfinding
- * Parameters: (EngineState *) s: The game state
- *             (reg_t) poly_list: Polygon list
- *             (Common::Point) start: The start point
- *             (Common::Point) end: The end point
- *             (int) opt: Optimization level (0, 1 or 2)
- * Returns   : (PathfindingState *) On success a newly allocated pathfinding state,
- *                            NULL otherwise
+ * Numbers the vertices of the polygon set and computes the key of its
+ * visibility graph.
+ * Parameters: (PathfindingState *) s: The pathfinding state
+ *             (Common::Array<int16> &) key: The key
+ * Returns   : (int) The number of vertices
  */
-static PathfindingState *convert_polygon_set(EngineState *s, reg_t poly_list, Common::Point start, Common::Point end, int width, int height, int opt) {
-	SegManager *segMan = s->_segMan;
-	Polygon *polygon;
+static int index_polygon_set(PathfindingState *s, Common::Array<int16> &key) {
 	int count = 0;
-	PathfindingState *pf_s = new PathfindingState(width, height);
 
-	// Convert all polygons
-	if (poly_list.getSegment()) {
-		List *list = s->_segMan->lookupList(poly_list);
-		Node *node = s->_segMan->lookupNode(list->first);
-
-		while (node) {
-			// The node value might be null, in which case there's no polygon to parse.
-			// Happens in LB2 floppy - refer to bug #3041232
-			polygon = !node->value.isNull() ? convert_polygon(s, node->value) : NULL;
-
-			if (polygon) {
-				pf_s->polygons.push_back(polygon);
-				count += readSelectorValue(segMan, node->value, SELECTOR(size));
-			}
+	for (PolygonList::iterator it = s->polygons.begin(); it != s->polygons.end(); ++it) {
+		Polygon *polygon = *it;
+		Vertex *vertex;
 
-			node = s->_segMan->lookupNode(node->succ);
+		key.push_back(polygon->vertices.size());
+		CLIST_FOREACH(vertex, &polygon->vertices) {
+			vertex->index = count++;
+			key.push_back(vertex->v.x);
+			key.push_back(vertex->v.y);
 		}
 	}
 
+	return count;
+}
+
+/**
+ * Prepares converted polygons for pathfinding
+ * Parameters: (EngineState *) s: The game state
+ *             (PathfindingState *) pf_s: The pathfinding state with the polygons
+ *             (Common::Point) start: The start point
+ *             (Common::Point) end: The end point
+ *             (int) opt: Optimization level (0, 1 or 2)
+ *             (bool) useCache: Whether to use the cached visibility graphs
+ * Returns   : (PathfindingState *) pf_s on success, NULL otherwise, in
+ *                            which case pf_s has been deleted
+ */
+static PathfindingState *prepare_polygon_set(EngineState *s, PathfindingState *pf_s, Common::Point start, Common::Point end, int opt, bool useCache) {
+	Polygon *polygon;
+
 	if (opt == 0)
 		change_polygons_opt_0(pf_s);
 
@@ -1276,6 +1437,11 @@ static PathfindingState *convert_polygon_set(EngineState *s, reg_t poly_list, Co
 		}
 	}
 
+	// The fixups may have removed polygons, so the polygon set is only
+	// known now
+	Common::Array<int16> key;
+	int count = index_polygon_set(pf_s, key);
+
 	// Merge start and end points into polygon set
 	pf_s->vertex_start = merge_point(pf_s, *new_start);
 	pf_s->vertex_end = merge_point(pf_s, *new_end);
@@ -1283,6 +1449,18 @@ static PathfindingState *convert_polygon_set(EngineState *s, reg_t poly_list, Co
 	delete new_start;
 	delete new_end;
 
+	if (useCache) {
+		PathfindingCache *cache = getPathfindingCache();
+		cache->stats.calls++;
+
+		// A point which split an edge has changed the polygon set
+		if ((pf_s->vertex_start->index < 0 && VERTEX_HAS_EDGES(pf_s->vertex_start))
+		 || (pf_s->vertex_end->index < 0 && VERTEX_HAS_EDGES(pf_s->vertex_end)))
+			cache->stats.uncached++;
+		else
+			pf_s->_visibility = cache->lookup(key, count);
+	}
+
 	// Allocate and build vertex index
 	pf_s->vertex_index = (Vertex**)malloc(sizeof(Vertex *) * (count + 2));
 
@@ -1302,6 +1480,185 @@ static PathfindingState *convert_polygon_set(EngineState *s, reg_t poly_list, Co
 	return pf_s;
 }
 
+/**
+ * Converts the SCI input data for pathfinding
+ * Parameters: (EngineState *) s: The game state
+ *             (reg_t) poly_list: Polygon list
+ *             (Common::Point) start: The start point
+ *             (Common::Point) end: The end point
+ *             (int) opt: Optimization level (0, 1 or 2)
+ * Returns   : (PathfindingState *) On success a newly allocated pathfinding state,
+ *                            NULL otherwise
+ */
+static PathfindingState *convert_polygon_set(EngineState *s, reg_t poly_list, Common::Point start, Common::Point end, int width, int height, int opt) {
+	Polygon *polygon;
+	PathfindingState *pf_s = new PathfindingState(width, height);
+
+	// Convert all polygons
+	if (poly_list.getSegment()) {
+		List *list = s->_segMan->lookupList(poly_list);
+		Node *node = s->_segMan->lookupNode(list->first);
+
+		while (node) {
+			// The node value might be null, in which case there's no polygon to parse.
+			// Happens in LB2 floppy - refer to bug #3041232
+			polygon = !node->value.isNull() ? convert_polygon(s, node->value) : NULL;
+
+			if (polygon)
+				pf_s->polygons.push_back(polygon);
+
+			node = s->_segMan->lookupNode(node->succ);
+		}
+	}
+
+	PathfindingCache *cache = getPathfindingCache();
+	if (cache->recording && cache->calls.size() < PathfindingCache::kMaxRecordedCalls) {
+		PathfindingCache::Call call;
+
+		for (PolygonList::iterator it = pf_s->polygons.begin(); it != pf_s->polygons.end(); ++it) {
+			Vertex *vertex;
+
+			call.polygons.push_back((*it)->type);
+			call.polygons.push_back((*it)->vertices.size());
+			CLIST_FOREACH(vertex, &(*it)->vertices) {
+				call.polygons.push_back(vertex->v.x);
+				call.polygons.push_back(vertex->v.y);
+			}
+		}
+
+		call.start = start;
+		call.end = end;
+		call.width = width;
+		call.height = height;
+		call.opt = opt;
+		cache->calls.push_back(call);
+	}
+
+	return prepare_polygon_set(s, pf_s, start, end, opt, true);
+}
+
+/**
+ * Converts a recorded kAvoidPath call for pathfinding
+ * Parameters: (EngineState *) s: The game state
+ *             (const PathfindingCache::Call &) call: The recorded call
+ *             (bool) useCache: Whether to use the cached visibility graphs
+ * Returns   : (PathfindingState *) On success a newly allocated pathfinding state,
+ *                            NULL otherwise
+ */
+static PathfindingState *convert_recorded_call(EngineState *s, const PathfindingCache::Call &call, bool useCache) {
+	PathfindingState *pf_s = new PathfindingState(call.width, call.height);
+	uint i = 0;
+
+	while (i < call.polygons.size()) {
+		Polygon *polygon = new Polygon(call.polygons[i]);
+		const int size = call.polygons[i + 1];
+
+		i += 2;
+		for (int j = 0; j < size; j++, i += 2)
+			polygon->vertices.insertAtEnd(new Vertex(Common::Point(call.polygons[i], call.polygons[i + 1])));
+
+		pf_s->polygons.push_back(polygon);
+	}
+
+	return prepare_polygon_set(s, pf_s, call.start, call.end, call.opt, useCache);
+}
+
+/**
+ * The open set of the A* search, a binary heap ordered by the F cost of
+ * the vertices. Of vertices with the same cost, the one which was added last
+ * comes first, which is the order in which the search has always picked
+ * them.
+ */
+class OpenSet {
+public:
+	OpenSet() : _order(0) {}
+
+	bool empty() const {
+		return _heap.empty();
+	}
+
+	bool contains(const Vertex *vertex) const {
+		return vertex->heapIndex >= 0;
+	}
+
+	Vertex *top() const {
+		return _heap[0];
+	}
+
+	void push(Vertex *vertex) {
+		vertex->openOrder = _order++;
+		vertex->heapIndex = _heap.size();
+		_heap.push_back(vertex);
+		siftUp(vertex->heapIndex);
+	}
+
+	void pop() {
+		Vertex *last = _heap.back();
+
+		_heap[0]->heapIndex = -1;
+		_heap.pop_back();
+
+		if (!_heap.empty()) {
+			_heap[0] = last;
+			last->heapIndex = 0;
+			siftDown(0);
+		}
+	}
+
+	/**
+	 * Moves a vertex to its new position after its F cost decreased.
+	 */
+	void update(Vertex *vertex) {
+		siftUp(vertex->heapIndex);
+	}
+
+private:
+	static bool before(const Vertex *a, const Vertex *b) {
+		if (a->costF != b->costF)
+			return a->costF < b->costF;
+		return a->openOrder > b->openOrder;
+	}
+
+	void place(Vertex *vertex, int index) {
+		_heap[index] = vertex;
+		vertex->heapIndex = index;
+	}
+
+	void siftUp(int index) {
+		Vertex *vertex = _heap[index];
+
+		while (index > 0) {
+			const int parent = (index - 1) / 2;
+			if (!before(vertex, _heap[parent]))
+				break;
+			place(_heap[parent], index);
+			index = parent;
+		}
+
+		place(vertex, index);
+	}
+
+	void siftDown(int index) {
+		Vertex *vertex = _heap[index];
+		const int size = _heap.size();
+
+		while (2 * index + 1 < size) {
+			int child = 2 * index + 1;
+			if (child + 1 < size && before(_heap[child + 1], _heap[child]))
+				child++;
+			if (!before(_heap[child], vertex))
+				break;
+			place(_heap[child], index);
+			index = child;
+		}
+
+		place(vertex, index);
+	}
+
+	Common::Array<Vertex *> _heap;
+	uint32 _order;
+};
+
 /**
  * Computes a shortest path from vertex_start to vertex_end. The caller can
  * construct the resulting path by following the path_prev links from
@@ -1310,6 +1667,87 @@ static PathfindingState *convert_polygon_set(EngineState *s, reg_t poly_list, Co
  * Parameters: (PathfindingState *) s: The pathfinding state
  */
 static void AStar(PathfindingState *s) {
+	// The vertices of which the shortest path is not known yet. Those
+	// of which it is known are marked as closed.
+	OpenSet openSet;
+
+	s->vertex_start->costG = 0;
+	s->vertex_start->costF = (uint32)sqrt((float)s->vertex_start->v.sqrDist(s->vertex_end->v));
+	openSet.push(s->vertex_start);
+
+	// See below
+	const bool qfg1VgaWorkaround = (g_sci->getGameId() == GID_QFG1VGA &&
+									g_sci->getEngineState()->currentRoomNumber() == 81);
+
+	while (!openSet.empty()) {
+		// Find vertex in open set with lowest F cost
+		Vertex *vertex_min = openSet.top();
+
+		assert(vertex_min->costF < HUGE_DISTANCE);	// the vertex cost should never be bigger than HUGE_DISTANCE
+
+		// Check if we are done
+		if (vertex_min == s->vertex_end)
+			break;
+
+		// Move vertex from set open to set closed
+		vertex_min->closed = true;
+		openSet.pop();
+
+		VertexList *visVerts = visible_vertices(s, vertex_min);
+
+		for (VertexList::iterator it = visVerts->begin(); it != visVerts->end(); ++it) {
+			uint32 new_dist;
+			Vertex *vertex = *it;
+
+			if (vertex->closed)
+				continue;
+
+			new_dist = vertex_min->costG + (uint32)sqrt((float)vertex_min->v.sqrDist(vertex->v));
+
+			// When travelling to a vertex on the screen edge, we
+			// add a penalty score to make this path less appealing.
+			// NOTE: If an obstacle has only one vertex on a screen edge,
+			// later SSCI pathfinders will treat that vertex like any
+			// other, while we apply a penalty to paths traversing it.
+			// This difference might lead to problems, but none are
+			// known at the time of writing.
+
+			// WORKAROUND: This check fails in QFG1VGA, room 81 (bug report #3568452).
+			// However, it is needed in other SCI1.1 games, such as LB2. Therefore, we
+			// add this workaround for that scene in QFG1VGA, until our algorithm matches
+			// better what SSCI is doing. With this workaround, QFG1VGA no longer freezes
+			// in that scene.
+			if (s->pointOnScreenBorder(vertex->v) && !qfg1VgaWorkaround)
+				new_dist += 10000;
+
+			const bool open = openSet.contains(vertex);
+
+			if (new_dist < vertex->costG) {
+				vertex->costG = new_dist;
+				vertex->costF = vertex->costG + (uint32)sqrt((float)vertex->v.sqrDist(s->vertex_end->v));
+				vertex->path_prev = vertex_min;
+
+				if (open)
+					openSet.update(vertex);
+			}
+
+			if (!open)
+				openSet.push(vertex);
+		}
+
+		delete visVerts;
+	}
+
+	if (openSet.empty())
+		debugC(kDebugLevelAvoidPath, "AvoidPath: End point (%i, %i) is unreachable", s->vertex_end->v.x, s->vertex_end->v.y);
+}
+
+/**
+ * The original version of AStar(), which keeps its open set in a list. This
+ * is what the avoidpath_bench console command compares AStar() against.
+ * Parameters: (PathfindingState *) s: The pathfinding state
+ */
+static void AStarReference(PathfindingState *s) {
 	// Vertices of which the shortest path is known
 	VertexList closedSet;
 
@@ -1410,62 +1848,77 @@ static reg_t allocateOutputArray(SegManager *segMan, int size) {
 }
 
 /**
- * Stores the final path in newly allocated dynmem
+ * Collects the points of the final path
  * Parameters: (PathfindingState *) p: The pathfinding state
- *             (EngineState *) s: The game state
- * Returns   : (reg_t) Pointer to dynmem containing path
+ *             (Common::Array<Common::Point> &) path: The points
+ * Returns   : (int) The number of vertices of the shortest path, 0 if the
+ *                   end point is unreachable
  */
-static reg_t output_path(PathfindingState *p, EngineState *s) {
+static int collect_path(PathfindingState *p, Common::Array<Common::Point> &path) {
 	int path_len = 0;
-	reg_t output;
 	Vertex *vertex = p->vertex_end;
-	int unreachable = vertex->path_prev == NULL;
-
-	if (!unreachable) {
-		while (vertex) {
-			// Compute path length
-			path_len++;
-			vertex = vertex->path_prev;
-		}
-	}
-
-	// Allocate memory for path, plus 3 extra for appended point, prepended point and sentinel
-	output = allocateOutputArray(s->_segMan, path_len + 3);
-	SegmentRef arrayRef = s->_segMan->dereference(output);
-	assert(arrayRef.isValid() && !arrayRef.skipByte);
 
-	if (unreachable) {
+	if (vertex->path_prev == NULL) {
 		// If pathfinding failed we only return the path up to vertex_start
 
 		if (p->_prependPoint)
-			writePoint(arrayRef, 0, *p->_prependPoint);
+			path.push_back(*p->_prependPoint);
 		else
-			writePoint(arrayRef, 0, p->vertex_start->v);
+			path.push_back(p->vertex_start->v);
 
-		writePoint(arrayRef, 1, p->vertex_start->v);
-		writePoint(arrayRef, 2, Common::Point(POLY_LAST_POINT, POLY_LAST_POINT));
-
-		return output;
+		path.push_back(p->vertex_start->v);
+		return 0;
 	}
 
-	int offset = 0;
+	while (vertex) {
+		// Compute path length
+		path_len++;
+		vertex = vertex->path_prev;
+	}
 
 	if (p->_prependPoint)
-		writePoint(arrayRef, offset++, *p->_prependPoint);
+		path.push_back(*p->_prependPoint);
+
+	const uint offset = path.size();
+	path.resize(offset + path_len);
 
 	vertex = p->vertex_end;
 	for (int i = path_len - 1; i >= 0; i--) {
-		writePoint(arrayRef, offset + i, vertex->v);
+		path[offset + i] = vertex->v;
 		vertex = vertex->path_prev;
 	}
-	offset += path_len;
 
 	if (p->_appendPoint)
-		writePoint(arrayRef, offset++, *p->_appendPoint);
+		path.push_back(*p->_appendPoint);
+
+	return path_len;
+}
+
+/**
+ * Stores the final path in newly allocated dynmem
+ * Parameters: (PathfindingState *) p: The pathfinding state
+ *             (EngineState *) s: The game state
+ * Returns   : (reg_t) Pointer to dynmem containing path
+ */
+static reg_t output_path(PathfindingState *p, EngineState *s) {
+	Common::Array<Common::Point> path;
+	const int path_len = collect_path(p, path);
+
+	// Allocate memory for path, plus 3 extra for appended point, prepended point and sentinel
+	reg_t output = allocateOutputArray(s->_segMan, path_len + 3);
+	SegmentRef arrayRef = s->_segMan->dereference(output);
+	assert(arrayRef.isValid() && !arrayRef.skipByte);
+
+	const int offset = path.size();
+	for (int i = 0; i < offset; i++)
+		writePoint(arrayRef, i, path[i]);
 
 	// Sentinel
 	writePoint(arrayRef, offset, Common::Point(POLY_LAST_POINT, POLY_LAST_POINT));
 
+	if (!path_len)
+		return output;
+
 	if (DebugMan.isDebugChannelEnabled(kDebugLevelAvoidPath)) {
 		debug("\nReturning path:");
 
@@ -1579,6 +2032,88 @@ reg_t kAvoidPath(EngineState *s, int argc, reg_t *argv) {
 	}
 }
 
+void setAvoidPathRecording(bool enable) {
+	getPathfindingCache()->recording = enable;
+}
+
+bool isAvoidPathRecording() {
+	return s_pathfindingCache && s_pathfindingCache->recording;
+}
+
+uint getRecordedAvoidPathCalls() {
+	return s_pathfindingCache ? s_pathfindingCache->calls.size() : 0;
+}
+
+void clearRecordedAvoidPathCalls() {
+	getPathfindingCache()->calls.clear();
+}
+
+const AvoidPathStatistics &getAvoidPathStatistics() {
+	return getPathfindingCache()->stats;
+}
+
+void resetAvoidPathStatistics() {
+	getPathfindingCache()->stats.reset();
+}
+
+bool replayAvoidPathCalls(EngineState *s, int passes, uint32 &referenceTime, uint32 &cachedTime) {
+	PathfindingCache *cache = getPathfindingCache();
+	Common::Array<Common::Array<Common::Point> > expected;
+	bool match = true;
+
+	expected.resize(cache->calls.size());
+
+	// Start with empty graphs, so that the first pass measures building them
+	for (int i = 0; i < PathfindingCache::kGraphs; i++)
+		cache->graphs[i] = VisibilityGraph();
+
+	uint32 startTime = g_system->getMillis();
+	for (int pass = 0; pass < passes; pass++) {
+		for (uint i = 0; i < cache->calls.size(); i++) {
+			PathfindingState *p = convert_recorded_call(s, cache->calls[i], false);
+			if (p) {
+				AStarReference(p);
+				if (pass == 0)
+					collect_path(p, expected[i]);
+				delete p;
+			}
+		}
+	}
+	referenceTime = g_system->getMillis() - startTime;
+
+	const AvoidPathStatistics stats = cache->stats;
+
+	startTime = g_system->getMillis();
+	for (int pass = 0; pass < passes; pass++) {
+		for (uint i = 0; i < cache->calls.size(); i++) {
+			PathfindingState *p = convert_recorded_call(s, cache->calls[i], true);
+			if (p) {
+				AStar(p);
+				if (pass == 0) {
+					Common::Array<Common::Point> path;
+					collect_path(p, path);
+					if (path != expected[i])
+						match = false;
+				}
+				delete p;
+			} else if (!expected[i].empty()) {
+				match = false;
+			}
+		}
+	}
+	cachedTime = g_system->getMillis() - startTime;
+
+	// The replay should not show up in the statistics of the game
+	cache->stats = stats;
+
+	return match;
+}
+
+void freePathfindingCache() {
+	delete s_pathfindingCache;
+	s_pathfindingCache = NULL;
+}
+
 static bool PointInRect(const Common::Point &point, int16 rectX1, int16 rectY1, int16 rectX2, int16 rectY2) {
 	int16 top = MIN<int16>(rectY1, rectY2);
 	int16 left = MIN<int16>(rectX1, rectX2);
@@ -42,6 +42,10 @@ reg_t kLoad(EngineState *s, int argc, reg_t *argv) {
 	if (restype == kResourceTypeMemory)
 		return s->_segMan->allocateHunkEntry("kLoad()", resnr);
 
+	// Scripts load the resources they use in their init methods, which is a
+	// good hint for the resources to prefetch
+	g_sci->getResMan()->prefetchResource(ResourceId(restype, resnr));
+
 	return make_reg(0, ((restype << 11) | resnr)); // Return the resource identifier as handle
 }
 
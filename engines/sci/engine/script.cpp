@@ -70,6 +70,11 @@ void Script::freeScript() {
 	_offsetLookupObjectCount = 0;
 	_offsetLookupStringCount = 0;
 	_offsetLookupSaidCount = 0;
+
+	for (uint i = 0; i < _decodedPages.size(); i++)
+		delete[] _decodedPages[i];
+	_decodedPages.clear();
+	_decodedCount = 0;
 }
 
 void Script::load(int script_nr, ResourceManager *resMan, ScriptPatcher *scriptPatcher) {
@@ -155,6 +160,10 @@ void Script::load(int script_nr, ResourceManager *resMan, ScriptPatcher *scriptP
 	// Check scripts (+ possibly SCI 1.1 heap) for matching signatures and patch those, if found
 	scriptPatcher->processScript(_nr, _buf, _bufSize);
 
+	_decodedPages.resize((_bufSize + kDecodedPageSize - 1) >> kDecodedPageBits);
+	for (uint i = 0; i < _decodedPages.size(); i++)
+		_decodedPages[i] = NULL;
+
 	if (getSciVersion() <= SCI_VERSION_1_LATE) {
 		_exportTable = (const uint16 *)findBlockSCI0(SCI_OBJ_EXPORTS);
 		if (_exportTable) {
@@ -215,6 +224,26 @@ void Script::load(int script_nr, ResourceManager *resMan, ScriptPatcher *scriptP
 	identifyOffsets();
 }
 
+const DecodedInstruction &Script::decodeInstruction(uint32 offset) {
+	DecodedInstruction *&page = _decodedPages[offset >> kDecodedPageBits];
+	if (!page)
+		page = new DecodedInstruction[kDecodedPageSize]();
+
+	DecodedInstruction &instruction = page[offset & (kDecodedPageSize - 1)];
+	instruction.size = readPMachineInstruction(_buf + offset, instruction.extOpcode, instruction.opparams);
+	_decodedCount++;
+	return instruction;
+}
+
+uint32 Script::getDecodedMemorySize() const {
+	uint32 size = _decodedPages.size() * sizeof(DecodedInstruction *);
+	for (uint i = 0; i < _decodedPages.size(); i++) {
+		if (_decodedPages[i])
+			size += kDecodedPageSize * sizeof(DecodedInstruction);
+	}
+	return size;
+}
+
 void Script::identifyOffsets() {
 	offsetLookupArrayEntry arrayEntry;
 	const byte *scriptDataPtr  = NULL;
@@ -64,6 +64,15 @@ struct offsetLookupArrayEntry {
 
 typedef Common::Array<offsetLookupArrayEntry> offsetLookupArrayType;
 
+/**
+ * A PMachine instruction, as read by readPMachineInstruction().
+ */
+struct DecodedInstruction {
+	int16 opparams[4]; ///< parameters of the instruction
+	uint16 size;       ///< length of the instruction in bytes, 0 if not decoded yet
+	byte extOpcode;    ///< "extended" opcode of the instruction
+};
+
 class Script : public SegmentObj {
 private:
 	int _nr; /**< Script number */
@@ -90,6 +99,20 @@ private:
 
 	ObjMap _objects;	/**< Table for objects, contains property variables */
 
+	enum {
+		kDecodedPageBits = 8,
+		kDecodedPageSize = 1 << kDecodedPageBits
+	};
+
+	/**
+	 * Instructions decoded so far, indexed by offset. Only the pages of
+	 * kDecodedPageSize offsets which contain executed code are allocated.
+	 */
+	Common::Array<DecodedInstruction *> _decodedPages;
+	uint32 _decodedCount; /**< Number of instructions in _decodedPages */
+
+	const DecodedInstruction &decodeInstruction(uint32 offset);
+
 protected:
 	offsetLookupArrayType _offsetLookupArray; // Table of all elements of currently loaded script, that may get pointed to
 
@@ -107,6 +130,25 @@ public:
 	uint32 getBufSize() const { return _bufSize; }
 	const byte *getBuf(uint offset = 0) const { return _buf + offset; }
 
+	/**
+	 * Get the instruction at the specified offset, which must be within the
+	 * buffer. Instructions are decoded the first time they are executed, and
+	 * kept until the script is unloaded, so the VM doesn't have to read the
+	 * operands of each instruction again every time it runs.
+	 */
+	const DecodedInstruction &getInstruction(uint32 offset) {
+		const DecodedInstruction *page = _decodedPages[offset >> kDecodedPageBits];
+		if (page && page[offset & (kDecodedPageSize - 1)].size)
+			return page[offset & (kDecodedPageSize - 1)];
+		return decodeInstruction(offset);
+	}
+	bool isInstructionDecoded(uint32 offset) const {
+		const DecodedInstruction *page = _decodedPages[offset >> kDecodedPageBits];
+		return page && page[offset & (kDecodedPageSize - 1)].size;
+	}
+	uint32 getDecodedInstructionCount() const { return _decodedCount; }
+	uint32 getDecodedMemorySize() const;
+
 	int getScriptNumber() const { return _nr; }
 	SegmentId getLocalsSegment() const { return _localsSegment; }
 	reg_t *getLocalsBegin() { return _localsBlock ? _localsBlock->_locals.begin() : NULL; }
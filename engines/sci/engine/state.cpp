@@ -25,8 +25,10 @@
 #include "sci/sci.h"	// for INCLUDE_OLDGFX
 #include "sci/debug.h"	// for g_debug_sleeptime_factor
 #include "sci/event.h"
+#include "sci/resource.h"
 
 #include "sci/engine/file.h"
+#include "sci/engine/gc.h"
 #include "sci/engine/kernel.h"
 #include "sci/engine/state.h"
 #include "sci/engine/selector.h"
@@ -90,6 +92,8 @@ void EngineState::reset(bool isRestoring) {
 		_memorySegmentSize = 0;
 		_fileHandles.resize(5);
 		abortScriptProcessing = kAbortNone;
+		_gcStatistics.reset();
+		_roomChangeStatistics.reset();
 	}
 
 	// reset delayed restore game functionality
@@ -115,6 +119,9 @@ void EngineState::reset(bool isRestoring) {
 	_throttleTrigger = false;
 	_gameIsBenchmarking = false;
 
+	_timedRoomNumber = 0;
+	_roomChangePending = false;
+
 	_lastSaveVirtualId = SAVEGAMEID_OFFICIALRANGE_START;
 	_lastSaveNewId = 0;
 
@@ -132,7 +139,42 @@ void EngineState::reset(bool isRestoring) {
 	_vmdPalEnd = 256;
 }
 
+static void countResourceLoads(uint32 &loads, uint32 &prefetched) {
+	ResourceManager *resMan = g_sci->getResMan();
+	loads = prefetched = 0;
+	for (int i = 0; i < kResourceCacheClassCount; i++) {
+		const ResourceCacheStatistics &stats = resMan->getCacheStatistics((ResourceCacheClass)i);
+		loads += stats.misses;
+		prefetched += stats.prefetchHits;
+	}
+}
+
 void EngineState::speedThrottler(uint32 neededSleep) {
+	// A room change takes the game cycle after the one which set the new
+	// room number, which ends here
+	if (_roomChangePending) {
+		RoomChangeStatistics &stats = _roomChangeStatistics;
+		uint32 loads, prefetched;
+		countResourceLoads(loads, prefetched);
+
+		stats.changes++;
+		stats.lastTime = g_system->getMillis() - _roomChangeStart;
+		stats.totalTime += stats.lastTime;
+		stats.maxTime = MAX(stats.maxTime, stats.lastTime);
+		stats.lastRoom = _timedRoomNumber;
+		stats.lastLoads = loads - _roomChangeLoads;
+		stats.lastPrefetched = prefetched - _roomChangePrefetched;
+		_roomChangePending = false;
+
+		debugC(kDebugLevelRoom, "Room %d entered in %d ms, %d resources loaded, %d prefetched ones used",
+			stats.lastRoom, stats.lastTime, stats.lastLoads, stats.lastPrefetched);
+	}
+
+	// Use the rest of the wait to load the resources of the room the game is
+	// about to enter (its new room number is set a cycle early)
+	const uint32 deadline = _throttleTrigger ? _throttleLastTime + neededSleep : 0;
+	g_sci->getResMan()->prefetchRoom(currentRoomNumber(), deadline);
+
 	if (_throttleTrigger) {
 		uint32 curTime = g_system->getMillis();
 		uint32 duration = curTime - _throttleLastTime;
@@ -145,6 +187,14 @@ void EngineState::speedThrottler(uint32 neededSleep) {
 		}
 		_throttleTrigger = false;
 	}
+
+	const uint16 roomNumber = currentRoomNumber();
+	if (roomNumber != _timedRoomNumber) {
+		_timedRoomNumber = roomNumber;
+		_roomChangePending = true;
+		_roomChangeStart = g_system->getMillis();
+		countResourceLoads(_roomChangeLoads, _roomChangePrefetched);
+	}
 }
 
 void EngineState::wait(int16 ticks) {
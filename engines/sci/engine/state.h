@@ -99,6 +99,42 @@ struct VideoState {
 	}
 };
 
+/**
+ * Pause times of the garbage collector, as shown by the gc_stats console
+ * command. All times are in milliseconds.
+ */
+struct GCStatistics {
+	uint32 runs;      ///< number of collections
+	uint32 frameEndRuns; ///< collections run right after a frame was shown
+	uint32 totalTime; ///< time spent in all collections
+	uint32 maxTime;   ///< longest collection
+	uint32 lastTime;  ///< last collection
+	uint32 freed;     ///< number of objects freed by all collections
+
+	void reset() {
+		runs = frameEndRuns = 0;
+		totalTime = maxTime = lastTime = 0;
+		freed = 0;
+	}
+};
+
+struct RoomChangeStatistics {
+	uint32 changes;      ///< number of room changes
+	uint32 totalTime;    ///< time spent in all room changes
+	uint32 maxTime;      ///< slowest room change
+	uint32 lastTime;     ///< last room change
+	uint16 lastRoom;     ///< room entered last
+	uint32 lastLoads;    ///< resources loaded by the last room change
+	uint32 lastPrefetched; ///< prefetched resources used by the last room change
+
+	void reset() {
+		changes = 0;
+		totalTime = maxTime = lastTime = 0;
+		lastRoom = 0;
+		lastLoads = lastPrefetched = 0;
+	}
+};
+
 struct EngineState : public Common::Serializable {
 public:
 	EngineState(SegManager *segMan);
@@ -194,6 +230,14 @@ public:
 	void shrinkStackToBase();
 
 	int gcCountDown; /**< Number of kernel calls until next gc */
+	GCStatistics _gcStatistics;
+
+	RoomChangeStatistics _roomChangeStatistics;
+	uint16 _timedRoomNumber;   /**< room number seen by the last speedThrottler() */
+	bool _roomChangePending;   /**< the room is being changed since _roomChangeStart */
+	uint32 _roomChangeStart;
+	uint32 _roomChangeLoads;   /**< resource loads when the room change started */
+	uint32 _roomChangePrefetched;
 
 	MessageState *_msgState;
 
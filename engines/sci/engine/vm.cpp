@@ -220,8 +220,21 @@ static void write_var(EngineState *s, int type, int index, reg_t value) {
 // 16 bit:
 #define PUSH(v) PUSH32(make_reg(0, v))
 // 32 bit:
-#define PUSH32(a) (*(validate_stack_addr(s, (s->xs->sp)++)) = (a))
-#define POP32() (*(validate_stack_addr(s, --(s->xs->sp))))
+#define PUSH32_CHECKED(a) (*(validate_stack_addr(s, (s->xs->sp)++)) = (a))
+#define POP32_CHECKED() (*(validate_stack_addr(s, --(s->xs->sp))))
+#ifdef RELEASE_BUILD
+// Validating each stack access is too slow for release builds. Instead,
+// run_vm() makes sure that there is room for one more entry on the stack
+// before each instruction, and that the stack pointer hasn't dropped below
+// the frame pointer after it. Instructions pushing more than one entry have
+// to use PUSH32_CHECKED(). Popping still compares against the stack base,
+// since popping from an empty stack would read before its start.
+#define PUSH32(a) (*((s->xs->sp)++) = (a))
+#define POP32() (*(s->xs->sp > s->stack_base ? --(s->xs->sp) : validate_stack_addr(s, --(s->xs->sp))))
+#else
+#define PUSH32(a) PUSH32_CHECKED(a)
+#define POP32() POP32_CHECKED()
+#endif
 
 ExecStack *execute_method(EngineState *s, uint16 script, uint16 pubfunct, StackPtr sp, reg_t calling_obj, uint16 argc, StackPtr argp) {
 	int seg = s->_segMan->getScriptSegment(script);
@@ -347,6 +360,15 @@ static void addKernelCallToExecStack(EngineState *s, int kernelCallNr, int argc,
 // from scriptdebug.cpp
 extern void logKernelCall(const KernelFunction *kernelCall, const KernelSubFunction *kernelSubCall, EngineState *s, int argc, reg_t *argv, reg_t result);
 
+/**
+ * Returns whether the given kernel function ends a frame of the game, i.e.
+ * draws the cast and screen items and shows them.
+ */
+static bool isFrameEnd(int kernelCallNr) {
+	const Common::String &name = g_sci->getKernel()->getKernelName(kernelCallNr);
+	return name == "Animate" || name == "FrameOut";
+}
+
 static void callKernelFunc(EngineState *s, int kernelCallNr, int argc) {
 	Kernel *kernel = g_sci->getKernel();
 
@@ -625,6 +647,11 @@ void run_vm(EngineState *s) {
 			error("run_vm(): stack underflow, sp: %04x:%04x, fp: %04x:%04x",
 			PRINT_REG(*s->xs->sp), PRINT_REG(*s->xs->fp));
 
+#ifdef RELEASE_BUILD
+		if (s->xs->sp >= s->stack_top)
+			error("run_vm(): stack overflow, stack index: %d", (int)(s->xs->sp - s->stack_base));
+#endif
+
 		s->variablesMax[VAR_TEMP] = s->xs->sp - s->xs->fp;
 
 		if (s->xs->addr.pc.getOffset() >= scr->getBufSize())
@@ -632,8 +659,10 @@ void run_vm(EngineState *s) {
 			s->xs->addr.pc.getOffset(), scr->getBufSize());
 
 		// Get opcode
-		byte extOpcode;
-		s->xs->addr.pc.incOffset(readPMachineInstruction(scr->getBuf(s->xs->addr.pc.getOffset()), extOpcode, opparams));
+		const DecodedInstruction &instruction = scr->getInstruction(s->xs->addr.pc.getOffset());
+		const byte extOpcode = instruction.extOpcode;
+		memcpy(opparams, instruction.opparams, sizeof(opparams));
+		s->xs->addr.pc.incOffset(instruction.size);
 		const byte opcode = extOpcode >> 1;
 		//debug("%s: %d, %d, %d, %d, acc = %04x:%04x, script %d, local script %d", opcodeNames[opcode], opparams[0], opparams[1], opparams[2], opparams[3], PRINT_REG(s->r_acc), scr->getScriptNumber(), local_script->getScriptNumber());
 
@@ -855,8 +884,10 @@ void run_vm(EngineState *s) {
 		}
 
 		case op_callk: { // 0x21 (33)
-			// Run the garbage collector, if needed
-			if (s->gcCountDown-- <= 0) {
+			// Run the garbage collector, if needed. A due collection is put
+			// off until the game has shown a frame (see below), unless that
+			// takes too long.
+			if (s->gcCountDown-- <= -GC_MAX_DELAY) {
 				s->gcCountDown = s->scriptGCInterval;
 				run_gc(s);
 			}
@@ -888,6 +919,16 @@ void run_vm(EngineState *s) {
 			if (s->abortScriptProcessing != kAbortNone)
 				return; // Stop processing
 
+			// The game has just shown a frame, and the kernel call has
+			// returned, so all roots are on the VM stack again. A collection
+			// run now is taken from the time the throttler would otherwise
+			// sleep before the next frame.
+			if (s->gcCountDown < 0 && isFrameEnd(opparams[0])) {
+				s->_gcStatistics.frameEndRuns++;
+				s->gcCountDown = s->scriptGCInterval;
+				run_gc(s);
+			}
+
 			break;
 		}
 
@@ -1053,7 +1094,7 @@ void run_vm(EngineState *s) {
 			s->r_rest = MAX<int16>(s->xs->argc - temp + 1, 0); // +1 because temp counts the paramcount while argc doesn't
 
 			for (; temp <= s->xs->argc; temp++)
-				PUSH32(s->xs->variables_argp[temp]);
+				PUSH32_CHECKED(s->xs->variables_argp[temp]);
 
 			break;
 
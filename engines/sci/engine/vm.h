@@ -134,7 +134,12 @@ enum {
 
 /** Number of kernel calls in between gcs; should be < 50000 */
 enum {
-	GC_INTERVAL = 0x8000
+	GC_INTERVAL = 0x8000,
+	/**
+	 * Number of kernel calls a due gc may be put off, waiting for the game to
+	 * show a frame with kAnimate or kFrameOut (see op_callk)
+	 */
+	GC_MAX_DELAY = 0x4000
 };
 
 enum SciOpcodes {
@@ -344,6 +344,7 @@ void EventManager::updateScreen() {
 	if (g_system->getMillis() - s->_screenUpdateTime >= 1000 / 60) {
 		g_system->updateScreen();
 		s->_screenUpdateTime = g_system->getMillis();
+		g_sci->getSciDebugger()->onFrameEnd();
 		// Throttle the checking of shouldQuit() to 60fps as well, since
 		// Engine::shouldQuit() invokes 2 virtual functions
 		// (EventManager::shouldQuit() and EventManager::shouldRTL()),
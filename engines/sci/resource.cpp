@@ -25,6 +25,8 @@
 #include "common/file.h"
 #include "common/fs.h"
 #include "common/macresman.h"
+#include "common/memstream.h"
+#include "common/system.h"
 #include "common/textconsole.h"
 
 #include "sci/resource.h"
@@ -198,6 +200,10 @@ Resource::Resource(ResourceManager *resMan, ResourceId id) : _resMan(resMan), _i
 	_source = NULL;
 	_header = NULL;
 	_headerSize = 0;
+	_lruPrev[0] = _lruPrev[1] = NULL;
+	_lruNext[0] = _lruNext[1] = NULL;
+	_prefetched = false;
+	_prefetchJob = -1;
 }
 
 Resource::~Resource() {
@@ -211,6 +217,7 @@ void Resource::unalloc() {
 	delete[] data;
 	data = NULL;
 	_status = kResStatusNoMalloc;
+	_prefetched = false;
 }
 
 void Resource::writeToStream(Common::WriteStream *stream) const {
@@ -861,13 +868,26 @@ void ResourceManager::freeResourceSources() {
 }
 
 ResourceManager::ResourceManager() {
+	_prefetchThreadRunning = false;
+	_prefetchQuit = false;
+	_prefetchSubmitted = _prefetchAdopted = 0;
+	_prefetchFinished = 0;
 }
 
 void ResourceManager::init() {
-	_maxMemoryLRU = 256 * 1024; // 256KiB
 	_memoryLocked = 0;
-	_memoryLRU = 0;
-	_LRU.clear();
+	_LRU.first = _LRU.last = NULL;
+	_LRU.memory = 0;
+	_LRU.maxMemory = 256 * 1024; // 256KiB
+	for (int i = 0; i < kResourceCacheClassCount; i++) {
+		_classLRU[i].first = _classLRU[i].last = NULL;
+		_classLRU[i].memory = 0;
+		_classLRU[i].maxMemory = 0;
+		_cacheStats[i].reset();
+	}
+	_prefetchRooms = false;
+	_prefetchedRoom = 0xFFFF;
+	_prefetchQueue.clear();
 	_resMap.clear();
 	_audioMapSCI1 = NULL;
 
@@ -923,7 +943,7 @@ void ResourceManager::init() {
 	// cache, leading to constant decompression of picture resources
 	// and making the renderer very slow.
 	if (getSciVersion() >= SCI_VERSION_2) {
-		_maxMemoryLRU = 2048 * 1024; // 2MiB
+		_LRU.maxMemory = 2048 * 1024; // 2MiB
 	}
 
 	switch (_viewType) {
@@ -952,6 +972,8 @@ void ResourceManager::init() {
 }
 
 ResourceManager::~ResourceManager() {
+	setPrefetchThread(false);
+
 	// freeing resources
 	ResourceMap::iterator itr = _resMap.begin();
 	while (itr != _resMap.end()) {
@@ -967,13 +989,37 @@ ResourceManager::~ResourceManager() {
 	}
 }
 
+void ResourceManager::linkLRU(LRUList &list, LRULink link, Resource *res) {
+	res->_lruPrev[link] = NULL;
+	res->_lruNext[link] = list.first;
+	if (list.first)
+		list.first->_lruPrev[link] = res;
+	else
+		list.last = res;
+	list.first = res;
+	list.memory += res->size;
+}
+
+void ResourceManager::unlinkLRU(LRUList &list, LRULink link, Resource *res) {
+	if (res->_lruPrev[link])
+		res->_lruPrev[link]->_lruNext[link] = res->_lruNext[link];
+	else
+		list.first = res->_lruNext[link];
+	if (res->_lruNext[link])
+		res->_lruNext[link]->_lruPrev[link] = res->_lruPrev[link];
+	else
+		list.last = res->_lruPrev[link];
+	res->_lruPrev[link] = res->_lruNext[link] = NULL;
+	list.memory -= res->size;
+}
+
 void ResourceManager::removeFromLRU(Resource *res) {
 	if (res->_status != kResStatusEnqueued) {
 		warning("resMan: trying to remove resource that isn't enqueued");
 		return;
 	}
-	_LRU.remove(res);
-	_memoryLRU -= res->size;
+	unlinkLRU(_LRU, kLRULinkAll, res);
+	unlinkLRU(_classLRU[getCacheClass(res->getType())], kLRULinkClass, res);
 	res->_status = kResStatusAllocated;
 }
 
@@ -982,12 +1028,12 @@ void ResourceManager::addToLRU(Resource *res) {
 		warning("resMan: trying to enqueue resource with state %d", res->_status);
 		return;
 	}
-	_LRU.push_front(res);
-	_memoryLRU += res->size;
+	linkLRU(_LRU, kLRULinkAll, res);
+	linkLRU(_classLRU[getCacheClass(res->getType())], kLRULinkClass, res);
 #if SCI_VERBOSE_RESMAN
 	debug("Adding %s (%d bytes) to lru control: %d bytes total",
 	      res->_id.toString().c_str(), res->size,
-	      _memoryLRU);
+	      _LRU.memory);
 #endif
 	res->_status = kResStatusEnqueued;
 }
@@ -995,29 +1041,253 @@ void ResourceManager::addToLRU(Resource *res) {
 void ResourceManager::printLRU() {
 	int mem = 0;
 	int entries = 0;
-	Common::List<Resource *>::iterator it = _LRU.begin();
-	Resource *res;
+	Resource *res = _LRU.first;
 
-	while (it != _LRU.end()) {
-		res = *it;
+	while (res) {
 		debug("\t%s: %d bytes", res->_id.toString().c_str(), res->size);
 		mem += res->size;
 		++entries;
-		++it;
+		res = res->_lruNext[kLRULinkAll];
 	}
 
-	debug("Total: %d entries, %d bytes (mgr says %d)", entries, mem, _memoryLRU);
+	debug("Total: %d entries, %d bytes (mgr says %d)", entries, mem, _LRU.memory);
 }
 
-void ResourceManager::freeOldResources() {
-	while (_maxMemoryLRU < _memoryLRU) {
-		assert(!_LRU.empty());
-		Resource *goner = *_LRU.reverse_begin();
-		removeFromLRU(goner);
-		goner->unalloc();
+void ResourceManager::freeLRUResource(Resource *goner) {
+	removeFromLRU(goner);
+	goner->unalloc();
+	_cacheStats[getCacheClass(goner->getType())].evictions++;
 #ifdef SCI_VERBOSE_RESMAN
-		debug("resMan-debug: LRU: Freeing %s (%d bytes)", goner->_id.toString().c_str(), goner->size);
+	debug("resMan-debug: LRU: Freeing %s (%d bytes)", goner->_id.toString().c_str(), goner->size);
 #endif
+}
+
+void ResourceManager::freeOldResources() {
+	for (int i = 0; i < kResourceCacheClassCount; i++) {
+		LRUList &list = _classLRU[i];
+		while (list.maxMemory && list.maxMemory < list.memory) {
+			assert(list.last);
+			freeLRUResource(list.last);
+		}
+	}
+
+	while (_LRU.maxMemory < _LRU.memory) {
+		assert(_LRU.last);
+		freeLRUResource(_LRU.last);
+	}
+}
+
+ResourceCacheClass ResourceManager::getCacheClass(ResourceType type) {
+	switch (type) {
+	case kResourceTypeView:
+		return kResourceCacheView;
+	case kResourceTypePic:
+		return kResourceCachePic;
+	case kResourceTypeAudio:
+	case kResourceTypeAudio36:
+		return kResourceCacheAudio;
+	case kResourceTypeSync:
+	case kResourceTypeSync36:
+		return kResourceCacheSync;
+	case kResourceTypeScript:
+	case kResourceTypeHeap:
+		return kResourceCacheScript;
+	default:
+		return kResourceCacheOther;
+	}
+}
+
+const char *ResourceManager::getCacheClassName(ResourceCacheClass cacheClass) {
+	static const char *const names[kResourceCacheClassCount] = {
+		"views", "pics", "audio", "sync", "scripts", "other"
+	};
+	return names[cacheClass];
+}
+
+void ResourceManager::prefetchRoom(uint16 roomNumber, uint32 deadline) {
+	if (!isPrefetching())
+		return;
+
+	if (_prefetchRooms && roomNumber != _prefetchedRoom) {
+		// The resources which usually share the number of a room
+		static const ResourceType roomTypes[] = {
+			kResourceTypeScript, kResourceTypeHeap, kResourceTypePic, kResourceTypePalette,
+			kResourceTypeView, kResourceTypeMessage
+		};
+
+		_prefetchedRoom = roomNumber;
+		_prefetchQueue.clear();
+		for (int i = 0; i < ARRAYSIZE(roomTypes); i++)
+			_prefetchQueue.push_back(ResourceId(roomTypes[i], roomNumber));
+	}
+
+	adoptPrefetchJobs();
+
+	// Load at least one resource, and more while there is time left. With
+	// the prefetch thread, only the packed data is read here.
+	do {
+		if (_prefetchQueue.empty())
+			return;
+
+		Resource *res = testResource(_prefetchQueue.front());
+		if (res && _prefetchThreadRunning && !canSubmitPrefetchJob())
+			return;
+		_prefetchQueue.pop_front();
+		if (!res || res->_status != kResStatusNoMalloc || res->_prefetchJob != -1)
+			continue;
+
+		if (_prefetchThreadRunning && submitPrefetchJob(res))
+			continue;
+
+		loadResource(res);
+		if (res->_status != kResStatusAllocated)
+			continue;
+
+		res->_prefetched = true;
+		_cacheStats[getCacheClass(res->getType())].prefetches++;
+		addToLRU(res);
+		freeOldResources();
+	} while ((int32)(deadline - g_system->getMillis()) > 0);
+}
+
+void ResourceManager::prefetchResource(ResourceId id) {
+	if (!isPrefetching())
+		return;
+
+	Resource *res = testResource(id);
+	if (!res || res->_status != kResStatusNoMalloc || res->_prefetchJob != -1)
+		return;
+
+	if (canSubmitPrefetchJob() && submitPrefetchJob(res))
+		return;
+
+	_prefetchQueue.push_back(id);
+}
+
+bool ResourceManager::setPrefetchThread(bool enable) {
+	if (enable == _prefetchThreadRunning)
+		return _prefetchThreadRunning;
+
+	if (enable) {
+		_prefetchQuit = false;
+		_prefetchThreadRunning = _prefetchThread.start(prefetchThreadProc, this);
+		return _prefetchThreadRunning;
+	}
+
+	// Let the thread finish the jobs it has, so that their results can be
+	// taken over before it goes
+	adoptPrefetchJobs(_prefetchSubmitted - 1);
+	_prefetchQuit = true;
+	_prefetchStart.post();
+	_prefetchThread.join();
+	_prefetchThreadRunning = false;
+	return false;
+}
+
+void ResourceManager::prefetchThreadProc(void *param) {
+	ResourceManager *resMan = (ResourceManager *)param;
+
+	while (true) {
+		resMan->_prefetchStart.wait();
+		if (resMan->_prefetchQuit)
+			break;
+
+		// Jobs are handed over and finished in order
+		PrefetchJob &job = resMan->_prefetchJobs[Common::atomicLoad(&resMan->_prefetchFinished) % kPrefetchJobs];
+		Decompressor *dec = Resource::createDecompressor(job.compression);
+		if (dec) {
+			Common::MemoryReadStream stream(job.packed, job.packedSize);
+			job.data = new byte[job.size];
+			job.error = dec->unpack(&stream, job.data, job.packedSize, job.size);
+			delete dec;
+		} else {
+			// E.g. STACpack in builds without SCI32. Loading the resource
+			// the usual way reports it.
+			job.error = SCI_ERROR_UNKNOWN_COMPRESSION;
+		}
+
+		Common::atomicAdd(&resMan->_prefetchFinished, 1);
+		resMan->_prefetchDone.post();
+	}
+}
+
+bool ResourceManager::submitPrefetchJob(Resource *res) {
+	assert(canSubmitPrefetchJob());
+
+	// Everything else needs more than a plain read before decompressing
+	if (res->_source->getSourceType() != kSourceVolume)
+		return false;
+
+	Common::SeekableReadStream *fileStream = res->_source->getVolumeFile(this, res);
+	if (!fileStream)
+		return true;
+	fileStream->seek(res->_fileOffset, SEEK_SET);
+
+	PrefetchJob &job = _prefetchJobs[_prefetchSubmitted % kPrefetchJobs];
+	job.id = res->_id;
+	job.packed = NULL;
+	job.data = NULL;
+
+	int error = res->readResourceInfo(_volVersion, fileStream, job.packedSize, job.compression);
+	if (!error) {
+		job.size = res->size;
+		job.packed = new byte[job.packedSize];
+		if (fileStream->read(job.packed, job.packedSize) != job.packedSize)
+			error = SCI_ERROR_IO_ERROR;
+	}
+
+	if (res->_source->_resourceFile)
+		delete fileStream;
+
+	if (error) {
+		warning("Error %d occurred while reading %s from resource file %s: %s",
+				error, res->_id.toString().c_str(), res->getResourceLocation().c_str(),
+				s_errorDescriptions[error]);
+		delete[] job.packed;
+		res->unalloc();
+		return true;
+	}
+
+	res->_prefetchJob = _prefetchSubmitted++;
+	_prefetchStart.post();
+	return true;
+}
+
+void ResourceManager::adoptPrefetchJobs(int32 lastJob) {
+	while (_prefetchAdopted < _prefetchSubmitted) {
+		if (Common::atomicLoad(&_prefetchFinished) <= _prefetchAdopted) {
+			if (_prefetchAdopted > lastJob)
+				break;
+			_prefetchDone.wait();
+			continue;
+		}
+
+		PrefetchJob &job = _prefetchJobs[_prefetchAdopted % kPrefetchJobs];
+		Resource *res = testResource(job.id);
+
+		// The resource may have been loaded or replaced by a patch meanwhile
+		if (res && res->_prefetchJob == _prefetchAdopted) {
+			res->_prefetchJob = -1;
+			if (job.error) {
+				warning("Error %d occurred while decompressing %s from resource file %s: %s",
+						job.error, res->_id.toString().c_str(), res->getResourceLocation().c_str(),
+						s_errorDescriptions[job.error]);
+			} else if (res->_status == kResStatusNoMalloc) {
+				res->data = job.data;
+				res->size = job.size;
+				res->_status = kResStatusAllocated;
+				job.data = NULL;
+
+				res->_prefetched = true;
+				_cacheStats[getCacheClass(res->getType())].prefetches++;
+				addToLRU(res);
+				freeOldResources();
+			}
+		}
+
+		delete[] job.packed;
+		delete[] job.data;
+		_prefetchAdopted++;
 	}
 }
 
@@ -1040,10 +1310,24 @@ Resource *ResourceManager::findResource(ResourceId id, bool lock) {
 	if (!retval)
 		return NULL;
 
-	if (retval->_status == kResStatusNoMalloc)
+	// Rather than decompressing it a second time, wait for the prefetch
+	// thread to finish the resource
+	if (retval->_prefetchJob != -1)
+		adoptPrefetchJobs(retval->_prefetchJob);
+
+	ResourceCacheStatistics &stats = _cacheStats[getCacheClass(retval->getType())];
+	if (retval->_status == kResStatusNoMalloc) {
+		stats.misses++;
 		loadResource(retval);
-	else if (retval->_status == kResStatusEnqueued)
-		removeFromLRU(retval);
+	} else {
+		stats.hits++;
+		if (retval->_prefetched) {
+			stats.prefetchHits++;
+			retval->_prefetched = false;
+		}
+		if (retval->_status == kResStatusEnqueued)
+			removeFromLRU(retval);
+	}
 	// Unless an error occurred, the resource is now either
 	// locked or allocated, but never queued or freed.
 
@@ -1839,6 +2123,7 @@ Resource *ResourceManager::updateResource(ResourceId resId, ResourceSource *src,
 	}
 
 	res->_status = kResStatusNoMalloc;
+	res->_prefetchJob = -1;	// Drop what the prefetch thread read from the old source
 	res->_source = src;
 	res->_headerSize = 0;
 	res->size = size;
@@ -1947,40 +2232,41 @@ int Resource::readResourceInfo(ResVersion volVersion, Common::SeekableReadStream
 	return (compression == kCompUnknown) ? SCI_ERROR_UNKNOWN_COMPRESSION : SCI_ERROR_NONE;
 }
 
-int Resource::decompress(ResVersion volVersion, Common::SeekableReadStream *file) {
-	int errorNum;
-	uint32 szPacked = 0;
-	ResourceCompression compression = kCompUnknown;
-
-	// fill resource info
-	errorNum = readResourceInfo(volVersion, file, szPacked, compression);
-	if (errorNum)
-		return errorNum;
-
-	// getting a decompressor
-	Decompressor *dec = NULL;
+Decompressor *Resource::createDecompressor(ResourceCompression compression) {
 	switch (compression) {
 	case kCompNone:
-		dec = new Decompressor;
-		break;
+		return new Decompressor;
 	case kCompHuffman:
-		dec = new DecompressorHuffman;
-		break;
+		return new DecompressorHuffman;
 	case kCompLZW:
 	case kCompLZW1:
 	case kCompLZW1View:
 	case kCompLZW1Pic:
-		dec = new DecompressorLZW(compression);
-		break;
+		return new DecompressorLZW(compression);
 	case kCompDCL:
-		dec = new DecompressorDCL;
-		break;
+		return new DecompressorDCL;
 #ifdef ENABLE_SCI32
 	case kCompSTACpack:
-		dec = new DecompressorLZS;
-		break;
+		return new DecompressorLZS;
 #endif
 	default:
+		return NULL;
+	}
+}
+
+int Resource::decompress(ResVersion volVersion, Common::SeekableReadStream *file) {
+	int errorNum;
+	uint32 szPacked = 0;
+	ResourceCompression compression = kCompUnknown;
+
+	// fill resource info
+	errorNum = readResourceInfo(volVersion, file, szPacked, compression);
+	if (errorNum)
+		return errorNum;
+
+	// getting a decompressor
+	Decompressor *dec = createDecompressor(compression);
+	if (!dec) {
 		error("Resource %s: Compression method %d not supported", _id.toString().c_str(), compression);
 		return SCI_ERROR_UNKNOWN_COMPRESSION;
 	}
@@ -26,6 +26,8 @@
 #include "common/str.h"
 #include "common/list.h"
 #include "common/hashmap.h"
+#include "common/atomic.h"
+#include "common/thread.h"
 
 #include "sci/graphics/helpers.h"		// for ViewType
 #include "sci/decompressor.h"
@@ -119,6 +121,38 @@ enum ResourceType {
 
 const char *getResourceTypeName(ResourceType restype);
 
+/**
+ * The groups of resource types which the resource cache can give their own
+ * memory budget, see ResourceManager::setLRUBudget().
+ */
+enum ResourceCacheClass {
+	kResourceCacheView = 0,
+	kResourceCachePic,
+	kResourceCacheAudio,
+	kResourceCacheSync,
+	kResourceCacheScript,
+	kResourceCacheOther,
+
+	kResourceCacheClassCount
+};
+
+/**
+ * Statistics of one class of the resource cache, as shown by the
+ * resource_cache console command.
+ */
+struct ResourceCacheStatistics {
+	uint32 hits;         ///< lookups of resources which were in memory
+	uint32 misses;       ///< lookups of resources which had to be loaded
+	uint32 evictions;    ///< resources freed to stay within the budgets
+	uint32 prefetches;   ///< resources loaded before they were needed
+	uint32 prefetchHits; ///< prefetched resources which were then looked up
+
+	void reset() {
+		hits = misses = evictions = 0;
+		prefetches = prefetchHits = 0;
+	}
+};
+
 enum ResVersion {
 	kResVersionUnknown,
 	kResVersionSci0Sci1Early,
@@ -274,12 +308,26 @@ protected:
 	ResourceSource *_source;
 	ResourceManager *_resMan;
 
+	/**
+	 * Links of the LRU lists of the resource manager, indexed by
+	 * ResourceManager::LRULink
+	 */
+	Resource *_lruPrev[2];
+	Resource *_lruNext[2];
+
+	/** Loaded by a prefetch and not looked up since */
+	bool _prefetched;
+
+	/** Prefetch job decompressing the resource on the prefetch thread, or -1 */
+	int32 _prefetchJob;
+
 	bool loadPatch(Common::SeekableReadStream *file);
 	bool loadFromPatchFile();
 	bool loadFromWaveFile(Common::SeekableReadStream *file);
 	bool loadFromAudioVolumeSCI1(Common::SeekableReadStream *file);
 	bool loadFromAudioVolumeSCI11(Common::SeekableReadStream *file);
 	int decompress(ResVersion volVersion, Common::SeekableReadStream *file);
+	static Decompressor *createDecompressor(ResourceCompression compression);
 	int readResourceInfo(ResVersion volVersion, Common::SeekableReadStream *file, uint32 &szPacked, ResourceCompression &compression);
 };
 
@@ -362,6 +410,61 @@ public:
 	 */
 	Common::List<ResourceId> listResources(ResourceType type, int mapNumber = -1);
 
+	/**
+	 * Sets the amount of memory for resources which are not in use. The
+	 * least recently used ones are freed when it is exceeded.
+	 */
+	void setMaxMemoryLRU(int maxMemory) { _LRU.maxMemory = maxMemory; }
+	int getMaxMemoryLRU() const { return _LRU.maxMemory; }
+	int getMemoryLRU() const { return _LRU.memory; }
+
+	/**
+	 * Sets how much of the memory for resources which are not in use the
+	 * resources of one class may take, or 0 for no limit besides the overall
+	 * one.
+	 */
+	void setLRUBudget(ResourceCacheClass cacheClass, int maxMemory) { _classLRU[cacheClass].maxMemory = maxMemory; }
+	int getLRUBudget(ResourceCacheClass cacheClass) const { return _classLRU[cacheClass].maxMemory; }
+	int getLRUMemory(ResourceCacheClass cacheClass) const { return _classLRU[cacheClass].memory; }
+
+	static ResourceCacheClass getCacheClass(ResourceType type);
+	static const char *getCacheClassName(ResourceCacheClass cacheClass);
+	ResourceCacheStatistics &getCacheStatistics(ResourceCacheClass cacheClass) { return _cacheStats[cacheClass]; }
+
+	/**
+	 * Enables loading the resources of a room before the game needs them,
+	 * see prefetchRoom().
+	 */
+	void setPrefetchRooms(bool enable) { _prefetchRooms = enable; }
+	bool isPrefetchingRooms() const { return _prefetchRooms; }
+
+	/**
+	 * Called while the game waits for its next frame. When the room number
+	 * changes, queues the resources of the new room which are not loaded
+	 * yet, and loads queued resources until the deadline has passed.
+	 * @param roomNumber	The room the game is in or about to enter
+	 * @param deadline		Time at which the game wants to continue, as
+	 *						returned by OSystem::getMillis()
+	 */
+	void prefetchRoom(uint16 roomNumber, uint32 deadline);
+
+	/**
+	 * Decompresses resources from the volume files on a thread of their own,
+	 * so that prefetching them does not hold up the game, see
+	 * prefetchResource().
+	 * @return whether the thread is running
+	 */
+	bool setPrefetchThread(bool enable);
+	bool isPrefetchThreadRunning() const { return _prefetchThreadRunning; }
+	int getPendingPrefetchJobs() const { return _prefetchSubmitted - _prefetchAdopted; }
+
+	/**
+	 * Hints that the game is going to need a resource soon. If prefetching
+	 * is enabled, the resource is handed to the prefetch thread or else
+	 * loaded the next time the game waits for a frame, see prefetchRoom().
+	 */
+	void prefetchResource(ResourceId id);
+
 	void setAudioLanguage(int language);
 	int getAudioLanguage() const;
 	void changeAudioDirectory(Common::String path);
@@ -417,17 +520,84 @@ public:
 	ResourceType convertResType(byte type);
 
 protected:
-	// Maximum number of bytes to allow being allocated for resources
-	// Note: maxMemory will not be interpreted as a hard limit, only as a restriction
-	// for resources which are not explicitly locked. However, a warning will be
-	// issued whenever this limit is exceeded.
-	int _maxMemoryLRU;
+	/**
+	 * A list of the resources under LRU control, most recently used first.
+	 * The links are kept in the resources themselves, so that adding and
+	 * removing resources takes constant time.
+	 */
+	struct LRUList {
+		Resource *first;
+		Resource *last;
+		int memory;		///< Amount of resource bytes in the list
+		// Maximum number of bytes to allow being allocated for the resources
+		// in the list, or 0 for no limit.
+		// Note: maxMemory will not be interpreted as a hard limit, only as a
+		// restriction for resources which are not explicitly locked.
+		int maxMemory;
+	};
+
+	enum LRULink {
+		kLRULinkAll = 0,	///< Links of _LRU
+		kLRULinkClass = 1	///< Links of the _classLRU list of the resource
+	};
 
 	ViewType _viewType; // Used to determine if the game has EGA or VGA graphics
 	Common::List<ResourceSource *> _sources;
 	int _memoryLocked;	///< Amount of resource bytes in locked memory
-	int _memoryLRU;		///< Amount of resource bytes under LRU control
-	Common::List<Resource *> _LRU; ///< Last Resource Used list
+	LRUList _LRU; ///< Last Resource Used list of all resources
+	LRUList _classLRU[kResourceCacheClassCount]; ///< The same resources by class
+	ResourceCacheStatistics _cacheStats[kResourceCacheClassCount];
+
+	bool _prefetchRooms;
+	uint16 _prefetchedRoom;	///< Room whose resources were queued last
+	Common::List<ResourceId> _prefetchQueue;
+
+	/**
+	 * A resource decompressed by the prefetch thread. The main thread reads
+	 * the packed data from the volume file, the prefetch thread unpacks it,
+	 * and the main thread then hands the result to the resource.
+	 */
+	struct PrefetchJob {
+		ResourceId id;
+		ResourceCompression compression;
+		byte *packed;
+		uint32 packedSize;
+		byte *data;
+		uint32 size;
+		int error;
+	};
+
+	enum {
+		kPrefetchJobs = 16	///< Maximum number of jobs handed to the prefetch thread at a time
+	};
+
+	Common::Thread _prefetchThread;
+	bool _prefetchThreadRunning;
+	volatile bool _prefetchQuit;
+	Common::Semaphore _prefetchStart;	///< Posted for each job handed to the thread, and to quit
+	Common::Semaphore _prefetchDone;	///< Posted for each job the thread has finished
+	PrefetchJob _prefetchJobs[kPrefetchJobs];	///< Ring of the jobs, indexed by job number
+	int32 _prefetchSubmitted;	///< Number of jobs handed to the thread
+	int32 _prefetchAdopted;		///< Number of jobs whose results were taken over
+	Common::AtomicInt32 _prefetchFinished;	///< Number of jobs finished by the thread
+
+	static void prefetchThreadProc(void *param);
+	bool isPrefetching() const { return _prefetchRooms || _prefetchThreadRunning; }
+	bool canSubmitPrefetchJob() const { return _prefetchThreadRunning && getPendingPrefetchJobs() < kPrefetchJobs; }
+
+	/**
+	 * Reads the packed data of a resource and hands it to the prefetch
+	 * thread.
+	 * @return false if the resource cannot be decompressed on the thread
+	 */
+	bool submitPrefetchJob(Resource *res);
+
+	/**
+	 * Takes over the resources decompressed by the prefetch thread, all
+	 * jobs up to and including the given one, waiting for them if needed,
+	 * or else the ones finished already.
+	 */
+	void adoptPrefetchJobs(int32 lastJob = -1);
 	ResourceMap _resMap;
 	Common::List<Common::File *> _volumeFiles; ///< list of opened volume files
 	ResourceSource *_audioMapSCI1; ///< Currently loaded audio map for SCI1
@@ -547,6 +717,9 @@ protected:
 	void printLRU();
 	void addToLRU(Resource *res);
 	void removeFromLRU(Resource *res);
+	void linkLRU(LRUList &list, LRULink link, Resource *res);
+	void unlinkLRU(LRUList &list, LRULink link, Resource *res);
+	void freeLRUResource(Resource *res);
 
 	ResourceCompression getViewCompression();
 	ViewType detectViewType();
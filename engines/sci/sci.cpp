@@ -196,10 +196,32 @@ SciEngine::~SciEngine() {
 	delete[] _opcode_formats;
 
 	delete _scriptPatcher;
+	freePathfindingCache();
 	delete _resMan;	// should be deleted last
 	g_sci = 0;
 }
 
+void SciEngine::configureResourceCache() {
+	// All sizes are in KB
+	if (ConfMan.hasKey("lru_size"))
+		_resMan->setMaxMemoryLRU(MAX(ConfMan.getInt("lru_size"), 0) * 1024);
+
+	static const char *const budgetKeys[] = {
+		"lru_views", "lru_pics", "lru_audio", "lru_sync", "lru_scripts"
+	};
+	for (int i = 0; i < ARRAYSIZE(budgetKeys); i++) {
+		if (ConfMan.hasKey(budgetKeys[i]))
+			_resMan->setLRUBudget((ResourceCacheClass)i, MAX(ConfMan.getInt(budgetKeys[i]), 0) * 1024);
+	}
+
+	if (ConfMan.hasKey("prefetch_rooms"))
+		_resMan->setPrefetchRooms(ConfMan.getBool("prefetch_rooms"));
+	if (ConfMan.hasKey("prefetch_thread") && ConfMan.getBool("prefetch_thread")) {
+		if (!_resMan->setPrefetchThread(true))
+			warning("Resources cannot be decompressed in the background on this system");
+	}
+}
+
 extern void showScummVMDialog(const Common::String &message);
 
 Common::Error SciEngine::run() {
@@ -207,6 +229,7 @@ Common::Error SciEngine::run() {
 	assert(_resMan);
 	_resMan->addAppropriateSources();
 	_resMan->init();
+	configureResourceCache();
 
 	// TODO: Add error handling. Check return values of addAppropriateSources
 	// and init. We first have to *add* sensible return values, though ;).
@@ -343,6 +343,9 @@ public:
 	// Initializes ports and paint16 for non-sci32 games, also sets default palette
 	void initGraphics();
 
+	// Applies the resource cache budgets and options of the configuration
+	void configureResourceCache();
+
 public:
 	GfxAnimate *_gfxAnimate; // Animate for 16-bit gfx
 	GfxCache *_gfxCache;
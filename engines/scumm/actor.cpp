@@ -1634,9 +1634,20 @@ AdjustBoxResult Actor::adjustXYToBeInBox(int dstX, int dstY) {
 		bestDist = (_vm->_game.version >= 7) ? 0x7FFFFFFF : 0xFFFF;
 		bestBox = kInvalidBox;
 
+		// With a threshold, only the boxes near the coordinates can pass
+		// the quick test below, so we only need to look at those.
+		const byte *nearBoxes = NULL;
+		int count = numBoxes - firstValidBox + 1;
+		if (threshold > 0)
+			nearBoxes = _vm->getBoxesNear(dstX, dstY, count);
+
 		// We iterate (backwards) over all boxes, searching the one closest
 		// to the desired coordinates.
-		for (box = numBoxes; box >= firstValidBox; box--) {
+		for (int i = 0; i < count; i++) {
+			box = nearBoxes ? nearBoxes[i] : numBoxes - i;
+			if (box < firstValidBox)
+				continue;
+
 			flags = _vm->getBoxFlags(box);
 
 			// Skip over invisible boxes
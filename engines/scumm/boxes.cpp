@@ -572,6 +572,157 @@ bool ScummEngine::checkXYInBoxBounds(int boxnum, int x, int y) {
 }
 
 BoxCoords ScummEngine::getBoxCoordinates(int boxnum) {
+	const BoxIndex *index = getBoxIndex();
+	if (boxnum >= 0 && boxnum < index->numBoxes)
+		return index->coords[boxnum];
+
+	// Let readBoxCoordinates apply its workarounds and checks
+	return readBoxCoordinates(boxnum);
+}
+
+namespace {
+
+/** Bounding rectangle of a walkbox, inclusive, in int to avoid overflows */
+struct BoxBounds {
+	int left, top, right, bottom;
+};
+
+} // End of anonymous namespace
+
+/**
+ * Return the index of the walkboxes of the current room, rebuilding it
+ * first if the boxes have changed since it was last built.
+ */
+BoxIndex *ScummEngine::getBoxIndex() {
+	BoxIndex &index = *_boxIndex;
+	const uint32 generation = _res->_types[rtMatrix]._generation;
+	if (index.generation == generation && index.roomWidth == _roomWidth && index.roomHeight == _roomHeight)
+		return &index;
+
+	index.generation = generation;
+	index.roomWidth = _roomWidth;
+	index.roomHeight = _roomHeight;
+	index.builds++;
+	index.hasNextBoxes = false;
+	index.nextBoxes.clear();
+	index.truncatedRows.clear();
+
+	const int num = getNumBoxes();
+	index.numBoxes = num;
+	index.coords.resize(num);
+	for (int i = 0; i < num; i++)
+		index.coords[i] = readBoxCoordinates(i);
+
+	index.cellStart.clear();
+	index.cellBoxes.clear();
+	index.outsideBoxes.clear();
+	if (num == 0) {
+		index.gridLeft = index.gridTop = 0;
+		index.gridWidth = index.gridHeight = 0;
+		index.cellStart.push_back(0);
+		return &index;
+	}
+
+	// The grid covers the room, grown by the largest distance at which a
+	// box is still considered to be near a point. Some boxes lie far
+	// outside the room, e.g. the ones actors are put into to hide them, so
+	// sizing the grid by all boxes could make it huge.
+	const int left = -BoxIndex::kNearDistance;
+	const int top = -BoxIndex::kNearDistance;
+	const int right = MAX(_roomWidth, 1) - 1 + BoxIndex::kNearDistance;
+	const int bottom = MAX(_roomHeight, 1) - 1 + BoxIndex::kNearDistance;
+
+	// Compute the bounding rectangles of the boxes, grown by that distance
+	// and clipped to the grid. A point outside the grid is further than
+	// that from the room, so only boxes reaching out of it can be near it.
+	Common::Array<BoxBounds> bounds;
+	bounds.resize(num);
+	for (int i = num - 1; i >= 0; i--) {
+		const BoxCoords &box = index.coords[i];
+		BoxBounds &r = bounds[i];
+		r.left = MIN(MIN(box.ul.x, box.ur.x), MIN(box.ll.x, box.lr.x));
+		r.top = MIN(MIN(box.ul.y, box.ur.y), MIN(box.ll.y, box.lr.y));
+		r.right = MAX(MAX(box.ul.x, box.ur.x), MAX(box.ll.x, box.lr.x));
+		r.bottom = MAX(MAX(box.ul.y, box.ur.y), MAX(box.ll.y, box.lr.y));
+
+		if (r.left < 0 || r.top < 0 || r.right >= _roomWidth || r.bottom >= _roomHeight)
+			index.outsideBoxes.push_back(i);
+
+		r.left = MAX(r.left - BoxIndex::kNearDistance, left);
+		r.top = MAX(r.top - BoxIndex::kNearDistance, top);
+		r.right = MIN(r.right + BoxIndex::kNearDistance, right);
+		r.bottom = MIN(r.bottom + BoxIndex::kNearDistance, bottom);
+	}
+
+	index.gridLeft = left;
+	index.gridTop = top;
+	index.gridWidth = ((right - left) >> BoxIndex::kCellShift) + 1;
+	index.gridHeight = ((bottom - top) >> BoxIndex::kCellShift) + 1;
+
+	// Count the boxes of each cell, then fill in the lists. Going through
+	// the boxes backwards leaves each list in descending order.
+	const int numCells = index.gridWidth * index.gridHeight;
+	index.cellStart.resize(numCells + 1);
+	for (int i = 0; i <= numCells; i++)
+		index.cellStart[i] = 0;
+
+	for (int pass = 0; pass < 2; pass++) {
+		for (int i = num - 1; i >= 0; i--) {
+			const BoxBounds &r = bounds[i];
+			if (r.left > r.right || r.top > r.bottom)
+				continue;
+
+			const int x1 = (r.left - left) >> BoxIndex::kCellShift;
+			const int x2 = (r.right - left) >> BoxIndex::kCellShift;
+			const int y1 = (r.top - top) >> BoxIndex::kCellShift;
+			const int y2 = (r.bottom - top) >> BoxIndex::kCellShift;
+			for (int y = y1; y <= y2; y++) {
+				for (int x = x1; x <= x2; x++) {
+					const int cell = y * index.gridWidth + x;
+					if (pass == 0)
+						index.cellStart[cell + 1]++;
+					else
+						index.cellBoxes[index.cellStart[cell]++] = i;
+				}
+			}
+		}
+
+		if (pass == 0) {
+			for (int i = 0; i < numCells; i++)
+				index.cellStart[i + 1] += index.cellStart[i];
+			index.cellBoxes.resize(index.cellStart[numCells]);
+		} else {
+			// Filling in moved each start to the start of the next cell
+			for (int i = numCells; i > 0; i--)
+				index.cellStart[i] = index.cellStart[i - 1];
+			index.cellStart[0] = 0;
+		}
+	}
+
+	return &index;
+}
+
+/**
+ * Return the boxes which might be within BoxIndex::kNearDistance pixels
+ * of the given point, in descending order. All other boxes are certainly
+ * further away.
+ */
+const byte *ScummEngine::getBoxesNear(int x, int y, int &count) {
+	const BoxIndex *index = getBoxIndex();
+	const int cellX = (x - index->gridLeft) >> BoxIndex::kCellShift;
+	const int cellY = (y - index->gridTop) >> BoxIndex::kCellShift;
+
+	if (x < index->gridLeft || y < index->gridTop || cellX >= index->gridWidth || cellY >= index->gridHeight) {
+		count = index->outsideBoxes.size();
+		return count ? &index->outsideBoxes[0] : NULL;
+	}
+
+	const int cell = cellY * index->gridWidth + cellX;
+	count = index->cellStart[cell + 1] - index->cellStart[cell];
+	return count ? &index->cellBoxes[index->cellStart[cell]] : NULL;
+}
+
+BoxCoords ScummEngine::readBoxCoordinates(int boxnum) {
 	BoxCoords tmp, *box = &tmp;
 	Box *bp = getBoxBaseAddr(boxnum);
 	assert(bp);
@@ -700,9 +851,7 @@ byte *ScummEngine::getBoxMatrixBaseAddr() {
  */
 int ScummEngine::getNextBox(byte from, byte to) {
 	const byte *boxm;
-	byte i;
 	const int numOfBoxes = getNumBoxes();
-	int dest = -1;
 
 	if (from == to)
 		return to;
@@ -718,22 +867,7 @@ int ScummEngine::getNextBox(byte from, byte to) {
 
 	boxm = getBoxMatrixBaseAddr();
 
-	if (_game.version == 0) {
-		// calculate shortest paths
-		byte *itineraryMatrix = (byte *)malloc(numOfBoxes * numOfBoxes);
-		calcItineraryMatrix(itineraryMatrix, numOfBoxes);
-
-		dest = to;
-		do {
-			dest = itineraryMatrix[numOfBoxes * from + dest];
-		} while (dest != Actor::kInvalidBox && !areBoxesNeighbors(from, dest));
-
-		if (dest == Actor::kInvalidBox)
-			dest = -1;
-
-		free(itineraryMatrix);
-		return dest;
-	} else if (_game.version <= 2) {
+	if (_game.version == 1 || _game.version == 2) {
 		// The v2 box matrix is a real matrix with numOfBoxes rows and columns.
 		// The first numOfBoxes bytes contain indices to the start of the corresponding
 		// row (although that seems unnecessary to me - the value is easily computable.
@@ -741,6 +875,35 @@ int ScummEngine::getNextBox(byte from, byte to) {
 		return (int8)boxm[to];
 	}
 
+	// WORKAROUND #2: In addition to the truncated box matrix (see
+	// findNextBoxInMatrix), we have to add this special case to fix the
+	// scene in Indy3 where Indy meets Hitler in Berlin.
+	// See bug #770690 and also bug #774783.
+	if ((_game.id == GID_INDY3) && _roomResource == 46 && from == 1 && to == 0)
+		return 0;
+
+	// Searching the compressed matrix (or computing the shortest paths in
+	// v0) for every step of every walk is slow, so look up all pairs at once
+	BoxIndex *index = getBoxIndex();
+	if (!index->hasNextBoxes)
+		buildNextBoxes();
+
+	if (index->truncatedRows[from])
+		debug(0, "The box matrix apparently is truncated (room %d)", _roomResource);
+
+	return index->nextBoxes[from * numOfBoxes + to];
+}
+
+/**
+ * Search the compressed box matrix of v3+ games for the next box on the way
+ * from box 'from' to box 'to'. This is what getNextBox looks up.
+ */
+int ScummEngine::findNextBoxInMatrix(byte from, byte to, bool &truncated) {
+	assert(_game.version >= 3);
+	const byte *boxm = getBoxMatrixBaseAddr();
+	int dest = -1;
+	byte i;
+
 	// WORKAROUND #1: It seems that in some cases, the box matrix is corrupt
 	// (more precisely, is too short) in the datafiles already. In
 	// particular this seems to be the case in room 46 of Indy3 EGA (see
@@ -754,12 +917,6 @@ int ScummEngine::getNextBox(byte from, byte to) {
 	// resource, and abort the search once we reach the end.
 	const byte *end = boxm + getResourceSize(rtMatrix, 1);
 
-	// WORKAROUND #2: In addition to the above, we have to add this special
-	// case to fix the scene in Indy3 where Indy meets Hitler in Berlin.
-	// See bug #770690 and also bug #774783.
-	if ((_game.id == GID_INDY3) && _roomResource == 46 && from == 1 && to == 0)
-		return 0;
-
 	// Skip up to the matrix data for box 'from'
 	for (i = 0; i < from && boxm < end; i++) {
 		while (boxm < end && *boxm != 0xFF)
@@ -774,12 +931,69 @@ int ScummEngine::getNextBox(byte from, byte to) {
 		boxm += 3;
 	}
 
-	if (boxm >= end)
-		debug(0, "The box matrix apparently is truncated (room %d)", _roomResource);
-
+	truncated = (boxm >= end);
 	return dest;
 }
 
+void ScummEngine::buildNextBoxes() {
+	BoxIndex &index = *_boxIndex;
+	const int num = index.numBoxes;
+
+	index.nextBoxBuilds++;
+	index.nextBoxes.resize(num * num);
+	index.truncatedRows.resize(num);
+	for (int i = 0; i < num * num; i++)
+		index.nextBoxes[i] = -1;
+	for (int i = 0; i < num; i++)
+		index.truncatedRows[i] = false;
+
+	if (_game.version == 0) {
+		// calculate shortest paths
+		byte *itineraryMatrix = (byte *)malloc(num * num);
+		calcItineraryMatrix(itineraryMatrix, num);
+
+		for (int from = 0; from < num; from++) {
+			for (int to = 0; to < num; to++) {
+				// getNextBox handles this case itself, and the loop below
+				// need not terminate for it
+				if (from == to)
+					continue;
+
+				int dest = to;
+				int steps = 0;
+				do {
+					dest = itineraryMatrix[num * from + dest];
+				} while (dest != Actor::kInvalidBox && !areBoxesNeighbors(from, dest) && ++steps < num);
+
+				if (dest != Actor::kInvalidBox && steps < num)
+					index.nextBoxes[from * num + to] = dest;
+			}
+		}
+
+		free(itineraryMatrix);
+	} else {
+		// Walk through the matrix just like findNextBoxInMatrix does, but
+		// fill in a whole row at once. Later entries override earlier ones.
+		const byte *boxm = getBoxMatrixBaseAddr();
+		const byte *end = boxm + getResourceSize(rtMatrix, 1);
+
+		for (int from = 0; from < num; from++) {
+			int8 *row = &index.nextBoxes[from * num];
+			while (boxm < end && boxm[0] != 0xFF) {
+				for (int to = boxm[0]; to <= boxm[1] && to < num; to++)
+					row[to] = (int8)boxm[2];
+				boxm += 3;
+			}
+
+			index.truncatedRows[from] = (boxm >= end);
+			if (boxm < end)
+				boxm++;
+		}
+	}
+
+	index.hasNextBoxes = true;
+}
+
 /*
  * Computes the next point actor a has to walk towards in a straight
  * line in order to get from box1 to box3 via box2.
@@ -23,6 +23,7 @@
 #ifndef SCUMM_BOXES_H
 #define SCUMM_BOXES_H
 
+#include "common/array.h"
 #include "common/rect.h"
 
 namespace Scumm {
@@ -51,6 +52,58 @@ struct BoxCoords {			/* Box coordinates */
 
 int getClosestPtOnBox(const BoxCoords &box, int x, int y, int16& outX, int16& outY);
 
+/**
+ * Data derived from the walkboxes and the box matrix of the current room.
+ * It is rebuilt whenever one of the rtMatrix resources changes.
+ */
+struct BoxIndex {
+	enum {
+		kCellShift = 5,			///< The grid cells are 32x32 pixels
+		kNearDistance = 80		///< The largest threshold used by Actor::adjustXYToBeInBox
+	};
+
+	/** rtMatrix generation the index was built for, or 0 if none */
+	uint32 generation;
+	int numBoxes;
+
+	/** Decoded coordinates of all boxes */
+	Common::Array<BoxCoords> coords;
+
+	/** Size of the room the index was built for */
+	int roomWidth, roomHeight;
+
+	/**
+	 * For each grid cell, the boxes whose bounding rectangle grown by
+	 * kNearDistance intersects the cell, in descending order. The boxes of
+	 * cell i are cellBoxes[cellStart[i]] to cellBoxes[cellStart[i + 1] - 1].
+	 * The grid covers the room grown by kNearDistance.
+	 */
+	int gridLeft, gridTop, gridWidth, gridHeight;
+	Common::Array<uint32> cellStart;
+	Common::Array<byte> cellBoxes;
+
+	/**
+	 * The boxes which are not entirely within the room, in descending
+	 * order. Only they can be near points outside the grid.
+	 */
+	Common::Array<byte> outsideBoxes;
+
+	/**
+	 * The result of getNextBox() for all pairs of boxes, nextBoxes[from *
+	 * numBoxes + to]. It is computed on first use.
+	 */
+	bool hasNextBoxes;
+	Common::Array<int8> nextBoxes;
+	/** Rows which ran past the end of the box matrix */
+	Common::Array<bool> truncatedRows;
+
+	uint32 builds;
+	uint32 nextBoxBuilds;
+
+	BoxIndex() : generation(0), numBoxes(0), roomWidth(0), roomHeight(0), gridLeft(0), gridTop(0), gridWidth(0), gridHeight(0),
+		hasNextBoxes(false), builds(0), nextBoxBuilds(0) {}
+};
+
 } // End of namespace Scumm
 
 #endif
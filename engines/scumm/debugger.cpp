@@ -37,6 +37,8 @@
 
 namespace Scumm {
 
+extern const char *nameOfResType(ResType type);
+
 void debugC(int channel, const char *s, ...) {
 	char buf[STRINGBUFLEN];
 	va_list va;
@@ -71,7 +73,10 @@ ScummDebugger::ScummDebugger(ScummEngine *s)
 	registerCmd("actors",    WRAP_METHOD(ScummDebugger, Cmd_PrintActor));
 	registerCmd("box",       WRAP_METHOD(ScummDebugger, Cmd_PrintBox));
 	registerCmd("matrix",    WRAP_METHOD(ScummDebugger, Cmd_PrintBoxMatrix));
+	registerCmd("boxindex",  WRAP_METHOD(ScummDebugger, Cmd_BoxIndex));
 	registerCmd("camera",    WRAP_METHOD(ScummDebugger, Cmd_Camera));
+	registerCmd("stripcache", WRAP_METHOD(ScummDebugger, Cmd_StripCache));
+	registerCmd("rescache",  WRAP_METHOD(ScummDebugger, Cmd_ResourceCache));
 	registerCmd("room",      WRAP_METHOD(ScummDebugger, Cmd_Room));
 	registerCmd("objects",   WRAP_METHOD(ScummDebugger, Cmd_PrintObjects));
 	registerCmd("object",    WRAP_METHOD(ScummDebugger, Cmd_Object));
@@ -542,6 +547,67 @@ bool ScummDebugger::Cmd_Camera(int argc, const char **argv) {
 	return true;
 }
 
+bool ScummDebugger::Cmd_StripCache(int argc, const char **argv) {
+	Gdi::StripCacheStats &stats = _vm->_gdi->_stripCacheStats;
+
+	if (argc > 1) {
+		if (!strcmp(argv[1], "reset")) {
+			stats.reset();
+			debugPrintf("Strip cache statistics reset\n");
+		} else {
+			debugPrintf("Usage: %s [reset]\n", argv[0]);
+		}
+		return true;
+	}
+
+	const uint32 total = stats.hits + stats.misses + stats.uncached;
+	debugPrintf("Room background strips: %d drawn, %d from the cache, %d decoded into it, %d not cacheable\n",
+		total, stats.hits, stats.misses, stats.uncached);
+	if (total)
+		debugPrintf("Hit rate: %d%%\n", stats.hits * 100 / total);
+	debugPrintf("Cache flushes: %d, size: %d KB\n", stats.flushes, _vm->_gdi->getStripCacheSize() / 1024);
+
+	return true;
+}
+
+bool ScummDebugger::Cmd_ResourceCache(int argc, const char **argv) {
+	ResourceManager *res = _vm->_res;
+
+	if (argc > 1) {
+		if (!strcmp(argv[1], "reset")) {
+			for (ResType type = rtFirst; type <= rtLast; type = ResType(type + 1))
+				res->_cacheStats[type].reset();
+			debugPrintf("Resource cache statistics reset\n");
+		} else {
+			debugPrintf("Usage: %s [reset]\n", argv[0]);
+		}
+		return true;
+	}
+
+	debugPrintf("Loaded: %d of %d KB, compressed copies: %d of %d KB\n",
+		res->getAllocatedSize() / 1024, res->getMaxHeapThreshold() / 1024,
+		res->getCompressedAllocatedSize() / 1024, res->getMaxCompressedThreshold() / 1024);
+	debugPrintf("%-12s %6s %6s %6s %6s %6s %6s %8s\n", "Type", "Hits", "Misses", "Expire", "Kept", "Evict", "Copies", "KB");
+
+	for (ResType type = rtFirst; type <= rtLast; type = ResType(type + 1)) {
+		const ResourceManager::CacheStats &stats = res->_cacheStats[type];
+		int copies = 0;
+		uint32 copySize = 0;
+		for (ResId idx = 0; idx < res->_types[type].size(); idx++) {
+			if (res->_types[type][idx]._compressedAddress) {
+				copies++;
+				copySize += res->_types[type][idx]._compressedSize;
+			}
+		}
+
+		if (stats.hits || stats.misses || stats.expired || copies)
+			debugPrintf("%-12s %6d %6d %6d %6d %6d %6d %8d\n", nameOfResType(type),
+				stats.hits, stats.misses, stats.expired, stats.compressed, stats.evicted, copies, copySize / 1024);
+	}
+
+	return true;
+}
+
 bool ScummDebugger::Cmd_PrintBox(int argc, const char **argv) {
 	int num, i = 0;
 
@@ -582,6 +648,117 @@ bool ScummDebugger::Cmd_PrintBoxMatrix(int argc, const char **argv) {
 	return true;
 }
 
+/** Find the topmost box containing the point, like getSpecialBox does. */
+static int findBoxAt(ScummEngine *vm, int x, int y, bool useIndex) {
+	if (useIndex) {
+		int count;
+		const byte *nearBoxes = vm->getBoxesNear(x, y, count);
+		for (int i = 0; i < count; i++) {
+			if (vm->checkXYInBoxBounds(nearBoxes[i], x, y))
+				return nearBoxes[i];
+		}
+	} else {
+		for (int box = vm->getNumBoxes() - 1; box >= 0; box--) {
+			if (vm->checkXYInBoxBounds(box, x, y))
+				return box;
+		}
+	}
+	return -1;
+}
+
+bool ScummDebugger::Cmd_BoxIndex(int argc, const char **argv) {
+	if (argc > 3 || (argc > 1 && strcmp(argv[1], "bench"))) {
+		debugPrintf("Usage: %s [bench [passes]]\n", argv[0]);
+		return true;
+	}
+
+	BoxIndex *index = _vm->getBoxIndex();
+	const int num = index->numBoxes;
+	debugPrintf("%d walk boxes, %d x %d grid cells with %d box entries, %d boxes outside the room\n",
+		num, index->gridWidth, index->gridHeight, index->cellBoxes.size(), index->outsideBoxes.size());
+	debugPrintf("Index built %d times, next boxes computed %d times\n", index->builds, index->nextBoxBuilds);
+
+	if (argc < 2 || num == 0)
+		return true;
+
+	const int passes = (argc > 2) ? MAX(atoi(argv[2]), 1) : 100;
+	uint32 startTime;
+
+	// Rebuilding the index as after a room change
+	startTime = g_system->getMillis();
+	for (int pass = 0; pass < passes; pass++) {
+		index->generation = 0;
+		_vm->getBoxIndex();
+		if (_vm->_game.version == 0 || _vm->_game.version >= 3)
+			_vm->buildNextBoxes();
+	}
+	debugPrintf("Building the index: %d ms for %d passes\n", g_system->getMillis() - startTime, passes);
+
+	// Next boxes from the table and from the compressed matrix
+	if (_vm->_game.version >= 3) {
+		int mismatches = 0;
+		for (int from = 0; from < num; from++) {
+			for (int to = 0; to < num; to++) {
+				bool truncated;
+				if (from != to && index->nextBoxes[from * num + to] != _vm->findNextBoxInMatrix(from, to, truncated))
+					mismatches++;
+			}
+		}
+
+		startTime = g_system->getMillis();
+		for (int pass = 0; pass < passes; pass++) {
+			for (int from = 0; from < num; from++) {
+				for (int to = 0; to < num; to++)
+					_vm->getNextBox(from, to);
+			}
+		}
+		const uint32 tableTime = g_system->getMillis() - startTime;
+
+		startTime = g_system->getMillis();
+		for (int pass = 0; pass < passes; pass++) {
+			for (int from = 0; from < num; from++) {
+				for (int to = 0; to < num; to++) {
+					bool truncated;
+					_vm->findNextBoxInMatrix(from, to, truncated);
+				}
+			}
+		}
+		const uint32 matrixTime = g_system->getMillis() - startTime;
+
+		debugPrintf("Next box for all pairs: %d ms from the table, %d ms from the box matrix, %d mismatches\n",
+			tableTime, matrixTime, mismatches);
+	}
+
+	// Point in box queries over the whole room
+	int mismatches = 0;
+	int found = 0;
+	for (int y = 0; y < _vm->_roomHeight; y += 4) {
+		for (int x = 0; x < _vm->_roomWidth; x += 4) {
+			const int box = findBoxAt(_vm, x, y, false);
+			if (box != findBoxAt(_vm, x, y, true))
+				mismatches++;
+			if (box >= 0)
+				found++;
+		}
+	}
+
+	uint32 times[2];
+	for (int useIndex = 0; useIndex < 2; useIndex++) {
+		startTime = g_system->getMillis();
+		for (int pass = 0; pass < passes; pass++) {
+			for (int y = 0; y < _vm->_roomHeight; y += 4) {
+				for (int x = 0; x < _vm->_roomWidth; x += 4)
+					findBoxAt(_vm, x, y, useIndex != 0);
+			}
+		}
+		times[useIndex] = g_system->getMillis() - startTime;
+	}
+	debugPrintf("Point in box for every 4th pixel: %d ms with the index, %d ms over all boxes, %d points in boxes, %d mismatches\n",
+		times[1], times[0], found, mismatches);
+
+	return true;
+}
+
 void ScummDebugger::printBox(int box) {
 	if (box < 0 || box >= _vm->getNumBoxes()) {
 		debugPrintf("%d is not a valid box!\n", box);
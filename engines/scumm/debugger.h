@@ -49,9 +49,12 @@ private:
 	bool Cmd_PrintActor(int argc, const char **argv);
 	bool Cmd_PrintBox(int argc, const char **argv);
 	bool Cmd_PrintBoxMatrix(int argc, const char **argv);
+	bool Cmd_BoxIndex(int argc, const char **argv);
 	bool Cmd_PrintObjects(int argc, const char **argv);
 	bool Cmd_Actor(int argc, const char **argv);
 	bool Cmd_Camera(int argc, const char **argv);
+	bool Cmd_StripCache(int argc, const char **argv);
+	bool Cmd_ResourceCache(int argc, const char **argv);
 	bool Cmd_Object(int argc, const char **argv);
 	bool Cmd_Script(int argc, const char **argv);
 	bool Cmd_PrintScript(int argc, const char **argv);
@@ -215,9 +215,16 @@ Gdi::Gdi(ScummEngine *vm) : _vm(vm) {
 	_zbufferDisabled = false;
 	_objectMode = false;
 	_distaff = false;
+
+	_cacheStrips = false;
+	_stripCacheRoom = -1;
+	_stripCacheHeight = 0;
+	memset(_stripCachePalette, 0, sizeof(_stripCachePalette));
+	_stripCacheStats.reset();
 }
 
 Gdi::~Gdi() {
+	clearStripCache();
 }
 
 GdiHE::GdiHE(ScummEngine *vm) : Gdi(vm), _tmskPtr(0) {
@@ -1008,7 +1015,7 @@ void ScummEngine::redrawBGStrip(int start, int num) {
 	else
 		room = getResourceAddress(rtRoom, _roomResource);
 
-	_gdi->drawBitmap(room + _IM00_offs, &_virtscr[kMainVirtScreen], s, 0, _roomWidth, _virtscr[kMainVirtScreen].h, s, num, 0);
+	_gdi->drawBitmap(room + _IM00_offs, &_virtscr[kMainVirtScreen], s, 0, _roomWidth, _virtscr[kMainVirtScreen].h, s, num, Gdi::dbCacheStrips);
 }
 
 void ScummEngine::restoreBackground(Common::Rect rect, byte backColor) {
@@ -1793,6 +1800,11 @@ void Gdi::drawBitmap(const byte *ptr, VirtScreen *vs, int x, const int y, const
 	_vertStripNextInc = height * vs->pitch - 1 * vs->format.bytesPerPixel;
 
 	_objectMode = (flag & dbObjectMode) == dbObjectMode;
+
+	// HE games can draw into their room images, so only the images of the
+	// older games are known not to change while the room is shown
+	_cacheStrips = (flag & dbCacheStrips) && vs->format.bytesPerPixel == 1 && _vm->_game.heversion == 0;
+
 	prepareDrawBitmap(ptr, vs, x, y, width, height, stripnr, numstrip);
 
 	sx = x - vs->xstart / 8;
@@ -1908,9 +1920,89 @@ bool Gdi::drawStrip(byte *dstPtr, VirtScreen *vs, int x, int y, const int width,
 			_roomPalette = _vm->_roomPalette;
 	}
 
+	if (_cacheStrips)
+		return drawCachedStrip(dstPtr, vs->pitch, stripnr, smap_ptr + offset, offset, height);
+
 	return decompressBitmap(dstPtr, vs->pitch, smap_ptr + offset, height);
 }
 
+bool Gdi::drawCachedStrip(byte *dst, int dstPitch, int stripnr, const byte *src, uint32 offset, int height) {
+	// The decoded colors depend on the room palette, which scripts may
+	// change at any time
+	if (_vm->_roomResource != _stripCacheRoom || height != _stripCacheHeight ||
+		memcmp(_stripCachePalette, _roomPalette, sizeof(_stripCachePalette))) {
+		if (_stripCacheRoom != -1)
+			_stripCacheStats.flushes++;
+		clearStripCache();
+		_stripCacheRoom = _vm->_roomResource;
+		_stripCacheHeight = height;
+		memcpy(_stripCachePalette, _roomPalette, sizeof(_stripCachePalette));
+	}
+
+	if (stripnr >= (int)_stripCache.size()) {
+		const uint oldSize = _stripCache.size();
+		_stripCache.resize(stripnr + 1);
+		for (uint i = oldSize; i < _stripCache.size(); i++) {
+			_stripCache[i].offset = 0;
+			_stripCache[i].pixels = 0;
+		}
+	}
+
+	StripCacheEntry &entry = _stripCache[stripnr];
+
+	if (entry.offset != offset) {
+		entry.offset = offset;
+		if (!entry.pixels)
+			entry.pixels = (byte *)malloc(8 * height);
+
+		// The vertical decoders step from one column to the next with
+		// _vertStripNextInc, which has to match the pitch of the cache
+		const uint32 vertStripNextInc = _vertStripNextInc;
+		_vertStripNextInc = height * 8 - 1;
+		const bool transpStrip = decompressBitmap(entry.pixels, 8, src, height);
+		_vertStripNextInc = vertStripNextInc;
+
+		if (transpStrip) {
+			free(entry.pixels);
+			entry.pixels = 0;
+		} else {
+			_stripCacheStats.misses++;
+		}
+	} else if (entry.pixels) {
+		_stripCacheStats.hits++;
+	}
+
+	if (!entry.pixels) {
+		_stripCacheStats.uncached++;
+		return decompressBitmap(dst, dstPitch, src, height);
+	}
+
+	const byte *pixels = entry.pixels;
+	do {
+		memcpy(dst, pixels, 8);
+		dst += dstPitch;
+		pixels += 8;
+	} while (--height);
+
+	return false;
+}
+
+void Gdi::clearStripCache() {
+	for (uint i = 0; i < _stripCache.size(); i++)
+		free(_stripCache[i].pixels);
+	_stripCache.clear();
+	_stripCacheRoom = -1;
+}
+
+uint32 Gdi::getStripCacheSize() const {
+	uint32 size = 0;
+	for (uint i = 0; i < _stripCache.size(); i++) {
+		if (_stripCache[i].pixels)
+			size += 8 * _stripCacheHeight;
+	}
+	return size;
+}
+
 bool GdiNES::drawStrip(byte *dstPtr, VirtScreen *vs, int x, int y, const int width, const int height,
 					int stripnr, const byte *smap_ptr) {
 	byte *mask_ptr = getMaskBuffer(x, y, 1);
@@ -3581,6 +3673,23 @@ void Gdi::drawStripRaw(byte *dst, int dstPitch, const byte *src, int height, con
 			*dst = _roomPalette[*src++];
 			NEXT_ROW;
 		}
+	} else if (_vm->_bytesPerPixel == 1) {
+		// Look up the palette directly instead of calling writeRoomColor()
+		// for every pixel
+		const byte paletteMod = _paletteMod;
+		do {
+			if (transpCheck) {
+				for (x = 0; x < 8; x++) {
+					if (src[x] != _transparentColor)
+						dst[x] = _roomPalette[(src[x] + paletteMod) & 0xFF];
+				}
+			} else {
+				for (x = 0; x < 8; x++)
+					dst[x] = _roomPalette[(src[x] + paletteMod) & 0xFF];
+			}
+			src += 8;
+			dst += dstPitch;
+		} while (--height);
 	} else {
 		do {
 			for (x = 0; x < 8; x ++) {
@@ -24,6 +24,7 @@
 #define SCUMM_GFX_H
 
 #include "common/system.h"
+#include "common/array.h"
 #include "common/list.h"
 
 #include "graphics/surface.h"
@@ -197,6 +198,45 @@ protected:
 	/** Flag which is true when an object is being rendered, false otherwise. */
 	bool _objectMode;
 
+	/** Flag which is true when the strips being drawn may come from the strip cache. */
+	bool _cacheStrips;
+
+	/**
+	 * Decoded strips of the room background. Scrolling and redrawing the
+	 * room draw the same strips over and over again, so they are only
+	 * decoded once. An entry without pixels marks a strip with transparent
+	 * pixels, which depend on what was drawn before and cannot be cached.
+	 */
+	struct StripCacheEntry {
+		/** Offset of the compressed strip in the SMAP, 0 if unused. */
+		uint32 offset;
+		/** The decoded 8 x _stripCacheHeight pixels. */
+		byte *pixels;
+	};
+
+	Common::Array<StripCacheEntry> _stripCache;
+	int _stripCacheRoom;
+	int _stripCacheHeight;
+	byte _stripCachePalette[256];
+
+public:
+	struct StripCacheStats {
+		/** Strips copied from the cache. */
+		uint32 hits;
+		/** Strips decoded into the cache. */
+		uint32 misses;
+		/** Strips which could not be cached because of transparent pixels. */
+		uint32 uncached;
+		/** Times the cache was emptied because the room or its palette changed. */
+		uint32 flushes;
+
+		void reset() {
+			hits = misses = uncached = flushes = 0;
+		}
+	};
+
+	StripCacheStats _stripCacheStats;
+
 public:
 	/** Flag which is true when loading objects or titles for distaff, in PCEngine version of Loom. */
 	bool _distaff;
@@ -236,6 +276,8 @@ protected:
 					int x, int y, const int width, const int height,
 					int stripnr, const byte *smap_ptr);
 
+	bool drawCachedStrip(byte *dst, int dstPitch, int stripnr, const byte *src, uint32 offset, int height);
+
 	virtual void decodeMask(int x, int y, const int width, const int height,
 	                int stripnr, int numzbuf, const byte *zplane_list[9],
 	                bool transpStrip, byte flag);
@@ -267,10 +309,14 @@ public:
 
 	void resetBackground(int top, int bottom, int strip);
 
+	void clearStripCache();
+	uint32 getStripCacheSize() const;
+
 	enum DrawBitmapFlags {
 		dbAllowMaskOr   = 1 << 0,
 		dbDrawMaskOnAll = 1 << 1,
-		dbObjectMode    = 2 << 2
+		dbObjectMode    = 2 << 2,
+		dbCacheStrips   = 1 << 4
 	};
 };
 
@@ -24,6 +24,9 @@
 #ifndef MACOSX
 #include "common/config-manager.h"
 #endif
+#ifdef USE_ZLIB
+#include "common/zlib.h"
+#endif
 
 #include "scumm/charset.h"
 #include "scumm/dialogs.h"
@@ -642,6 +645,10 @@ int ScummEngine::loadResource(ResType type, ResId idx) {
 	if (fileOffs == RES_INVALID_OFFSET)
 		return 0;
 
+	if (_res->restoreCompressedResource(type, idx))
+		return 1;
+	_res->_cacheStats[type].misses++;
+
 	openRoom(roomNr);
 
 	_fileHandle->seek(fileOffs + _fileOffset, SEEK_SET);
@@ -821,6 +828,12 @@ byte *ResourceManager::createResource(ResType type, ResId idx, uint32 size) {
 
 	nukeResource(type, idx);
 
+	// The new data replaces whatever the compressed copy held
+	if (_types[type][idx]._compressedAddress) {
+		_compressedAllocatedSize -= _types[type][idx]._compressedSize;
+		_types[type][idx].nukeCompressed();
+	}
+
 	expireResources(size);
 
 	byte *ptr = new byte[size + SAFETY_AREA];
@@ -833,6 +846,7 @@ byte *ResourceManager::createResource(ResType type, ResId idx, uint32 size) {
 
 	_types[type][idx]._address = ptr;
 	_types[type][idx]._size = size;
+	_types[type]._generation++;
 	setResourceCounter(type, idx, 1);
 	return ptr;
 }
@@ -844,11 +858,17 @@ ResourceManager::Resource::Resource() {
 	_status = 0;
 	_roomno = 0;
 	_roomoffs = 0;
+	_compressedAddress = 0;
+	_compressedSize = 0;
+	_uncompressedSize = 0;
+	_compressedStamp = 0;
 }
 
 ResourceManager::Resource::~Resource() {
 	delete[] _address;
 	_address = 0;
+	delete[] _compressedAddress;
+	_compressedAddress = 0;
 }
 
 void ResourceManager::Resource::nuke() {
@@ -859,9 +879,17 @@ void ResourceManager::Resource::nuke() {
 	_status &= ~RS_MODIFIED;
 }
 
+void ResourceManager::Resource::nukeCompressed() {
+	delete[] _compressedAddress;
+	_compressedAddress = 0;
+	_compressedSize = 0;
+	_uncompressedSize = 0;
+}
+
 ResourceManager::ResTypeData::ResTypeData() {
 	_mode = kDynamicResTypeMode;
 	_tag = 0;
+	_generation = 1;
 }
 
 ResourceManager::ResTypeData::~ResTypeData() {
@@ -872,6 +900,9 @@ ResourceManager::ResourceManager(ScummEngine *vm) : _vm(vm) {
 	_maxHeapThreshold = 0;
 	_minHeapThreshold = 0;
 	_expireCounter = 0;
+	_compressedAllocatedSize = 0;
+	_maxCompressedThreshold = 0;
+	_compressedClock = 0;
 }
 
 ResourceManager::~ResourceManager() {
@@ -885,6 +916,13 @@ void ResourceManager::setHeapThreshold(int min, int max) {
 	_minHeapThreshold = min;
 }
 
+void ResourceManager::setCompressedThreshold(uint32 max) {
+#ifdef USE_ZLIB
+	_maxCompressedThreshold = max;
+#endif
+	expireCompressedResources(0);
+}
+
 bool ResourceManager::validateResource(const char *str, ResType type, ResId idx) const {
 	if (type < rtFirst || type > rtLast || (uint)idx >= (uint)_types[type].size()) {
 		error("%s Illegal Glob type %s (%d) num %d", str, nameOfResType(type), type, idx);
@@ -899,6 +937,7 @@ void ResourceManager::nukeResource(ResType type, ResId idx) {
 		debugC(DEBUG_RESOURCE, "nukeResource(%s,%d)", nameOfResType(type), idx);
 		_allocatedSize -= _types[type][idx]._size;
 		_types[type][idx].nuke();
+		_types[type]._generation++;
 	}
 }
 
@@ -1071,6 +1110,8 @@ void ResourceManager::expireResources(uint32 size) {
 
 		if (!best_type)
 			break;
+		_cacheStats[best_type].expired++;
+		compressResource(best_type, best_res);
 		nukeResource(best_type, best_res);
 	} while (size + _allocatedSize > _minHeapThreshold);
 
@@ -1079,15 +1120,108 @@ void ResourceManager::expireResources(uint32 size) {
 	debugC(DEBUG_RESOURCE, "Expired resources, mem %d -> %d", oldAllocatedSize, _allocatedSize);
 }
 
+void ResourceManager::compressResource(ResType type, ResId idx) {
+#ifdef USE_ZLIB
+	Resource &res = _types[type][idx];
+
+	// Only resources which are exactly as in the data files can be restored
+	// from a copy instead of being reloaded.
+	if (!_maxCompressedThreshold || _types[type]._mode != kStaticResTypeMode || res.isModified())
+		return;
+
+	unsigned long size = Common::compressBound(res._size);
+	byte *buffer = new byte[size];
+	if (!Common::compress(buffer, &size, res._address, res._size, 1) || size >= res._size || size > _maxCompressedThreshold) {
+		delete[] buffer;
+		return;
+	}
+
+	expireCompressedResources(size);
+
+	res._compressedAddress = new byte[size];
+	memcpy(res._compressedAddress, buffer, size);
+	res._compressedSize = size;
+	res._uncompressedSize = res._size;
+	res._compressedStamp = ++_compressedClock;
+	_compressedAllocatedSize += size;
+	_cacheStats[type].compressed++;
+	delete[] buffer;
+
+	debugC(DEBUG_RESOURCE, "Compressed %s %d: %d -> %d bytes", nameOfResType(type), idx, res._size, (int)size);
+#endif
+}
+
+void ResourceManager::expireCompressedResources(uint32 size) {
+	// Drop the oldest copies until the new one fits
+	while (_compressedAllocatedSize && _compressedAllocatedSize + size > _maxCompressedThreshold) {
+		ResType oldestType = rtInvalid;
+		ResId oldestIdx = 0;
+		uint32 oldestStamp = 0xFFFFFFFF;
+
+		for (ResType type = rtFirst; type <= rtLast; type = ResType(type + 1)) {
+			ResId idx = _types[type].size();
+			while (idx-- > 0) {
+				const Resource &tmp = _types[type][idx];
+				if (tmp._compressedAddress && tmp._compressedStamp < oldestStamp) {
+					oldestStamp = tmp._compressedStamp;
+					oldestType = type;
+					oldestIdx = idx;
+				}
+			}
+		}
+
+		if (!oldestType)
+			break;
+		_compressedAllocatedSize -= _types[oldestType][oldestIdx]._compressedSize;
+		_types[oldestType][oldestIdx].nukeCompressed();
+		_cacheStats[oldestType].evicted++;
+	}
+}
+
+bool ResourceManager::restoreCompressedResource(ResType type, ResId idx) {
+#ifdef USE_ZLIB
+	Resource &res = _types[type][idx];
+	if (!res._compressedAddress)
+		return false;
+
+	// Take the copy out first, since createResource drops it
+	byte *compressed = res._compressedAddress;
+	const uint32 compressedSize = res._compressedSize;
+	const uint32 size = res._uncompressedSize;
+	res._compressedAddress = 0;
+	res.nukeCompressed();
+	_compressedAllocatedSize -= compressedSize;
+
+	byte *ptr = createResource(type, idx, size);
+	unsigned long uncompressedSize = size;
+	const bool success = Common::uncompress(ptr, &uncompressedSize, compressed, compressedSize) && uncompressedSize == size;
+	delete[] compressed;
+
+	if (!success) {
+		warning("Could not restore %s %d from its compressed copy", nameOfResType(type), idx);
+		nukeResource(type, idx);
+		return false;
+	}
+
+	_cacheStats[type].hits++;
+	debugC(DEBUG_RESOURCE, "Restored %s %d from its compressed copy", nameOfResType(type), idx);
+	return true;
+#else
+	return false;
+#endif
+}
+
 void ResourceManager::freeResources() {
 	for (ResType type = rtFirst; type <= rtLast; type = ResType(type + 1)) {
 		ResId idx = _types[type].size();
 		while (idx-- > 0) {
 			if (isResourceLoaded(type, idx))
 				nukeResource(type, idx);
+			_types[type][idx].nukeCompressed();
 		}
 		_types[type].clear();
 	}
+	_compressedAllocatedSize = 0;
 }
 
 void ScummEngine::loadPtrToResource(ResType type, ResId idx, const byte *source) {
@@ -126,11 +126,35 @@ public:
 		 */
 		uint32 _roomoffs;
 
+		/**
+		 * A compressed copy of the data of an expired resource, from which
+		 * the resource can be restored without reading the data files.
+		 * Only one of _address and _compressedAddress is set at a time.
+		 */
+		byte *_compressedAddress;
+
+		/**
+		 * Size of the compressed copy.
+		 */
+		uint32 _compressedSize;
+
+		/**
+		 * Size of the resource restored from the compressed copy.
+		 */
+		uint32 _uncompressedSize;
+
+		/**
+		 * Age of the compressed copy, compared to
+		 * ResourceManager::_compressedClock when dropping the oldest copy.
+		 */
+		uint32 _compressedStamp;
+
 	public:
 		Resource();
 		~Resource();
 
 		void nuke();
+		void nukeCompressed();
 
 		inline void setResourceCounter(byte counter);
 		inline byte getResourceCounter() const;
@@ -165,23 +189,70 @@ public:
 		 */
 		uint32 _tag;
 
+		/**
+		 * Incremented whenever a resource of this type is created or nuked,
+		 * so that data derived from these resources can detect that it is
+		 * stale.
+		 */
+		uint32 _generation;
+
 	public:
 		ResTypeData();
 		~ResTypeData();
 	};
 	ResTypeData _types[rtLast + 1];
 
+	/**
+	 * Cache statistics of a resource type.
+	 */
+	struct CacheStats {
+		uint32 hits;		///< Resources restored from a compressed copy
+		uint32 misses;		///< Resources loaded from the data files
+		uint32 expired;		///< Resources removed from memory to make room
+		uint32 compressed;	///< Expired resources of which a compressed copy was kept
+		uint32 evicted;		///< Compressed copies dropped to make room
+
+		CacheStats() { reset(); }
+		void reset() { hits = misses = expired = compressed = evicted = 0; }
+	};
+	CacheStats _cacheStats[rtLast + 1];
+
 protected:
 	uint32 _allocatedSize;
 	uint32 _maxHeapThreshold, _minHeapThreshold;
 	byte _expireCounter;
 
+	/**
+	 * Total size of the compressed copies of expired resources, and the
+	 * maximum it may reach.
+	 */
+	uint32 _compressedAllocatedSize, _maxCompressedThreshold;
+	uint32 _compressedClock;
+
 public:
 	ResourceManager(ScummEngine *vm);
 	~ResourceManager();
 
 	void setHeapThreshold(int min, int max);
 
+	/**
+	 * Set how much memory the compressed copies of expired resources may
+	 * use. With a size of 0, expired resources are always reloaded from the
+	 * data files.
+	 */
+	void setCompressedThreshold(uint32 max);
+
+	uint32 getAllocatedSize() const { return _allocatedSize; }
+	uint32 getCompressedAllocatedSize() const { return _compressedAllocatedSize; }
+	uint32 getMaxHeapThreshold() const { return _maxHeapThreshold; }
+	uint32 getMaxCompressedThreshold() const { return _maxCompressedThreshold; }
+
+	/**
+	 * Restore a resource from its compressed copy, if there is one.
+	 * @return true if the resource was restored
+	 */
+	bool restoreCompressedResource(ResType type, ResId idx);
+
 	void allocResTypeData(ResType type, uint32 tag, int num, ResTypeMode mode);
 	void freeResources();
 
@@ -229,6 +300,8 @@ public:
 	bool validateResource(const char *str, ResType type, ResId idx) const;
 protected:
 	void expireResources(uint32 size);
+	void compressResource(ResType type, ResId idx);
+	void expireCompressedResources(uint32 size);
 };
 
 } // End of namespace Scumm
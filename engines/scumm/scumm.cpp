@@ -35,6 +35,7 @@
 #include "graphics/cursorman.h"
 
 #include "scumm/akos.h"
+#include "scumm/boxes.h"
 #include "scumm/charset.h"
 #include "scumm/costume.h"
 #include "scumm/debugger.h"
@@ -140,6 +141,7 @@ ScummEngine::ScummEngine(OSystem *syst, const DetectorResult &dr)
 		_gdi = new Gdi(this);
 	}
 	_res = new ResourceManager(this);
+	_boxIndex = new BoxIndex();
 
 	// Convert MD5 checksum back into a digest
 	for (int i = 0; i < 16; ++i) {
@@ -648,6 +650,7 @@ ScummEngine::~ScummEngine() {
 	delete _debugger;
 
 	delete _res;
+	delete _boxIndex;
 	delete _gdi;
 }
 
@@ -1365,7 +1368,17 @@ void ScummEngine::setupScumm() {
 		maxHeapThreshold = 550000;
 	}
 
-	_res->setHeapThreshold(400000, maxHeapThreshold);
+	// The memory used for resources can be configured (in kilobytes), to
+	// bound it on small devices or to avoid reloading on big ones.
+	// Expired resources are kept compressed in a second, smaller budget.
+	if (ConfMan.hasKey("resource_memory"))
+		maxHeapThreshold = MAX(ConfMan.getInt("resource_memory"), 1) * 1024;
+	int maxCompressedThreshold = maxHeapThreshold / 4;
+	if (ConfMan.hasKey("resource_cache"))
+		maxCompressedThreshold = MAX(ConfMan.getInt("resource_cache"), 0) * 1024;
+
+	_res->setHeapThreshold(MIN(400000, maxHeapThreshold), maxHeapThreshold);
+	_res->setCompressedThreshold(maxCompressedThreshold);
 
 	free(_compositeBuf);
 	_compositeBuf = (byte *)malloc(_screenWidth * _textSurfaceMultiplier * _screenHeight * _textSurfaceMultiplier * _outputPixelFormat.bytesPerPixel);
@@ -2078,6 +2091,8 @@ Common::Error ScummEngine::go() {
 		// Halt the stop watch and compute how much time this iteration took.
 		diff = _system->getMillis() - diff;
 
+		_debugger->onFrameEnd();
+
 
 		if (shouldQuit()) {
 			// TODO: Maybe perform an autosave on exit?
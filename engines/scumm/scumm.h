@@ -93,6 +93,7 @@ class Sound;
 
 struct Box;
 struct BoxCoords;
+struct BoxIndex;
 struct FindObjectInRoom;
 
 // Use g_scumm from error() ONLY
@@ -1138,6 +1139,10 @@ public:
 	bool checkXYInBoxBounds(int box, int x, int y);
 
 	BoxCoords getBoxCoordinates(int boxnum);
+	BoxCoords readBoxCoordinates(int boxnum);
+	const byte *getBoxesNear(int x, int y, int &count);
+	BoxIndex *getBoxIndex();
+	int findNextBoxInMatrix(byte from, byte to, bool &truncated);
 
 	byte getMaskFromBox(int box);
 	Box *getBoxBaseAddr(int box);
@@ -1148,6 +1153,9 @@ public:
 	int getScaleFromSlot(int slot, int x, int y);
 
 protected:
+	BoxIndex *_boxIndex;
+	void buildNextBoxes();
+
 	// Scaling slots/items
 	struct ScaleSlot {
 		int x1, y1, scale1;
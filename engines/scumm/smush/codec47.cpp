@@ -29,46 +29,27 @@
 
 namespace Scumm {
 
-#if defined(SCUMM_NEED_ALIGNMENT)
-
-#define COPY_4X1_LINE(dst, src)			\
-	do {					\
-		(dst)[0] = (src)[0];	\
-		(dst)[1] = (src)[1];	\
-		(dst)[2] = (src)[2];	\
-		(dst)[3] = (src)[3];	\
-	} while (0)
-
-#define COPY_2X1_LINE(dst, src)			\
-	do {					\
-		(dst)[0] = (src)[0];	\
-		(dst)[1] = (src)[1];	\
-	} while (0)
+// The lines are copied and filled with memcpy and memset of a constant
+// size, which compilers turn into single loads and stores wherever the
+// target allows unaligned ones, and into byte accesses elsewhere.
 
-
-#else /* SCUMM_NEED_ALIGNMENT */
+#define COPY_8X1_LINE(dst, src)			\
+	memcpy((dst), (src), 8)
 
 #define COPY_4X1_LINE(dst, src)			\
-	*(uint32 *)(dst) = *(const uint32 *)(src)
+	memcpy((dst), (src), 4)
 
 #define COPY_2X1_LINE(dst, src)			\
-	*(uint16 *)(dst) = *(const uint16 *)(src)
+	memcpy((dst), (src), 2)
 
-#endif
+#define FILL_8X1_LINE(dst, val)			\
+	memset((dst), (val), 8)
 
 #define FILL_4X1_LINE(dst, val)			\
-	do {					\
-		(dst)[0] = val;	\
-		(dst)[1] = val;	\
-		(dst)[2] = val;	\
-		(dst)[3] = val;	\
-	} while (0)
+	memset((dst), (val), 4)
 
 #define FILL_2X1_LINE(dst, val)			\
-	do {					\
-		(dst)[0] = val;	\
-		(dst)[1] = val;	\
-	} while (0)
+	memset((dst), (val), 2)
 
 static const  int8 codec47_table_small1[] = {
   0, 1, 2, 3, 3, 3, 3, 2, 1, 0, 0, 0, 1, 2, 2, 1,
@@ -451,8 +432,7 @@ void Codec47Decoder::level1(byte *d_dst) {
 	if (code < 0xF8) {
 		tmp2 = _table[code] + _offset1;
 		for (i = 0; i < 8; i++) {
-			COPY_4X1_LINE(d_dst + 0, d_dst + tmp2);
-			COPY_4X1_LINE(d_dst + 4, d_dst + tmp2 + 4);
+			COPY_8X1_LINE(d_dst, d_dst + tmp2);
 			d_dst += _d_pitch;
 		}
 	} else if (code == 0xFF) {
@@ -466,8 +446,7 @@ void Codec47Decoder::level1(byte *d_dst) {
 	} else if (code == 0xFE) {
 		byte t = *_d_src++;
 		for (i = 0; i < 8; i++) {
-			FILL_4X1_LINE(d_dst, t);
-			FILL_4X1_LINE(d_dst + 4, t);
+			FILL_8X1_LINE(d_dst, t);
 			d_dst += _d_pitch;
 		}
 	} else if (code == 0xFD) {
@@ -490,15 +469,13 @@ void Codec47Decoder::level1(byte *d_dst) {
 	} else if (code == 0xFC) {
 		tmp2 = _offset2;
 		for (i = 0; i < 8; i++) {
-			COPY_4X1_LINE(d_dst + 0, d_dst + tmp2);
-			COPY_4X1_LINE(d_dst + 4, d_dst + tmp2 + 4);
+			COPY_8X1_LINE(d_dst, d_dst + tmp2);
 			d_dst += _d_pitch;
 		}
 	} else {
 		byte t = _paramPtr[code];
 		for (i = 0; i < 8; i++) {
-			FILL_4X1_LINE(d_dst, t);
-			FILL_4X1_LINE(d_dst + 4, t);
+			FILL_8X1_LINE(d_dst, t);
 			d_dst += _d_pitch;
 		}
 	}
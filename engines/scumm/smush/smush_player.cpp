@@ -25,6 +25,7 @@
 #include "common/config-manager.h"
 #include "common/file.h"
 #include "common/system.h"
+#include "common/thread.h"
 #include "common/util.h"
 
 #include "graphics/cursorman.h"
@@ -242,6 +243,7 @@ SmushPlayer::SmushPlayer(ScummEngine_v7 *scumm) {
 	_middleAudio = false;
 	_skipPalette = false;
 	_IACTstream = NULL;
+	_decodeAhead = NULL;
 	_smixer = _vm->_smixer;
 	_paused = false;
 	_pauseStartTime = 0;
@@ -284,6 +286,8 @@ void SmushPlayer::init(int32 speed) {
 void SmushPlayer::release() {
 	_vm->_smushVideoShouldFinish = true;
 
+	stopDecodeAhead();
+
 	for (int i = 0; i < 5; i++) {
 		delete _sf[i];
 		_sf[i] = NULL;
@@ -727,18 +731,22 @@ void SmushPlayer::handleNewPalette(int32 subSize, Common::SeekableReadStream &b)
 
 void smush_decode_codec1(byte *dst, const byte *src, int left, int top, int width, int height, int pitch);
 
-void SmushPlayer::decodeFrameObject(int codec, const uint8 *src, int left, int top, int width, int height) {
+/**
+ * Choose where a frame object of the given size gets drawn.
+ * @return false if it is not drawn at all
+ */
+bool SmushPlayer::setFrameObjectTarget(int width, int height) {
 	if ((height == 242) && (width == 384)) {
 		if (_specialBuffer == 0)
 			_specialBuffer = (byte *)malloc(242 * 384);
 		_dst = _specialBuffer;
 	} else if ((height > _vm->_screenHeight) || (width > _vm->_screenWidth))
-		return;
+		return false;
 	// FT Insane uses smaller frames to draw overlays with moving objects
 	// Other .san files do have them as well but their purpose in unknown
 	// and often it causes memory overdraw. So just skip those frames
 	else if (!_insanity && ((height != _vm->_screenHeight) || (width != _vm->_screenWidth)))
-		return;
+		return false;
 
 	if ((height == 242) && (width == 384)) {
 		_width = width;
@@ -748,6 +756,23 @@ void SmushPlayer::decodeFrameObject(int codec, const uint8 *src, int left, int t
 		_height = _vm->_screenHeight;
 	}
 
+	return true;
+}
+
+void SmushPlayer::storeFrameObject() {
+	if (_storeFrame) {
+		if (_frameBuffer == NULL) {
+			_frameBuffer = (byte *)malloc(_width * _height);
+		}
+		memcpy(_frameBuffer, _dst, _width * _height);
+		_storeFrame = false;
+	}
+}
+
+void SmushPlayer::decodeFrameObject(int codec, const uint8 *src, int left, int top, int width, int height) {
+	if (!setFrameObjectTarget(width, height))
+		return;
+
 	switch (codec) {
 	case 1:
 	case 3:
@@ -769,13 +794,7 @@ void SmushPlayer::decodeFrameObject(int codec, const uint8 *src, int left, int t
 		error("Invalid codec for frame object : %d", codec);
 	}
 
-	if (_storeFrame) {
-		if (_frameBuffer == NULL) {
-			_frameBuffer = (byte *)malloc(_width * _height);
-		}
-		memcpy(_frameBuffer, _dst, _width * _height);
-		_storeFrame = false;
-	}
+	storeFrameObject();
 }
 
 #ifdef USE_ZLIB
@@ -785,6 +804,9 @@ void SmushPlayer::handleZlibFrameObject(int32 subSize, Common::SeekableReadStrea
 		return;
 	}
 
+	if (_decodeAhead && pullDecodedFrame(b.pos()))
+		return;
+
 	int32 chunkSize = subSize;
 	byte *chunkBuffer = (byte *)malloc(chunkSize);
 	assert(chunkBuffer);
@@ -816,6 +838,9 @@ void SmushPlayer::handleFrameObject(int32 subSize, Common::SeekableReadStream &b
 		return;
 	}
 
+	if (_decodeAhead && pullDecodedFrame(b.pos()))
+		return;
+
 	int codec = b.readUint16LE();
 	int left = b.readUint16LE();
 	int top = b.readUint16LE();
@@ -835,6 +860,306 @@ void SmushPlayer::handleFrameObject(int32 subSize, Common::SeekableReadStream &b
 	free(chunk_buffer);
 }
 
+// Decoding ahead
+//
+// Outside of Insane, the frame objects drawn with codec 37 and 47 only
+// depend on each other, so a thread can decode them while the player is
+// still busy with the frames before. It reads the video from its own file,
+// and hands every frame object out in the order of the file, leaving the
+// others to the player. Everything else, including the sound, the text and
+// the palettes, is still done by the player as the frames are played.
+
+enum {
+	kDecodeAheadFrames = 4
+};
+
+/** A frame object in the order of the video file. */
+struct SmushPlayer::DecodedFrame {
+	int32 offset;	///< Where the frame object starts in the file, or -1 at the end of the video
+	bool decoded;	///< Whether the pixels hold the frame object, or the player has to decode it
+	int width, height;
+	byte *pixels;
+	int32 size;	///< Number of pixels the codec wrote
+	int32 capacity;
+};
+
+struct SmushPlayer::DecodeAhead {
+	DecodeAhead(Common::SeekableReadStream *f, uint32 fSize, int sWidth, int sHeight) :
+		file(f), fileSize(fSize), screenWidth(sWidth), screenHeight(sHeight),
+		codec37(0), codec47(0), codec37Size(0), codec47Size(0),
+		quit(false), readIndex(0), writeIndex(0),
+		freeFrames(kDecodeAheadFrames), decodedFrames(0) {
+		for (int i = 0; i < kDecodeAheadFrames; i++) {
+			frames[i].pixels = 0;
+			frames[i].capacity = 0;
+		}
+	}
+
+	~DecodeAhead() {
+		for (int i = 0; i < kDecodeAheadFrames; i++)
+			free(frames[i].pixels);
+
+		delete codec37;
+		delete codec47;
+		delete file;
+	}
+
+	Common::SeekableReadStream *file;
+	uint32 fileSize;
+	int screenWidth, screenHeight;
+
+	// Owned by the decoder thread while it runs
+	Codec37Decoder *codec37;
+	Codec47Decoder *codec47;
+	int32 codec37Size, codec47Size;
+
+	bool quit;
+	uint readIndex, writeIndex;
+	DecodedFrame frames[kDecodeAheadFrames];
+	Common::Semaphore freeFrames, decodedFrames;
+	Common::Thread thread;
+
+	/**
+	 * Wait until the player has a free frame.
+	 * @return the frame, or 0 if the thread has to quit
+	 */
+	DecodedFrame *waitForFrame() {
+		freeFrames.wait();
+		return quit ? 0 : &frames[writeIndex];
+	}
+
+	void postFrame() {
+		writeIndex = (writeIndex + 1) % kDecodeAheadFrames;
+		decodedFrames.post();
+	}
+
+	void decodeFrameObject(DecodedFrame &frame, const byte *src, int codec, int width, int height);
+	bool handleFrameObject(uint32 type, int32 size);
+	void run();
+};
+
+/**
+ * Decode a frame object with codec 37 or 47, if the player would draw it.
+ * This must match SmushPlayer::setFrameObjectTarget() without Insane,
+ * since the codecs must see exactly the frame objects they see there.
+ */
+void SmushPlayer::DecodeAhead::decodeFrameObject(DecodedFrame &frame, const byte *src, int codec, int width, int height) {
+	frame.decoded = false;
+
+	if (codec != 37 && codec != 47)
+		return;
+	if (!(width == 384 && height == 242) && (width != screenWidth || height != screenHeight))
+		return;
+
+	// The codecs write as many pixels as the first frame object had
+	if (codec == 37) {
+		if (!codec37) {
+			codec37 = new Codec37Decoder(width, height);
+			codec37Size = width * height;
+		}
+		frame.size = codec37Size;
+	} else {
+		if (!codec47) {
+			codec47 = new Codec47Decoder(width, height);
+			codec47Size = width * height;
+		}
+		frame.size = codec47Size;
+	}
+
+	if (frame.capacity < frame.size) {
+		free(frame.pixels);
+		frame.pixels = (byte *)malloc(frame.size);
+		frame.capacity = frame.size;
+	}
+
+	if (codec == 37)
+		codec37->decode(frame.pixels, src);
+	else if (!codec47->decode(frame.pixels, src))
+		frame.size = 0;
+
+	frame.decoded = true;
+	frame.width = width;
+	frame.height = height;
+}
+
+/**
+ * Hand out a FOBJ or ZFOB chunk.
+ * @return false if the thread has to quit
+ */
+bool SmushPlayer::DecodeAhead::handleFrameObject(uint32 type, int32 size) {
+	DecodedFrame *frame = waitForFrame();
+	if (!frame)
+		return false;
+
+	frame->offset = file->pos();
+	frame->decoded = false;
+
+	if (type == MKTAG('F','O','B','J') && size >= 14) {
+		const int codec = file->readUint16LE();
+		file->skip(4);
+		const int width = file->readUint16LE();
+		const int height = file->readUint16LE();
+		file->skip(4);
+
+		byte *chunk = (byte *)malloc(size - 14);
+		if (chunk && file->read(chunk, size - 14) == (uint32)(size - 14))
+			decodeFrameObject(*frame, chunk, codec, width, height);
+		free(chunk);
+#ifdef USE_ZLIB
+	} else if (type == MKTAG('Z','F','O','B') && size >= 4) {
+		byte *chunk = (byte *)malloc(size);
+		if (chunk && file->read(chunk, size) == (uint32)size) {
+			unsigned long decompressedSize = READ_BE_UINT32(chunk);
+			byte *fobj = (byte *)malloc(decompressedSize);
+
+			if (fobj && decompressedSize >= 14 && Common::uncompress(fobj, &decompressedSize, chunk + 4, size - 4))
+				decodeFrameObject(*frame, fobj + 14, READ_LE_UINT16(fobj), READ_LE_UINT16(fobj + 6), READ_LE_UINT16(fobj + 8));
+			free(fobj);
+		}
+		free(chunk);
+#endif
+	}
+
+	postFrame();
+	return true;
+}
+
+/**
+ * Walk through the chunks like SmushPlayer::parseNextFrame() and
+ * SmushPlayer::handleFrame() do, stopping at anything they do not know.
+ */
+void SmushPlayer::DecodeAhead::run() {
+	while (true) {
+		const uint32 subType = file->readUint32BE();
+		const int32 subSize = file->readUint32BE();
+		const int32 subOffset = file->pos();
+
+		if (file->pos() >= (int32)fileSize || file->err())
+			break;
+
+		if (subType == MKTAG('F','R','M','E')) {
+			int32 frameSize = subSize;
+
+			while (frameSize > 0) {
+				const uint32 objType = file->readUint32BE();
+				const int32 objSize = file->readUint32BE();
+				const int32 objOffset = file->pos();
+
+				if (file->err() || objSize < 0)
+					break;
+
+				if (objType == MKTAG('F','O','B','J') || objType == MKTAG('Z','F','O','B')) {
+					if (!handleFrameObject(objType, objSize))
+						return;
+				}
+
+				frameSize -= objSize + 8;
+				file->seek(objOffset + objSize, SEEK_SET);
+				if (objSize & 1) {
+					file->skip(1);
+					frameSize--;
+				}
+			}
+		} else if (subType != MKTAG('A','H','D','R')) {
+			break;
+		}
+
+		file->seek(subOffset + subSize, SEEK_SET);
+	}
+
+	// Tell the player there is nothing more to come
+	DecodedFrame *frame = waitForFrame();
+	if (frame) {
+		frame->offset = -1;
+		frame->decoded = false;
+		postFrame();
+	}
+}
+
+void SmushPlayer::decodeAheadThreadProc(void *param) {
+	((DecodeAhead *)param)->run();
+}
+
+void SmushPlayer::startDecodeAhead() {
+	// Like the YUV conversion, this uses a thread unless video_threads
+	// is 1, or 0 on a single processor
+	const int threads = ConfMan.getInt("video_threads");
+	if (!Common::hasThreads() || threads == 1 || (threads == 0 && Common::getProcessorCount() < 2))
+		return;
+
+	ScummFile *file = new ScummFile();
+	if (!_vm->openFile(*file, _seekFile)) {
+		delete file;
+		return;
+	}
+	file->seek(_base->pos(), SEEK_SET);
+
+	_decodeAhead = new DecodeAhead(file, _baseSize, _vm->_screenWidth, _vm->_screenHeight);
+	if (!_decodeAhead->thread.start(decodeAheadThreadProc, _decodeAhead)) {
+		delete _decodeAhead;
+		_decodeAhead = NULL;
+	}
+}
+
+void SmushPlayer::stopDecodeAhead(bool keepCodecs) {
+	if (!_decodeAhead)
+		return;
+
+	// The thread either waits for a free frame, is about to, or is done
+	// already, so one post is enough to let it see the quit flag
+	_decodeAhead->quit = true;
+	_decodeAhead->freeFrames.post();
+	_decodeAhead->thread.join();
+
+	if (keepCodecs) {
+		if (_decodeAhead->codec37) {
+			delete _codec37;
+			_codec37 = _decodeAhead->codec37;
+			_decodeAhead->codec37 = 0;
+		}
+		if (_decodeAhead->codec47) {
+			delete _codec47;
+			_codec47 = _decodeAhead->codec47;
+			_decodeAhead->codec47 = 0;
+		}
+	}
+
+	delete _decodeAhead;
+	_decodeAhead = NULL;
+}
+
+/**
+ * Take the frame object starting at the given offset from the decoder
+ * thread, and draw it if the thread decoded it.
+ * @return false if the player has to decode the frame object itself
+ */
+bool SmushPlayer::pullDecodedFrame(int32 offset) {
+	DecodeAhead *ahead = _decodeAhead;
+
+	ahead->decodedFrames.wait();
+	DecodedFrame &frame = ahead->frames[ahead->readIndex];
+
+	if (frame.offset != offset) {
+		// The thread gave up before this frame object, which only happens
+		// with broken videos. Leave the rest of the video to the player.
+		// The codecs of the thread have seen all frame objects drawn so
+		// far, and the ones of the player none of them, so go on with the
+		// former.
+		stopDecodeAhead(true);
+		return false;
+	}
+
+	const bool decoded = frame.decoded;
+	if (decoded && setFrameObjectTarget(frame.width, frame.height)) {
+		memcpy(_dst, frame.pixels, frame.size);
+		storeFrameObject();
+	}
+
+	ahead->readIndex = (ahead->readIndex + 1) % kDecodeAheadFrames;
+	ahead->freeFrames.post();
+	return decoded;
+}
+
 void SmushPlayer::handleFrame(int32 frameSize, Common::SeekableReadStream &b) {
 	debugC(DEBUG_SMUSH, "SmushPlayer::handleFrame(%d)", _frame);
 	_skipNext = false;
@@ -974,6 +1299,8 @@ SmushFont *SmushPlayer::getFont(int font) {
 void SmushPlayer::parseNextFrame() {
 
 	if (_seekPos >= 0) {
+		stopDecodeAhead();
+
 		if (_smixer)
 			_smixer->stop();
 
@@ -1015,6 +1342,11 @@ void SmushPlayer::parseNextFrame() {
 		_startTime = _vm->_system->getMillis();
 
 		_seekPos = -1;
+
+		// Insane draws into the frames and seeks around, so its videos
+		// are always decoded as they are played
+		if (!_insanity && _seekFile.size() > 0)
+			startDecodeAhead();
 	}
 
 	assert(_base);
@@ -82,6 +82,12 @@ private:
 	bool _middleAudio;
 	bool _skipPalette;
 
+	// Decoding ahead
+	struct DecodedFrame;
+	struct DecodeAhead;
+
+	DecodeAhead *_decodeAhead;
+
 public:
 	SmushPlayer(ScummEngine_v7 *scumm);
 	~SmushPlayer();
@@ -117,6 +123,8 @@ private:
 	void tryCmpFile(const char *filename);
 
 	bool readString(const char *file);
+	bool setFrameObjectTarget(int width, int height);
+	void storeFrameObject();
 	void decodeFrameObject(int codec, const uint8 *src, int left, int top, int width, int height);
 	void handleAnimHeader(int32 subSize, Common::SeekableReadStream &);
 	void handleFrame(int32 frameSize, Common::SeekableReadStream &);
@@ -135,6 +143,11 @@ private:
 	void readPalette(byte *, Common::SeekableReadStream &);
 
 	void timerCallback();
+
+	void startDecodeAhead();
+	void stopDecodeAhead(bool keepCodecs = false);
+	bool pullDecodedFrame(int32 offset);
+	static void decodeAheadThreadProc(void *param);
 };
 
 } // End of namespace Scumm
@@ -38,9 +38,15 @@
 #include "graphics/transparent_surface.h"
 #include "common/queue.h"
 #include "common/config-manager.h"
+#include "common/thread.h"
 
 #define DIRTY_RECT_LIMIT 800
 
+// The dirty rect is split into tiles of this size, which are drawn in
+// parallel. Wide tiles keep the rows of a tile close together in memory.
+#define RENDER_TILE_WIDTH 128
+#define RENDER_TILE_HEIGHT 64
+
 namespace Wintermute {
 
 BaseRenderer *makeOSystemRenderer(BaseGame *inGame) {
@@ -63,6 +69,17 @@ BaseRenderOSystem::BaseRenderOSystem(BaseGame *inGame) : BaseRenderer(inGame) {
 		_disableDirtyRects = !ConfMan.getBool("dirty_rects");
 	}
 
+	// 0 uses one thread per processor, 1 draws everything on the main thread
+	int renderThreads = 0;
+	if (ConfMan.hasKey("render_threads")) {
+		renderThreads = ConfMan.getInt("render_threads");
+	}
+	_renderPool = new Common::WorkerPool(renderThreads);
+	_clearTiles = true;
+
+	_frameTimeStats.reset();
+	_lastFlipTime = 0;
+
 	_lastScreenChangeID = g_system->getScreenChangeID();
 }
 
@@ -76,6 +93,7 @@ BaseRenderOSystem::~BaseRenderOSystem() {
 	}
 
 	delete _dirtyRect;
+	delete _renderPool;
 
 	_renderSurface->free();
 	delete _renderSurface;
@@ -152,6 +170,8 @@ bool BaseRenderOSystem::indicatorFlip() {
 }
 
 bool BaseRenderOSystem::flip() {
+	const uint32 flipStart = g_system->getMillis();
+
 	if (_skipThisFrame) {
 		_skipThisFrame = false;
 		delete _dirtyRect;
@@ -201,11 +221,51 @@ bool BaseRenderOSystem::flip() {
 	}
 	_lastFrameIter = _renderQueue.end();
 
+	const uint32 now = g_system->getMillis();
+	if (_lastFlipTime) {
+		_frameTimeStats.addFrame(now - _lastFlipTime, now - flipStart);
+	}
+	_lastFlipTime = now;
+
 	g_system->updateScreen();
 
 	return STATUS_OK;
 }
 
+//////////////////////////////////////////////////////////////////////////
+const uint32 BaseRenderOSystem::FrameTimeStats::kBucketLimits[] = { 10, 17, 20, 25, 34, 50, 100 };
+
+void BaseRenderOSystem::FrameTimeStats::reset() {
+	_frames = 0;
+	for (int i = 0; i < kBuckets; ++i) {
+		_buckets[i] = 0;
+	}
+	_totalFrameTime = 0;
+	_totalRenderTime = 0;
+	_maxFrameTime = 0;
+}
+
+void BaseRenderOSystem::FrameTimeStats::addFrame(uint32 frameTime, uint32 renderTime) {
+	int bucket = 0;
+	while (bucket < kBuckets - 1 && frameTime >= kBucketLimits[bucket]) {
+		bucket++;
+	}
+	_buckets[bucket]++;
+	_frames++;
+	_totalFrameTime += frameTime;
+	_totalRenderTime += renderTime;
+	_maxFrameTime = MAX(_maxFrameTime, frameTime);
+}
+
+void BaseRenderOSystem::resetFrameTimeStats() {
+	_frameTimeStats.reset();
+	_lastFlipTime = 0;
+}
+
+int BaseRenderOSystem::getRenderThreadCount() const {
+	return _renderPool->getThreadCount();
+}
+
 //////////////////////////////////////////////////////////////////////////
 bool BaseRenderOSystem::fill(byte r, byte g, byte b, Common::Rect *rect) {
 	_clearColor = _renderSurface->format.ARGBToColor(0xFF, r, g, b);
@@ -406,35 +466,14 @@ void BaseRenderOSystem::drawTickets() {
 	// Caveat: The FPS-counter will invalidate this.
 	if (it != _lastFrameIter && _renderQueue.front() == _renderQueue.back() && (*it)->_transform._alphaDisable == true) {
 		// If our single opaque rect fills the dirty rect, we can skip filling.
-		if (*_dirtyRect != (*it)->_dstRect) {
-			// Apply the clear-color to the dirty rect.
-			_renderSurface->fillRect(*_dirtyRect, _clearColor);
-		}
-		// Otherwise Do NOT fill.
+		_clearTiles = (*_dirtyRect != (*it)->_dstRect);
 	} else {
-		// Apply the clear-color to the dirty rect.
-		_renderSurface->fillRect(*_dirtyRect, _clearColor);
-	}
-	for (; it != _renderQueue.end(); ++it) {
-		RenderTicket *ticket = *it;
-		if (ticket->_dstRect.intersects(*_dirtyRect)) {
-			// dstClip is the area we want redrawn.
-			Common::Rect dstClip(ticket->_dstRect);
-			// reduce it to the dirty rect
-			dstClip.clip(*_dirtyRect);
-			// we need to keep track of the position to redraw the dirty rect
-			Common::Rect pos(dstClip);
-			int16 offsetX = ticket->_dstRect.left;
-			int16 offsetY = ticket->_dstRect.top;
-			// convert from screen-coords to surface-coords.
-			dstClip.translate(-offsetX, -offsetY);
-
-			drawFromSurface(ticket, &pos, &dstClip);
-			_needsFlip = true;
-		}
-		// Some tickets want redraw but don't actually clip the dirty area (typically the ones that shouldnt become clear-color)
-		ticket->_wantsDraw = false;
+		_clearTiles = true;
 	}
+
+	binTickets();
+	_renderPool->run(drawTileProc, this, _tiles.size());
+
 	g_system->copyRectToScreen((byte *)_renderSurface->getBasePtr(_dirtyRect->left, _dirtyRect->top), _renderSurface->pitch, _dirtyRect->left, _dirtyRect->top, _dirtyRect->width(), _dirtyRect->height());
 
 	it = _renderQueue.begin();
@@ -452,6 +491,79 @@ void BaseRenderOSystem::drawTickets() {
 
 }
 
+void BaseRenderOSystem::binTickets() {
+	const int tilesX = (_dirtyRect->width() + RENDER_TILE_WIDTH - 1) / RENDER_TILE_WIDTH;
+	const int tilesY = (_dirtyRect->height() + RENDER_TILE_HEIGHT - 1) / RENDER_TILE_HEIGHT;
+
+	_tiles.resize(0);
+	for (int y = 0; y < tilesY; ++y) {
+		for (int x = 0; x < tilesX; ++x) {
+			Common::Rect tile(RENDER_TILE_WIDTH, RENDER_TILE_HEIGHT);
+			tile.moveTo(_dirtyRect->left + x * RENDER_TILE_WIDTH, _dirtyRect->top + y * RENDER_TILE_HEIGHT);
+			tile.clip(*_dirtyRect);
+			_tiles.push_back(tile);
+		}
+	}
+
+	// Keep the ticket lists around between frames, to reuse their storage
+	if (_tileTickets.size() < _tiles.size()) {
+		_tileTickets.resize(_tiles.size());
+	}
+	for (uint i = 0; i < _tiles.size(); ++i) {
+		_tileTickets[i].resize(0);
+	}
+
+	for (RenderQueueIterator it = _renderQueue.begin(); it != _renderQueue.end(); ++it) {
+		RenderTicket *ticket = *it;
+		if (ticket->_dstRect.intersects(*_dirtyRect)) {
+			Common::Rect area(ticket->_dstRect);
+			area.clip(*_dirtyRect);
+
+			const int firstX = (area.left - _dirtyRect->left) / RENDER_TILE_WIDTH;
+			const int lastX = (area.right - 1 - _dirtyRect->left) / RENDER_TILE_WIDTH;
+			const int firstY = (area.top - _dirtyRect->top) / RENDER_TILE_HEIGHT;
+			const int lastY = (area.bottom - 1 - _dirtyRect->top) / RENDER_TILE_HEIGHT;
+			for (int y = firstY; y <= lastY; ++y) {
+				for (int x = firstX; x <= lastX; ++x) {
+					_tileTickets[y * tilesX + x].push_back(ticket);
+				}
+			}
+			_needsFlip = true;
+		}
+		// Some tickets want redraw but don't actually clip the dirty area (typically the ones that shouldnt become clear-color)
+		ticket->_wantsDraw = false;
+	}
+}
+
+void BaseRenderOSystem::drawTile(int tile) {
+	const Common::Rect &tileRect = _tiles[tile];
+	if (_clearTiles) {
+		// Apply the clear-color to the tile.
+		_renderSurface->fillRect(tileRect, _clearColor);
+	}
+
+	const Common::Array<RenderTicket *> &tickets = _tileTickets[tile];
+	for (uint i = 0; i < tickets.size(); ++i) {
+		RenderTicket *ticket = tickets[i];
+		// dstClip is the area we want redrawn.
+		Common::Rect dstClip(ticket->_dstRect);
+		// reduce it to the tile
+		dstClip.clip(tileRect);
+		// we need to keep track of the position to redraw the tile
+		Common::Rect pos(dstClip);
+		int16 offsetX = ticket->_dstRect.left;
+		int16 offsetY = ticket->_dstRect.top;
+		// convert from screen-coords to surface-coords.
+		dstClip.translate(-offsetX, -offsetY);
+
+		drawFromSurface(ticket, &pos, &dstClip);
+	}
+}
+
+void BaseRenderOSystem::drawTileProc(void *param, int tile) {
+	((BaseRenderOSystem *)param)->drawTile(tile);
+}
+
 // Replacement for SDL2's SDL_RenderCopy
 void BaseRenderOSystem::drawFromSurface(RenderTicket *ticket) {
 	ticket->drawToSurface(_renderSurface);
@@ -33,8 +33,13 @@
 #include "common/rect.h"
 #include "graphics/surface.h"
 #include "common/list.h"
+#include "common/array.h"
 #include "graphics/transform_struct.h"
 
+namespace Common {
+class WorkerPool;
+}
+
 namespace Wintermute {
 class BaseSurfaceOSystem;
 class RenderTicket;
@@ -112,6 +117,30 @@ public:
 	void endSaveLoad();
 	void drawSurface(BaseSurfaceOSystem *owner, const Graphics::Surface *surf, Common::Rect *srcRect, Common::Rect *dstRect, Graphics::TransformStruct &transform);
 	BaseSurface *createSurface() override;
+
+	/**
+	 * Histogram of the time between two calls to flip(), as shown by the
+	 * "frame_times" debugger command.
+	 */
+	struct FrameTimeStats {
+		enum {
+			kBuckets = 8
+		};
+		/** Upper bound of each bucket but the last one, in milliseconds. */
+		static const uint32 kBucketLimits[kBuckets - 1];
+
+		uint32 _frames;
+		uint32 _buckets[kBuckets];
+		uint32 _totalFrameTime;
+		uint32 _totalRenderTime;
+		uint32 _maxFrameTime;
+
+		void reset();
+		void addFrame(uint32 frameTime, uint32 renderTime);
+	};
+	const FrameTimeStats &getFrameTimeStats() const { return _frameTimeStats; }
+	void resetFrameTimeStats();
+	int getRenderThreadCount() const;
 private:
 	/**
 	 * Mark a specified rect of the screen as dirty.
@@ -122,6 +151,17 @@ private:
 	 * Traverse the tickets that are dirty, and draw them
 	 */
 	void drawTickets();
+	/**
+	 * Split the dirty rect into tiles, and sort the tickets that need
+	 * redrawing into the tiles they overlap, keeping their order.
+	 */
+	void binTickets();
+	/**
+	 * Clear one tile and draw its tickets. Tiles don't overlap, so
+	 * different tiles can be drawn in parallel.
+	 */
+	void drawTile(int tile);
+	static void drawTileProc(void *param, int tile);
 	// Non-dirty-rects:
 	void drawFromSurface(RenderTicket *ticket);
 	// Dirty-rects:
@@ -129,6 +169,14 @@ private:
 	Common::Rect *_dirtyRect;
 	Common::List<RenderTicket *> _renderQueue;
 
+	Common::WorkerPool *_renderPool;
+	Common::Array<Common::Rect> _tiles;
+	Common::Array<Common::Array<RenderTicket *> > _tileTickets;
+	bool _clearTiles;
+
+	FrameTimeStats _frameTimeStats;
+	uint32 _lastFlipTime;
+
 	bool _needsFlip;
 	RenderQueueIterator _lastFrameIter;
 	Common::Rect _renderRect;
@@ -25,12 +25,14 @@
 #include "engines/wintermute/base/base_engine.h"
 #include "engines/wintermute/base/base_file_manager.h"
 #include "engines/wintermute/base/base_game.h"
+#include "engines/wintermute/base/gfx/osystem/base_render_osystem.h"
 
 namespace Wintermute {
 
 Console::Console(WintermuteEngine *vm) : GUI::Debugger(), _engineRef(vm) {
 	registerCmd("show_fps", WRAP_METHOD(Console, Cmd_ShowFps));
 	registerCmd("dump_file", WRAP_METHOD(Console, Cmd_DumpFile));
+	registerCmd("frame_times", WRAP_METHOD(Console, Cmd_FrameTimes));
 }
 
 Console::~Console(void) {
@@ -81,4 +83,43 @@ bool Console::Cmd_DumpFile(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::Cmd_FrameTimes(int argc, const char **argv) {
+	BaseRenderOSystem *renderer = static_cast<BaseRenderOSystem *>(_engineRef->_game->_renderer);
+
+	if (argc > 1) {
+		if (Common::String(argv[1]) == "reset") {
+			renderer->resetFrameTimeStats();
+			debugPrintf("Frame time statistics reset\n");
+		} else {
+			debugPrintf("Usage: %s [reset]\n", argv[0]);
+		}
+		return true;
+	}
+
+	const BaseRenderOSystem::FrameTimeStats &stats = renderer->getFrameTimeStats();
+	if (!stats._frames) {
+		debugPrintf("No frames drawn yet\n");
+		return true;
+	}
+
+	debugPrintf("%d frames drawn with %d render threads\n", stats._frames, renderer->getRenderThreadCount());
+	debugPrintf("Frame time: average %.1f ms, maximum %d ms\n", (float)stats._totalFrameTime / stats._frames, stats._maxFrameTime);
+	debugPrintf("Render time: average %.1f ms\n", (float)stats._totalRenderTime / stats._frames);
+
+	for (int i = 0; i < BaseRenderOSystem::FrameTimeStats::kBuckets; ++i) {
+		const uint32 count = stats._buckets[i];
+		Common::String bars;
+		for (uint32 j = 0; j < count * 40 / stats._frames; ++j) {
+			bars += '#';
+		}
+
+		if (i < BaseRenderOSystem::FrameTimeStats::kBuckets - 1) {
+			debugPrintf("  < %3d ms: %6d (%3d%%) %s\n", BaseRenderOSystem::FrameTimeStats::kBucketLimits[i], count, count * 100 / stats._frames, bars.c_str());
+		} else {
+			debugPrintf(" >= %3d ms: %6d (%3d%%) %s\n", BaseRenderOSystem::FrameTimeStats::kBucketLimits[i - 1], count, count * 100 / stats._frames, bars.c_str());
+		}
+	}
+	return true;
+}
+
 } // End of namespace Wintermute
@@ -0,0 +1,133 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "graphics/dirtyrects.h"
+
+namespace Graphics {
+
+DirtyRectList::DirtyRectList() : _width(0), _height(0), _tilesPerRow(0), _tileRows(0), _empty(true), _area(0) {
+}
+
+void DirtyRectList::setSize(int width, int height) {
+	_width = width;
+	_height = height;
+	_tilesPerRow = (width + kTileSize - 1) / kTileSize;
+	_tileRows = (height + kTileSize - 1) / kTileSize;
+
+	_tiles.resize(_tilesPerRow * _tileRows);
+	clear();
+}
+
+void DirtyRectList::clear() {
+	for (uint i = 0; i < _tiles.size(); ++i) {
+		Tile &tile = _tiles[i];
+		tile.left = tile.top = kTileSize;
+		tile.right = tile.bottom = 0;
+	}
+	_empty = true;
+}
+
+void DirtyRectList::addRect(const Common::Rect &rect) {
+	Common::Rect r(rect);
+	r.clip(Common::Rect(_width, _height));
+	if (r.isEmpty())
+		return;
+
+	_empty = false;
+
+	const int firstRow = r.top / kTileSize, lastRow = (r.bottom - 1) / kTileSize;
+	const int firstColumn = r.left / kTileSize, lastColumn = (r.right - 1) / kTileSize;
+
+	for (int ty = firstRow; ty <= lastRow; ++ty) {
+		const int y = ty * kTileSize;
+		const byte top = (byte)MAX<int>(r.top - y, 0);
+		const byte bottom = (byte)MIN<int>(r.bottom - y, kTileSize);
+
+		Tile *tile = &_tiles[ty * _tilesPerRow + firstColumn];
+		for (int tx = firstColumn; tx <= lastColumn; ++tx, ++tile) {
+			const int x = tx * kTileSize;
+			tile->left = MIN<byte>(tile->left, (byte)MAX<int>(r.left - x, 0));
+			tile->right = MAX<byte>(tile->right, (byte)MIN<int>(r.right - x, kTileSize));
+			tile->top = MIN(tile->top, top);
+			tile->bottom = MAX(tile->bottom, bottom);
+		}
+	}
+}
+
+const Common::Array<Common::Rect> &DirtyRectList::getRects() {
+	// Shrink without freeing the storage, the lists are reused every frame
+	_rects.resize(0);
+	_runs[1].resize(0);
+	_area = 0;
+
+	if (_empty)
+		return _rects;
+
+	for (int ty = 0; ty < _tileRows; ++ty) {
+		const Tile *row = &_tiles[ty * _tilesPerRow];
+		const int y = ty * kTileSize;
+		Common::Array<Run> &runs = _runs[ty & 1];
+		const Common::Array<Run> &prevRuns = _runs[(ty & 1) ^ 1];
+		uint prev = 0;
+
+		runs.resize(0);
+		for (int tx = 0; tx < _tilesPerRow; ) {
+			if (!row[tx].isDirty()) {
+				++tx;
+				continue;
+			}
+
+			// Collect a run of dirty tiles and the bounding box of their
+			// dirty pixels
+			Run run;
+			run.first = tx;
+			Common::Rect box(tx * kTileSize + row[tx].left, y + row[tx].top, tx * kTileSize + row[tx].right, y + row[tx].bottom);
+			for (++tx; tx < _tilesPerRow && row[tx].isDirty(); ++tx) {
+				const int x = tx * kTileSize;
+				box.extend(Common::Rect(x + row[tx].left, y + row[tx].top, x + row[tx].right, y + row[tx].bottom));
+			}
+			run.last = tx - 1;
+
+			// Continue the rectangle of the previous tile row if it covers
+			// exactly the same tiles. Both lists are sorted.
+			while (prev < prevRuns.size() && prevRuns[prev].first < run.first)
+				++prev;
+
+			if (prev < prevRuns.size() && prevRuns[prev].first == run.first && prevRuns[prev].last == run.last) {
+				run.rect = prevRuns[prev].rect;
+				_rects[run.rect].extend(box);
+			} else {
+				run.rect = _rects.size();
+				_rects.push_back(box);
+			}
+
+			runs.push_back(run);
+		}
+	}
+
+	for (uint i = 0; i < _rects.size(); ++i)
+		_area += _rects[i].width() * _rects[i].height();
+
+	return _rects;
+}
+
+} // End of namespace Graphics
@@ -0,0 +1,114 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef GRAPHICS_DIRTYRECTS_H
+#define GRAPHICS_DIRTYRECTS_H
+
+#include "common/array.h"
+#include "common/rect.h"
+
+namespace Graphics {
+
+/**
+ * Collects the dirty areas of a screen and merges overlapping and adjacent
+ * ones into few rectangles, so that a backend can scale and upload them
+ * in one go each, instead of once per rectangle added.
+ *
+ * The screen is split into tiles. Each tile remembers the bounding box of
+ * the dirty pixels inside it. Runs of dirty tiles in a row of tiles form a
+ * rectangle, and rectangles spanning the same tile columns in consecutive
+ * rows are merged. Finally every rectangle is shrunk to the bounding box
+ * of the dirty pixels in its tiles, so a single small rectangle comes out
+ * unchanged.
+ */
+class DirtyRectList {
+public:
+	enum {
+		kTileSize = 16
+	};
+
+	DirtyRectList();
+
+	/**
+	 * Set the size of the screen and clear the list.
+	 */
+	void setSize(int width, int height);
+
+	int getWidth() const { return _width; }
+	int getHeight() const { return _height; }
+
+	/**
+	 * Mark an area as dirty. It is clipped to the screen.
+	 */
+	void addRect(const Common::Rect &r);
+
+	/**
+	 * Mark the whole screen as dirty.
+	 */
+	void addAll() { addRect(Common::Rect(_width, _height)); }
+
+	/** Remove all dirty areas. */
+	void clear();
+
+	/** Return whether anything was added since the last call to clear(). */
+	bool empty() const { return _empty; }
+
+	/**
+	 * Merge the dirty areas and return the resulting rectangles. They do
+	 * not overlap each other. The list stays valid until the next call to
+	 * any non-const method.
+	 */
+	const Common::Array<Common::Rect> &getRects();
+
+	/**
+	 * Return the number of pixels covered by the rectangles of the last
+	 * call to getRects().
+	 */
+	uint32 getArea() const { return _area; }
+
+private:
+	/** Bounding box of the dirty pixels in a tile, relative to it. */
+	struct Tile {
+		byte left, top, right, bottom;
+
+		bool isDirty() const { return right != 0; }
+	};
+
+	/** A run of dirty tiles in a tile row. */
+	struct Run {
+		int first, last;
+		uint rect;
+	};
+
+	int _width, _height;
+	int _tilesPerRow, _tileRows;
+	bool _empty;
+
+	Common::Array<Tile> _tiles;
+	Common::Array<Common::Rect> _rects;
+	Common::Array<Run> _runs[2];	///< Runs of the current and the previous tile row
+	uint32 _area;
+};
+
+} // End of namespace Graphics
+
+#endif
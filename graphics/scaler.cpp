@@ -20,14 +20,20 @@
  *
  */
 
+#include "graphics/scaler.h"
 #include "graphics/scaler/intern.h"
 #include "graphics/scaler/scalebit.h"
 #include "common/util.h"
 #include "common/system.h"
 #include "common/textconsole.h"
+#include "common/thread.h"
 
 int gBitFormat = 565;
 
+/** Threads used by ScaleInBands(), only created when there are several. */
+static Common::WorkerPool *g_scalerPool = 0;
+static int g_scalerThreads = 1;
+
 #ifdef USE_HQ_SCALERS
 // RGB-to-YUV lookup table
 extern "C" {
@@ -157,6 +163,106 @@ void DestroyScalers() {
 	free(RGBtoYUV);
 	RGBtoYUV = 0;
 #endif
+
+	delete g_scalerPool;
+	g_scalerPool = 0;
+	g_scalerThreads = 1;
+}
+
+void SetScalerThreads(int threads) {
+	if (threads <= 0)
+		threads = Common::getProcessorCount();
+
+	if (threads == g_scalerThreads)
+		return;
+
+	delete g_scalerPool;
+	g_scalerPool = 0;
+	g_scalerThreads = 1;
+
+	if (threads > 1) {
+		g_scalerPool = new Common::WorkerPool(threads);
+		g_scalerThreads = g_scalerPool->getThreadCount();
+	}
+}
+
+int GetScalerThreads() {
+	return g_scalerThreads;
+}
+
+namespace {
+
+enum {
+	/**
+	 * Bands start at multiples of this, so that scalers with a pattern
+	 * depending on the row, like DotMatrix, give the same result as when
+	 * scaling the rect in one piece.
+	 */
+	kBandAlignment = 4,
+
+	/** Rects with fewer rows are not worth waking up other threads for. */
+	kMinBandHeight = 16
+};
+
+struct ScalerBands {
+	ScalerProc *scaler;
+	int scaleFactor;
+	const uint8 *srcPtr;
+	uint32 srcPitch;
+	uint8 *dstPtr;
+	uint32 dstPitch;
+	int width, height;
+	int bands, bandHeight;
+};
+
+void scaleBand(void *param, int band) {
+	const ScalerBands &b = *(const ScalerBands *)param;
+	const int y = band * b.bandHeight;
+
+	// The last band takes the remaining rows, so that no band gets too
+	// small for the scalers which need at least two rows
+	const int height = (band == b.bands - 1) ? b.height - y : b.bandHeight;
+
+	b.scaler(b.srcPtr + y * b.srcPitch, b.srcPitch,
+	         b.dstPtr + y * b.scaleFactor * b.dstPitch, b.dstPitch,
+	         b.width, height);
+}
+
+} // End of anonymous namespace
+
+void ScaleInBands(ScalerProc *scaler, int scaleFactor, const uint8 *srcPtr, uint32 srcPitch,
+					uint8 *dstPtr, uint32 dstPitch, int width, int height) {
+	bool reentrant = true;
+#if defined(USE_HQ_SCALERS) && defined(USE_NASM)
+	// The assembly versions keep their state in global variables
+	if (scaler == HQ2x || scaler == HQ3x)
+		reentrant = false;
+#endif
+
+	if (!g_scalerPool || !reentrant || height < 2 * kMinBandHeight) {
+		scaler(srcPtr, srcPitch, dstPtr, dstPitch, width, height);
+		return;
+	}
+
+	// Two bands per thread even out differences in the cost of the bands
+	int bands = MIN(2 * g_scalerThreads, height / kMinBandHeight);
+	int bandHeight = (height + bands - 1) / bands;
+	bandHeight = (bandHeight + kBandAlignment - 1) & ~(kBandAlignment - 1);
+	bands = height / bandHeight;
+
+	ScalerBands param;
+	param.scaler = scaler;
+	param.scaleFactor = scaleFactor;
+	param.srcPtr = srcPtr;
+	param.srcPitch = srcPitch;
+	param.dstPtr = dstPtr;
+	param.dstPitch = dstPitch;
+	param.width = width;
+	param.height = height;
+	param.bands = bands;
+	param.bandHeight = bandHeight;
+
+	g_scalerPool->run(scaleBand, &param, bands);
 }
 
 
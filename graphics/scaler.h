@@ -62,6 +62,30 @@ DECLARE_SCALER(HQ3x);
 
 #endif // #ifdef USE_SCALERS
 
+/**
+ * Set the number of threads used by ScaleInBands(). Passing 0 uses one
+ * thread per processor, 1 disables threading.
+ */
+extern void SetScalerThreads(int threads);
+
+/**
+ * Return the number of threads used by ScaleInBands().
+ */
+extern int GetScalerThreads();
+
+/**
+ * Run a scaler on a rect, split into horizontal bands which are scaled in
+ * parallel. The scalers only read around the rect in the source, so the
+ * rows each band needs above and below it are just the neighbouring bands'
+ * rows and no extra copies are needed. Small rects, and scalers which are
+ * not reentrant, are scaled in one piece on the calling thread.
+ *
+ * @param scaleFactor	integer factor by which the scaler enlarges the rect
+ */
+extern void ScaleInBands(ScalerProc *scaler, int scaleFactor,
+							const uint8 *srcPtr, uint32 srcPitch,
+							uint8 *dstPtr, uint32 dstPitch, int width, int height);
+
 // creates a 160x100 thumbnail for 320x200 games
 // and 160x120 thumbnail for 320x240 and 640x480 games
 // only 565 mode
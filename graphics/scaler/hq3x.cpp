@@ -126,7 +126,22 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 	//	 | w7 | w8 | w9 |
 	//	 +----+----+----+
 
+	// The YUV values of the rows above, at and below the current row,
+	// starting one pixel to the left, and the patterns computed from them
+	uint32 *yuvRows = new uint32[3 * (width + 2)];
+	uint32 *yuvPrev = yuvRows;
+	uint32 *yuvCur = yuvPrev + width + 2;
+	uint32 *yuvNext = yuvCur + width + 2;
+	uint8 *patterns = new uint8[width];
+
+	hqxRowToYUV(p - 1 - nextlineSrc, width + 2, yuvPrev);
+	hqxRowToYUV(p - 1, width + 2, yuvCur);
+
 	while (height--) {
+		hqxRowToYUV(p - 1 + nextlineSrc, width + 2, yuvNext);
+		hqxComputePatterns(yuvPrev, yuvCur, yuvNext, width, patterns);
+		const uint8 *pattern = patterns;
+
 		w1 = *(p - 1 - nextlineSrc);
 		w4 = *(p - 1);
 		w7 = *(p - 1 + nextlineSrc);
@@ -143,18 +158,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			w6 = *(p);
 			w9 = *(p + nextlineSrc);
 
-			int pattern = 0;
-			const int yuv5 = YUV(5);
-			if (w5 != w1 && diffYUV(yuv5, YUV(1))) pattern |= 0x0001;
-			if (w5 != w2 && diffYUV(yuv5, YUV(2))) pattern |= 0x0002;
-			if (w5 != w3 && diffYUV(yuv5, YUV(3))) pattern |= 0x0004;
-			if (w5 != w4 && diffYUV(yuv5, YUV(4))) pattern |= 0x0008;
-			if (w5 != w6 && diffYUV(yuv5, YUV(6))) pattern |= 0x0010;
-			if (w5 != w7 && diffYUV(yuv5, YUV(7))) pattern |= 0x0020;
-			if (w5 != w8 && diffYUV(yuv5, YUV(8))) pattern |= 0x0040;
-			if (w5 != w9 && diffYUV(yuv5, YUV(9))) pattern |= 0x0080;
-
-			switch (pattern) {
+			switch (*pattern++) {
 			case 0:
 			case 1:
 			case 4:
@@ -2931,7 +2935,15 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 		}
 		p += nextlineSrc - width;
 		q += (nextlineDst - width) * 3;
+
+		uint32 *yuvTmp = yuvPrev;
+		yuvPrev = yuvCur;
+		yuvCur = yuvNext;
+		yuvNext = yuvTmp;
 	}
+
+	delete[] yuvRows;
+	delete[] patterns;
 }
 
 void HQ3x(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height) {
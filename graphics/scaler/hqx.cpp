@@ -0,0 +1,163 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "graphics/scaler/intern.h"
+#include "common/cpudetect.h"
+
+#if defined(SCUMMVM_SSE2)
+#include <emmintrin.h>
+#endif
+
+#if defined(SCUMMVM_AVX2)
+#include <immintrin.h>
+#endif
+
+extern "C" uint32 *RGBtoYUV;
+
+void hqxRowToYUV(const uint16 *src, int count, uint32 *yuv) {
+	for (int i = 0; i < count; ++i)
+		yuv[i] = RGBtoYUV[src[i]];
+}
+
+//	The neighbours of pixel x, and the pattern bit each one sets:
+//
+//	 prev[x] 0x01  prev[x + 1] 0x02  prev[x + 2] 0x04
+//	 cur[x]  0x08  cur[x + 1]  --    cur[x + 2]  0x10
+//	 next[x] 0x20  next[x + 1] 0x40  next[x + 2] 0x80
+
+static void computePatterns(const uint32 *prev, const uint32 *cur, const uint32 *next, int first, int width, uint8 *patterns) {
+	for (int x = first; x < width; ++x) {
+		const int yuv5 = cur[x + 1];
+		int pattern = 0;
+
+		if (diffYUV(yuv5, prev[x    ])) pattern |= 0x0001;
+		if (diffYUV(yuv5, prev[x + 1])) pattern |= 0x0002;
+		if (diffYUV(yuv5, prev[x + 2])) pattern |= 0x0004;
+		if (diffYUV(yuv5, cur[x     ])) pattern |= 0x0008;
+		if (diffYUV(yuv5, cur[x + 2] )) pattern |= 0x0010;
+		if (diffYUV(yuv5, next[x    ])) pattern |= 0x0020;
+		if (diffYUV(yuv5, next[x + 1])) pattern |= 0x0040;
+		if (diffYUV(yuv5, next[x + 2])) pattern |= 0x0080;
+
+		patterns[x] = pattern;
+	}
+}
+
+// The Y, U and V values are all in the range 64-191, so they can be
+// compared as unsigned bytes. A pixel differs from its neighbour when the
+// absolute difference of any of the components exceeds its threshold,
+// i.e. when it does not saturate to zero when subtracting the thresholds.
+#define HQX_THRESHOLDS	0x00300706
+
+#if defined(SCUMMVM_SSE2)
+
+static inline __m128i diffBitSSE2(__m128i yuv5, const uint32 *neighbour, __m128i thresholds, int bit) {
+	const __m128i yuv = _mm_loadu_si128((const __m128i *)neighbour);
+	const __m128i absDiff = _mm_or_si128(_mm_subs_epu8(yuv5, yuv), _mm_subs_epu8(yuv, yuv5));
+	const __m128i similar = _mm_cmpeq_epi32(_mm_subs_epu8(absDiff, thresholds), _mm_setzero_si128());
+	return _mm_andnot_si128(similar, _mm_set1_epi32(bit));
+}
+
+static inline __m128i computePatterns4SSE2(const uint32 *prev, const uint32 *cur, const uint32 *next, __m128i thresholds) {
+	const __m128i yuv5 = _mm_loadu_si128((const __m128i *)(cur + 1));
+
+	__m128i pattern = diffBitSSE2(yuv5, prev, thresholds, 0x01);
+	pattern = _mm_or_si128(pattern, diffBitSSE2(yuv5, prev + 1, thresholds, 0x02));
+	pattern = _mm_or_si128(pattern, diffBitSSE2(yuv5, prev + 2, thresholds, 0x04));
+	pattern = _mm_or_si128(pattern, diffBitSSE2(yuv5, cur, thresholds, 0x08));
+	pattern = _mm_or_si128(pattern, diffBitSSE2(yuv5, cur + 2, thresholds, 0x10));
+	pattern = _mm_or_si128(pattern, diffBitSSE2(yuv5, next, thresholds, 0x20));
+	pattern = _mm_or_si128(pattern, diffBitSSE2(yuv5, next + 1, thresholds, 0x40));
+	pattern = _mm_or_si128(pattern, diffBitSSE2(yuv5, next + 2, thresholds, 0x80));
+	return pattern;
+}
+
+/**
+ * Compute the patterns of width pixels, which must be a multiple of 8.
+ */
+static void computePatternsSSE2(const uint32 *prev, const uint32 *cur, const uint32 *next, int width, uint8 *patterns) {
+	const __m128i thresholds = _mm_set1_epi32(HQX_THRESHOLDS);
+
+	for (int x = 0; x < width; x += 8) {
+		const __m128i low = computePatterns4SSE2(prev + x, cur + x, next + x, thresholds);
+		const __m128i high = computePatterns4SSE2(prev + x + 4, cur + x + 4, next + x + 4, thresholds);
+		const __m128i words = _mm_packs_epi32(low, high);
+		_mm_storel_epi64((__m128i *)(patterns + x), _mm_packus_epi16(words, words));
+	}
+}
+
+#endif // SCUMMVM_SSE2
+
+#if defined(SCUMMVM_AVX2)
+
+SCUMMVM_TARGET_AVX2
+static inline __m256i diffBitAVX2(__m256i yuv5, const uint32 *neighbour, __m256i thresholds, int bit) {
+	const __m256i yuv = _mm256_loadu_si256((const __m256i *)neighbour);
+	const __m256i absDiff = _mm256_or_si256(_mm256_subs_epu8(yuv5, yuv), _mm256_subs_epu8(yuv, yuv5));
+	const __m256i similar = _mm256_cmpeq_epi32(_mm256_subs_epu8(absDiff, thresholds), _mm256_setzero_si256());
+	return _mm256_andnot_si256(similar, _mm256_set1_epi32(bit));
+}
+
+/**
+ * Compute the patterns of width pixels, which must be a multiple of 8.
+ */
+SCUMMVM_TARGET_AVX2
+static void computePatternsAVX2(const uint32 *prev, const uint32 *cur, const uint32 *next, int width, uint8 *patterns) {
+	const __m256i thresholds = _mm256_set1_epi32(HQX_THRESHOLDS);
+
+	for (int x = 0; x < width; x += 8) {
+		const __m256i yuv5 = _mm256_loadu_si256((const __m256i *)(cur + x + 1));
+
+		__m256i pattern = diffBitAVX2(yuv5, prev + x, thresholds, 0x01);
+		pattern = _mm256_or_si256(pattern, diffBitAVX2(yuv5, prev + x + 1, thresholds, 0x02));
+		pattern = _mm256_or_si256(pattern, diffBitAVX2(yuv5, prev + x + 2, thresholds, 0x04));
+		pattern = _mm256_or_si256(pattern, diffBitAVX2(yuv5, cur + x, thresholds, 0x08));
+		pattern = _mm256_or_si256(pattern, diffBitAVX2(yuv5, cur + x + 2, thresholds, 0x10));
+		pattern = _mm256_or_si256(pattern, diffBitAVX2(yuv5, next + x, thresholds, 0x20));
+		pattern = _mm256_or_si256(pattern, diffBitAVX2(yuv5, next + x + 1, thresholds, 0x40));
+		pattern = _mm256_or_si256(pattern, diffBitAVX2(yuv5, next + x + 2, thresholds, 0x80));
+
+		const __m128i words = _mm_packs_epi32(_mm256_castsi256_si128(pattern), _mm256_extracti128_si256(pattern, 1));
+		_mm_storel_epi64((__m128i *)(patterns + x), _mm_packus_epi16(words, words));
+	}
+}
+
+#endif // SCUMMVM_AVX2
+
+void hqxComputePatterns(const uint32 *prev, const uint32 *cur, const uint32 *next, int width, uint8 *patterns) {
+	int done = 0;
+
+#if defined(SCUMMVM_AVX2)
+	if (Common::hasCPUFeature(Common::kCPUFeatureAVX2)) {
+		done = width & ~7;
+		computePatternsAVX2(prev, cur, next, done, patterns);
+	} else
+#endif
+#if defined(SCUMMVM_SSE2)
+	if (Common::hasCPUFeature(Common::kCPUFeatureSSE2)) {
+		done = width & ~7;
+		computePatternsSSE2(prev, cur, next, done, patterns);
+	}
+#endif
+
+	computePatterns(prev, cur, next, done, width, patterns);
+}
@@ -218,4 +218,28 @@ static inline bool diffYUV(int yuv1, int yuv2) {
 */
 }
 
+#ifdef USE_HQ_SCALERS
+
+/**
+ * Convert a row of pixels to YUV through the lookup table of the hq
+ * scaler family.
+ */
+void hqxRowToYUV(const uint16 *src, int count, uint32 *yuv);
+
+/**
+ * Compute the hq scaler pattern of each pixel in a row, i.e. the bitmask
+ * telling which of its eight neighbours differ from it according to
+ * diffYUV(). The YUV rows start one pixel left of the first pixel, so they
+ * hold width + 2 values each.
+ *
+ * @param prev		YUV values of the row above
+ * @param cur		YUV values of the row itself
+ * @param next		YUV values of the row below
+ * @param width		number of pixels in the row
+ * @param patterns	receives one pattern per pixel
+ */
+void hqxComputePatterns(const uint32 *prev, const uint32 *cur, const uint32 *next, int width, uint8 *patterns);
+
+#endif
+
 #endif
@@ -28,6 +28,7 @@
 
 
 #include "common/algorithm.h"
+#include "common/cpudetect.h"
 #include "common/endian.h"
 #include "common/util.h"
 #include "common/rect.h"
@@ -37,6 +38,19 @@
 #include "graphics/transparent_surface.h"
 #include "graphics/transform_tools.h"
 
+#if defined(SCUMM_LITTLE_ENDIAN) && (defined(SCUMMVM_SSE2) || defined(SCUMMVM_NEON))
+// The vector blitters expect the alpha channel in the lowest byte
+#define TRANSPARENT_SURFACE_SIMD
+#endif
+
+#if defined(TRANSPARENT_SURFACE_SIMD) && defined(SCUMMVM_SSE2)
+#include <emmintrin.h>
+#endif
+
+#if defined(TRANSPARENT_SURFACE_SIMD) && defined(SCUMMVM_NEON)
+#include <arm_neon.h>
+#endif
+
 //#define ENABLE_BILINEAR
 
 namespace Graphics {
@@ -82,6 +96,216 @@ TransparentSurface::TransparentSurface(const Surface &surf, bool copyData) : Sur
 	}
 }
 
+/*
+ * Vector versions of the blitters below, for rows which are not flipped
+ * horizontally. Each one handles a multiple of four pixels and produces
+ * exactly the same output as the plain C++ loops, which handle the rest.
+ */
+
+#if defined(TRANSPARENT_SURFACE_SIMD) && defined(SCUMMVM_SSE2)
+
+static void blitRowOpaqueSSE2(const byte *in, byte *out, uint32 width) {
+	const __m128i alpha = _mm_set1_epi32(0xFF);
+
+	for (uint32 j = 0; j < width; j += 4) {
+		const __m128i pix = _mm_loadu_si128((const __m128i *)(in + j * 4));
+		_mm_storeu_si128((__m128i *)(out + j * 4), _mm_or_si128(pix, alpha));
+	}
+}
+
+static void blitRowBinarySSE2(const byte *in, byte *out, uint32 width) {
+	const __m128i alpha = _mm_set1_epi32(0xFF);
+
+	for (uint32 j = 0; j < width; j += 4) {
+		const __m128i pix = _mm_loadu_si128((const __m128i *)(in + j * 4));
+		const __m128i dst = _mm_loadu_si128((const __m128i *)(out + j * 4));
+		const __m128i transparent = _mm_cmpeq_epi32(_mm_and_si128(pix, alpha), _mm_setzero_si128());
+		const __m128i opaque = _mm_or_si128(pix, alpha);
+		_mm_storeu_si128((__m128i *)(out + j * 4), _mm_or_si128(_mm_and_si128(transparent, dst), _mm_andnot_si128(transparent, opaque)));
+	}
+}
+
+/**
+ * Broadcast the alpha value of two pixels, unpacked to 16 bit channels,
+ * to all their channels.
+ */
+static inline __m128i broadcastAlphaSSE2(__m128i pix) {
+	return _mm_shufflehi_epi16(_mm_shufflelo_epi16(pix, 0), 0);
+}
+
+/**
+ * Blend two pixels, unpacked to 16 bit channels. Neither sum can exceed
+ * 255 * 255, so all of it fits into 16 bits.
+ */
+static inline __m128i blendSSE2(__m128i in, __m128i out) {
+	const __m128i a = broadcastAlphaSSE2(in);
+	const __m128i invA = _mm_sub_epi16(_mm_set1_epi16(255), a);
+	return _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(in, a), _mm_mullo_epi16(out, invA)), 8);
+}
+
+static void blitRowAlphaSSE2(const byte *in, byte *out, uint32 width) {
+	const __m128i alpha = _mm_set1_epi32(0xFF);
+	const __m128i zero = _mm_setzero_si128();
+
+	for (uint32 j = 0; j < width; j += 4) {
+		const __m128i pix = _mm_loadu_si128((const __m128i *)(in + j * 4));
+		const __m128i dst = _mm_loadu_si128((const __m128i *)(out + j * 4));
+
+		const __m128i lo = blendSSE2(_mm_unpacklo_epi8(pix, zero), _mm_unpacklo_epi8(dst, zero));
+		const __m128i hi = blendSSE2(_mm_unpackhi_epi8(pix, zero), _mm_unpackhi_epi8(dst, zero));
+		const __m128i blended = _mm_or_si128(_mm_packus_epi16(lo, hi), alpha);
+
+		const __m128i transparent = _mm_cmpeq_epi32(_mm_and_si128(pix, alpha), zero);
+		_mm_storeu_si128((__m128i *)(out + j * 4), _mm_or_si128(_mm_and_si128(transparent, dst), _mm_andnot_si128(transparent, blended)));
+	}
+}
+
+/**
+ * Blend two pixels, unpacked to 16 bit channels, with color modulation.
+ * The product of a channel with the modulated alpha and the modulation
+ * color needs 24 bits, of which _mm_mulhi_epu16 returns the top 8 bits.
+ */
+static inline __m128i blendTintSSE2(__m128i in, __m128i out, __m128i modA, __m128i mod) {
+	const __m128i a = _mm_srli_epi16(_mm_mullo_epi16(broadcastAlphaSSE2(in), modA), 8);
+	const __m128i invA = _mm_sub_epi16(_mm_set1_epi16(255), a);
+	out = _mm_srli_epi16(_mm_mullo_epi16(out, invA), 8);
+	return _mm_add_epi16(out, _mm_mulhi_epu16(_mm_mullo_epi16(in, a), mod));
+}
+
+static void blitRowTintSSE2(const byte *in, byte *out, uint32 width, uint32 color) {
+	const int ca = (color >> kAModShift) & 0xFF;
+	const int cr = (color >> kRModShift) & 0xFF;
+	const int cg = (color >> kGModShift) & 0xFF;
+	const int cb = (color >> kBModShift) & 0xFF;
+
+	const __m128i alpha = _mm_set1_epi32(0xFF);
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i modA = _mm_set1_epi16(ca);
+	const __m128i mod = _mm_set_epi16(cr, cg, cb, 0, cr, cg, cb, 0);
+
+	for (uint32 j = 0; j < width; j += 4) {
+		const __m128i pix = _mm_loadu_si128((const __m128i *)(in + j * 4));
+		const __m128i dst = _mm_loadu_si128((const __m128i *)(out + j * 4));
+
+		const __m128i lo = blendTintSSE2(_mm_unpacklo_epi8(pix, zero), _mm_unpacklo_epi8(dst, zero), modA, mod);
+		const __m128i hi = blendTintSSE2(_mm_unpackhi_epi8(pix, zero), _mm_unpackhi_epi8(dst, zero), modA, mod);
+		_mm_storeu_si128((__m128i *)(out + j * 4), _mm_or_si128(_mm_packus_epi16(lo, hi), alpha));
+	}
+}
+
+#endif // SCUMMVM_SSE2
+
+#if defined(TRANSPARENT_SURFACE_SIMD) && defined(SCUMMVM_NEON)
+
+static void blitRowOpaqueNEON(const byte *in, byte *out, uint32 width) {
+	const uint32x4_t alpha = vdupq_n_u32(0xFF);
+
+	for (uint32 j = 0; j < width; j += 4)
+		vst1q_u32((uint32 *)(out + j * 4), vorrq_u32(vld1q_u32((const uint32 *)(in + j * 4)), alpha));
+}
+
+static void blitRowBinaryNEON(const byte *in, byte *out, uint32 width) {
+	const uint32x4_t alpha = vdupq_n_u32(0xFF);
+
+	for (uint32 j = 0; j < width; j += 4) {
+		const uint32x4_t pix = vld1q_u32((const uint32 *)(in + j * 4));
+		const uint32x4_t dst = vld1q_u32((const uint32 *)(out + j * 4));
+		const uint32x4_t transparent = vceqq_u32(vandq_u32(pix, alpha), vdupq_n_u32(0));
+		vst1q_u32((uint32 *)(out + j * 4), vbslq_u32(transparent, dst, vorrq_u32(pix, alpha)));
+	}
+}
+
+/**
+ * Broadcast the alpha value of four pixels to all their channels.
+ */
+static inline uint8x16_t broadcastAlphaNEON(uint32x4_t pix) {
+	return vreinterpretq_u8_u32(vmulq_n_u32(vandq_u32(pix, vdupq_n_u32(0xFF)), 0x01010101));
+}
+
+static inline uint8x8_t blendNEON(uint8x8_t in, uint8x8_t out, uint8x8_t a) {
+	const uint16x8_t sum = vmlal_u8(vmull_u8(in, a), out, vsub_u8(vdup_n_u8(255), a));
+	return vshrn_n_u16(sum, 8);
+}
+
+static void blitRowAlphaNEON(const byte *in, byte *out, uint32 width) {
+	const uint32x4_t alpha = vdupq_n_u32(0xFF);
+
+	for (uint32 j = 0; j < width; j += 4) {
+		const uint32x4_t pix = vld1q_u32((const uint32 *)(in + j * 4));
+		const uint32x4_t dst = vld1q_u32((const uint32 *)(out + j * 4));
+		const uint8x16_t a = broadcastAlphaNEON(pix);
+		const uint8x16_t pix8 = vreinterpretq_u8_u32(pix);
+		const uint8x16_t dst8 = vreinterpretq_u8_u32(dst);
+
+		const uint8x8_t lo = blendNEON(vget_low_u8(pix8), vget_low_u8(dst8), vget_low_u8(a));
+		const uint8x8_t hi = blendNEON(vget_high_u8(pix8), vget_high_u8(dst8), vget_high_u8(a));
+		const uint32x4_t blended = vorrq_u32(vreinterpretq_u32_u8(vcombine_u8(lo, hi)), alpha);
+
+		const uint32x4_t transparent = vceqq_u32(vandq_u32(pix, alpha), vdupq_n_u32(0));
+		vst1q_u32((uint32 *)(out + j * 4), vbslq_u32(transparent, dst, blended));
+	}
+}
+
+static inline uint8x8_t blendTintNEON(uint8x8_t in, uint8x8_t out, uint8x8_t a, uint8x8_t modA, uint16x8_t mod) {
+	a = vshrn_n_u16(vmull_u8(a, modA), 8);
+	const uint16x8_t dst = vshrq_n_u16(vmull_u8(out, vsub_u8(vdup_n_u8(255), a)), 8);
+	const uint16x8_t src = vmull_u8(in, a);
+	const uint16x4_t srcLo = vshrn_n_u32(vmull_u16(vget_low_u16(src), vget_low_u16(mod)), 16);
+	const uint16x4_t srcHi = vshrn_n_u32(vmull_u16(vget_high_u16(src), vget_high_u16(mod)), 16);
+	return vmovn_u16(vaddq_u16(dst, vcombine_u16(srcLo, srcHi)));
+}
+
+static void blitRowTintNEON(const byte *in, byte *out, uint32 width, uint32 color) {
+	const uint16 cr = (color >> kRModShift) & 0xFF;
+	const uint16 cg = (color >> kGModShift) & 0xFF;
+	const uint16 cb = (color >> kBModShift) & 0xFF;
+	const uint16 modValues[8] = { 0, cb, cg, cr, 0, cb, cg, cr };
+
+	const uint32x4_t alpha = vdupq_n_u32(0xFF);
+	const uint8x8_t modA = vdup_n_u8((color >> kAModShift) & 0xFF);
+	const uint16x8_t mod = vld1q_u16(modValues);
+
+	for (uint32 j = 0; j < width; j += 4) {
+		const uint32x4_t pix = vld1q_u32((const uint32 *)(in + j * 4));
+		const uint8x16_t a = broadcastAlphaNEON(pix);
+		const uint8x16_t pix8 = vreinterpretq_u8_u32(pix);
+		const uint8x16_t dst8 = vld1q_u8(out + j * 4);
+
+		const uint8x8_t lo = blendTintNEON(vget_low_u8(pix8), vget_low_u8(dst8), vget_low_u8(a), modA, mod);
+		const uint8x8_t hi = blendTintNEON(vget_high_u8(pix8), vget_high_u8(dst8), vget_high_u8(a), modA, mod);
+		vst1q_u32((uint32 *)(out + j * 4), vorrq_u32(vreinterpretq_u32_u8(vcombine_u8(lo, hi)), alpha));
+	}
+}
+
+#endif // SCUMMVM_NEON
+
+/**
+ * Check whether the vector blitters can be used, and return the number of
+ * pixels per row they should handle.
+ */
+static uint32 getVectorBlitWidth(uint32 width, int32 inStep) {
+#if defined(TRANSPARENT_SURFACE_SIMD) && defined(SCUMMVM_SSE2)
+	if (inStep == 4 && Common::hasCPUFeature(Common::kCPUFeatureSSE2))
+		return width & ~3;
+#elif defined(TRANSPARENT_SURFACE_SIMD) && defined(SCUMMVM_NEON)
+	if (inStep == 4 && Common::hasCPUFeature(Common::kCPUFeatureNEON))
+		return width & ~3;
+#endif
+	return 0;
+}
+
+#if defined(TRANSPARENT_SURFACE_SIMD) && defined(SCUMMVM_SSE2)
+#define blitRowOpaqueVector blitRowOpaqueSSE2
+#define blitRowBinaryVector blitRowBinarySSE2
+#define blitRowAlphaVector blitRowAlphaSSE2
+#define blitRowTintVector blitRowTintSSE2
+#elif defined(TRANSPARENT_SURFACE_SIMD) && defined(SCUMMVM_NEON)
+#define blitRowOpaqueVector blitRowOpaqueNEON
+#define blitRowBinaryVector blitRowBinaryNEON
+#define blitRowAlphaVector blitRowAlphaNEON
+#define blitRowTintVector blitRowTintNEON
+#endif
+
 /**
  * Optimized version of doBlit to be used w/opaque blitting (no alpha).
  */
@@ -90,11 +314,21 @@ void doBlitOpaqueFast(byte *ino, byte *outo, uint32 width, uint32 height, uint32
 	byte *in;
 	byte *out;
 
+	// Whole rows are copied, even when flipped horizontally
+	const uint32 vectorWidth = getVectorBlitWidth(width, 4);
+
 	for (uint32 i = 0; i < height; i++) {
 		out = outo;
 		in = ino;
-		memcpy(out, in, width * 4);
-		for (uint32 j = 0; j < width; j++) {
+#ifdef TRANSPARENT_SURFACE_SIMD
+		if (vectorWidth) {
+			blitRowOpaqueVector(in, out, vectorWidth);
+			in += vectorWidth * 4;
+			out += vectorWidth * 4;
+		}
+#endif
+		memcpy(out, in, (width - vectorWidth) * 4);
+		for (uint32 j = vectorWidth; j < width; j++) {
 			out[kAIndex] = 0xFF;
 			out += 4;
 		}
@@ -111,10 +345,19 @@ void doBlitBinaryFast(byte *ino, byte *outo, uint32 width, uint32 height, uint32
 	byte *in;
 	byte *out;
 
+	const uint32 vectorWidth = getVectorBlitWidth(width, inStep);
+
 	for (uint32 i = 0; i < height; i++) {
 		out = outo;
 		in = ino;
-		for (uint32 j = 0; j < width; j++) {
+#ifdef TRANSPARENT_SURFACE_SIMD
+		if (vectorWidth) {
+			blitRowBinaryVector(in, out, vectorWidth);
+			in += vectorWidth * 4;
+			out += vectorWidth * 4;
+		}
+#endif
+		for (uint32 j = vectorWidth; j < width; j++) {
 			uint32 pix = *(uint32 *)in;
 			int a = in[kAIndex];
 
@@ -145,12 +388,21 @@ void doBlitAlphaBlend(byte *ino, byte *outo, uint32 width, uint32 height, uint32
 	byte *in;
 	byte *out;
 
+	const uint32 vectorWidth = getVectorBlitWidth(width, inStep);
+
 	if (color == 0xffffffff) {
 
 		for (uint32 i = 0; i < height; i++) {
 			out = outo;
 			in = ino;
-			for (uint32 j = 0; j < width; j++) {
+#ifdef TRANSPARENT_SURFACE_SIMD
+			if (vectorWidth) {
+				blitRowAlphaVector(in, out, vectorWidth);
+				in += vectorWidth * 4;
+				out += vectorWidth * 4;
+			}
+#endif
+			for (uint32 j = vectorWidth; j < width; j++) {
 
 				if (in[kAIndex] != 0) {
 					out[kAIndex] = 255;
@@ -175,7 +427,14 @@ void doBlitAlphaBlend(byte *ino, byte *outo, uint32 width, uint32 height, uint32
 		for (uint32 i = 0; i < height; i++) {
 			out = outo;
 			in = ino;
-			for (uint32 j = 0; j < width; j++) {
+#ifdef TRANSPARENT_SURFACE_SIMD
+			if (vectorWidth) {
+				blitRowTintVector(in, out, vectorWidth, color);
+				in += vectorWidth * 4;
+				out += vectorWidth * 4;
+			}
+#endif
+			for (uint32 j = vectorWidth; j < width; j++) {
 
 				uint32 ina = in[kAIndex] * ca >> 8;
 				out[kAIndex] = 255;
@@ -83,9 +83,21 @@
 // BASIS, AND BROWN UNIVERSITY HAS NO OBLIGATION TO PROVIDE MAINTENANCE,
 // SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 
+#include "common/cpudetect.h"
+#include "common/thread.h"
+#include "common/util.h"
+
 #include "graphics/surface.h"
 #include "graphics/yuv_to_rgb.h"
 
+#if defined(SCUMMVM_SSE2)
+#include <emmintrin.h>
+#endif
+
+#if defined(SCUMMVM_NEON)
+#include <arm_neon.h>
+#endif
+
 namespace Common {
 DECLARE_SINGLETON(Graphics::YUVToRGBManager);
 }
@@ -157,8 +169,10 @@ YUVToRGBLookup::YUVToRGBLookup(Graphics::PixelFormat format, YUVToRGBManager::Lu
 	}
 }
 
-YUVToRGBManager::YUVToRGBManager() {
-	_lookup = 0;
+YUVToRGBManager::YUVToRGBManager() : _lookupLock(1) {
+	_pool = 0;
+	_poolBusy = 0;
+	_threads = 1;
 
 	int16 *Cr_r_tab = &_colorTab[0 * 256];
 	int16 *Cr_g_tab = &_colorTab[1 * 256];
@@ -180,16 +194,48 @@ YUVToRGBManager::YUVToRGBManager() {
 }
 
 YUVToRGBManager::~YUVToRGBManager() {
-	delete _lookup;
+	for (uint i = 0; i < _lookups.size(); i++)
+		delete _lookups[i];
+	delete _pool;
+}
+
+void YUVToRGBManager::setThreads(int threads) {
+	if (threads <= 0)
+		threads = Common::getProcessorCount();
+
+	if (threads == _threads)
+		return;
+
+	delete _pool;
+	_pool = 0;
+	_threads = 1;
+
+	if (threads > 1) {
+		_pool = new Common::WorkerPool(threads);
+		_threads = _pool->getThreadCount();
+	}
 }
 
 const YUVToRGBLookup *YUVToRGBManager::getLookup(Graphics::PixelFormat format, YUVToRGBManager::LuminanceScale scale) {
-	if (_lookup && _lookup->getFormat() == format && _lookup->getScale() == scale)
-		return _lookup;
+	_lookupLock.wait();
+
+	// Games use one or two formats at most, so the list stays short. The
+	// last one is usually the one asked for.
+	YUVToRGBLookup *lookup = 0;
+	for (int i = (int)_lookups.size() - 1; i >= 0; i--) {
+		if (_lookups[i]->getFormat() == format && _lookups[i]->getScale() == scale) {
+			lookup = _lookups[i];
+			break;
+		}
+	}
+
+	if (!lookup) {
+		lookup = new YUVToRGBLookup(format, scale);
+		_lookups.push_back(lookup);
+	}
 
-	delete _lookup;
-	_lookup = new YUVToRGBLookup(format, scale);
-	return _lookup;
+	_lookupLock.post();
+	return lookup;
 }
 
 #define PUT_PIXEL(s, d) \
@@ -197,7 +243,7 @@ const YUVToRGBLookup *YUVToRGBManager::getLookup(Graphics::PixelFormat format, Y
 	*((PixelInt *)(d)) = (L[cr_r] | L[crb_g] | L[cb_b])
 
 template<typename PixelInt>
-void convertYUV444ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, int16 *colorTab, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+void convertYUV444ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, const int16 *colorTab, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
 	// Keep the tables in pointers here to avoid a dereference on each pixel
 	const int16 *Cr_r_tab = colorTab;
 	const int16 *Cr_g_tab = Cr_r_tab + 256;
@@ -227,23 +273,9 @@ void convertYUV444ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup
 	}
 }
 
-void YUVToRGBManager::convert444(Graphics::Surface *dst, YUVToRGBManager::LuminanceScale scale, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
-	// Sanity checks
-	assert(dst && dst->getPixels());
-	assert(dst->format.bytesPerPixel == 2 || dst->format.bytesPerPixel == 4);
-	assert(ySrc && uSrc && vSrc);
-
-	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
-
-	// Use a templated function to avoid an if check on every pixel
-	if (dst->format.bytesPerPixel == 2)
-		convertYUV444ToRGB<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
-	else
-		convertYUV444ToRGB<uint32>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
-}
 
 template<typename PixelInt>
-void convertYUV420ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, int16 *colorTab, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+void convertYUV420ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, const int16 *colorTab, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
 	int halfHeight = yHeight >> 1;
 	int halfWidth = yWidth >> 1;
 
@@ -274,29 +306,13 @@ void convertYUV420ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup
 			dstPtr += sizeof(PixelInt);
 		}
 
-		dstPtr += dstPitch;
+		dstPtr += (dstPitch << 1) - yWidth * sizeof(PixelInt);
 		ySrc += (yPitch << 1) - yWidth;
 		uSrc += uvPitch - halfWidth;
 		vSrc += uvPitch - halfWidth;
 	}
 }
 
-void YUVToRGBManager::convert420(Graphics::Surface *dst, YUVToRGBManager::LuminanceScale scale, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
-	// Sanity checks
-	assert(dst && dst->getPixels());
-	assert(dst->format.bytesPerPixel == 2 || dst->format.bytesPerPixel == 4);
-	assert(ySrc && uSrc && vSrc);
-	assert((yWidth & 1) == 0);
-	assert((yHeight & 1) == 0);
-
-	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
-
-	// Use a templated function to avoid an if check on every pixel
-	if (dst->format.bytesPerPixel == 2)
-		convertYUV420ToRGB<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
-	else
-		convertYUV420ToRGB<uint32>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
-}
 
 #define READ_QUAD(ptr, prefix) \
 	byte prefix##A = ptr[index]; \
@@ -323,7 +339,7 @@ void YUVToRGBManager::convert420(Graphics::Surface *dst, YUVToRGBManager::Lumina
 	xDiff++
 
 template<typename PixelInt>
-void convertYUV410ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, int16 *colorTab, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+void convertYUV410ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, const int16 *colorTab, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
 	// Keep the tables in pointers here to avoid a dereference on each pixel
 	const int16 *Cr_r_tab = colorTab;
 	const int16 *Cr_g_tab = Cr_r_tab + 256;
@@ -366,6 +382,491 @@ void convertYUV410ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup
 #undef DO_INTERPOLATION
 #undef DO_YUV410_PIXEL
 
+#if defined(SCUMMVM_SSE2) || defined(SCUMMVM_NEON)
+
+// The vector paths compute the chroma terms and clip the colors themselves
+// instead of going through the lookup tables, eight pixels at a time. The
+// constants are chosen to give exactly the same result. Columns left over
+// at the right edge are converted by the functions above.
+
+namespace {
+
+/**
+ * The fractional parts of the chroma factors used for the color tables,
+ * scaled by 2^16. With these, (|c| * factor) >> 16 matches the values of
+ * the tables, which are truncated towards zero, for all chroma values.
+ */
+enum {
+	kCrToR = 26302, // 1.401
+	kCrToG = 46767, // -0.714
+	kCbToG = 22571, // -0.344
+	kCbToB = 50686, // 1.773
+
+	/** @see clip() */
+	kITUScale = 10774
+};
+
+/** The weights of the left and right chroma samples in YUV410 rows. */
+static const int16 kWeightsLeft[8]  = { 4, 3, 2, 1, 4, 3, 2, 1 };
+static const int16 kWeightsRight[8] = { 0, 1, 2, 3, 0, 1, 2, 3 };
+
+// The vector paths work on 16 bit values, so 32 bit pixels are put
+// together from their low and high halves. A shift of 16 moves a channel
+// out of the half it does not belong to.
+
+inline int shiftLow(int shift) {
+	return shift < 16 ? shift : 16;
+}
+
+inline int shiftHigh(int shift) {
+	return shift >= 16 ? shift - 16 : 16;
+}
+
+/** Check that no channel of the format crosses the middle of 32 bit pixels. */
+inline bool isSplitFormat(const Graphics::PixelFormat &format) {
+	return (format.rShift >= 16 || format.rShift + 8 - format.rLoss <= 16) &&
+	       (format.gShift >= 16 || format.gShift + 8 - format.gLoss <= 16) &&
+	       (format.bShift >= 16 || format.bShift + 8 - format.bLoss <= 16);
+}
+
+#if defined(SCUMMVM_SSE2)
+
+typedef __m128i Vector;
+
+/** The destination format, prepared for the vector paths. */
+struct VectorFormat {
+	explicit VectorFormat(const YUVToRGBLookup *lookup);
+
+	bool scaleITU;
+	__m128i rLoss, gLoss, bLoss;
+	__m128i rShift, gShift, bShift;         ///< Into the low 16 bits
+	__m128i rShiftHigh, gShiftHigh, bShiftHigh; ///< Into the high 16 bits of 32 bit pixels
+	__m128i alpha, alphaHigh;
+};
+
+VectorFormat::VectorFormat(const YUVToRGBLookup *lookup) {
+	const Graphics::PixelFormat format = lookup->getFormat();
+	const uint32 alphaBits = (0xFF >> format.aLoss) << format.aShift;
+
+	// Shifting by 16 or more clears the values, for the channels which are
+	// in the other half
+	scaleITU = (lookup->getScale() == YUVToRGBManager::kScaleITU);
+	rLoss = _mm_cvtsi32_si128(format.rLoss);
+	gLoss = _mm_cvtsi32_si128(format.gLoss);
+	bLoss = _mm_cvtsi32_si128(format.bLoss);
+	rShift = _mm_cvtsi32_si128(shiftLow(format.rShift));
+	gShift = _mm_cvtsi32_si128(shiftLow(format.gShift));
+	bShift = _mm_cvtsi32_si128(shiftLow(format.bShift));
+	rShiftHigh = _mm_cvtsi32_si128(shiftHigh(format.rShift));
+	gShiftHigh = _mm_cvtsi32_si128(shiftHigh(format.gShift));
+	bShiftHigh = _mm_cvtsi32_si128(shiftHigh(format.bShift));
+	alpha = _mm_set1_epi16((int16)(alphaBits & 0xFFFF));
+	alphaHigh = _mm_set1_epi16((int16)(alphaBits >> 16));
+}
+
+/** Load eight bytes as 16 bit values. */
+inline __m128i loadVector(const byte *src) {
+	return _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)src), _mm_setzero_si128());
+}
+
+inline __m128i loadVector(const int16 *src) {
+	return _mm_loadu_si128((const __m128i *)src);
+}
+
+inline __m128i splatVector(int value) {
+	return _mm_set1_epi16(value);
+}
+
+/** a * wa + b * wb */
+inline __m128i mulAdd(__m128i a, __m128i wa, __m128i b, __m128i wb) {
+	return _mm_add_epi16(_mm_mullo_epi16(a, wa), _mm_mullo_epi16(b, wb));
+}
+
+inline __m128i shiftRight4(__m128i v) {
+	return _mm_srli_epi16(v, 4);
+}
+
+/** Repeat each value twice, the first four into low and the rest into high. */
+inline void repeat2(__m128i v, __m128i &low, __m128i &high) {
+	low = _mm_unpacklo_epi16(v, v);
+	high = _mm_unpackhi_epi16(v, v);
+}
+
+/** Repeat each value four times, two values into each of out[0] to out[3]. */
+inline void repeat4(__m128i v, __m128i *out) {
+	const __m128i low = _mm_unpacklo_epi16(v, v);
+	const __m128i high = _mm_unpackhi_epi16(v, v);
+	out[0] = _mm_unpacklo_epi32(low, low);
+	out[1] = _mm_unpackhi_epi32(low, low);
+	out[2] = _mm_unpacklo_epi32(high, high);
+	out[3] = _mm_unpackhi_epi32(high, high);
+}
+
+/** (v ^ sign) - sign, negating v where sign is all ones. */
+inline __m128i applySign(__m128i v, __m128i sign) {
+	return _mm_sub_epi16(_mm_xor_si128(v, sign), sign);
+}
+
+/** The terms added to the luminance, the same as the color tables hold. */
+inline void chromaTerms(__m128i u, __m128i v, __m128i &r, __m128i &g, __m128i &b) {
+	const __m128i cb = _mm_sub_epi16(u, _mm_set1_epi16(128));
+	const __m128i cr = _mm_sub_epi16(v, _mm_set1_epi16(128));
+	const __m128i cbSign = _mm_srai_epi16(cb, 15);
+	const __m128i crSign = _mm_srai_epi16(cr, 15);
+	const __m128i cbAbs = applySign(cb, cbSign);
+	const __m128i crAbs = applySign(cr, crSign);
+
+	r = applySign(_mm_add_epi16(crAbs, _mm_mulhi_epu16(crAbs, _mm_set1_epi16((int16)kCrToR))), crSign);
+	g = _mm_sub_epi16(_mm_setzero_si128(), _mm_add_epi16(
+		applySign(_mm_mulhi_epu16(crAbs, _mm_set1_epi16((int16)kCrToG)), crSign),
+		applySign(_mm_mulhi_epu16(cbAbs, _mm_set1_epi16((int16)kCbToG)), cbSign)));
+	b = applySign(_mm_add_epi16(cbAbs, _mm_mulhi_epu16(cbAbs, _mm_set1_epi16((int16)kCbToB))), cbSign);
+}
+
+/**
+ * Clip the values to the luminance range and scale them to [0, 255], like
+ * the RGB lookup table does.
+ */
+inline __m128i clip(__m128i v, bool scaleITU) {
+	if (!scaleITU)
+		return _mm_min_epi16(_mm_max_epi16(v, _mm_setzero_si128()), _mm_set1_epi16(255));
+
+	// (v - 16) * 255 / 219, which is v + v * 36 / 219 after subtracting 16.
+	// The fraction is 36 / 219 scaled by 2^16 and rounded up, which is
+	// exact for this range.
+	v = _mm_min_epi16(_mm_max_epi16(v, _mm_set1_epi16(16)), _mm_set1_epi16(235));
+	v = _mm_sub_epi16(v, _mm_set1_epi16(16));
+	return _mm_add_epi16(v, _mm_mulhi_epu16(v, _mm_set1_epi16(kITUScale)));
+}
+
+/** Put eight pixels from their luminance and chroma terms. */
+inline void putPixels(uint16 *dst, __m128i y, __m128i r, __m128i g, __m128i b, const VectorFormat &format) {
+	r = _mm_srl_epi16(clip(_mm_add_epi16(y, r), format.scaleITU), format.rLoss);
+	g = _mm_srl_epi16(clip(_mm_add_epi16(y, g), format.scaleITU), format.gLoss);
+	b = _mm_srl_epi16(clip(_mm_add_epi16(y, b), format.scaleITU), format.bLoss);
+
+	const __m128i pixels = _mm_or_si128(
+		_mm_or_si128(_mm_sll_epi16(r, format.rShift), _mm_sll_epi16(g, format.gShift)),
+		_mm_or_si128(_mm_sll_epi16(b, format.bShift), format.alpha));
+	_mm_storeu_si128((__m128i *)dst, pixels);
+}
+
+inline void putPixels(uint32 *dst, __m128i y, __m128i r, __m128i g, __m128i b, const VectorFormat &format) {
+	r = _mm_srl_epi16(clip(_mm_add_epi16(y, r), format.scaleITU), format.rLoss);
+	g = _mm_srl_epi16(clip(_mm_add_epi16(y, g), format.scaleITU), format.gLoss);
+	b = _mm_srl_epi16(clip(_mm_add_epi16(y, b), format.scaleITU), format.bLoss);
+
+	// Put the low and high halves of the pixels together separately
+	const __m128i low = _mm_or_si128(
+		_mm_or_si128(_mm_sll_epi16(r, format.rShift), _mm_sll_epi16(g, format.gShift)),
+		_mm_or_si128(_mm_sll_epi16(b, format.bShift), format.alpha));
+	const __m128i high = _mm_or_si128(
+		_mm_or_si128(_mm_sll_epi16(r, format.rShiftHigh), _mm_sll_epi16(g, format.gShiftHigh)),
+		_mm_or_si128(_mm_sll_epi16(b, format.bShiftHigh), format.alphaHigh));
+	_mm_storeu_si128((__m128i *)dst, _mm_unpacklo_epi16(low, high));
+	_mm_storeu_si128((__m128i *)dst + 1, _mm_unpackhi_epi16(low, high));
+}
+
+inline bool useVectorPath(const Graphics::PixelFormat &format) {
+	return Common::hasCPUFeature(Common::kCPUFeatureSSE2) && isSplitFormat(format);
+}
+
+#elif defined(SCUMMVM_NEON)
+
+typedef int16x8_t Vector;
+
+/** The destination format, prepared for the vector paths. */
+struct VectorFormat {
+	explicit VectorFormat(const YUVToRGBLookup *lookup);
+
+	bool scaleITU;
+	// NEON shifts right by negative counts
+	int16x8_t rLoss, gLoss, bLoss;
+	int16x8_t rShift, gShift, bShift;         ///< Into the low 16 bits
+	int16x8_t rShiftHigh, gShiftHigh, bShiftHigh; ///< Into the high 16 bits of 32 bit pixels
+	uint16x8_t alpha, alphaHigh;
+};
+
+VectorFormat::VectorFormat(const YUVToRGBLookup *lookup) {
+	const Graphics::PixelFormat format = lookup->getFormat();
+	const uint32 alphaBits = (0xFF >> format.aLoss) << format.aShift;
+
+	scaleITU = (lookup->getScale() == YUVToRGBManager::kScaleITU);
+	rLoss = vdupq_n_s16(-format.rLoss);
+	gLoss = vdupq_n_s16(-format.gLoss);
+	bLoss = vdupq_n_s16(-format.bLoss);
+	rShift = vdupq_n_s16(shiftLow(format.rShift));
+	gShift = vdupq_n_s16(shiftLow(format.gShift));
+	bShift = vdupq_n_s16(shiftLow(format.bShift));
+	rShiftHigh = vdupq_n_s16(shiftHigh(format.rShift));
+	gShiftHigh = vdupq_n_s16(shiftHigh(format.gShift));
+	bShiftHigh = vdupq_n_s16(shiftHigh(format.bShift));
+	alpha = vdupq_n_u16(alphaBits & 0xFFFF);
+	alphaHigh = vdupq_n_u16(alphaBits >> 16);
+}
+
+inline int16x8_t loadVector(const byte *src) {
+	return vreinterpretq_s16_u16(vmovl_u8(vld1_u8(src)));
+}
+
+inline int16x8_t loadVector(const int16 *src) {
+	return vld1q_s16(src);
+}
+
+inline int16x8_t splatVector(int value) {
+	return vdupq_n_s16(value);
+}
+
+inline int16x8_t mulAdd(int16x8_t a, int16x8_t wa, int16x8_t b, int16x8_t wb) {
+	return vmlaq_s16(vmulq_s16(a, wa), b, wb);
+}
+
+inline int16x8_t shiftRight4(int16x8_t v) {
+	return vreinterpretq_s16_u16(vshrq_n_u16(vreinterpretq_u16_s16(v), 4));
+}
+
+inline void repeat2(int16x8_t v, int16x8_t &low, int16x8_t &high) {
+	const int16x8x2_t zipped = vzipq_s16(v, v);
+	low = zipped.val[0];
+	high = zipped.val[1];
+}
+
+inline void repeat4(int16x8_t v, int16x8_t *out) {
+	const int16x8x2_t pairs = vzipq_s16(v, v);
+	const int32x4x2_t low = vzipq_s32(vreinterpretq_s32_s16(pairs.val[0]), vreinterpretq_s32_s16(pairs.val[0]));
+	const int32x4x2_t high = vzipq_s32(vreinterpretq_s32_s16(pairs.val[1]), vreinterpretq_s32_s16(pairs.val[1]));
+	out[0] = vreinterpretq_s16_s32(low.val[0]);
+	out[1] = vreinterpretq_s16_s32(low.val[1]);
+	out[2] = vreinterpretq_s16_s32(high.val[0]);
+	out[3] = vreinterpretq_s16_s32(high.val[1]);
+}
+
+/** (v * factor) >> 16, for non-negative values */
+inline int16x8_t mulFraction(int16x8_t v, uint16 factor) {
+	const uint16x8_t u = vreinterpretq_u16_s16(v);
+	const uint32x4_t low = vmull_n_u16(vget_low_u16(u), factor);
+	const uint32x4_t high = vmull_n_u16(vget_high_u16(u), factor);
+	return vreinterpretq_s16_u16(vcombine_u16(vshrn_n_u32(low, 16), vshrn_n_u32(high, 16)));
+}
+
+inline int16x8_t applySign(int16x8_t v, int16x8_t sign) {
+	return vsubq_s16(veorq_s16(v, sign), sign);
+}
+
+inline void chromaTerms(int16x8_t u, int16x8_t v, int16x8_t &r, int16x8_t &g, int16x8_t &b) {
+	const int16x8_t cb = vsubq_s16(u, vdupq_n_s16(128));
+	const int16x8_t cr = vsubq_s16(v, vdupq_n_s16(128));
+	const int16x8_t cbSign = vshrq_n_s16(cb, 15);
+	const int16x8_t crSign = vshrq_n_s16(cr, 15);
+	const int16x8_t cbAbs = vabsq_s16(cb);
+	const int16x8_t crAbs = vabsq_s16(cr);
+
+	r = applySign(vaddq_s16(crAbs, mulFraction(crAbs, kCrToR)), crSign);
+	g = vnegq_s16(vaddq_s16(applySign(mulFraction(crAbs, kCrToG), crSign), applySign(mulFraction(cbAbs, kCbToG), cbSign)));
+	b = applySign(vaddq_s16(cbAbs, mulFraction(cbAbs, kCbToB)), cbSign);
+}
+
+/** @see clip() of the SSE2 path */
+inline uint16x8_t clip(int16x8_t v, bool scaleITU) {
+	if (!scaleITU)
+		return vreinterpretq_u16_s16(vminq_s16(vmaxq_s16(v, vdupq_n_s16(0)), vdupq_n_s16(255)));
+
+	v = vsubq_s16(vminq_s16(vmaxq_s16(v, vdupq_n_s16(16)), vdupq_n_s16(235)), vdupq_n_s16(16));
+	return vreinterpretq_u16_s16(vaddq_s16(v, mulFraction(v, kITUScale)));
+}
+
+inline void putPixels(uint16 *dst, int16x8_t y, int16x8_t r, int16x8_t g, int16x8_t b, const VectorFormat &format) {
+	const uint16x8_t r16 = vshlq_u16(clip(vaddq_s16(y, r), format.scaleITU), format.rLoss);
+	const uint16x8_t g16 = vshlq_u16(clip(vaddq_s16(y, g), format.scaleITU), format.gLoss);
+	const uint16x8_t b16 = vshlq_u16(clip(vaddq_s16(y, b), format.scaleITU), format.bLoss);
+
+	const uint16x8_t pixels = vorrq_u16(
+		vorrq_u16(vshlq_u16(r16, format.rShift), vshlq_u16(g16, format.gShift)),
+		vorrq_u16(vshlq_u16(b16, format.bShift), format.alpha));
+	vst1q_u16(dst, pixels);
+}
+
+inline void putPixels(uint32 *dst, int16x8_t y, int16x8_t r, int16x8_t g, int16x8_t b, const VectorFormat &format) {
+	const uint16x8_t r16 = vshlq_u16(clip(vaddq_s16(y, r), format.scaleITU), format.rLoss);
+	const uint16x8_t g16 = vshlq_u16(clip(vaddq_s16(y, g), format.scaleITU), format.gLoss);
+	const uint16x8_t b16 = vshlq_u16(clip(vaddq_s16(y, b), format.scaleITU), format.bLoss);
+
+	// Put the low and high halves of the pixels together separately
+	uint16x8x2_t halves;
+	halves.val[0] = vorrq_u16(
+		vorrq_u16(vshlq_u16(r16, format.rShift), vshlq_u16(g16, format.gShift)),
+		vorrq_u16(vshlq_u16(b16, format.bShift), format.alpha));
+	halves.val[1] = vorrq_u16(
+		vorrq_u16(vshlq_u16(r16, format.rShiftHigh), vshlq_u16(g16, format.gShiftHigh)),
+		vorrq_u16(vshlq_u16(b16, format.bShiftHigh), format.alphaHigh));
+	vst2q_u16((uint16 *)dst, halves);	// Little endian only, see useVectorPath()
+}
+
+inline bool useVectorPath(const Graphics::PixelFormat &format) {
+#ifdef SCUMM_BIG_ENDIAN
+	if (format.bytesPerPixel == 4)
+		return false;
+#endif
+	return Common::hasCPUFeature(Common::kCPUFeatureNEON) && isSplitFormat(format);
+}
+
+#endif
+
+} // End of anonymous namespace
+
+template<typename PixelInt>
+void convertYUV444ToRGBVector(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, const int16 *colorTab, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+	const VectorFormat format(lookup);
+	const int vectorWidth = yWidth & ~7;
+
+	for (int h = 0; h < yHeight; h++) {
+		PixelInt *dst = (PixelInt *)(dstPtr + h * dstPitch);
+		const byte *yRow = ySrc + h * yPitch;
+		const byte *uRow = uSrc + h * uvPitch;
+		const byte *vRow = vSrc + h * uvPitch;
+
+		for (int x = 0; x < vectorWidth; x += 8) {
+			Vector r, g, b;
+			chromaTerms(loadVector(uRow + x), loadVector(vRow + x), r, g, b);
+			putPixels(dst + x, loadVector(yRow + x), r, g, b, format);
+		}
+	}
+
+	if (vectorWidth < yWidth)
+		convertYUV444ToRGB<PixelInt>(dstPtr + vectorWidth * sizeof(PixelInt), dstPitch, lookup, colorTab, ySrc + vectorWidth, uSrc + vectorWidth, vSrc + vectorWidth, yWidth - vectorWidth, yHeight, yPitch, uvPitch);
+}
+
+template<typename PixelInt>
+void convertYUV420ToRGBVector(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, const int16 *colorTab, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+	const VectorFormat format(lookup);
+	const int vectorWidth = yWidth & ~15;
+
+	for (int h = 0; h < yHeight; h += 2) {
+		PixelInt *dst0 = (PixelInt *)(dstPtr + h * dstPitch);
+		PixelInt *dst1 = (PixelInt *)(dstPtr + (h + 1) * dstPitch);
+		const byte *yRow0 = ySrc + h * yPitch;
+		const byte *yRow1 = yRow0 + yPitch;
+		const byte *uRow = uSrc + (h >> 1) * uvPitch;
+		const byte *vRow = vSrc + (h >> 1) * uvPitch;
+
+		for (int x = 0; x < vectorWidth; x += 16) {
+			Vector r, g, b, rLow, gLow, bLow, rHigh, gHigh, bHigh;
+			chromaTerms(loadVector(uRow + (x >> 1)), loadVector(vRow + (x >> 1)), r, g, b);
+			repeat2(r, rLow, rHigh);
+			repeat2(g, gLow, gHigh);
+			repeat2(b, bLow, bHigh);
+
+			// Both rows share the chroma
+			putPixels(dst0 + x, loadVector(yRow0 + x), rLow, gLow, bLow, format);
+			putPixels(dst0 + x + 8, loadVector(yRow0 + x + 8), rHigh, gHigh, bHigh, format);
+			putPixels(dst1 + x, loadVector(yRow1 + x), rLow, gLow, bLow, format);
+			putPixels(dst1 + x + 8, loadVector(yRow1 + x + 8), rHigh, gHigh, bHigh, format);
+		}
+	}
+
+	if (vectorWidth < yWidth)
+		convertYUV420ToRGB<PixelInt>(dstPtr + vectorWidth * sizeof(PixelInt), dstPitch, lookup, colorTab, ySrc + vectorWidth, uSrc + (vectorWidth >> 1), vSrc + (vectorWidth >> 1), yWidth - vectorWidth, yHeight, yPitch, uvPitch);
+}
+
+template<typename PixelInt>
+void convertYUV410ToRGBVector(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, const int16 *colorTab, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+	const VectorFormat format(lookup);
+	const Vector weightsLeft = loadVector(kWeightsLeft);
+	const Vector weightsRight = loadVector(kWeightsRight);
+
+	// Each step covers eight chroma samples and reads the one after them
+	// too, which may be the extra column
+	const int vectorWidth = yWidth & ~31;
+
+	for (int y = 0; y < yHeight; y++) {
+		PixelInt *dst = (PixelInt *)(dstPtr + y * dstPitch);
+		const byte *yRow = ySrc + y * yPitch;
+		const byte *uRow = uSrc + (y >> 2) * uvPitch;
+		const byte *vRow = vSrc + (y >> 2) * uvPitch;
+
+		// The same bilinear interpolation as convertYUV410ToRGB(), first
+		// between the chroma rows and then between the columns
+		const Vector weightsTop = splatVector(4 - (y & 3));
+		const Vector weightsBottom = splatVector(y & 3);
+
+		for (int x = 0; x < vectorWidth; x += 32) {
+			const int index = x >> 2;
+			Vector uLeft[4], uRight[4], vLeft[4], vRight[4];
+
+			repeat4(mulAdd(loadVector(uRow + index), weightsTop, loadVector(uRow + uvPitch + index), weightsBottom), uLeft);
+			repeat4(mulAdd(loadVector(uRow + index + 1), weightsTop, loadVector(uRow + uvPitch + index + 1), weightsBottom), uRight);
+			repeat4(mulAdd(loadVector(vRow + index), weightsTop, loadVector(vRow + uvPitch + index), weightsBottom), vLeft);
+			repeat4(mulAdd(loadVector(vRow + index + 1), weightsTop, loadVector(vRow + uvPitch + index + 1), weightsBottom), vRight);
+
+			for (int i = 0; i < 4; i++) {
+				Vector r, g, b;
+				chromaTerms(shiftRight4(mulAdd(uLeft[i], weightsLeft, uRight[i], weightsRight)),
+				            shiftRight4(mulAdd(vLeft[i], weightsLeft, vRight[i], weightsRight)), r, g, b);
+				putPixels(dst + x + i * 8, loadVector(yRow + x + i * 8), r, g, b, format);
+			}
+		}
+	}
+
+	if (vectorWidth < yWidth)
+		convertYUV410ToRGB<PixelInt>(dstPtr + vectorWidth * sizeof(PixelInt), dstPitch, lookup, colorTab, ySrc + vectorWidth, uSrc + (vectorWidth >> 2), vSrc + (vectorWidth >> 2), yWidth - vectorWidth, yHeight, yPitch, uvPitch);
+}
+
+#endif // SCUMMVM_SSE2 || SCUMMVM_NEON
+
+void YUVToRGBManager::convert444(Graphics::Surface *dst, YUVToRGBManager::LuminanceScale scale, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+	// Sanity checks
+	assert(dst && dst->getPixels());
+	assert(dst->format.bytesPerPixel == 2 || dst->format.bytesPerPixel == 4);
+	assert(ySrc && uSrc && vSrc);
+
+	ConvertProc proc;
+
+	// Use a templated function to avoid an if check on every pixel
+	if (dst->format.bytesPerPixel == 2)
+		proc = convertYUV444ToRGB<uint16>;
+	else
+		proc = convertYUV444ToRGB<uint32>;
+
+#if defined(SCUMMVM_SSE2) || defined(SCUMMVM_NEON)
+	if (useVectorPath(dst->format)) {
+		if (dst->format.bytesPerPixel == 2)
+			proc = convertYUV444ToRGBVector<uint16>;
+		else
+			proc = convertYUV444ToRGBVector<uint32>;
+	}
+#endif
+
+	convert(proc, 0, dst, scale, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+}
+
+void YUVToRGBManager::convert420(Graphics::Surface *dst, YUVToRGBManager::LuminanceScale scale, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+	// Sanity checks
+	assert(dst && dst->getPixels());
+	assert(dst->format.bytesPerPixel == 2 || dst->format.bytesPerPixel == 4);
+	assert(ySrc && uSrc && vSrc);
+	assert((yWidth & 1) == 0);
+	assert((yHeight & 1) == 0);
+
+	ConvertProc proc;
+
+	// Use a templated function to avoid an if check on every pixel
+	if (dst->format.bytesPerPixel == 2)
+		proc = convertYUV420ToRGB<uint16>;
+	else
+		proc = convertYUV420ToRGB<uint32>;
+
+#if defined(SCUMMVM_SSE2) || defined(SCUMMVM_NEON)
+	if (useVectorPath(dst->format)) {
+		if (dst->format.bytesPerPixel == 2)
+			proc = convertYUV420ToRGBVector<uint16>;
+		else
+			proc = convertYUV420ToRGBVector<uint32>;
+	}
+#endif
+
+	convert(proc, 1, dst, scale, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+}
+
 void YUVToRGBManager::convert410(Graphics::Surface *dst, YUVToRGBManager::LuminanceScale scale, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
 	// Sanity checks
 	assert(dst && dst->getPixels());
@@ -374,13 +875,96 @@ void YUVToRGBManager::convert410(Graphics::Surface *dst, YUVToRGBManager::Lumina
 	assert((yWidth & 3) == 0);
 	assert((yHeight & 3) == 0);
 
-	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
+	ConvertProc proc;
 
 	// Use a templated function to avoid an if check on every pixel
 	if (dst->format.bytesPerPixel == 2)
-		convertYUV410ToRGB<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		proc = convertYUV410ToRGB<uint16>;
 	else
-		convertYUV410ToRGB<uint32>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		proc = convertYUV410ToRGB<uint32>;
+
+#if defined(SCUMMVM_SSE2) || defined(SCUMMVM_NEON)
+	if (useVectorPath(dst->format)) {
+		if (dst->format.bytesPerPixel == 2)
+			proc = convertYUV410ToRGBVector<uint16>;
+		else
+			proc = convertYUV410ToRGBVector<uint32>;
+	}
+#endif
+
+	convert(proc, 2, dst, scale, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+}
+
+namespace {
+
+enum {
+	/**
+	 * Bands start at multiples of this, so that the first row of each band
+	 * starts a row of chroma in all subsamplings.
+	 */
+	kBandAlignment = 4,
+
+	/** Images with fewer pixels per band are not worth waking up other threads for. */
+	kMinBandPixels = 32 * 1024
+};
+
+} // End of anonymous namespace
+
+struct YUVToRGBManager::Bands {
+	ConvertProc proc;
+	byte *dstPtr;
+	int dstPitch;
+	const YUVToRGBLookup *lookup;
+	const int16 *colorTab;
+	const byte *ySrc, *uSrc, *vSrc;
+	int yWidth, yHeight, yPitch, uvPitch;
+	int uvShift;
+	int bandHeight;
+};
+
+void YUVToRGBManager::convertBand(void *param, int band) {
+	const Bands &b = *(const Bands *)param;
+	const int y = band * b.bandHeight;
+	const int height = MIN(b.bandHeight, b.yHeight - y);
+	const int uvOffset = (y >> b.uvShift) * b.uvPitch;
+
+	b.proc(b.dstPtr + y * b.dstPitch, b.dstPitch, b.lookup, b.colorTab,
+	       b.ySrc + y * b.yPitch, b.uSrc + uvOffset, b.vSrc + uvOffset,
+	       b.yWidth, height, b.yPitch, b.uvPitch);
+}
+
+void YUVToRGBManager::convert(ConvertProc proc, int uvShift, Graphics::Surface *dst, YUVToRGBManager::LuminanceScale scale, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
+	const int pixels = yWidth * yHeight;
+
+	// The pool runs the jobs of one thread at a time, so if another thread
+	// is using it, e.g. a video decoding ahead, convert on this one
+	if (!_pool || pixels < 2 * kMinBandPixels || !Common::atomicCompareAndSwap(&_poolBusy, 0, 1)) {
+		proc((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		return;
+	}
+
+	// Two bands per thread even out differences in the cost of the bands
+	const int bands = MIN(2 * _threads, pixels / kMinBandPixels);
+
+	Bands param;
+	param.proc = proc;
+	param.dstPtr = (byte *)dst->getPixels();
+	param.dstPitch = dst->pitch;
+	param.lookup = lookup;
+	param.colorTab = _colorTab;
+	param.ySrc = ySrc;
+	param.uSrc = uSrc;
+	param.vSrc = vSrc;
+	param.yWidth = yWidth;
+	param.yHeight = yHeight;
+	param.yPitch = yPitch;
+	param.uvPitch = uvPitch;
+	param.uvShift = uvShift;
+	param.bandHeight = ((yHeight + bands - 1) / bands + kBandAlignment - 1) & ~(kBandAlignment - 1);
+
+	_pool->run(convertBand, &param, (yHeight + param.bandHeight - 1) / param.bandHeight);
+	Common::atomicStore(&_poolBusy, 0);
 }
 
 } // End of namespace Graphics
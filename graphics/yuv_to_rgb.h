@@ -39,7 +39,9 @@
 #define GRAPHICS_YUV_TO_RGB_H
 
 #include "common/scummsys.h"
+#include "common/array.h"
 #include "common/singleton.h"
+#include "common/thread.h"
 #include "graphics/surface.h"
 
 namespace Graphics {
@@ -105,15 +107,52 @@ public:
 	 */
 	void convert410(Graphics::Surface *dst, LuminanceScale scale, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch);
 
+	/**
+	 * Set the number of threads large images are converted on. Passing 0
+	 * uses one per processor, 1 converts everything on the calling thread.
+	 * The result is the same either way. The manager starts out with 1, but
+	 * when a game is started, it is set from the video_threads option, which
+	 * defaults to 0.
+	 *
+	 * Images may be converted on several threads at once, e.g. by videos
+	 * decoding ahead, but this must not be called while they are.
+	 */
+	void setThreads(int threads);
+
+	/** Return the number of threads large images are converted on. */
+	int getThreads() const { return _threads; }
+
 private:
 	friend class Common::Singleton<SingletonBaseType>;
 	YUVToRGBManager();
 	~YUVToRGBManager();
 
+	typedef void (*ConvertProc)(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, const int16 *colorTab, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch);
+
 	const YUVToRGBLookup *getLookup(Graphics::PixelFormat format, LuminanceScale scale);
 
-	YUVToRGBLookup *_lookup;
+	/**
+	 * Run a conversion function on the image, split into bands of rows if
+	 * it is large enough and there are several threads.
+	 *
+	 * @param uvShift the vertical chroma subsampling, as a power of two
+	 */
+	void convert(ConvertProc proc, int uvShift, Graphics::Surface *dst, LuminanceScale scale, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch);
+
+	struct Bands;
+	static void convertBand(void *param, int band);
+
+	/**
+	 * All lookup tables created so far. They are kept until the manager is
+	 * destroyed, since other threads may still be converting with them.
+	 */
+	Common::Array<YUVToRGBLookup *> _lookups;
+	Common::Semaphore _lookupLock; ///< Guards _lookups
 	int16 _colorTab[4 * 256]; // 2048 bytes
+
+	Common::WorkerPool *_pool; ///< Threads converting large images, if any
+	Common::AtomicInt32 _poolBusy; ///< 1 while a thread is converting on the pool
+	int _threads;
 };
 
 } // End of namespace Graphics
@@ -23,6 +23,7 @@
 // NB: This is really only necessary if USE_READLINE is defined
 #define FORBIDDEN_SYMBOL_ALLOW_ALL
 
+#include "common/atomic.h"
 #include "common/debug.h"
 #include "common/debug-channels.h"
 #include "common/system.h"
@@ -47,11 +48,33 @@
 
 namespace GUI {
 
+namespace {
+// Heap allocations done by Common::String during the current frame. Strings
+// are also allocated on other threads, e.g. by videos decoding ahead.
+Common::AtomicInt32 g_stringAllocations = 0;
+Common::AtomicInt32 g_stringAllocatedBytes = 0;
+
+void countStringAllocation(uint32 bytes) {
+	Common::atomicAdd(&g_stringAllocations, 1);
+	Common::atomicAdd(&g_stringAllocatedBytes, bytes);
+}
+
+// Return a counter and set it back to 0, without losing what other threads
+// add in between
+uint32 takeCount(Common::AtomicInt32 *counter) {
+	const int32 value = Common::atomicLoad(counter);
+	Common::atomicAdd(counter, -value);
+	return value;
+}
+} // End of anonymous namespace
+
 Debugger::Debugger() {
 	_frameCountdown = 0;
 	_isActive = false;
 	_errStr = NULL;
 	_firstTime = true;
+	_stringStats.enabled = false;
+	resetStringStats();
 #ifndef USE_TEXT_CONSOLE_FOR_DEBUGGER
 	_debuggerDialog = new GUI::ConsoleDialog(1.0f, 0.67f);
 	_debuggerDialog->setInputCallback(debuggerInputCallback, this);
@@ -77,9 +100,12 @@ Debugger::Debugger() {
 	registerCmd("debugflag_list",		WRAP_METHOD(Debugger, cmdDebugFlagsList));
 	registerCmd("debugflag_enable",	WRAP_METHOD(Debugger, cmdDebugFlagEnable));
 	registerCmd("debugflag_disable",	WRAP_METHOD(Debugger, cmdDebugFlagDisable));
+	registerCmd("string_stats",		WRAP_METHOD(Debugger, cmdStringStats));
 }
 
 Debugger::~Debugger() {
+	if (_stringStats.enabled)
+		Common::String::setAllocationHook(0);
 #ifndef USE_TEXT_CONSOLE_FOR_DEBUGGER
 	delete _debuggerDialog;
 #endif
@@ -179,10 +205,41 @@ void Debugger::onFrame() {
 			enter();
 			postEnter();
 			_isActive = false;
+
+			// Do not count the allocations of the console itself
+			takeCount(&g_stringAllocations);
+			takeCount(&g_stringAllocatedBytes);
 		}
 	}
 }
 
+void Debugger::onFrameEnd() {
+	if (!_stringStats.enabled)
+		return;
+
+	const uint32 allocations = takeCount(&g_stringAllocations);
+	const uint32 bytes = takeCount(&g_stringAllocatedBytes);
+
+	_stringStats.frames++;
+	_stringStats.lastAllocations = allocations;
+	_stringStats.lastBytes = bytes;
+	_stringStats.peakAllocations = MAX(_stringStats.peakAllocations, allocations);
+	_stringStats.totalAllocations += allocations;
+	_stringStats.totalBytes += bytes;
+}
+
+void Debugger::resetStringStats() {
+	_stringStats.frames = 0;
+	_stringStats.lastAllocations = 0;
+	_stringStats.lastBytes = 0;
+	_stringStats.peakAllocations = 0;
+	_stringStats.totalAllocations = 0;
+	_stringStats.totalBytes = 0;
+
+	takeCount(&g_stringAllocations);
+	takeCount(&g_stringAllocatedBytes);
+}
+
 #if defined(USE_TEXT_CONSOLE_FOR_DEBUGGER) && defined(USE_READLINE)
 namespace {
 Debugger *g_readline_debugger;
@@ -717,6 +774,46 @@ bool Debugger::cmdDebugFlagDisable(int argc, const char **argv) {
 	return true;
 }
 
+bool Debugger::cmdStringStats(int argc, const char **argv) {
+	if (argc > 1) {
+		if (!scumm_stricmp(argv[1], "on")) {
+			resetStringStats();
+			_stringStats.enabled = true;
+			Common::String::setAllocationHook(countStringAllocation);
+			debugPrintf("String allocation statistics enabled\n");
+		} else if (!scumm_stricmp(argv[1], "off")) {
+			_stringStats.enabled = false;
+			Common::String::setAllocationHook(0);
+			debugPrintf("String allocation statistics disabled\n");
+		} else if (!scumm_stricmp(argv[1], "reset")) {
+			resetStringStats();
+			debugPrintf("String allocation statistics reset\n");
+		} else {
+			debugPrintf("Usage: %s [on | off | reset]\n", argv[0]);
+		}
+		return true;
+	}
+
+	if (!_stringStats.enabled) {
+		debugPrintf("String allocation statistics are disabled\n");
+		debugPrintf("Usage: %s [on | off | reset]\n", argv[0]);
+		return true;
+	}
+
+	if (_stringStats.frames == 0) {
+		debugPrintf("No frames counted yet (the engine may not report frames)\n");
+		return true;
+	}
+
+	debugPrintf("String heap allocations over %d frames:\n", _stringStats.frames);
+	debugPrintf("  last frame: %d (%d bytes)\n", _stringStats.lastAllocations, _stringStats.lastBytes);
+	debugPrintf("  average:    %d (%d bytes)\n",
+	            (int)(_stringStats.totalAllocations / _stringStats.frames),
+	            (int)(_stringStats.totalBytes / _stringStats.frames));
+	debugPrintf("  peak:       %d\n", _stringStats.peakAllocations);
+	return true;
+}
+
 // Console handler
 #ifndef USE_TEXT_CONSOLE_FOR_DEBUGGER
 bool Debugger::debuggerInputCallback(GUI::ConsoleDialog *console, const char *input, void *refCon) {
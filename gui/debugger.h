@@ -60,6 +60,14 @@ public:
 	 */
 	virtual void onFrame();
 
+	/**
+	 * The onFrameEnd() method should be invoked by the engine once for
+	 * each frame it displays, whether the debugger is attached or not.
+	 * It drives the per frame statistics offered by the debugger, like
+	 * those of the string_stats command.
+	 */
+	void onFrameEnd();
+
 	/**
 	 * 'Attach' the debugger. This ensures that the next time onFrame()
 	 * is invoked, the debugger will activate and accept user input.
@@ -175,6 +183,22 @@ private:
 	GUI::ConsoleDialog *_debuggerDialog;
 #endif
 
+	/**
+	 * Heap allocations done by Common::String, collected per frame while
+	 * enabled through the string_stats command.
+	 */
+	struct StringStats {
+		bool enabled;
+		uint32 frames;
+		uint32 lastAllocations;
+		uint32 lastBytes;
+		uint32 peakAllocations;
+		uint64 totalAllocations;
+		uint64 totalBytes;
+	} _stringStats;
+
+	void resetStringStats();
+
 protected:
 	/**
 	 * Hook for subclasses which is called just before enter() is run.
@@ -226,6 +250,7 @@ protected:
 	bool cmdDebugFlagsList(int argc, const char **argv);
 	bool cmdDebugFlagEnable(int argc, const char **argv);
 	bool cmdDebugFlagDisable(int argc, const char **argv);
+	bool cmdStringStats(int argc, const char **argv);
 
 #ifndef USE_TEXT_CONSOLE_FOR_DEBUGGER
 private:
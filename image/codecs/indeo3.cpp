@@ -482,11 +482,13 @@ void Indeo3Decoder::decodeChunk(byte *cur, byte *ref, int width, int height,
 			cmd = (bit_buf >> bit_pos) & 0x03;
 
 			if (cmd == 0 || ref_vectors != NULL) {
-				for (lp1 = 0; lp1 < blks_width; lp1++) {
-					for (i = 0, j = 0; i < blks_height; i++, j += width_tbl[1])
-						((uint32 *)cur_frm_pos)[j] = READ_UINT32(((uint32 *)ref_frm_pos)+j);
-					cur_frm_pos += 4;
-					ref_frm_pos += 4;
+				// Copy whole rows, from the top down. Without a motion vector
+				// each row is copied from the one above it, so the row above
+				// the strip still ends up repeated all the way down.
+				for (i = 0; i < blks_height; i++) {
+					memcpy(cur_frm_pos, ref_frm_pos, blks_width * 4);
+					cur_frm_pos += width_tbl[1] * 4;
+					ref_frm_pos += width_tbl[1] * 4;
 				}
 			} else if (cmd != 1)
 				return;
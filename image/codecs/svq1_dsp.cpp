@@ -0,0 +1,252 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+// The C++ interpolators are based off FFmpeg's dsputil
+
+#include "image/codecs/svq1_dsp.h"
+
+#include "common/cpudetect.h"
+#include "common/endian.h"
+
+#if defined(SCUMMVM_SSE2)
+#include <emmintrin.h>
+#endif
+
+#if defined(SCUMMVM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace Image {
+
+static inline uint32 rndAvg32(uint32 a, uint32 b) {
+	return (a | b) - (((a ^ b) & ~0x01010101) >> 1);
+}
+
+static void putPixels8L2(byte *dst, const byte *src1, const byte *src2,
+		int dstStride, int srcStride1, int srcStride2, int h) {
+	for (int i = 0; i < h; i++) {
+		uint32 a = READ_UINT32(&src1[srcStride1 * i]);
+		uint32 b = READ_UINT32(&src2[srcStride2 * i]);
+		*((uint32 *)&dst[dstStride * i]) = rndAvg32(a, b);
+		a = READ_UINT32(&src1[srcStride1 * i + 4]);
+		b = READ_UINT32(&src2[srcStride2 * i + 4]);
+		*((uint32 *)&dst[dstStride * i + 4]) = rndAvg32(a, b);
+	}
+}
+
+static void putPixels8XY2C(byte *block, const byte *pixels, int lineSize, int h) {
+	for (int j = 0; j < 2; j++) {
+		uint32 a = READ_UINT32(pixels);
+		uint32 b = READ_UINT32(pixels + 1);
+		uint32 l0 = (a & 0x03030303UL) + (b & 0x03030303UL) + 0x02020202UL;
+		uint32 h0 = ((a & 0xFCFCFCFCUL) >> 2) + ((b & 0xFCFCFCFCUL) >> 2);
+
+		pixels += lineSize;
+
+		for (int i = 0; i < h; i += 2) {
+			a = READ_UINT32(pixels);
+			b = READ_UINT32(pixels + 1);
+			uint32 l1 = (a & 0x03030303UL) + (b & 0x03030303UL);
+			uint32 h1 = ((a & 0xFCFCFCFCUL) >> 2) + ((b & 0xFCFCFCFCUL) >> 2);
+			*((uint32 *)block) = h0 + h1 + (((l0 + l1) >> 2) & 0x0F0F0F0FUL);
+			pixels += lineSize;
+			block += lineSize;
+			a = READ_UINT32(pixels);
+			b = READ_UINT32(pixels + 1);
+			l0 = (a & 0x03030303UL) + (b & 0x03030303UL) + 0x02020202UL;
+			h0 = ((a & 0xFCFCFCFCUL) >> 2) + ((b & 0xFCFCFCFCUL) >> 2);
+			*((uint32 *)block) = h0 + h1 + (((l0 + l1) >> 2) & 0x0F0F0F0FUL);
+			pixels += lineSize;
+			block += lineSize;
+		}
+
+		pixels += 4 - lineSize * (h + 1);
+		block += 4 - lineSize * h;
+	}
+}
+
+#if defined(SCUMMVM_SSE2)
+
+// A row of a block goes into the low 8 or all 16 bytes of a register. Only
+// the pixels of the block are read, since it may sit at the end of a plane.
+
+template<int kWidth>
+static inline __m128i loadRowSSE2(const byte *src) {
+	if (kWidth == 16)
+		return _mm_loadu_si128((const __m128i *)src);
+	return _mm_loadl_epi64((const __m128i *)src);
+}
+
+template<int kWidth>
+static inline void storeRowSSE2(byte *dst, __m128i row) {
+	if (kWidth == 16)
+		_mm_storeu_si128((__m128i *)dst, row);
+	else
+		_mm_storel_epi64((__m128i *)dst, row);
+}
+
+template<int kWidth>
+static void putPixelsL2SSE2(byte *block, const byte *src1, const byte *src2, int lineSize, int h) {
+	for (int i = 0; i < h; i++) {
+		// pavgb rounds up, just like rndAvg32()
+		storeRowSSE2<kWidth>(block, _mm_avg_epu8(loadRowSSE2<kWidth>(src1), loadRowSSE2<kWidth>(src2)));
+		block += lineSize;
+		src1 += lineSize;
+		src2 += lineSize;
+	}
+}
+
+/**
+ * Add each pixel of a row to its right neighbour. The 16 bit sums of the
+ * low and high 8 pixels go into lo and hi.
+ */
+template<int kWidth>
+static inline void pairSumsSSE2(const byte *src, __m128i &lo, __m128i &hi) {
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i a = loadRowSSE2<kWidth>(src);
+	const __m128i b = loadRowSSE2<kWidth>(src + 1);
+
+	lo = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+	hi = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+}
+
+template<int kWidth>
+static void putPixelsXY2SSE2(byte *block, const byte *pixels, int lineSize, int h) {
+	const __m128i two = _mm_set1_epi16(2);
+	__m128i lo0, hi0, lo1, hi1;
+
+	pairSumsSSE2<kWidth>(pixels, lo0, hi0);
+
+	for (int i = 0; i < h; i++) {
+		pixels += lineSize;
+		pairSumsSSE2<kWidth>(pixels, lo1, hi1);
+
+		// (a + b + c + d + 2) >> 2, each row's sums being used twice
+		const __m128i lo = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(lo0, lo1), two), 2);
+		const __m128i hi = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(hi0, hi1), two), 2);
+		storeRowSSE2<kWidth>(block, _mm_packus_epi16(lo, hi));
+
+		block += lineSize;
+		lo0 = lo1;
+		hi0 = hi1;
+	}
+}
+
+#endif // SCUMMVM_SSE2
+
+#if defined(SCUMMVM_NEON)
+
+static void putPixelsL2NEON(byte *block, const byte *src1, const byte *src2, int lineSize, int width, int h) {
+	for (int i = 0; i < h; i++) {
+		// vrhadd rounds up, just like rndAvg32()
+		if (width == 16)
+			vst1q_u8(block, vrhaddq_u8(vld1q_u8(src1), vld1q_u8(src2)));
+		else
+			vst1_u8(block, vrhadd_u8(vld1_u8(src1), vld1_u8(src2)));
+		block += lineSize;
+		src1 += lineSize;
+		src2 += lineSize;
+	}
+}
+
+static void putPixelsXY2NEON(byte *block, const byte *pixels, int lineSize, int width, int h) {
+	for (int x = 0; x < width; x += 8) {
+		const byte *src = pixels + x;
+		byte *dst = block + x;
+		uint16x8_t sum0 = vaddl_u8(vld1_u8(src), vld1_u8(src + 1));
+
+		for (int i = 0; i < h; i++) {
+			src += lineSize;
+			const uint16x8_t sum1 = vaddl_u8(vld1_u8(src), vld1_u8(src + 1));
+
+			// (a + b + c + d + 2) >> 2, each row's sums being used twice
+			vst1_u8(dst, vrshrn_n_u16(vaddq_u16(sum0, sum1), 2));
+
+			dst += lineSize;
+			sum0 = sum1;
+		}
+	}
+}
+
+#endif // SCUMMVM_NEON
+
+void svq1PutPixels(byte *block, const byte *pixels, int lineSize, int width, int h) {
+	for (int i = 0; i < h; i++) {
+		memcpy(block, pixels, width);
+		pixels += lineSize;
+		block += lineSize;
+	}
+}
+
+/**
+ * Put the averages of two blocks, which are lineSize apart for vertical
+ * interpolation and one pixel apart for horizontal interpolation.
+ */
+static void putPixelsL2(byte *block, const byte *src1, const byte *src2, int lineSize, int width, int h) {
+#if defined(SCUMMVM_SSE2)
+	if (Common::hasCPUFeature(Common::kCPUFeatureSSE2)) {
+		if (width == 16)
+			putPixelsL2SSE2<16>(block, src1, src2, lineSize, h);
+		else
+			putPixelsL2SSE2<8>(block, src1, src2, lineSize, h);
+		return;
+	}
+#elif defined(SCUMMVM_NEON)
+	if (Common::hasCPUFeature(Common::kCPUFeatureNEON)) {
+		putPixelsL2NEON(block, src1, src2, lineSize, width, h);
+		return;
+	}
+#endif
+
+	for (int x = 0; x < width; x += 8)
+		putPixels8L2(block + x, src1 + x, src2 + x, lineSize, lineSize, lineSize, h);
+}
+
+void svq1PutPixelsX2(byte *block, const byte *pixels, int lineSize, int width, int h) {
+	putPixelsL2(block, pixels, pixels + 1, lineSize, width, h);
+}
+
+void svq1PutPixelsY2(byte *block, const byte *pixels, int lineSize, int width, int h) {
+	putPixelsL2(block, pixels, pixels + lineSize, lineSize, width, h);
+}
+
+void svq1PutPixelsXY2(byte *block, const byte *pixels, int lineSize, int width, int h) {
+#if defined(SCUMMVM_SSE2)
+	if (Common::hasCPUFeature(Common::kCPUFeatureSSE2)) {
+		if (width == 16)
+			putPixelsXY2SSE2<16>(block, pixels, lineSize, h);
+		else
+			putPixelsXY2SSE2<8>(block, pixels, lineSize, h);
+		return;
+	}
+#elif defined(SCUMMVM_NEON)
+	if (Common::hasCPUFeature(Common::kCPUFeatureNEON)) {
+		putPixelsXY2NEON(block, pixels, lineSize, width, h);
+		return;
+	}
+#endif
+
+	for (int x = 0; x < width; x += 8)
+		putPixels8XY2C(block + x, pixels + x, lineSize, h);
+}
+
+} // End of namespace Image
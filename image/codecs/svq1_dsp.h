@@ -0,0 +1,49 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef IMAGE_CODECS_SVQ1_DSP_H
+#define IMAGE_CODECS_SVQ1_DSP_H
+
+#include "common/scummsys.h"
+
+namespace Image {
+
+// The half-pel motion compensation of the SVQ1 decoder. The blocks are 8
+// or 16 pixels wide, and an even number of rows high. The interpolated
+// pixels are rounded up, like in the original decoder, and the vector
+// units are used when available. All paths give exactly the same result.
+
+/** Copy a block of pixels. */
+void svq1PutPixels(byte *block, const byte *pixels, int lineSize, int width, int h);
+
+/** Put the average of each pixel and its right neighbour. */
+void svq1PutPixelsX2(byte *block, const byte *pixels, int lineSize, int width, int h);
+
+/** Put the average of each pixel and the one below it. */
+void svq1PutPixelsY2(byte *block, const byte *pixels, int lineSize, int width, int h);
+
+/** Put the average of each pixel and its right, lower and diagonal neighbours. */
+void svq1PutPixelsXY2(byte *block, const byte *pixels, int lineSize, int width, int h);
+
+} // End of namespace Image
+
+#endif // IMAGE_CODECS_SVQ1_DSP_H
@@ -20,6 +20,7 @@ MODULE_OBJS := \
 	codecs/rpza.o \
 	codecs/smc.o \
 	codecs/svq1.o \
+	codecs/svq1_dsp.o \
 	codecs/truemotion1.o
 
 ifdef USE_MPEG2
@@ -0,0 +1,231 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/audiostream.h"
+#include "audio/decoders/raw.h"
+#include "audio/rate.h"
+
+#include "common/config-manager.h"
+#include "common/cpudetect.h"
+#include "common/endian.h"
+#include "common/stream.h"
+
+#include "test/system.h"
+
+class RateConverterTestSuite : public CxxTest::TestSuite
+{
+private:
+	// The sinc converters share their filters under a mutex
+	TestSystem *_system;
+
+	static uint32 nextRandom(uint32 &seed) {
+		seed = seed * 1103515245 + 12345;
+		return seed >> 8;
+	}
+
+	/**
+	 * Create a stream of loud noise, so that the mixing saturates often.
+	 */
+	static Audio::AudioStream *createNoiseStream(int rate, int samples, bool stereo, uint32 seed) {
+		int16 *data = (int16 *)malloc(samples * sizeof(int16));
+		for (int i = 0; i < samples; ++i)
+			WRITE_LE_UINT16(&data[i], (uint16)nextRandom(seed));
+
+		Common::SeekableReadStream *stream = new Common::MemoryReadStream((const byte *)data, samples * sizeof(int16), DisposeAfterUse::YES);
+		return Audio::makeRawStream(stream, rate, Audio::FLAG_16BITS | Audio::FLAG_LITTLE_ENDIAN | (stereo ? Audio::FLAG_STEREO : 0));
+	}
+
+	/**
+	 * Run a converter over a whole noise stream, in odd sized chunks, and
+	 * mix its output into a noise prefilled buffer.
+	 */
+	static int16 *convert(uint32 features, int inRate, int outRate, bool stereo, bool reverseStereo, Audio::st_volume_t volL, Audio::st_volume_t volR, int &pairs) {
+		Common::setCPUFeatureMask(features);
+
+		const int inSamples = 9973 * (stereo ? 2 : 1);
+		Audio::AudioStream *stream = createNoiseStream(inRate, inSamples, stereo, 1);
+		Audio::RateConverter *converter = Audio::makeRateConverter(inRate, outRate, stereo, reverseStereo);
+
+		const int maxPairs = inSamples * outRate / inRate + 1024;
+		int16 *out = new int16[maxPairs * 2];
+		uint32 seed = 2;
+		for (int i = 0; i < maxPairs * 2; ++i)
+			out[i] = (int16)nextRandom(seed);
+
+		pairs = 0;
+		int chunk = 1;
+		while (pairs + chunk <= maxPairs) {
+			const int produced = converter->flow(*stream, out + pairs * 2, chunk, volL, volR);
+			pairs += produced;
+			if (produced < chunk)
+				break;
+			chunk = chunk * 3 % 997 + 1;
+		}
+
+		delete converter;
+		delete stream;
+
+		Common::setCPUFeatureMask(Common::kCPUFeatureAll);
+		return out;
+	}
+
+	/**
+	 * Run the sinc converter over the given mono input, as far as the input
+	 * goes, and return the number of samples it produced.
+	 */
+	static int convertSinc(const int16 *data, int inSamples, int inRate, int outRate, int16 *out, int maxSamples) {
+		ConfMan.set("resampler", "sinc", Common::ConfigManager::kTransientDomain);
+
+		byte *copy = (byte *)malloc(inSamples * sizeof(int16));
+		for (int i = 0; i < inSamples; ++i)
+			WRITE_LE_UINT16(copy + i * 2, data[i]);
+
+		Common::SeekableReadStream *stream = new Common::MemoryReadStream(copy, inSamples * sizeof(int16), DisposeAfterUse::YES);
+		Audio::AudioStream *input = Audio::makeRawStream(stream, inRate, Audio::FLAG_16BITS | Audio::FLAG_LITTLE_ENDIAN);
+		Audio::RateConverter *converter = Audio::makeRateConverter(inRate, outRate, false);
+
+		memset(out, 0, maxSamples * 2 * sizeof(int16));
+		const int produced = converter->flow(*input, out, maxSamples, 256, 256);
+
+		delete converter;
+		delete input;
+
+		ConfMan.removeKey("resampler", Common::ConfigManager::kTransientDomain);
+		return produced;
+	}
+
+	void compareTemplate(int inRate, int outRate, bool stereo, bool reverseStereo, Audio::st_volume_t volL, Audio::st_volume_t volR, const char *resampler = "linear") {
+		ConfMan.set("resampler", resampler, Common::ConfigManager::kTransientDomain);
+
+		int refPairs, vecPairs;
+		int16 *ref = convert(0, inRate, outRate, stereo, reverseStereo, volL, volR, refPairs);
+		int16 *vec = convert(Common::kCPUFeatureAll, inRate, outRate, stereo, reverseStereo, volL, volR, vecPairs);
+
+		TS_ASSERT_EQUALS(refPairs, vecPairs);
+		TS_ASSERT_EQUALS(memcmp(ref, vec, refPairs * 2 * sizeof(int16)), 0);
+
+		delete[] ref;
+		delete[] vec;
+
+		ConfMan.removeKey("resampler", Common::ConfigManager::kTransientDomain);
+	}
+
+public:
+	void setUp() {
+		_system = new TestSystem();
+		g_system = _system;
+	}
+
+	void tearDown() {
+		g_system = 0;
+		delete _system;
+	}
+
+	void test_copy_mono() {
+		compareTemplate(22050, 22050, false, false, 256, 256);
+		compareTemplate(22050, 22050, false, false, 37, 211);
+	}
+
+	void test_copy_stereo() {
+		compareTemplate(44100, 44100, true, false, 256, 0);
+		compareTemplate(44100, 44100, true, true, 129, 255);
+	}
+
+	void test_simple_mono() {
+		compareTemplate(44100, 22050, false, false, 256, 256);
+		compareTemplate(44100, 11025, false, false, 17, 200);
+	}
+
+	void test_simple_stereo() {
+		compareTemplate(44100, 22050, true, false, 255, 64);
+		compareTemplate(44100, 22050, true, true, 100, 256);
+	}
+
+	void test_linear_mono() {
+		compareTemplate(11025, 44100, false, false, 256, 256);
+		compareTemplate(22050, 48000, false, false, 1, 199);
+	}
+
+	void test_linear_stereo() {
+		compareTemplate(22050, 44100, true, false, 256, 128);
+		compareTemplate(32000, 44100, true, true, 73, 256);
+	}
+
+	void test_sinc_mono() {
+		compareTemplate(11025, 44100, false, false, 256, 256, "sinc");
+		compareTemplate(44100, 11025, false, false, 37, 211, "sinc");
+	}
+
+	void test_sinc_stereo() {
+		compareTemplate(22050, 48000, true, false, 256, 128, "sinc");
+		compareTemplate(48000, 44100, true, true, 73, 256, "sinc");
+	}
+
+	void test_sinc_dc() {
+		// A constant signal has to pass the filter unchanged, once the
+		// filter history has been filled.
+		ConfMan.set("resampler", "sinc", Common::ConfigManager::kTransientDomain);
+
+		const int inSamples = 4000;
+		int16 *data = (int16 *)malloc(inSamples * sizeof(int16));
+		for (int i = 0; i < inSamples; ++i)
+			WRITE_LE_UINT16(&data[i], 12345);
+
+		Common::SeekableReadStream *stream = new Common::MemoryReadStream((const byte *)data, inSamples * sizeof(int16), DisposeAfterUse::YES);
+		Audio::AudioStream *input = Audio::makeRawStream(stream, 22050, Audio::FLAG_16BITS | Audio::FLAG_LITTLE_ENDIAN);
+		Audio::RateConverter *converter = Audio::makeRateConverter(22050, 44100, false);
+
+		int16 out[2 * 4000];
+		memset(out, 0, sizeof(out));
+		TS_ASSERT_EQUALS(converter->flow(*input, out, 4000, 256, 256), 4000);
+		for (int i = 100; i < 4000; ++i) {
+			TS_ASSERT_EQUALS(out[i * 2], 12345);
+			TS_ASSERT_EQUALS(out[i * 2 + 1], 12345);
+		}
+
+		delete converter;
+		delete input;
+
+		ConfMan.removeKey("resampler", Common::ConfigManager::kTransientDomain);
+	}
+
+	void test_sinc_rate() {
+		// These rate pairs need more phases than the filter has. One second
+		// of input still has to give one second of output, apart from the
+		// half filter length the converter waits for at the end.
+		static const int rates[][2] = { { 11025, 48000 }, { 22254, 44100 }, { 44100, 11127 } };
+		const int maxSamples = 50000;
+		int16 *data = new int16[44100];
+		int16 *out = new int16[maxSamples * 2];
+		memset(data, 0, 44100 * sizeof(int16));
+
+		for (int i = 0; i < ARRAYSIZE(rates); ++i) {
+			const int inRate = rates[i][0];
+			const int outRate = rates[i][1];
+			const int produced = convertSinc(data, inRate, inRate, outRate, out, maxSamples);
+			const int delay = 64 / 2 * outRate / inRate + 1;
+			TS_ASSERT_LESS_THAN_EQUALS(outRate - delay, produced);
+			TS_ASSERT_LESS_THAN_EQUALS(produced, outRate);
+		}
+
+		delete[] data;
+		delete[] out;
+	}
+
+	void test_sinc_latency() {
+		// The output must not be delayed against the input: an impulse at
+		// input sample 100 peaks at output sample 200 when doubling the rate.
+		int16 data[1000];
+		int16 out[2 * 2000];
+		memset(data, 0, sizeof(data));
+		data[100] = 16384;
+
+		TS_ASSERT_EQUALS(convertSinc(data, 1000, 22050, 44100, out, 1000), 1000);
+
+		int peak = 0;
+		for (int i = 0; i < 1000; ++i) {
+			if (out[i * 2] > out[peak * 2])
+				peak = i;
+		}
+		TS_ASSERT_EQUALS(peak, 200);
+	}
+};
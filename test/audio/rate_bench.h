@@ -0,0 +1,86 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/audiostream.h"
+#include "audio/rate.h"
+
+#include "common/config-manager.h"
+#include "common/str.h"
+
+/**
+ * An endless stream of noise, so that the benchmark only measures the
+ * converter and not the decoding of the input.
+ */
+class NoiseStream : public Audio::AudioStream {
+public:
+	NoiseStream(int rate, bool stereo) : _rate(rate), _stereo(stereo), _seed(1) {}
+
+	int readBuffer(int16 *buffer, const int numSamples) {
+		for (int i = 0; i < numSamples; ++i) {
+			_seed = _seed * 1103515245 + 12345;
+			buffer[i] = (int16)(_seed >> 16);
+		}
+		return numSamples;
+	}
+
+	bool isStereo() const { return _stereo; }
+	int getRate() const { return _rate; }
+	bool endOfData() const { return false; }
+
+private:
+	int _rate;
+	bool _stereo;
+	uint32 _seed;
+};
+
+class RateConverterBenchmarkSuite : public CxxTest::TestSuite
+{
+private:
+	enum {
+		kBufferPairs = 2048,
+		kTotalPairs = 2 * 1024 * 1024
+	};
+
+	/**
+	 * @return nanoseconds per output sample pair
+	 */
+	double measure(const char *resampler, int inRate, int outRate, bool stereo) {
+		ConfMan.set("resampler", resampler, Common::ConfigManager::kTransientDomain);
+
+		NoiseStream input(inRate, stereo);
+		Audio::RateConverter *converter = Audio::makeRateConverter(inRate, outRate, stereo);
+		int16 *buffer = new int16[kBufferPairs * 2];
+
+		const unsigned long long start = benchmarkMicros();
+		for (int done = 0; done < kTotalPairs; done += kBufferPairs) {
+			memset(buffer, 0, kBufferPairs * 2 * sizeof(int16));
+			TS_ASSERT_EQUALS(converter->flow(input, buffer, kBufferPairs, 192, 192), kBufferPairs);
+		}
+		const unsigned long long elapsed = benchmarkMicros() - start;
+
+		delete[] buffer;
+		delete converter;
+
+		ConfMan.removeKey("resampler", Common::ConfigManager::kTransientDomain);
+		return elapsed * 1000.0 / kTotalPairs;
+	}
+
+	void compare(int inRate, int outRate, bool stereo) {
+		const double linear = measure("linear", inRate, outRate, stereo);
+		const double sinc = measure("sinc", inRate, outRate, stereo);
+
+		benchmarkReport(Common::String::format("%5d -> %5d Hz %-6s: linear %6.2f ns/sample, sinc %6.2f ns/sample (x%.1f)",
+		                 inRate, outRate, stereo ? "stereo" : "mono", linear, sinc, sinc / linear));
+	}
+
+public:
+	void test_resampler_cost() {
+		compare(11025, 44100, false);
+		compare(11025, 48000, false);
+		compare(22050, 44100, false);
+		compare(22050, 48000, false);
+		compare(22050, 44100, true);
+		compare(44100, 48000, true);
+		compare(48000, 44100, true);
+		compare(44100, 22050, false);
+	}
+};
@@ -0,0 +1,147 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/str.h"
+
+#if defined(POSIX)
+#include "backends/fs/stdiostream.h"
+#include "backends/fs/posix/posix-fs.h"
+
+#include <unistd.h>
+#endif
+
+class FileStreamBenchmarkSuite : public CxxTest::TestSuite
+{
+private:
+#if defined(POSIX)
+	enum {
+		kFileSize = 64 * 1024 * 1024,
+		kChunkSize = 64 * 1024,
+		kIndexStep = 1024 * 1024	///< Distance of the bytes "startup" looks at
+	};
+
+	Common::String _path;
+
+	struct Measurement {
+		double millis;
+		double residentMB;	///< Growth of the resident set while the data is loaded
+		double privateMB;	///< The part of it which is not shared with the page cache
+	};
+
+	/**
+	 * Reads the resident and the shared memory of the process in bytes.
+	 * @return false if the system does not tell
+	 */
+	static bool readMemory(double &resident, double &shared) {
+#ifdef __linux__
+		StdioStream *statm = StdioStream::makeFromPath("/proc/self/statm", false);
+		if (!statm)
+			return false;
+		const Common::String line = statm->readLine();
+		delete statm;
+
+		// size resident shared text lib data dt, in pages
+		unsigned long fields[3] = { 0, 0, 0 };
+		int field = 0;
+		for (uint i = 0; i < line.size() && field < 3; ++i) {
+			if (line[i] == ' ')
+				++field;
+			else if (field < 3)
+				fields[field] = fields[field] * 10 + (line[i] - '0');
+		}
+
+		const double pageSize = sysconf(_SC_PAGESIZE);
+		resident = fields[1] * pageSize;
+		shared = fields[2] * pageSize;
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	/**
+	 * Loads the file the way engines do, or by mapping it, and then either
+	 * looks at an index spread over the file, like a game starting up, or
+	 * at all of it.
+	 */
+	Measurement measure(bool map, bool scanAll) {
+		double residentBefore = 0, sharedBefore = 0, residentAfter = 0, sharedAfter = 0;
+		readMemory(residentBefore, sharedBefore);
+
+		const unsigned long long start = benchmarkMicros();
+
+		Common::SeekableReadStream *stream;
+		const byte *data;
+		byte *buffer = 0;
+		if (map) {
+			// The way game data files are opened, see FSDirectory
+			stream = POSIXFilesystemNode(_path).createGameDataReadStream();
+			data = stream->getDataPointer();
+			TS_ASSERT(data);
+		} else {
+			stream = StdioStream::makeFromPath(_path, false);
+			buffer = new byte[stream->size()];
+			stream->read(buffer, stream->size());
+			data = buffer;
+		}
+
+		uint32 sum = 0;
+		const int step = scanAll ? 1 : kIndexStep;
+		for (int i = 0; i < kFileSize; i += step)
+			sum += data[i];
+
+		Measurement result;
+		result.millis = (benchmarkMicros() - start) / 1000.0;
+
+		readMemory(residentAfter, sharedAfter);
+		result.residentMB = (residentAfter - residentBefore) / (1024.0 * 1024.0);
+		result.privateMB = ((residentAfter - sharedAfter) - (residentBefore - sharedBefore)) / (1024.0 * 1024.0);
+
+		delete[] buffer;
+		delete stream;
+
+		// Keep the compiler from dropping the loop
+		TS_ASSERT_DIFFERS(sum, 0xFFFFFFFFU);
+		return result;
+	}
+
+	void report(const char *name, bool scanAll) {
+		const Measurement copied = measure(false, scanAll);
+		const Measurement mapped = measure(true, scanAll);
+
+		benchmarkReport(Common::String::format("%-8s read %8.1f ms %7.1f MB resident %7.1f MB private   mapped %8.1f ms %7.1f MB resident %7.1f MB private",
+			name, copied.millis, copied.residentMB, copied.privateMB, mapped.millis, mapped.residentMB, mapped.privateMB));
+	}
+
+	void createFile() {
+		_path = "filestream_bench.tmp";
+
+		StdioStream *file = StdioStream::makeFromPath(_path, true);
+		TS_ASSERT(file);
+
+		byte *chunk = new byte[kChunkSize];
+		uint32 seed = 1;
+		for (int offset = 0; offset < kFileSize; offset += kChunkSize) {
+			for (int i = 0; i < kChunkSize; ++i) {
+				seed = seed * 1103515245 + 12345;
+				chunk[i] = seed >> 24;
+			}
+			file->write(chunk, kChunkSize);
+		}
+		delete[] chunk;
+		delete file;
+	}
+
+#endif
+
+public:
+	void test_file_stream_load() {
+#if defined(POSIX)
+		// The file has just been written, so both variants read it from the
+		// page cache; the difference is the copy and the memory it takes
+		createFile();
+		report("startup", false);
+		report("scan", true);
+		unlink(_path.c_str());
+#endif
+	}
+};
@@ -0,0 +1,45 @@
+#ifndef TEST_BENCHMARK_H
+#define TEST_BENCHMARK_H
+
+// This header is included first into the benchmark runner (see
+// test/module.mk), before any ScummVM header. Benchmarks need a clock,
+// which regular code would get from OSystem, but there is no OSystem
+// instance in the test runners.
+#define FORBIDDEN_SYMBOL_EXCEPTION_time_h
+#define FORBIDDEN_SYMBOL_EXCEPTION_unistd_h
+#define FORBIDDEN_SYMBOL_EXCEPTION_getenv
+
+#include "cxxtest_mingw.h"
+#include <cxxtest/TestSuite.h>
+
+#if defined(POSIX)
+#include <sys/time.h>
+#endif
+#include <time.h>
+
+/**
+ * Returns a time stamp in microseconds, for measuring elapsed time.
+ */
+static inline unsigned long long benchmarkMicros() {
+#if defined(POSIX)
+	struct timeval tv;
+	gettimeofday(&tv, 0);
+	return (unsigned long long)tv.tv_sec * 1000000 + tv.tv_usec;
+#else
+	return (unsigned long long)clock() * 1000000 / CLOCKS_PER_SEC;
+#endif
+}
+
+/**
+ * Print one line of a benchmark report, a Common::String usually made with
+ * Common::String::format(). The output goes through the CxxTest tracer,
+ * since stdio is not available to code including ScummVM headers.
+ *
+ * This is a template only because common/str.h can't be included here.
+ */
+template<class String>
+static inline void benchmarkReport(const String &line) {
+	TS_TRACE(line.c_str());
+}
+
+#endif
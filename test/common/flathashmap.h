@@ -0,0 +1,300 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/flathashmap.h"
+#include "common/hash-str.h"
+
+class FlatHashMapTestSuite : public CxxTest::TestSuite
+{
+	typedef Common::FlatHashMap<Common::String, Common::String, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> FlatStringMap;
+
+	public:
+	void test_empty_clear() {
+		Common::FlatHashMap<int, int> container;
+		TS_ASSERT(container.empty());
+		container[0] = 17;
+		container[1] = 33;
+		TS_ASSERT(!container.empty());
+		container.clear();
+		TS_ASSERT(container.empty());
+
+		FlatStringMap container2;
+		TS_ASSERT(container2.empty());
+		container2["foo"] = "bar";
+		container2["quux"] = "blub";
+		TS_ASSERT(!container2.empty());
+		container2.clear();
+		TS_ASSERT(container2.empty());
+	}
+
+	void test_contains() {
+		Common::FlatHashMap<int, int> container;
+		container[0] = 17;
+		container[1] = 33;
+		TS_ASSERT(container.contains(0));
+		TS_ASSERT(container.contains(1));
+		TS_ASSERT(!container.contains(17));
+		TS_ASSERT(!container.contains(-1));
+
+		FlatStringMap container2;
+		container2["foo"] = "bar";
+		container2["quux"] = "blub";
+		TS_ASSERT(container2.contains("foo"));
+		TS_ASSERT(container2.contains("QUUX"));
+		TS_ASSERT(!container2.contains("bar"));
+		TS_ASSERT(!container2.contains("asdf"));
+	}
+
+	void test_add_remove() {
+		Common::FlatHashMap<int, int> container;
+		container[0] = 17;
+		container[1] = 33;
+		container[2] = 45;
+		container[3] = 12;
+		container[4] = 96;
+		TS_ASSERT(container.contains(1));
+		container.erase(1);
+		TS_ASSERT(!container.contains(1));
+		container[1] = 42;
+		TS_ASSERT(container.contains(1));
+		container.erase(0);
+		TS_ASSERT(!container.empty());
+		container.erase(1);
+		TS_ASSERT(!container.empty());
+		container.erase(2);
+		TS_ASSERT(!container.empty());
+		container.erase(3);
+		TS_ASSERT(!container.empty());
+		container.erase(4);
+		TS_ASSERT(container.empty());
+		container[1] = 33;
+		TS_ASSERT(container.contains(1));
+		TS_ASSERT(!container.empty());
+		container.erase(1);
+		TS_ASSERT(container.empty());
+	}
+
+	void test_add_remove_iterator() {
+		Common::FlatHashMap<int, int> container;
+		container[0] = 17;
+		container[1] = 33;
+		container[2] = 45;
+		container[3] = 12;
+		container[4] = 96;
+		TS_ASSERT(container.contains(1));
+		container.erase(container.find(1));
+		TS_ASSERT(!container.contains(1));
+		container[1] = 42;
+		TS_ASSERT(container.contains(1));
+		container.erase(container.find(0));
+		TS_ASSERT(!container.empty());
+		container.erase(container.find(1));
+		TS_ASSERT(!container.empty());
+		container.erase(container.find(2));
+		TS_ASSERT(!container.empty());
+		container.erase(container.find(3));
+		TS_ASSERT(!container.empty());
+		container.erase(container.find(4));
+		TS_ASSERT(container.empty());
+		container[1] = 33;
+		TS_ASSERT(container.contains(1));
+		TS_ASSERT(!container.empty());
+		container.erase(container.find(1));
+		TS_ASSERT(container.empty());
+	}
+
+	void test_lookup() {
+		Common::FlatHashMap<int, int> container;
+		container[0] = 17;
+		container[1] = -1;
+		container[2] = 45;
+		container[3] = 12;
+		container[4] = 96;
+
+		TS_ASSERT_EQUALS(container[0], 17);
+		TS_ASSERT_EQUALS(container[1], -1);
+		TS_ASSERT_EQUALS(container[2], 45);
+		TS_ASSERT_EQUALS(container[3], 12);
+		TS_ASSERT_EQUALS(container[4], 96);
+	}
+
+	void test_lookup_with_default() {
+		Common::FlatHashMap<int, int> container;
+		container[0] = 17;
+		container[1] = -1;
+		container[2] = 45;
+		container[3] = 12;
+		container[4] = 96;
+
+		// We take a const ref now to ensure that the map
+		// is not modified by getVal.
+		const Common::FlatHashMap<int, int> &containerRef = container;
+
+		TS_ASSERT_EQUALS(containerRef.getVal(0), 17);
+		TS_ASSERT_EQUALS(containerRef.getVal(17), 0);
+		TS_ASSERT_EQUALS(containerRef.getVal(0, -10), 17);
+		TS_ASSERT_EQUALS(containerRef.getVal(17, -10), -10);
+		TS_ASSERT_EQUALS(containerRef.size(), 5U);
+	}
+
+	void test_iterator_begin_end() {
+		Common::FlatHashMap<int, int> container;
+
+		// The container is initially empty ...
+		TS_ASSERT_EQUALS(container.begin(), container.end());
+
+		// ... then non-empty ...
+		container[324] = 33;
+		TS_ASSERT_DIFFERS(container.begin(), container.end());
+
+		// ... and again empty.
+		container.clear();
+		TS_ASSERT_EQUALS(container.begin(), container.end());
+	}
+
+	void test_hash_map_copy() {
+		Common::FlatHashMap<int, int> map1, container2;
+		map1[323] = 32;
+		map1[17] = 5;
+		map1.erase(17);
+		container2 = map1;
+		TS_ASSERT_EQUALS(container2[323], 32);
+		TS_ASSERT(!container2.contains(17));
+		TS_ASSERT_EQUALS(container2.size(), 1U);
+
+		Common::FlatHashMap<int, int> container3(container2);
+		TS_ASSERT_EQUALS(container3[323], 32);
+		TS_ASSERT_EQUALS(container3.size(), 1U);
+	}
+
+	void test_collision() {
+		// Keys which only differ in their upper bits all map to the same
+		// slot without mixing the hash.
+		Common::FlatHashMap<int, int> h;
+		h[5] = 1;
+		h[32+5] = 1;
+		h[64+5] = 1;
+		h[128+5] = 1;
+		TS_ASSERT(h.contains(5));
+		TS_ASSERT(h.contains(32+5));
+		TS_ASSERT(h.contains(64+5));
+		TS_ASSERT(h.contains(128+5));
+		h.erase(32+5);
+		TS_ASSERT(h.contains(5));
+		TS_ASSERT(h.contains(64+5));
+		TS_ASSERT(h.contains(128+5));
+		h.erase(5);
+		TS_ASSERT(h.contains(64+5));
+		TS_ASSERT(h.contains(128+5));
+		h[32+5] = 1;
+		TS_ASSERT(h.contains(32+5));
+		TS_ASSERT(h.contains(64+5));
+		TS_ASSERT(h.contains(128+5));
+		h[5] = 1;
+		TS_ASSERT(h.contains(5));
+		TS_ASSERT(h.contains(32+5));
+		TS_ASSERT(h.contains(64+5));
+		TS_ASSERT(h.contains(128+5));
+		h.erase(5);
+		TS_ASSERT(h.contains(32+5));
+		TS_ASSERT(h.contains(64+5));
+		TS_ASSERT(h.contains(128+5));
+		h.erase(64+5);
+		TS_ASSERT(h.contains(32+5));
+		TS_ASSERT(h.contains(128+5));
+		h.erase(128+5);
+		TS_ASSERT(h.contains(32+5));
+		h.erase(32+5);
+		TS_ASSERT(h.empty());
+	}
+
+	void test_grow() {
+		Common::FlatHashMap<int, int> h;
+		for (int i = 0; i < 5000; ++i)
+			h[i * 1024] = i;
+		TS_ASSERT_EQUALS(h.size(), 5000U);
+
+		// Erase every other element and fill the holes again, to make
+		// sure deleted slots are reused or purged.
+		for (int round = 0; round < 4; ++round) {
+			for (int i = 0; i < 5000; i += 2)
+				h.erase(i * 1024);
+			TS_ASSERT_EQUALS(h.size(), 2500U);
+			for (int i = 0; i < 5000; i += 2)
+				h[i * 1024] = -i;
+			TS_ASSERT_EQUALS(h.size(), 5000U);
+		}
+
+		for (int i = 0; i < 5000; ++i)
+			TS_ASSERT_EQUALS(h.getVal(i * 1024, 1), (i & 1) ? i : -i);
+		TS_ASSERT(!h.contains(5000 * 1024));
+
+		h.clear(true);
+		TS_ASSERT(h.empty());
+		TS_ASSERT_EQUALS(h.begin(), h.end());
+		h[7] = 8;
+		TS_ASSERT_EQUALS(h[7], 8);
+	}
+
+	void test_erase_while_iterating() {
+		Common::FlatHashMap<int, int> h;
+		for (int i = 0; i < 100; ++i)
+			h[i] = i;
+
+		// Like with HashMap, erasing keeps the other iterators valid
+		for (Common::FlatHashMap<int, int>::iterator i = h.begin(); i != h.end(); ) {
+			if (i->_key % 3)
+				h.erase(i++);
+			else
+				++i;
+		}
+
+		TS_ASSERT_EQUALS(h.size(), 34U);
+		for (int i = 0; i < 100; ++i)
+			TS_ASSERT_EQUALS(h.contains(i), (i % 3) == 0);
+	}
+
+	void test_string_values() {
+		FlatStringMap container;
+		for (int i = 0; i < 300; ++i)
+			container[Common::String::format("key%d", i)] = Common::String::format("value%d", i);
+		for (int i = 0; i < 300; i += 2)
+			container.erase(Common::String::format("KEY%d", i));
+
+		TS_ASSERT_EQUALS(container.size(), 150U);
+		for (int i = 1; i < 300; i += 2)
+			TS_ASSERT_EQUALS(container[Common::String::format("key%d", i)], Common::String::format("value%d", i));
+	}
+
+	void test_iterator() {
+		Common::FlatHashMap<int, int> container;
+		container[0] = 17;
+		container[1] = 33;
+		container[2] = 45;
+		container[3] = 12;
+		container[4] = 96;
+		container.erase(1);
+		container[1] = 42;
+		container.erase(0);
+		container.erase(1);
+
+		int found = 0;
+		Common::FlatHashMap<int, int>::iterator i;
+		for (i = container.begin(); i != container.end(); ++i) {
+			int key = i->_key;
+			TS_ASSERT(key >= 0 && key <= 4);
+			TS_ASSERT(!(found & (1 << key)));
+			found |= 1 << key;
+		}
+		TS_ASSERT(found == 16+8+4);
+
+		found = 0;
+		Common::FlatHashMap<int, int>::const_iterator j;
+		for (j = container.begin(); j != container.end(); ++j) {
+			int key = j->_key;
+			TS_ASSERT(key >= 0 && key <= 4);
+			TS_ASSERT(!(found & (1 << key)));
+			found |= 1 << key;
+		}
+		TS_ASSERT(found == 16+8+4);
+	}
+};
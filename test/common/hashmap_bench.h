@@ -0,0 +1,115 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/flathashmap.h"
+#include "common/hashmap.h"
+#include "common/hash-str.h"
+#include "common/str.h"
+
+class HashMapBenchmarkSuite : public CxxTest::TestSuite
+{
+private:
+	enum {
+		kRounds = 20
+	};
+
+	struct Timings {
+		double insert, lookup, iterate;
+	};
+
+	/**
+	 * Fill a map with the given keys, look all of them up again, plus the
+	 * same number of missing keys, and iterate over it.
+	 *
+	 * @return nanoseconds per element for each of the three steps
+	 */
+	template<class Map, class Key>
+	static Timings measure(const Key *keys, const Key *missing, int count) {
+		Timings t;
+		unsigned long long insert = 0, lookup = 0, iterate = 0;
+		int checksum = 0;
+
+		for (int round = 0; round < kRounds; ++round) {
+			Map map;
+
+			unsigned long long start = benchmarkMicros();
+			for (int i = 0; i < count; ++i)
+				map[keys[i]] = i;
+			insert += benchmarkMicros() - start;
+
+			start = benchmarkMicros();
+			for (int i = 0; i < count; ++i) {
+				checksum += map.getVal(keys[i], -1);
+				checksum += map.getVal(missing[i], -1);
+			}
+			lookup += benchmarkMicros() - start;
+
+			start = benchmarkMicros();
+			for (int pass = 0; pass < 4; ++pass) {
+				for (typename Map::const_iterator i = map.begin(); i != map.end(); ++i)
+					checksum += i->_value;
+			}
+			iterate += benchmarkMicros() - start;
+		}
+
+		// Keep the compiler from dropping the lookups
+		TS_ASSERT_DIFFERS(checksum, 0);
+
+		t.insert = insert * 1000.0 / (kRounds * count);
+		t.lookup = lookup * 1000.0 / (kRounds * count * 2);
+		t.iterate = iterate * 1000.0 / (kRounds * count * 4);
+		return t;
+	}
+
+	static void report(const char *name, int count, const Timings &chained, const Timings &flat) {
+		benchmarkReport(Common::String::format("%-7s %7d: insert %6.1f / %6.1f, lookup %6.1f / %6.1f, iterate %5.1f / %5.1f ns (HashMap / FlatHashMap)",
+		                 name, count, chained.insert, flat.insert, chained.lookup, flat.lookup, chained.iterate, flat.iterate));
+	}
+
+	static void compareInt(int count) {
+		int *keys = new int[count];
+		int *missing = new int[count];
+		uint32 seed = 1;
+		for (int i = 0; i < count; ++i) {
+			seed = seed * 1103515245 + 12345;
+			// Even keys are inserted, odd keys are missing
+			keys[i] = (int)(seed & ~1);
+			missing[i] = keys[i] | 1;
+		}
+
+		const Timings chained = measure<Common::HashMap<int, int>, int>(keys, missing, count);
+		const Timings flat = measure<Common::FlatHashMap<int, int>, int>(keys, missing, count);
+		report("int", count, chained, flat);
+
+		delete[] keys;
+		delete[] missing;
+	}
+
+	static void compareString(int count) {
+		Common::String *keys = new Common::String[count];
+		Common::String *missing = new Common::String[count];
+		for (int i = 0; i < count; ++i) {
+			keys[i] = Common::String::format("resource.%03d/%d", i % 1000, i);
+			missing[i] = Common::String::format("missing.%03d/%d", i % 1000, i);
+		}
+
+		const Timings chained = measure<Common::HashMap<Common::String, int, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo>, Common::String>(keys, missing, count);
+		const Timings flat = measure<Common::FlatHashMap<Common::String, int, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo>, Common::String>(keys, missing, count);
+		report("String", count, chained, flat);
+
+		delete[] keys;
+		delete[] missing;
+	}
+
+public:
+	void test_hashmap_int() {
+		compareInt(100);
+		compareInt(10000);
+		compareInt(500000);
+	}
+
+	void test_hashmap_string() {
+		compareString(100);
+		compareString(10000);
+		compareString(200000);
+	}
+};
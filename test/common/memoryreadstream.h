@@ -104,4 +104,13 @@ class MemoryReadStreamTestSuite : public CxxTest::TestSuite {
 		ms.seek(0, SEEK_SET);
 		TS_ASSERT(!ms.eos());
 	}
+
+	void test_data_pointer() {
+		byte contents[] = { 1, 2, 3 };
+		Common::MemoryReadStream ms(contents, sizeof(contents));
+
+		TS_ASSERT_EQUALS(ms.getDataPointer(), contents);
+		ms.readByte();
+		TS_ASSERT_EQUALS(ms.getDataPointer(), contents);
+	}
 };
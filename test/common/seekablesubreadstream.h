@@ -70,4 +70,12 @@ class SeekableSubReadStreamTestSuite : public CxxTest::TestSuite {
 		b = ssrs.readByte();
 		TS_ASSERT_EQUALS(b, 1);
 	}
+
+	void test_data_pointer() {
+		byte contents[10] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
+		Common::MemoryReadStream ms(contents, sizeof(contents));
+		Common::SeekableSubReadStream ssrs(&ms, 3, 9);
+
+		TS_ASSERT_EQUALS(ssrs.getDataPointer(), contents + 3);
+	}
 };
@@ -2,6 +2,17 @@
 
 #include "common/str.h"
 
+// Longer than the inline storage of any sensible SCUMMVM_STRING_SIZE
+static const char *const kLongString =
+	"This string is too long to be stored inline, surely. It goes on and on, "
+	"over more than a hundred and twenty-eight characters, just to be sure.";
+
+static uint32 s_stringTestAllocations = 0;
+
+static void countStringTestAllocation(uint32 bytes) {
+	s_stringTestAllocations++;
+}
+
 class StringTestSuite : public CxxTest::TestSuite
 {
 	public:
@@ -403,6 +414,57 @@ class StringTestSuite : public CxxTest::TestSuite
 		TS_ASSERT_EQUALS(strcmp(test4, resultString), 0);
 	}
 
+	void test_allocation_hook() {
+		s_stringTestAllocations = 0;
+		Common::String::setAllocationHook(countStringTestAllocation);
+
+		// Short strings are stored inline ...
+		Common::String str("short");
+		TS_ASSERT_EQUALS(s_stringTestAllocations, 0U);
+
+		// ... long ones are not, but copies share the storage
+		Common::String longStr(kLongString);
+		TS_ASSERT_EQUALS(s_stringTestAllocations, 1U);
+		Common::String copy(longStr);
+		str = longStr;
+		TS_ASSERT_EQUALS(s_stringTestAllocations, 1U);
+
+		// Modifying a shared string makes it unique
+		copy += "!";
+		TS_ASSERT_EQUALS(s_stringTestAllocations, 2U);
+
+		Common::String::setAllocationHook(0);
+		Common::String other(longStr + "?");
+		TS_ASSERT_EQUALS(s_stringTestAllocations, 2U);
+	}
+
+	void test_move() {
+#if __cplusplus >= 201103L
+		s_stringTestAllocations = 0;
+		Common::String::setAllocationHook(countStringTestAllocation);
+
+		Common::String longStr(kLongString);
+		Common::String moved(static_cast<Common::String &&>(longStr));
+		TS_ASSERT_EQUALS(moved, kLongString);
+		TS_ASSERT(longStr.empty());
+
+		Common::String str("short");
+		str = static_cast<Common::String &&>(moved);
+		TS_ASSERT_EQUALS(str, kLongString);
+		TS_ASSERT(moved.empty());
+
+		moved = static_cast<Common::String &&>(Common::String("inline"));
+		TS_ASSERT_EQUALS(moved, "inline");
+
+		// The moved from strings are still usable
+		longStr += "abc";
+		TS_ASSERT_EQUALS(longStr, "abc");
+
+		TS_ASSERT_EQUALS(s_stringTestAllocations, 1U);
+		Common::String::setAllocationHook(0);
+#endif
+	}
+
 	void test_scumm_stricmp() {
 		TS_ASSERT_EQUALS(scumm_stricmp("abCd", "abCd"), 0);
 		TS_ASSERT_EQUALS(scumm_stricmp("abCd", "ABCd"), 0);
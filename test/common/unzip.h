@@ -0,0 +1,132 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/archive.h"
+#include "common/unzip.h"
+
+#include "ziphelper.h"
+
+#include "test/system.h"
+
+class UnzipTestSuite : public CxxTest::TestSuite
+{
+	enum {
+		kLargeSize = 600 * 1024	// Larger than what ZipArchive decompresses at once
+	};
+
+	/** An archive on disk, which is read but not in memory */
+	class FileLikeReadStream : public Common::MemoryReadStream {
+	public:
+		FileLikeReadStream(const byte *data, uint32 size) : Common::MemoryReadStream(data, size, DisposeAfterUse::YES) {}
+		const byte *getDataPointer() const { return 0; }
+	};
+
+	// The archive guards its stream with a mutex
+	TestSystem *_system;
+
+	static void fill(byte *data, uint32 size, uint32 seed) {
+		for (uint32 i = 0; i < size; ++i) {
+			seed = seed * 1103515245 + 12345;
+			data[i] = (i & 256) ? (byte)(seed >> 16) : (byte)(i / 32);
+		}
+	}
+
+	static bool checkMember(Common::Archive *archive, const char *name, const byte *data, uint32 size) {
+		Common::SeekableReadStream *stream = archive->createReadStreamForMember(name);
+		if (!stream)
+			return false;
+
+		byte *contents = new byte[size];
+		bool ok = stream->size() == (int32)size && stream->read(contents, size) == size && !memcmp(contents, data, size);
+
+		// Seek backwards and forwards
+		if (ok && size > 100) {
+			stream->seek(size / 2, SEEK_SET);
+			ok = stream->readByte() == data[size / 2];
+			stream->seek(10, SEEK_SET);
+			ok = ok && stream->readByte() == data[10];
+		}
+
+		delete[] contents;
+		delete stream;
+		return ok;
+	}
+
+	void checkArchive(bool inMemory) {
+		byte small[1000], large[kLargeSize];
+		fill(small, sizeof(small), 1);
+		fill(large, sizeof(large), 2);
+
+		ZipBuilder builder;
+		builder.addMember("stored.bin", small, sizeof(small), false);
+		builder.addMember("deflated.bin", small, sizeof(small), true);
+		builder.addMember("dir/large_stored.bin", large, sizeof(large), false);
+		builder.addMember("dir/large_deflated.bin", large, sizeof(large), true);
+
+		uint32 size;
+		byte *zip = builder.finish(size);
+		Common::SeekableReadStream *zipStream;
+		if (inMemory)
+			zipStream = new Common::MemoryReadStream(zip, size, DisposeAfterUse::YES);
+		else
+			zipStream = new FileLikeReadStream(zip, size);
+		Common::Archive *archive = Common::makeZipArchive(zipStream);
+		TS_ASSERT(archive);
+
+		TS_ASSERT(archive->hasFile("STORED.BIN"));
+		TS_ASSERT(!archive->hasFile("missing.bin"));
+
+		Common::ArchiveMemberList list;
+		TS_ASSERT_EQUALS(archive->listMembers(list), 4);
+
+		TS_ASSERT(checkMember(archive, "stored.bin", small, sizeof(small)));
+		TS_ASSERT(checkMember(archive, "dir/large_stored.bin", large, sizeof(large)));
+#ifdef USE_ZLIB
+		// Twice, to get the member from the cache
+		TS_ASSERT(checkMember(archive, "deflated.bin", small, sizeof(small)));
+		TS_ASSERT(checkMember(archive, "deflated.bin", small, sizeof(small)));
+		TS_ASSERT(checkMember(archive, "dir/large_deflated.bin", large, sizeof(large)));
+#endif
+
+		// Large members share the archive stream, but not its position
+		Common::SeekableReadStream *first = archive->createReadStreamForMember("dir/large_stored.bin");
+		Common::SeekableReadStream *second = archive->createReadStreamForMember("dir/large_stored.bin");
+		first->seek(1000);
+		TS_ASSERT_EQUALS(second->readByte(), large[0]);
+		TS_ASSERT_EQUALS(first->readByte(), large[1000]);
+		TS_ASSERT_EQUALS(second->readByte(), large[1]);
+		delete first;
+		delete second;
+
+		// Streams outlive the archive
+		Common::SeekableReadStream *stream = archive->createReadStreamForMember("stored.bin");
+		Common::SeekableReadStream *largeStream = archive->createReadStreamForMember("dir/large_stored.bin");
+		delete archive;
+		TS_ASSERT_EQUALS(stream->readByte(), small[0]);
+		largeStream->seek(-1, SEEK_END);
+		TS_ASSERT_EQUALS(largeStream->readByte(), large[kLargeSize - 1]);
+		TS_ASSERT(!largeStream->eos());
+		largeStream->readByte();
+		TS_ASSERT(largeStream->eos());
+		delete stream;
+		delete largeStream;
+	}
+
+	public:
+	void setUp() {
+		_system = new TestSystem();
+		g_system = _system;
+	}
+
+	void tearDown() {
+		g_system = 0;
+		delete _system;
+	}
+
+	void test_members_in_memory() {
+		checkArchive(true);
+	}
+
+	void test_members_read() {
+		checkArchive(false);
+	}
+};
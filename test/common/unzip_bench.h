@@ -0,0 +1,139 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/archive.h"
+#include "common/unzip.h"
+
+#include "ziphelper.h"
+
+#include "test/system.h"
+
+class UnzipBenchmarkSuite : public CxxTest::TestSuite
+{
+private:
+	enum {
+		kSmallMembers = 5000,
+		kLargeMembers = 4,
+		kLargeSize = 4 * 1024 * 1024,
+		kRecentMembers = 100	///< Members reopened, which fit into the cache
+	};
+
+	/** An archive on disk, which is read but not in memory */
+	class FileLikeReadStream : public Common::MemoryReadStream {
+	public:
+		FileLikeReadStream(const byte *data, uint32 size) : Common::MemoryReadStream(data, size, DisposeAfterUse::YES) {}
+		const byte *getDataPointer() const { return 0; }
+	};
+
+	byte *_zip;
+	uint32 _zipSize;
+
+	// The archive guards its stream with a mutex
+	TestSystem *_system;
+
+	static void fill(byte *data, uint32 size, uint32 seed) {
+		for (uint32 i = 0; i < size; ++i) {
+			seed = seed * 1103515245 + 12345;
+			data[i] = (i & 512) ? (byte)(seed >> 24) : (byte)(i / 64);
+		}
+	}
+
+	static Common::String smallName(int i) {
+		return Common::String::format("data/%04d.bin", i);
+	}
+
+	static Common::String largeName(int i) {
+		return Common::String::format("movies/%d.bin", i);
+	}
+
+	/**
+	 * Reads all of a member, or only its beginning.
+	 * @return the number of bytes read
+	 */
+	static uint32 readMember(Common::Archive *archive, const Common::String &name, uint32 limit) {
+		static byte buffer[64 * 1024];
+		Common::SeekableReadStream *stream = archive->createReadStreamForMember(name);
+		TS_ASSERT(stream);
+
+		uint32 total = 0, bytes;
+		while (total < limit && (bytes = stream->read(buffer, MIN<uint32>(sizeof(buffer), limit - total))) > 0)
+			total += bytes;
+
+		delete stream;
+		return total;
+	}
+
+	void report(const char *name, bool inMemory) {
+		byte *copy = (byte *)malloc(_zipSize);
+		memcpy(copy, _zip, _zipSize);
+		Common::SeekableReadStream *stream = inMemory ?
+			new Common::MemoryReadStream(copy, _zipSize, DisposeAfterUse::YES) : new FileLikeReadStream(copy, _zipSize);
+
+		unsigned long long start = benchmarkMicros();
+		Common::Archive *archive = Common::makeZipArchive(stream);
+		TS_ASSERT(archive);
+		const double openTime = (benchmarkMicros() - start) / 1000.0;
+
+		start = benchmarkMicros();
+		for (int i = 0; i < kSmallMembers; ++i)
+			readMember(archive, smallName(i), 0xFFFFFFFF);
+		const double smallTime = (benchmarkMicros() - start) / 1000.0;
+
+		// Open the members used last again, which come from the cache
+		start = benchmarkMicros();
+		for (int i = kSmallMembers - kRecentMembers; i < kSmallMembers; ++i)
+			readMember(archive, smallName(i), 0xFFFFFFFF);
+		const double recentTime = (benchmarkMicros() - start) / 1000.0;
+
+		// Large members, of which games often only need the beginning
+		start = benchmarkMicros();
+		for (int i = 0; i < kLargeMembers; ++i)
+			readMember(archive, largeName(i), 64 * 1024);
+		const double largeStartTime = (benchmarkMicros() - start) / 1000.0;
+
+		start = benchmarkMicros();
+		for (int i = 0; i < kLargeMembers; ++i)
+			TS_ASSERT_EQUALS(readMember(archive, largeName(i), 0xFFFFFFFF), (uint32)kLargeSize);
+		const double largeTime = (benchmarkMicros() - start) / 1000.0;
+
+		delete archive;
+
+		benchmarkReport(Common::String::format("%-9s open %6.1f ms, %d small members %7.1f ms, last %d again %5.1f ms, %d large members: first 64 KB %5.1f ms, all %6.1f ms",
+			name, openTime, kSmallMembers, smallTime, kRecentMembers, recentTime, kLargeMembers, largeStartTime, largeTime));
+	}
+
+public:
+	void setUp() {
+		_system = new TestSystem();
+		g_system = _system;
+
+		ZipBuilder builder;
+
+		byte *data = new byte[kLargeSize];
+		for (int i = 0; i < kSmallMembers; ++i) {
+			const uint32 size = 1024 + (i * 37 % 16) * 1024;
+			fill(data, size, i);
+			builder.addMember(smallName(i), data, size, i % 4 != 0);
+		}
+		for (int i = 0; i < kLargeMembers; ++i) {
+			fill(data, kLargeSize, i);
+			builder.addMember(largeName(i), data, kLargeSize, i % 2 != 0);
+		}
+		delete[] data;
+
+		_zip = builder.finish(_zipSize);
+	}
+
+	void tearDown() {
+		free(_zip);
+
+		g_system = 0;
+		delete _system;
+	}
+
+	void test_open_all_members() {
+#ifdef USE_ZLIB
+		report("in memory", true);
+		report("read", false);
+#endif
+	}
+};
@@ -0,0 +1,104 @@
+#ifndef TEST_COMMON_ZIPHELPER_H
+#define TEST_COMMON_ZIPHELPER_H
+
+#include "common/memstream.h"
+#include "common/str.h"
+#include "common/zlib.h"
+
+/**
+ * Writes a ZIP archive into memory, with stored or deflated members.
+ */
+class ZipBuilder {
+	Common::MemoryWriteStreamDynamic _archive;
+	Common::MemoryWriteStreamDynamic _directory;
+	int _members;
+
+	static uint32 crc32(const byte *data, uint32 size) {
+		uint32 crc = 0xFFFFFFFF;
+		for (uint32 i = 0; i < size; ++i) {
+			crc ^= data[i];
+			for (int bit = 0; bit < 8; ++bit)
+				crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+		}
+		return ~crc;
+	}
+
+	static void writeHeader(Common::WriteStream &out, const Common::String &name, uint16 method, uint32 crc, uint32 compressedSize, uint32 size) {
+		out.writeUint16LE(20);		// version needed
+		out.writeUint16LE(0);		// flags
+		out.writeUint16LE(method);
+		out.writeUint32LE(0);		// date and time
+		out.writeUint32LE(crc);
+		out.writeUint32LE(compressedSize);
+		out.writeUint32LE(size);
+		out.writeUint16LE(name.size());
+	}
+
+public:
+	ZipBuilder() : _archive(DisposeAfterUse::NO), _directory(DisposeAfterUse::YES), _members(0) {}
+
+	void addMember(const Common::String &name, const byte *data, uint32 size, bool deflate) {
+		const byte *stored = data;
+		uint32 storedSize = size;
+		byte *compressed = 0;
+		uint16 method = 0;
+
+#ifdef USE_ZLIB
+		if (deflate) {
+			// ZIP archives contain the raw deflate data, without the zlib
+			// header and checksum
+			unsigned long compressedSize = Common::compressBound(size);
+			compressed = new byte[compressedSize];
+			Common::compress(compressed, &compressedSize, data, size, 6);
+			stored = compressed + 2;
+			storedSize = compressedSize - 6;
+			method = 8;
+		}
+#endif
+
+		const uint32 crc = crc32(data, size);
+		const uint32 offset = _archive.pos();
+
+		_archive.writeUint32LE(0x04034b50);
+		writeHeader(_archive, name, method, crc, storedSize, size);
+		_archive.writeUint16LE(0);	// extra field
+		_archive.write(name.c_str(), name.size());
+		_archive.write(stored, storedSize);
+
+		_directory.writeUint32LE(0x02014b50);
+		_directory.writeUint16LE(20);	// version made by
+		writeHeader(_directory, name, method, crc, storedSize, size);
+		_directory.writeUint16LE(0);	// extra field
+		_directory.writeUint16LE(0);	// comment
+		_directory.writeUint16LE(0);	// disk number
+		_directory.writeUint16LE(0);	// internal attributes
+		_directory.writeUint32LE(0);	// external attributes
+		_directory.writeUint32LE(offset);
+		_directory.write(name.c_str(), name.size());
+
+		delete[] compressed;
+		++_members;
+	}
+
+	/**
+	 * @return the archive, which the caller has to free()
+	 */
+	byte *finish(uint32 &size) {
+		const uint32 directoryOffset = _archive.pos();
+		_archive.write(_directory.getData(), _directory.size());
+
+		_archive.writeUint32LE(0x06054b50);
+		_archive.writeUint16LE(0);	// disk number
+		_archive.writeUint16LE(0);	// disk with the directory
+		_archive.writeUint16LE(_members);
+		_archive.writeUint16LE(_members);
+		_archive.writeUint32LE(_directory.size());
+		_archive.writeUint32LE(directoryOffset);
+		_archive.writeUint16LE(0);	// comment
+
+		size = _archive.size();
+		return _archive.getData();
+	}
+};
+
+#endif
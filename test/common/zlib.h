@@ -0,0 +1,34 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/zlib.h"
+
+class ZlibTestSuite : public CxxTest::TestSuite
+{
+	public:
+	void test_compress_roundtrip() {
+#ifdef USE_ZLIB
+		// Runs of repeated bytes followed by noise
+		byte data[4096];
+		uint32 seed = 1;
+		for (int i = 0; i < (int)sizeof(data); ++i) {
+			seed = seed * 1103515245 + 12345;
+			data[i] = (i < 2048) ? (byte)(i / 64) : (byte)(seed >> 16);
+		}
+
+		for (int level = 1; level <= 9; level += 8) {
+			unsigned long compressedLen = Common::compressBound(sizeof(data));
+			byte *compressed = new byte[compressedLen];
+			TS_ASSERT(Common::compress(compressed, &compressedLen, data, sizeof(data), level));
+			TS_ASSERT_LESS_THAN(compressedLen, sizeof(data));
+
+			byte result[sizeof(data)];
+			unsigned long resultLen = sizeof(result);
+			TS_ASSERT(Common::uncompress(result, &resultLen, compressed, compressedLen));
+			TS_ASSERT_EQUALS(resultLen, sizeof(data));
+			TS_ASSERT_SAME_DATA(result, data, sizeof(data));
+
+			delete[] compressed;
+		}
+#endif
+	}
+};
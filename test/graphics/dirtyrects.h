@@ -0,0 +1,114 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/dirtyrects.h"
+
+class DirtyRectListTestSuite : public CxxTest::TestSuite
+{
+	/**
+	 * Check that the merged rectangles cover all added ones and do not
+	 * overlap each other.
+	 */
+	static void checkCoverage(const Common::Array<Common::Rect> &rects, const Common::Rect *added, int count) {
+		for (int i = 0; i < count; ++i) {
+			for (int y = added[i].top; y < added[i].bottom; ++y) {
+				for (int x = added[i].left; x < added[i].right; ++x) {
+					int covered = 0;
+					for (uint j = 0; j < rects.size(); ++j)
+						covered += rects[j].contains(x, y) ? 1 : 0;
+					TS_ASSERT_EQUALS(covered, 1);
+				}
+			}
+		}
+
+		for (uint i = 0; i < rects.size(); ++i) {
+			for (uint j = i + 1; j < rects.size(); ++j)
+				TS_ASSERT(!rects[i].intersects(rects[j]));
+		}
+	}
+
+	public:
+	void test_empty() {
+		Graphics::DirtyRectList list;
+		list.setSize(320, 200);
+		TS_ASSERT(list.empty());
+		TS_ASSERT(list.getRects().empty());
+		TS_ASSERT_EQUALS(list.getArea(), 0U);
+
+		// Rects outside of the screen are dropped
+		list.addRect(Common::Rect(320, 0, 400, 10));
+		TS_ASSERT(list.empty());
+	}
+
+	void test_single() {
+		Graphics::DirtyRectList list;
+		list.setSize(320, 200);
+
+		// A small rect spanning four tiles comes out unchanged
+		list.addRect(Common::Rect(10, 12, 21, 25));
+		const Common::Array<Common::Rect> &rects = list.getRects();
+		TS_ASSERT_EQUALS(rects.size(), 1U);
+		TS_ASSERT_EQUALS(rects[0], Common::Rect(10, 12, 21, 25));
+		TS_ASSERT_EQUALS(list.getArea(), 11U * 13U);
+
+		list.clear();
+		TS_ASSERT(list.empty());
+		list.addRect(Common::Rect(-5, 190, 5, 210));
+		TS_ASSERT_EQUALS(list.getRects().size(), 1U);
+		TS_ASSERT_EQUALS(list.getRects()[0], Common::Rect(0, 190, 5, 200));
+	}
+
+	void test_merge_overlapping() {
+		Graphics::DirtyRectList list;
+		list.setSize(320, 200);
+
+		// A scrolling row of sprites
+		Common::Rect added[40];
+		for (int i = 0; i < 40; ++i) {
+			added[i] = Common::Rect(i * 7, 50, i * 7 + 10, 80);
+			list.addRect(added[i]);
+		}
+
+		const Common::Array<Common::Rect> &rects = list.getRects();
+		TS_ASSERT_EQUALS(rects.size(), 1U);
+		TS_ASSERT_EQUALS(rects[0], Common::Rect(0, 50, 283, 80));
+		checkCoverage(rects, added, 40);
+	}
+
+	void test_disjoint() {
+		Graphics::DirtyRectList list;
+		list.setSize(640, 480);
+
+		Common::Rect added[3] = {
+			Common::Rect(0, 0, 10, 10),
+			Common::Rect(100, 100, 150, 300),
+			Common::Rect(400, 20, 420, 40)
+		};
+		for (int i = 0; i < 3; ++i)
+			list.addRect(added[i]);
+
+		const Common::Array<Common::Rect> &rects = list.getRects();
+		TS_ASSERT_EQUALS(rects.size(), 3U);
+		TS_ASSERT_EQUALS(list.getArea(), 100U + 50U * 200U + 400U);
+		checkCoverage(rects, added, 3);
+	}
+
+	void test_random() {
+		Graphics::DirtyRectList list;
+		list.setSize(320, 200);
+
+		uint32 seed = 1;
+		Common::Rect added[200];
+		for (int i = 0; i < 200; ++i) {
+			seed = seed * 1103515245 + 12345;
+			const int x = (seed >> 8) % 320, y = (seed >> 16) % 200;
+			const int w = 1 + (seed >> 3) % 40, h = 1 + (seed >> 20) % 30;
+			added[i] = Common::Rect(x, y, MIN(x + w, 320), MIN(y + h, 200));
+			list.addRect(added[i]);
+		}
+
+		const Common::Array<Common::Rect> &rects = list.getRects();
+		TS_ASSERT_LESS_THAN(rects.size(), 200U);
+		TS_ASSERT_LESS_THAN_EQUALS(list.getArea(), 320U * 200U);
+		checkCoverage(rects, added, 200);
+	}
+};
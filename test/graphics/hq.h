@@ -0,0 +1,127 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/scaler.h"
+
+#include "common/cpudetect.h"
+
+class HQScalerTestSuite : public CxxTest::TestSuite
+{
+	enum {
+		kBorder = 2,
+		kWidth = 93,
+		kHeight = 61
+	};
+
+	uint16 *_src;
+
+	/**
+	 * Fill the source with flat areas, smooth gradients, hard edges and
+	 * noise, so that all pattern cases of the filters are hit.
+	 */
+	void createImage(int bitFormat) {
+		const int pitch = kWidth + 2 * kBorder;
+		uint32 seed = 1;
+
+		for (int y = 0; y < kHeight + 2 * kBorder; ++y) {
+			for (int x = 0; x < pitch; ++x) {
+				seed = seed * 1103515245 + 12345;
+				const int noise = (seed >> 16) & 0xFFFF;
+				int r, g, b;
+
+				switch ((x / 16 + y / 16) % 4) {
+				case 0:
+					r = g = b = (x / 16) * 40;
+					break;
+				case 1:
+					r = x * 2;
+					g = y * 4;
+					b = (x + y) * 2;
+					break;
+				case 2:
+					r = (noise & 1) ? 255 : 0;
+					g = (noise & 2) ? 255 : 0;
+					b = (noise & 4) ? 255 : 0;
+					break;
+				default:
+					r = noise & 0xFF;
+					g = (noise >> 4) & 0xFF;
+					b = (noise >> 8) & 0xFF;
+					break;
+				}
+
+				r &= 0xFF;
+				g &= 0xFF;
+				b &= 0xFF;
+				if (bitFormat == 565)
+					_src[y * pitch + x] = ((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3);
+				else
+					_src[y * pitch + x] = ((r >> 3) << 10) | ((g >> 3) << 5) | (b >> 3);
+			}
+		}
+	}
+
+	/**
+	 * Scale the test image and return a FNV-1a hash of the result.
+	 */
+	uint32 scaleAndHash(ScalerProc *scaler, int scaleFactor) {
+		const int srcPitch = (kWidth + 2 * kBorder) * 2;
+		const int dstPitch = kWidth * scaleFactor * 2;
+		const int dstSize = kHeight * scaleFactor * dstPitch;
+
+		uint8 *dst = new uint8[dstSize];
+		memset(dst, 0, dstSize);
+		scaler((const uint8 *)_src + kBorder * srcPitch + kBorder * 2, srcPitch, dst, dstPitch, kWidth, kHeight);
+
+		uint32 hash = 2166136261U;
+		for (int i = 0; i < dstSize; ++i)
+			hash = (hash ^ dst[i]) * 16777619U;
+
+		delete[] dst;
+		return hash;
+	}
+
+	/**
+	 * Compare the output of the filters against the output of the original
+	 * C++ implementation, with all vector paths allowed or only some.
+	 */
+	void checkGolden(uint32 cpuFeatureMask) {
+#ifdef USE_HQ_SCALERS
+		Common::setCPUFeatureMask(cpuFeatureMask);
+
+		InitScalers(565);
+		createImage(565);
+		TS_ASSERT_EQUALS(scaleAndHash(HQ2x, 2), 0xD279E915U);
+		TS_ASSERT_EQUALS(scaleAndHash(HQ3x, 3), 0xE0583CFAU);
+		DestroyScalers();
+
+		InitScalers(555);
+		createImage(555);
+		TS_ASSERT_EQUALS(scaleAndHash(HQ2x, 2), 0x6D23131FU);
+		TS_ASSERT_EQUALS(scaleAndHash(HQ3x, 3), 0x67559230U);
+		DestroyScalers();
+
+		Common::setCPUFeatureMask(Common::kCPUFeatureAll);
+#endif
+	}
+
+	public:
+	void setUp() {
+		_src = new uint16[(kWidth + 2 * kBorder) * (kHeight + 2 * kBorder)];
+	}
+
+	void tearDown() {
+		delete[] _src;
+	}
+
+	void test_golden_reference() {
+		checkGolden(0);
+	}
+
+	void test_golden_sse2() {
+		checkGolden(Common::kCPUFeatureSSE2);
+	}
+
+	void test_golden_avx2() {
+		checkGolden(Common::kCPUFeatureAll);
+	}
+};
@@ -0,0 +1,93 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/scaler.h"
+
+class ScalerTestSuite : public CxxTest::TestSuite
+{
+	enum {
+		// The scalers read up to two pixels around the rect
+		kBorder = 4,
+		kWidth = 160
+	};
+
+	/**
+	 * Scale a noisy image made of few colors, so that the filters take
+	 * most of their different paths, in one piece and in bands on several
+	 * threads, and check that both give the same result.
+	 */
+	static void compare(ScalerProc *scaler, int scaleFactor, int height) {
+		const int srcPitch = (kWidth + 2 * kBorder) * 2;
+		const int dstPitch = kWidth * scaleFactor * 2;
+		const int dstSize = height * scaleFactor * dstPitch;
+
+		uint16 *src = new uint16[(kWidth + 2 * kBorder) * (height + 2 * kBorder)];
+		uint32 seed = 1;
+		for (int i = 0; i < (kWidth + 2 * kBorder) * (height + 2 * kBorder); ++i) {
+			seed = seed * 1103515245 + 12345;
+			static const uint16 colors[] = { 0x0000, 0xFFFF, 0xF800, 0x07E0, 0x001F, 0x8410 };
+			src[i] = colors[(seed >> 16) % 6];
+		}
+		const uint8 *srcPtr = (const uint8 *)src + kBorder * srcPitch + kBorder * 2;
+
+		uint8 *expected = new uint8[dstSize];
+		uint8 *actual = new uint8[dstSize];
+		memset(expected, 0, dstSize);
+		memset(actual, 0x55, dstSize);
+
+		SetScalerThreads(1);
+		ScaleInBands(scaler, scaleFactor, srcPtr, srcPitch, expected, dstPitch, kWidth, height);
+		SetScalerThreads(4);
+		ScaleInBands(scaler, scaleFactor, srcPtr, srcPitch, actual, dstPitch, kWidth, height);
+		SetScalerThreads(1);
+
+		TS_ASSERT_SAME_DATA(expected, actual, dstSize);
+
+		delete[] src;
+		delete[] expected;
+		delete[] actual;
+	}
+
+	static void compareAll(int height) {
+		compare(Normal1x, 1, height);
+#ifdef USE_SCALERS
+		compare(Normal2x, 2, height);
+		compare(Normal3x, 3, height);
+		compare(_2xSaI, 2, height);
+		compare(Super2xSaI, 2, height);
+		compare(SuperEagle, 2, height);
+		compare(AdvMame2x, 2, height);
+		compare(AdvMame3x, 3, height);
+		compare(TV2x, 2, height);
+		compare(DotMatrix, 2, height);
+#ifdef USE_HQ_SCALERS
+		compare(HQ2x, 2, height);
+		compare(HQ3x, 3, height);
+#endif
+#endif
+	}
+
+	public:
+	void setUp() {
+		InitScalers(565);
+	}
+
+	void tearDown() {
+		DestroyScalers();
+	}
+
+	void test_bands() {
+		compareAll(200);
+	}
+
+	void test_odd_heights() {
+		// Heights which leave a short remainder for the last band
+		compareAll(33);
+		compareAll(97);
+		compareAll(161);
+	}
+
+	void test_small_rect() {
+		compareAll(2);
+		compareAll(31);
+	}
+};
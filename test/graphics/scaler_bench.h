@@ -0,0 +1,98 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/scaler.h"
+
+#include "common/thread.h"
+
+class ScalerBenchmarkSuite : public CxxTest::TestSuite
+{
+private:
+	enum {
+		kBorder = 4,
+		kWidth = 640,
+		kHeight = 480,
+		kFrames = 20
+	};
+
+	uint16 *_src;
+	uint8 *_dst;
+
+	/**
+	 * @return source megapixels scaled per second
+	 */
+	double measure(ScalerProc *scaler, int scaleFactor, int threads) {
+		const int srcPitch = (kWidth + 2 * kBorder) * 2;
+		const int dstPitch = kWidth * scaleFactor * 2;
+		const uint8 *srcPtr = (const uint8 *)_src + kBorder * srcPitch + kBorder * 2;
+
+		SetScalerThreads(threads);
+
+		const unsigned long long start = benchmarkMicros();
+		for (int frame = 0; frame < kFrames; ++frame)
+			ScaleInBands(scaler, scaleFactor, srcPtr, srcPitch, _dst, dstPitch, kWidth, kHeight);
+		const unsigned long long elapsed = benchmarkMicros() - start;
+
+		SetScalerThreads(1);
+		return (double)kWidth * kHeight * kFrames / MAX<unsigned long long>(elapsed, 1);
+	}
+
+	void report(const char *name, ScalerProc *scaler, int scaleFactor) {
+		static const int threadCounts[] = { 1, 2, 4, 0 };
+
+		Common::String line = Common::String::format("%-10s", name);
+		for (int i = 0; i < ARRAYSIZE(threadCounts); ++i) {
+			const double mpix = measure(scaler, scaleFactor, threadCounts[i]);
+			if (threadCounts[i])
+				line += Common::String::format("  %d: %7.1f", threadCounts[i], mpix);
+			else
+				line += Common::String::format("  auto (%d): %7.1f", Common::getProcessorCount(), mpix);
+		}
+
+		benchmarkReport(Common::String::format("%s MPix/s by thread count", line.c_str()));
+	}
+
+public:
+	void setUp() {
+		InitScalers(565);
+
+		// A mix of flat areas and noise, like the backgrounds and sprites of
+		// a game screen
+		_src = new uint16[(kWidth + 2 * kBorder) * (kHeight + 2 * kBorder)];
+		uint32 seed = 1;
+		for (int y = 0; y < kHeight + 2 * kBorder; ++y) {
+			for (int x = 0; x < kWidth + 2 * kBorder; ++x) {
+				seed = seed * 1103515245 + 12345;
+				uint16 color = (uint16)(((x / 32) * 0x0841 + (y / 24) * 0x1000) & 0xFFFF);
+				if (((x / 64) + (y / 48)) & 1)
+					color = (uint16)(seed >> 16);
+				_src[y * (kWidth + 2 * kBorder) + x] = color;
+			}
+		}
+
+		_dst = new uint8[kWidth * 3 * kHeight * 3 * 2];
+	}
+
+	void tearDown() {
+		delete[] _src;
+		delete[] _dst;
+		DestroyScalers();
+	}
+
+	void test_scaler_throughput() {
+#ifdef USE_SCALERS
+		report("normal2x", Normal2x, 2);
+		report("normal3x", Normal3x, 3);
+		report("2xsai", _2xSaI, 2);
+		report("super2xsai", Super2xSaI, 2);
+		report("supereagle", SuperEagle, 2);
+		report("advmame2x", AdvMame2x, 2);
+		report("advmame3x", AdvMame3x, 3);
+		report("tv2x", TV2x, 2);
+		report("dotmatrix", DotMatrix, 2);
+#ifdef USE_HQ_SCALERS
+		report("hq2x", HQ2x, 2);
+		report("hq3x", HQ3x, 3);
+#endif
+#endif
+	}
+};
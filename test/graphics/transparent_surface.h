@@ -0,0 +1,101 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/transparent_surface.h"
+
+#include "common/cpudetect.h"
+
+class TransparentSurfaceTestSuite : public CxxTest::TestSuite
+{
+	enum {
+		kWidth = 37,
+		kHeight = 11
+	};
+
+	static uint32 nextRandom(uint32 &seed) {
+		seed = seed * 1103515245 + 12345;
+		return seed >> 8;
+	}
+
+	/**
+	 * Fill a surface with random colors. The alpha values favour the
+	 * special cases 0 and 255.
+	 */
+	static void fill(Graphics::Surface &surface, uint32 seed) {
+		for (int y = 0; y < surface.h; ++y) {
+			for (int x = 0; x < surface.w; ++x) {
+				uint32 a = nextRandom(seed) & 0xFF;
+				if (a < 64)
+					a = 0;
+				else if (a > 192)
+					a = 255;
+				*(uint32 *)surface.getBasePtr(x, y) = surface.format.ARGBToColor(a, nextRandom(seed) & 0xFF, nextRandom(seed) & 0xFF, nextRandom(seed) & 0xFF);
+			}
+		}
+	}
+
+	/**
+	 * Blit a sprite once with the plain C++ code and once with all vector
+	 * paths enabled, and check that both give the same result.
+	 */
+	static void compare(Graphics::AlphaType alphaMode, int flipping, uint color, Graphics::TSpriteBlendMode blendMode) {
+		const Graphics::PixelFormat format = Graphics::TransparentSurface::getSupportedPixelFormat();
+
+		Graphics::TransparentSurface sprite;
+		sprite.create(kWidth, kHeight, format);
+		sprite.setAlphaMode(alphaMode);
+		fill(sprite, 1);
+
+		Graphics::Surface expected, actual;
+		expected.create(kWidth + 8, kHeight + 4, format);
+		fill(expected, 2);
+		actual.copyFrom(expected);
+
+		// Blit into the middle and over the edge of the target
+		Common::setCPUFeatureMask(0);
+		sprite.blit(expected, 3, 1, flipping, nullptr, color, -1, -1, blendMode);
+		sprite.blit(expected, 20, -5, flipping, nullptr, color, -1, -1, blendMode);
+		Common::setCPUFeatureMask(Common::kCPUFeatureAll);
+		sprite.blit(actual, 3, 1, flipping, nullptr, color, -1, -1, blendMode);
+		sprite.blit(actual, 20, -5, flipping, nullptr, color, -1, -1, blendMode);
+
+		TS_ASSERT_SAME_DATA(expected.getPixels(), actual.getPixels(), expected.h * expected.pitch);
+
+		sprite.free();
+		expected.free();
+		actual.free();
+	}
+
+	static void compareColors(Graphics::AlphaType alphaMode, Graphics::TSpriteBlendMode blendMode) {
+		static const uint colors[] = {
+			TS_ARGB(255, 255, 255, 255),
+			TS_ARGB(255, 128, 255, 0),
+			TS_ARGB(128, 255, 255, 255),
+			TS_ARGB(200, 17, 99, 230)
+		};
+
+		for (int i = 0; i < ARRAYSIZE(colors); ++i) {
+			compare(alphaMode, Graphics::FLIP_NONE, colors[i], blendMode);
+			compare(alphaMode, Graphics::FLIP_H, colors[i], blendMode);
+			compare(alphaMode, Graphics::FLIP_V, colors[i], blendMode);
+			compare(alphaMode, Graphics::FLIP_HV, colors[i], blendMode);
+		}
+	}
+
+	public:
+	void test_opaque() {
+		compareColors(Graphics::ALPHA_OPAQUE, Graphics::BLEND_NORMAL);
+	}
+
+	void test_binary() {
+		compareColors(Graphics::ALPHA_BINARY, Graphics::BLEND_NORMAL);
+	}
+
+	void test_alpha() {
+		compareColors(Graphics::ALPHA_FULL, Graphics::BLEND_NORMAL);
+	}
+
+	void test_additive_subtractive() {
+		compareColors(Graphics::ALPHA_FULL, Graphics::BLEND_ADDITIVE);
+		compareColors(Graphics::ALPHA_FULL, Graphics::BLEND_SUBTRACTIVE);
+	}
+};
@@ -0,0 +1,225 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/yuv_to_rgb.h"
+
+#include "common/cpudetect.h"
+#include "common/thread.h"
+
+class YUVToRGBTestSuite : public CxxTest::TestSuite
+{
+	enum {
+		// Not a multiple of the vector width, to exercise the leftover pixels
+		kWidth = 100,
+		kHeight = 12,
+
+		// Large enough to be converted in bands
+		kLargeWidth = 400,
+		kLargeHeight = 328
+	};
+
+	enum Subsampling {
+		k444,
+		k420,
+		k410
+	};
+
+	static uint32 nextRandom(uint32 &seed) {
+		seed = seed * 1103515245 + 12345;
+		return seed >> 8;
+	}
+
+	/**
+	 * Convert random planes with the given subsampling. The planes are
+	 * large enough for all subsamplings, including the extra row and
+	 * column of chroma YUV410 needs.
+	 */
+	static void convert(Graphics::Surface &dst, Subsampling subsampling, Graphics::YUVToRGBManager::LuminanceScale scale, int width, int height) {
+		const int pitch = width + 3;
+		const int size = pitch * (height + 1);
+		byte *planes = new byte[3 * size];
+
+		uint32 seed = 1;
+		for (int i = 0; i < 3 * size; i++)
+			planes[i] = nextRandom(seed) & 0xFF;
+
+		switch (subsampling) {
+		case k444:
+			YUVToRGBMan.convert444(&dst, scale, planes, planes + size, planes + 2 * size, width, height, pitch, pitch);
+			break;
+		case k420:
+			YUVToRGBMan.convert420(&dst, scale, planes, planes + size, planes + 2 * size, width, height, pitch, pitch);
+			break;
+		default:
+			YUVToRGBMan.convert410(&dst, scale, planes, planes + size, planes + 2 * size, width, height, pitch, pitch);
+			break;
+		}
+
+		delete[] planes;
+	}
+
+	/**
+	 * Convert an image once with the plain C++ code and once with all
+	 * vector paths enabled, and check that both give the same result.
+	 */
+	static void compare(const Graphics::PixelFormat &format, Subsampling subsampling, Graphics::YUVToRGBManager::LuminanceScale scale) {
+		Graphics::Surface expected, actual;
+		expected.create(kWidth, kHeight, format);
+		actual.create(kWidth, kHeight, format);
+
+		Common::setCPUFeatureMask(0);
+		convert(expected, subsampling, scale, kWidth, kHeight);
+		Common::setCPUFeatureMask(Common::kCPUFeatureAll);
+		convert(actual, subsampling, scale, kWidth, kHeight);
+
+		TS_ASSERT_SAME_DATA(expected.getPixels(), actual.getPixels(), expected.h * expected.pitch);
+
+		expected.free();
+		actual.free();
+	}
+
+	static void compareFormats(Subsampling subsampling) {
+		const Graphics::PixelFormat formats[] = {
+			Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0),
+			Graphics::PixelFormat(2, 5, 5, 5, 1, 10, 5, 0, 15),
+			Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0),
+			Graphics::PixelFormat(4, 8, 8, 8, 0, 0, 8, 16, 24)
+		};
+
+		for (int i = 0; i < ARRAYSIZE(formats); ++i) {
+			compare(formats[i], subsampling, Graphics::YUVToRGBManager::kScaleFull);
+			compare(formats[i], subsampling, Graphics::YUVToRGBManager::kScaleITU);
+		}
+	}
+
+	/**
+	 * Convert all chroma values, once with the plain C++ code and once with
+	 * all vector paths enabled. Each chroma term depends only on u or v, so
+	 * this covers them all.
+	 */
+	static void compareAllChroma(Graphics::YUVToRGBManager::LuminanceScale scale) {
+		const Graphics::PixelFormat format(4, 8, 8, 8, 8, 24, 16, 8, 0);
+		byte planes[3][256 * 4];
+
+		uint32 seed = 1;
+		for (int i = 0; i < 256 * 4; i++) {
+			planes[0][i] = nextRandom(seed) & 0xFF;
+			planes[1][i] = i & 0xFF;
+			planes[2][i] = 255 - (i & 0xFF);
+		}
+
+		Graphics::Surface expected, actual;
+		expected.create(256, 4, format);
+		actual.create(256, 4, format);
+
+		Common::setCPUFeatureMask(0);
+		YUVToRGBMan.convert444(&expected, scale, planes[0], planes[1], planes[2], 256, 4, 256, 256);
+		Common::setCPUFeatureMask(Common::kCPUFeatureAll);
+		YUVToRGBMan.convert444(&actual, scale, planes[0], planes[1], planes[2], 256, 4, 256, 256);
+
+		TS_ASSERT_SAME_DATA(expected.getPixels(), actual.getPixels(), expected.h * expected.pitch);
+
+		expected.free();
+		actual.free();
+	}
+
+	/**
+	 * Convert a large image on the calling thread and in bands on several
+	 * threads, and check that both give the same result.
+	 */
+	static void compareThreads(Subsampling subsampling) {
+		const Graphics::PixelFormat format(4, 8, 8, 8, 8, 24, 16, 8, 0);
+
+		Graphics::Surface expected, actual;
+		expected.create(kLargeWidth, kLargeHeight, format);
+		actual.create(kLargeWidth, kLargeHeight, format);
+
+		YUVToRGBMan.setThreads(1);
+		convert(expected, subsampling, Graphics::YUVToRGBManager::kScaleITU, kLargeWidth, kLargeHeight);
+		YUVToRGBMan.setThreads(4);
+		convert(actual, subsampling, Graphics::YUVToRGBManager::kScaleITU, kLargeWidth, kLargeHeight);
+		YUVToRGBMan.setThreads(1);
+
+		TS_ASSERT_SAME_DATA(expected.getPixels(), actual.getPixels(), expected.h * expected.pitch);
+
+		expected.free();
+		actual.free();
+	}
+
+	struct ConcurrentConversion {
+		Graphics::Surface *dst;
+		Subsampling subsampling;
+	};
+
+	static void convertProc(void *param) {
+		const ConcurrentConversion &c = *(const ConcurrentConversion *)param;
+		for (int i = 0; i < 20; i++)
+			convert(*c.dst, c.subsampling, Graphics::YUVToRGBManager::kScaleITU, kLargeWidth, kLargeHeight);
+	}
+
+	/**
+	 * Convert large images into two formats, once one after the other and
+	 * once on two threads at the same time, and check that both give the
+	 * same result.
+	 */
+	static void compareConcurrent() {
+		const Graphics::PixelFormat formats[] = {
+			Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0),
+			Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0)
+		};
+
+		Graphics::Surface expected[2], actual[2];
+		ConcurrentConversion conversions[2];
+		for (int i = 0; i < 2; ++i) {
+			expected[i].create(kLargeWidth, kLargeHeight, formats[i]);
+			actual[i].create(kLargeWidth, kLargeHeight, formats[i]);
+			convert(expected[i], k420, Graphics::YUVToRGBManager::kScaleITU, kLargeWidth, kLargeHeight);
+			conversions[i].dst = &actual[i];
+			conversions[i].subsampling = k420;
+		}
+
+		YUVToRGBMan.setThreads(4);
+		Common::Thread thread;
+		if (thread.start(convertProc, &conversions[0])) {
+			convertProc(&conversions[1]);
+			thread.join();
+		} else {
+			convertProc(&conversions[0]);
+			convertProc(&conversions[1]);
+		}
+		YUVToRGBMan.setThreads(1);
+
+		for (int i = 0; i < 2; ++i) {
+			TS_ASSERT_SAME_DATA(expected[i].getPixels(), actual[i].getPixels(), expected[i].h * expected[i].pitch);
+			expected[i].free();
+			actual[i].free();
+		}
+	}
+
+	public:
+	void test_yuv444() {
+		compareFormats(k444);
+	}
+
+	void test_yuv420() {
+		compareFormats(k420);
+	}
+
+	void test_yuv410() {
+		compareFormats(k410);
+	}
+
+	void test_all_chroma() {
+		compareAllChroma(Graphics::YUVToRGBManager::kScaleFull);
+		compareAllChroma(Graphics::YUVToRGBManager::kScaleITU);
+	}
+
+	void test_threads() {
+		compareThreads(k444);
+		compareThreads(k420);
+		compareThreads(k410);
+	}
+
+	void test_concurrent() {
+		compareConcurrent();
+	}
+};
@@ -0,0 +1,78 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/yuv_to_rgb.h"
+
+#include "common/cpudetect.h"
+#include "common/thread.h"
+
+class YUVToRGBBenchmarkSuite : public CxxTest::TestSuite
+{
+private:
+	enum {
+		kWidth = 640,
+		kHeight = 480,
+		kPitch = kWidth + 4,
+		kFrames = 50
+	};
+
+	byte *_planes;
+
+	/**
+	 * @return megapixels converted per second
+	 */
+	double measure(const Graphics::PixelFormat &format, bool yuv410, uint32 cpuFeatureMask, int threads) {
+		const int size = kPitch * (kHeight + 1);
+
+		Graphics::Surface dst;
+		dst.create(kWidth, kHeight, format);
+
+		Common::setCPUFeatureMask(cpuFeatureMask);
+		YUVToRGBMan.setThreads(threads);
+
+		const unsigned long long start = benchmarkMicros();
+		for (int frame = 0; frame < kFrames; ++frame) {
+			if (yuv410)
+				YUVToRGBMan.convert410(&dst, Graphics::YUVToRGBManager::kScaleFull, _planes, _planes + size, _planes + 2 * size, kWidth, kHeight, kPitch, kPitch);
+			else
+				YUVToRGBMan.convert420(&dst, Graphics::YUVToRGBManager::kScaleITU, _planes, _planes + size, _planes + 2 * size, kWidth, kHeight, kPitch, kPitch);
+		}
+		const unsigned long long elapsed = benchmarkMicros() - start;
+
+		YUVToRGBMan.setThreads(1);
+		Common::setCPUFeatureMask(Common::kCPUFeatureAll);
+		dst.free();
+		return (double)kWidth * kHeight * kFrames / MAX<unsigned long long>(elapsed, 1);
+	}
+
+	void report(const char *name, const Graphics::PixelFormat &format, bool yuv410) {
+		benchmarkReport(Common::String::format("%-10s scalar: %7.1f  vector: %7.1f  vector, auto (%d): %7.1f MPix/s", name,
+			measure(format, yuv410, 0, 1),
+			measure(format, yuv410, Common::kCPUFeatureAll, 1),
+			Common::getProcessorCount(),
+			measure(format, yuv410, Common::kCPUFeatureAll, 0)));
+	}
+
+public:
+	void setUp() {
+		const int size = kPitch * (kHeight + 1);
+
+		// Smooth gradients, like most video frames
+		_planes = new byte[3 * size];
+		for (int i = 0; i < 3 * size; ++i)
+			_planes[i] = (byte)((i % kPitch) / 3 + (i / kPitch) / 2);
+	}
+
+	void tearDown() {
+		delete[] _planes;
+	}
+
+	void test_yuv_throughput() {
+		const Graphics::PixelFormat rgb565(2, 5, 6, 5, 0, 11, 5, 0, 0);
+		const Graphics::PixelFormat argb8888(4, 8, 8, 8, 8, 24, 16, 8, 0);
+
+		report("420 565", rgb565, false);
+		report("420 8888", argb8888, false);
+		report("410 565", rgb565, true);
+		report("410 8888", argb8888, true);
+	}
+};
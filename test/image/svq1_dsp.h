@@ -0,0 +1,85 @@
+#include <cxxtest/TestSuite.h>
+
+#include "image/codecs/svq1_dsp.h"
+
+#include "common/cpudetect.h"
+
+class SVQ1DSPTestSuite : public CxxTest::TestSuite
+{
+	enum {
+		kPitch = 40,
+		kHeight = 24,
+		kBlocks = 64
+	};
+
+	static uint32 nextRandom(uint32 &seed) {
+		seed = seed * 1103515245 + 12345;
+		return seed >> 8;
+	}
+
+	/**
+	 * Interpolate blocks of both sizes from a random reference plane, at
+	 * all half-pel positions, and return a FNV-1a hash of the result.
+	 * Some blocks reach the last row and column of the reference plane.
+	 */
+	static uint32 runAndHash() {
+		byte reference[kPitch * kHeight];
+		byte plane[kPitch * kHeight];
+		uint32 seed = 1;
+
+		for (int i = 0; i < kPitch * kHeight; i++) {
+			reference[i] = nextRandom(seed) & 0xFF;
+			plane[i] = 0;
+		}
+
+		for (int i = 0; i < kBlocks; i++) {
+			const int size = (i & 1) ? 8 : 16;
+			const int x = (i & 8) ? kPitch - size - 1 : nextRandom(seed) % (kPitch - size);
+			const int y = (i & 16) ? kHeight - size - 1 : nextRandom(seed) % (kHeight - size);
+			const int dx = nextRandom(seed) % (kPitch - size);
+			const int dy = nextRandom(seed) % (kHeight - size);
+			const byte *src = reference + y * kPitch + x;
+			byte *dst = plane + dy * kPitch + dx;
+
+			switch ((i >> 1) & 3) {
+			case 0:
+				Image::svq1PutPixels(dst, src, kPitch, size, size);
+				break;
+			case 1:
+				Image::svq1PutPixelsX2(dst, src, kPitch, size, size);
+				break;
+			case 2:
+				Image::svq1PutPixelsY2(dst, src, kPitch, size, size);
+				break;
+			default:
+				Image::svq1PutPixelsXY2(dst, src, kPitch, size, size);
+				break;
+			}
+		}
+
+		uint32 hash = 2166136261U;
+		for (int i = 0; i < kPitch * kHeight; i++)
+			hash = (hash ^ plane[i]) * 16777619U;
+
+		return hash;
+	}
+
+	/**
+	 * Compare the output against the output of the original C++
+	 * implementation, with all vector paths allowed or none.
+	 */
+	void checkGolden(uint32 cpuFeatureMask) {
+		Common::setCPUFeatureMask(cpuFeatureMask);
+		TS_ASSERT_EQUALS(runAndHash(), 0x41263C0FU);
+		Common::setCPUFeatureMask(Common::kCPUFeatureAll);
+	}
+
+	public:
+	void test_golden_reference() {
+		checkGolden(0);
+	}
+
+	void test_golden_vector() {
+		checkGolden(Common::kCPUFeatureAll);
+	}
+};
@@ -3,13 +3,27 @@
 # Use the 'test' target to run them.
 # Edit TESTS and TESTLIBS to add more tests.
 #
+# Benchmarks are CxxTest suites too, named *_bench.h and living next to
+# the tests. They are kept out of the 'test' target and are run by the
+# 'benchmark' target instead.
+#
 ######################################################################
 
-TESTS        := $(srcdir)/test/common/*.h $(srcdir)/test/audio/*.h
-TEST_LIBS    := audio/libaudio.a common/libcommon.a
+TESTS        := $(filter-out %_bench.h,$(wildcard $(srcdir)/test/common/*.h $(srcdir)/test/audio/*.h $(srcdir)/test/graphics/*.h $(srcdir)/test/image/*.h $(srcdir)/test/video/*.h))
+BENCHMARKS   := $(wildcard $(srcdir)/test/common/*_bench.h $(srcdir)/test/audio/*_bench.h $(srcdir)/test/graphics/*_bench.h $(srcdir)/test/backends/*_bench.h $(srcdir)/test/video/*_bench.h)
+TEST_LIBS    := video/libvideo.a image/libimage.a graphics/libgraphics.a audio/libaudio.a common/libcommon.a
+
+# The video decoder benchmark needs the decoders and their codecs
+BENCHMARK_LIBS := video/libvideo.a image/libimage.a
+
+# The file stream benchmark compares the streams of the POSIX backend
+ifdef POSIX
+BENCHMARK_OBJS := backends/fs/stdiostream.o backends/fs/posix/posix-fs.o backends/fs/posix/posix-mmapstream.o
+endif
 
 #
 TEST_FLAGS   := --runner=StdioPrinter --no-std --no-eh --include=$(srcdir)/test/cxxtest_mingw.h
+BENCHMARK_FLAGS := --runner=StdioPrinter --no-std --no-eh --include=$(srcdir)/test/benchmark.h
 TEST_CFLAGS  := -I$(srcdir)/test/cxxtest
 TEST_LDFLAGS := $(LIBS)
 TEST_CXXFLAGS := $(filter-out -Wglobal-constructors,$(CXXFLAGS))
@@ -34,9 +48,17 @@ test/runner.cpp: $(TESTS)
 	@mkdir -p test
 	$(srcdir)/test/cxxtest/cxxtestgen.py $(TEST_FLAGS) -o $@ $+
 
+benchmark: test/benchmark
+	./test/benchmark
+test/benchmark: test/benchmark.cpp $(BENCHMARK_OBJS) $(BENCHMARK_LIBS) $(TEST_LIBS)
+	$(QUIET_LINK)$(CXX) $(TEST_CXXFLAGS) $(CPPFLAGS) $(TEST_CFLAGS) -o $@ $+ $(TEST_LDFLAGS)
+test/benchmark.cpp: $(BENCHMARKS)
+	@mkdir -p test
+	$(srcdir)/test/cxxtest/cxxtestgen.py $(BENCHMARK_FLAGS) -o $@ $+
+
 
 clean: clean-test
 clean-test:
-	-$(RM) test/runner.cpp test/runner
+	-$(RM) test/runner.cpp test/runner test/benchmark.cpp test/benchmark
 
-.PHONY: test clean-test
+.PHONY: test benchmark clean-test
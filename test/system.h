@@ -0,0 +1,87 @@
+#ifndef TEST_SYSTEM_H
+#define TEST_SYSTEM_H
+
+#include "common/system.h"
+
+#include "graphics/pixelformat.h"
+
+#ifdef USE_PTHREADS
+#include <pthread.h>
+#endif
+
+/**
+ * Just enough of an OSystem for code which needs g_system for its mutexes:
+ * a 640x480 screen which is never shown, no clock and no mixer. The test
+ * runners have no OSystem instance otherwise, so suites using this set
+ * g_system in setUp() and reset it in tearDown().
+ */
+class TestSystem : public OSystem {
+public:
+	const GraphicsMode *getSupportedGraphicsModes() const {
+		static const GraphicsMode modes[] = { { 0, 0, 0 } };
+		return modes;
+	}
+	int getDefaultGraphicsMode() const { return 0; }
+	bool setGraphicsMode(int mode) { return mode == 0; }
+	int getGraphicsMode() const { return 0; }
+	Graphics::PixelFormat getScreenFormat() const { return Graphics::PixelFormat(4, 8, 8, 8, 8, 8, 16, 24, 0); }
+	Common::List<Graphics::PixelFormat> getSupportedFormats() const {
+		Common::List<Graphics::PixelFormat> formats;
+		formats.push_back(getScreenFormat());
+		return formats;
+	}
+	void initSize(uint width, uint height, const Graphics::PixelFormat *format) {}
+	int16 getHeight() { return 480; }
+	int16 getWidth() { return 640; }
+	PaletteManager *getPaletteManager() { return 0; }
+	void copyRectToScreen(const void *buf, int pitch, int x, int y, int w, int h) {}
+	Graphics::Surface *lockScreen() { return 0; }
+	void unlockScreen() {}
+	void fillScreen(uint32 col) {}
+	void updateScreen() {}
+	void setShakePos(int shakeOffset) {}
+	void showOverlay() {}
+	void hideOverlay() {}
+	Graphics::PixelFormat getOverlayFormat() const { return getScreenFormat(); }
+	void clearOverlay() {}
+	void grabOverlay(void *buf, int pitch) {}
+	void copyRectToOverlay(const void *buf, int pitch, int x, int y, int w, int h) {}
+	int16 getOverlayHeight() { return 480; }
+	int16 getOverlayWidth() { return 640; }
+	bool showMouse(bool visible) { return false; }
+	void warpMouse(int x, int y) {}
+	void setMouseCursor(const void *buf, uint w, uint h, int hotspotX, int hotspotY, uint32 keycolor, bool dontScale, const Graphics::PixelFormat *format) {}
+	uint32 getMillis(bool skipRecord) { return 0; }
+	void delayMillis(uint msecs) {}
+	void getTimeAndDate(TimeDate &t) const { memset(&t, 0, sizeof(t)); }
+	Audio::Mixer *getMixer() { return 0; }
+	void quit() {}
+	void displayMessageOnOSD(const char *msg) {}
+	void logMessage(LogMessageType::Type type, const char *message) {}
+
+#ifdef USE_PTHREADS
+	// Code under test may lock its mutexes from its own threads too
+	MutexRef createMutex() {
+		pthread_mutexattr_t attr;
+		pthread_mutexattr_init(&attr);
+		pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+		pthread_mutex_t *mutex = new pthread_mutex_t;
+		pthread_mutex_init(mutex, &attr);
+		pthread_mutexattr_destroy(&attr);
+		return (MutexRef)mutex;
+	}
+	void lockMutex(MutexRef mutex) { pthread_mutex_lock((pthread_mutex_t *)mutex); }
+	void unlockMutex(MutexRef mutex) { pthread_mutex_unlock((pthread_mutex_t *)mutex); }
+	void deleteMutex(MutexRef mutex) {
+		pthread_mutex_destroy((pthread_mutex_t *)mutex);
+		delete (pthread_mutex_t *)mutex;
+	}
+#else
+	MutexRef createMutex() { return (MutexRef)1; }
+	void lockMutex(MutexRef mutex) {}
+	void unlockMutex(MutexRef mutex) {}
+	void deleteMutex(MutexRef mutex) {}
+#endif
+};
+
+#endif
@@ -0,0 +1,108 @@
+#include <cxxtest/TestSuite.h>
+
+#include "video/bink_dsp.h"
+
+#include "common/cpudetect.h"
+
+class BinkDSPTestSuite : public CxxTest::TestSuite
+{
+	enum {
+		kPitch = 40,
+		kHeight = 24,
+		kBlocks = 64
+	};
+
+	static uint32 nextRandom(uint32 &seed) {
+		seed = seed * 1103515245 + 12345;
+		return seed >> 8;
+	}
+
+#ifdef USE_BINK
+	/**
+	 * Fill a block of coefficients. Most are small, like in real videos,
+	 * but some blocks use the full range to hit all overflows.
+	 */
+	static void fillCoeffs(int16 *coeffs, uint32 &seed, int block) {
+		for (int i = 0; i < 64; i++) {
+			const uint32 r = nextRandom(seed);
+
+			if (block % 4 == 3)
+				coeffs[i] = (int16)r;
+			else if (i == 0 || (r & 3) == 0)
+				coeffs[i] = (int16)((r >> 4) % 2048) - 1024;
+			else
+				coeffs[i] = 0;
+		}
+	}
+
+	/**
+	 * Run all operations on a plane, at different positions, and return a
+	 * FNV-1a hash of the result.
+	 */
+	static uint32 runAndHash() {
+		byte plane[kPitch * kHeight];
+		uint32 seed = 1;
+
+		for (int i = 0; i < kPitch * kHeight; i++)
+			plane[i] = nextRandom(seed) & 0xFF;
+
+		for (int i = 0; i < kBlocks; i++) {
+			byte *dest = plane + (nextRandom(seed) % (kHeight - 15)) * kPitch + nextRandom(seed) % (kPitch - 15);
+			int16 coeffs[64];
+			byte pixels[64];
+			byte colors[2];
+
+			fillCoeffs(coeffs, seed, i);
+			for (int j = 0; j < 64; j++)
+				pixels[j] = nextRandom(seed) & 0xFF;
+			colors[0] = nextRandom(seed) & 0xFF;
+			colors[1] = nextRandom(seed) & 0xFF;
+
+			switch (i % 5) {
+			case 0:
+				Video::binkIDCTPut(dest, kPitch, coeffs);
+				break;
+			case 1:
+				Video::binkIDCTAdd(dest, kPitch, coeffs);
+				break;
+			case 2:
+				Video::binkAddResidue(dest, kPitch, coeffs);
+				break;
+			case 3:
+				Video::binkPutPattern(dest, kPitch, colors, pixels);
+				break;
+			default:
+				Video::binkPutScaled(dest, kPitch, pixels);
+				break;
+			}
+		}
+
+		uint32 hash = 2166136261U;
+		for (int i = 0; i < kPitch * kHeight; i++)
+			hash = (hash ^ plane[i]) * 16777619U;
+
+		return hash;
+	}
+#endif
+
+	/**
+	 * Compare the output against the output of the original C++
+	 * implementation, with all vector paths allowed or none.
+	 */
+	void checkGolden(uint32 cpuFeatureMask) {
+#ifdef USE_BINK
+		Common::setCPUFeatureMask(cpuFeatureMask);
+		TS_ASSERT_EQUALS(runAndHash(), 0xABCB53DBU);
+		Common::setCPUFeatureMask(Common::kCPUFeatureAll);
+#endif
+	}
+
+	public:
+	void test_golden_reference() {
+		checkGolden(0);
+	}
+
+	void test_golden_vector() {
+		checkGolden(Common::kCPUFeatureAll);
+	}
+};
@@ -0,0 +1,1162 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/mixer_intern.h"
+
+#include "common/cpudetect.h"
+#include "common/math.h"
+#include "common/memstream.h"
+#include "common/str.h"
+#include "common/thread.h"
+
+#include "graphics/surface.h"
+
+#include "image/codecs/svq1.h"
+#include "image/codecs/svq1_vlc.h"
+
+#include "video/avi_decoder.h"
+#include "video/bink_decoder.h"
+#include "video/coktel_decoder.h"
+#include "video/dxa_decoder.h"
+#include "video/flic_decoder.h"
+#include "video/mpegps_decoder.h"
+#include "video/psx_decoder.h"
+#include "video/qt_decoder.h"
+#include "video/smk_decoder.h"
+#ifdef USE_THEORADEC
+#include "video/theora_decoder.h"
+#endif
+
+#if defined(POSIX)
+#include "backends/fs/stdiostream.h"
+#endif
+
+#include "test/system.h"
+
+#include <stdlib.h>
+
+/**
+ * The test system, with a clock and a mixer which never plays anything.
+ */
+class VideoBenchmarkSystem : public TestSystem {
+public:
+	VideoBenchmarkSystem() : _mixer(0) {}
+
+	~VideoBenchmarkSystem() {
+		delete _mixer;
+	}
+
+	uint32 getMillis(bool skipRecord) { return (uint32)(benchmarkMicros() / 1000); }
+	Audio::Mixer *getMixer() {
+		// The mixer needs g_system for its mutex
+		if (!_mixer)
+			_mixer = new Audio::MixerImpl(this, 22050);
+		return _mixer;
+	}
+
+private:
+	Audio::MixerImpl *_mixer;
+};
+
+class VideoDecoderBenchmarkSuite : public CxxTest::TestSuite
+{
+private:
+	enum {
+		kWidth = 640,
+		kHeight = 480,
+		kFrames = 100,
+		kMaxFrames = 1000,	///< Frames decoded at most from a sample video
+		kAheadFrames = 4,
+		kBinkFrames = 20,
+		kBinkThreads = 4,
+		kSVQ1Frames = 40,
+		kWorkMicros = 5000	///< Time the engine spends on a frame besides decoding it
+	};
+
+	VideoBenchmarkSystem *_system;
+
+	struct Measurement {
+		uint frames;
+		double fps;
+		uint32 hash;
+	};
+
+	static void spin(unsigned long long micros) {
+		const unsigned long long end = benchmarkMicros() + micros;
+		while (benchmarkMicros() < end)
+			;
+	}
+
+	static uint32 hashFrame(uint32 hash, const Graphics::Surface *frame) {
+		for (int y = 0; y < frame->h; ++y) {
+			const byte *row = (const byte *)frame->getBasePtr(0, y);
+			for (int x = 0; x < frame->w * frame->format.bytesPerPixel; ++x)
+				hash = (hash ^ row[x]) * 16777619U;
+		}
+		return hash;
+	}
+
+	/**
+	 * Plays a video as fast as possible. Every frame is hashed, and the
+	 * engine may spend some time on it before asking for the next one.
+	 */
+	static bool measure(Video::VideoDecoder *decoder, const byte *data, uint32 size, uint ahead, uint workMicros, Measurement &result) {
+		if (!decoder->setDecodeAhead(ahead))
+			return false;
+		if (!decoder->loadStream(new Common::MemoryReadStream(data, size)))
+			return false;
+
+		result.frames = 0;
+		result.hash = 2166136261U;
+
+		const unsigned long long start = benchmarkMicros();
+		while (!decoder->endOfVideo() && result.frames < kMaxFrames) {
+			const Graphics::Surface *frame = decoder->decodeNextFrame();
+			if (frame)
+				result.hash = hashFrame(result.hash, frame);
+			result.frames++;
+			spin(workMicros);
+		}
+		const unsigned long long elapsed = benchmarkMicros() - start;
+
+		decoder->close();
+		result.fps = result.frames * 1000000.0 / MAX<unsigned long long>(elapsed, 1);
+		return true;
+	}
+
+	/**
+	 * Rewinds while decoding ahead, which must throw away the frames that
+	 * were decoded already.
+	 * @return false if the video cannot be rewound
+	 */
+	static bool hashAfterRewind(Video::VideoDecoder *decoder, const byte *data, uint32 size, uint frames, uint32 &hash) {
+		decoder->setDecodeAhead(kAheadFrames);
+		decoder->loadStream(new Common::MemoryReadStream(data, size));
+
+		if (!decoder->isRewindable()) {
+			decoder->close();
+			return false;
+		}
+
+		for (uint i = 0; i < frames / 2; ++i)
+			decoder->decodeNextFrame();
+		TS_ASSERT(decoder->rewind());
+		TS_ASSERT_EQUALS(decoder->getCurFrame(), -1);
+
+		hash = 2166136261U;
+		for (uint i = 0; i < frames && !decoder->endOfVideo(); ++i) {
+			const Graphics::Surface *frame = decoder->decodeNextFrame();
+			if (frame)
+				hash = hashFrame(hash, frame);
+		}
+
+		decoder->close();
+		return true;
+	}
+
+	/**
+	 * Reports the frame rate of a video decoded synchronously and ahead,
+	 * with and without the engine doing something between the frames.
+	 */
+	static void report(const char *name, Video::VideoDecoder *decoder, const byte *data, uint32 size) {
+		Measurement sync, syncWork, ahead, aheadWork;
+
+		if (!measure(decoder, data, size, 0, 0, sync)) {
+			benchmarkReport(Common::String::format("%-12s could not be loaded", name));
+			delete decoder;
+			return;
+		}
+		measure(decoder, data, size, 0, kWorkMicros, syncWork);
+
+		Common::String line = Common::String::format("%-12s %4u frames  sync: %7.1f  +work: %7.1f", name, sync.frames, sync.fps, syncWork.fps);
+		if (measure(decoder, data, size, kAheadFrames, 0, ahead) && measure(decoder, data, size, kAheadFrames, kWorkMicros, aheadWork)) {
+			line += Common::String::format("  ahead: %7.1f  +work: %7.1f", ahead.fps, aheadWork.fps);
+
+			// Decoding ahead must not change the frames
+			TS_ASSERT_EQUALS(ahead.frames, sync.frames);
+			TS_ASSERT_EQUALS(ahead.hash, sync.hash);
+
+			uint32 hash;
+			if (sync.frames < kMaxFrames && hashAfterRewind(decoder, data, size, sync.frames, hash))
+				TS_ASSERT_EQUALS(hash, sync.hash);
+		} else {
+			line += "  (no decoding ahead)";
+		}
+
+		benchmarkReport(line);
+		delete decoder;
+	}
+
+	static void writePixels(Common::WriteStream &stream, int y, int frame, int count) {
+		for (int x = 0; x < count; ++x)
+			stream.writeByte((byte)(x * 2 + y + frame * 3));
+	}
+
+	/**
+	 * A FLIC with a full palette, whose frames are all byte run encoded.
+	 */
+	static byte *createFlic(uint32 &size) {
+		Common::MemoryWriteStreamDynamic stream(DisposeAfterUse::NO);
+
+		stream.writeUint32LE(0);	// size, patched below
+		stream.writeUint16LE(0xAF12);
+		stream.writeUint16LE(kFrames);
+		stream.writeUint16LE(kWidth);
+		stream.writeUint16LE(kHeight);
+		stream.writeUint16LE(8);
+		stream.writeUint16LE(0);	// flags
+		stream.writeUint32LE(66);	// speed
+		while (stream.pos() < 80)
+			stream.writeByte(0);
+		stream.writeUint32LE(128);	// first frame
+		stream.writeUint32LE(0);	// second frame, patched below
+		while (stream.pos() < 128)
+			stream.writeByte(0);
+
+		const uint32 lineSize = 1 + (kWidth / 64) * (2 + 33);
+		const uint32 brunSize = 6 + kHeight * lineSize;
+		const uint32 palSize = 6 + 4 + 256 * 3;
+
+		for (int frame = 0; frame < kFrames; ++frame) {
+			if (frame == 1)
+				WRITE_LE_UINT32(stream.getData() + 84, stream.pos());
+
+			stream.writeUint32LE(16 + brunSize + (frame == 0 ? palSize : 0));
+			stream.writeUint16LE(0xF1FA);
+			stream.writeUint16LE(frame == 0 ? 2 : 1);
+			stream.writeUint16LE(0);	// delay
+			stream.writeUint16LE(0);	// reserved
+			stream.writeUint16LE(0);	// width
+			stream.writeUint16LE(0);	// height
+
+			if (frame == 0) {
+				stream.writeUint32LE(palSize);
+				stream.writeUint16LE(4);
+				stream.writeUint16LE(1);
+				stream.writeUint16LE(0);	// all 256 colors
+				for (int i = 0; i < 256 * 3; ++i)
+					stream.writeByte((byte)(i * 7));
+			}
+
+			// Alternate runs and literals of 32 pixels each
+			stream.writeUint32LE(brunSize);
+			stream.writeUint16LE(15);
+			for (int y = 0; y < kHeight; ++y) {
+				stream.writeByte(kWidth / 32);
+				for (int x = 0; x < kWidth; x += 64) {
+					stream.writeByte(32);
+					stream.writeByte((byte)(x / 64 + y / 16 + frame));
+					stream.writeByte((byte)-32);
+					writePixels(stream, y, frame, 32);
+				}
+			}
+		}
+
+		size = stream.size();
+		WRITE_LE_UINT32(stream.getData(), size);
+		return stream.getData();
+	}
+
+	/**
+	 * An AVI with a single Microsoft RLE video stream.
+	 */
+	static byte *createAVI(uint32 &size) {
+		Common::MemoryWriteStreamDynamic stream(DisposeAfterUse::NO);
+
+		const uint32 strfSize = 40 + 256 * 4;
+		const uint32 strlSize = 4 + 8 + 56 + 8 + strfSize;
+		const uint32 hdrlSize = 4 + 8 + 56 + 8 + strlSize;
+		const uint32 frameSize = kHeight * ((kWidth / 64) * (2 + 2 + 32) + 2);
+
+		stream.writeUint32BE(MKTAG('R', 'I', 'F', 'F'));
+		stream.writeUint32LE(0);	// size, patched below
+		stream.writeUint32BE(MKTAG('A', 'V', 'I', ' '));
+
+		stream.writeUint32BE(MKTAG('L', 'I', 'S', 'T'));
+		stream.writeUint32LE(hdrlSize);
+		stream.writeUint32BE(MKTAG('h', 'd', 'r', 'l'));
+
+		stream.writeUint32BE(MKTAG('a', 'v', 'i', 'h'));
+		stream.writeUint32LE(56);
+		stream.writeUint32LE(66666);	// microseconds per frame
+		stream.writeUint32LE(0);
+		stream.writeUint32LE(0);
+		stream.writeUint32LE(0);	// flags
+		stream.writeUint32LE(kFrames);
+		stream.writeUint32LE(0);
+		stream.writeUint32LE(1);	// streams
+		stream.writeUint32LE(frameSize);
+		stream.writeUint32LE(kWidth);
+		stream.writeUint32LE(kHeight);
+		for (int i = 0; i < 4; ++i)
+			stream.writeUint32LE(0);
+
+		stream.writeUint32BE(MKTAG('L', 'I', 'S', 'T'));
+		stream.writeUint32LE(strlSize);
+		stream.writeUint32BE(MKTAG('s', 't', 'r', 'l'));
+
+		stream.writeUint32BE(MKTAG('s', 't', 'r', 'h'));
+		stream.writeUint32LE(56);
+		stream.writeUint32BE(MKTAG('v', 'i', 'd', 's'));
+		stream.writeUint32LE(0);	// handler
+		stream.writeUint32LE(0);	// flags
+		stream.writeUint16LE(0);	// priority
+		stream.writeUint16LE(0);	// language
+		stream.writeUint32LE(0);	// initial frames
+		stream.writeUint32LE(1);	// scale
+		stream.writeUint32LE(15);	// rate
+		stream.writeUint32LE(0);	// start
+		stream.writeUint32LE(kFrames);
+		stream.writeUint32LE(frameSize);
+		stream.writeUint32LE(0);	// quality
+		stream.writeUint32LE(0);	// sample size
+		for (int i = 0; i < 4; ++i)
+			stream.writeUint16LE(0);	// frame rectangle
+
+		stream.writeUint32BE(MKTAG('s', 't', 'r', 'f'));
+		stream.writeUint32LE(strfSize);
+		stream.writeUint32LE(40);
+		stream.writeUint32LE(kWidth);
+		stream.writeUint32LE(kHeight);
+		stream.writeUint16LE(1);	// planes
+		stream.writeUint16LE(8);	// bits per pixel
+		stream.writeUint32LE(1);	// BI_RLE8
+		stream.writeUint32LE(frameSize);
+		stream.writeUint32LE(0);
+		stream.writeUint32LE(0);
+		stream.writeUint32LE(256);	// colors used
+		stream.writeUint32LE(0);
+		for (int i = 0; i < 256; ++i) {
+			stream.writeByte((byte)i);
+			stream.writeByte((byte)(255 - i));
+			stream.writeByte((byte)(i * 3));
+			stream.writeByte(0);
+		}
+
+		stream.writeUint32BE(MKTAG('L', 'I', 'S', 'T'));
+		stream.writeUint32LE(4 + kFrames * (8 + frameSize));
+		stream.writeUint32BE(MKTAG('m', 'o', 'v', 'i'));
+
+		// Alternate runs and literals of 32 pixels each
+		for (int frame = 0; frame < kFrames; ++frame) {
+			stream.writeUint32BE(MKTAG('0', '0', 'd', 'c'));
+			stream.writeUint32LE(frameSize);
+			for (int y = 0; y < kHeight; ++y) {
+				for (int x = 0; x < kWidth; x += 64) {
+					stream.writeByte(32);
+					stream.writeByte((byte)(x / 64 + y / 16 + frame));
+					stream.writeByte(0);
+					stream.writeByte(32);
+					writePixels(stream, y, frame, 32);
+				}
+				stream.writeByte(0);
+				stream.writeByte(y == kHeight - 1 ? 1 : 0);	// end of picture or line
+			}
+		}
+
+		size = stream.size();
+		WRITE_LE_UINT32(stream.getData() + 4, size - 8);
+		return stream.getData();
+	}
+
+	enum {
+		kBinkBlockTypes,
+		kBinkSubBlockTypes,
+		kBinkColors,
+		kBinkPattern,
+		kBinkXOff,
+		kBinkYOff,
+		kBinkIntraDC,
+		kBinkInterDC,
+		kBinkRun,
+		kBinkSources
+	};
+
+	/** Bits in the order Common::BitStream32LELSB reads them, one per byte. */
+	typedef Common::Array<byte> Bits;
+
+	/** A row of blocks of a Bink plane: the bundle values and the bits read per block. */
+	struct BinkRow {
+		Common::Array<int> values[kBinkSources];
+		Bits bits;
+	};
+
+	static uint32 nextRandom(uint32 &seed, uint32 range) {
+		seed = seed * 1103515245 + 12345;
+		return (seed >> 8) % range;
+	}
+
+	static void putBits(Bits &bits, uint32 value, int count) {
+		for (int i = 0; i < count; ++i)
+			bits.push_back((value >> i) & 1);
+	}
+
+	static uint32 putRandomBits(Bits &bits, uint32 &seed, int count) {
+		const uint32 value = nextRandom(seed, 1 << count);
+		putBits(bits, value, count);
+		return value;
+	}
+
+	/**
+	 * Writes random DCT coefficients. Any bits are valid here, so this
+	 * walks through the coefficient lists like the decoder does and
+	 * flips a coin for every bit it reads.
+	 */
+	static void putDCTCoeffs(Bits &bits, uint32 &seed) {
+		int coefList[128], modeList[128];
+		int listStart = 64, listEnd = 64;
+
+		coefList[listEnd] = 4;  modeList[listEnd++] = 0;
+		coefList[listEnd] = 24; modeList[listEnd++] = 0;
+		coefList[listEnd] = 44; modeList[listEnd++] = 0;
+		coefList[listEnd] = 1;  modeList[listEnd++] = 3;
+		coefList[listEnd] = 2;  modeList[listEnd++] = 3;
+		coefList[listEnd] = 3;  modeList[listEnd++] = 3;
+
+		const int maxBits = nextRandom(seed, 6);
+		putBits(bits, maxBits, 4);
+
+		for (int b = maxBits - 1; b >= 0; b--) {
+			int listPos = listStart;
+
+			while (listPos < listEnd) {
+				if (!(modeList[listPos] | coefList[listPos]) || !putRandomBits(bits, seed, 1)) {
+					listPos++;
+					continue;
+				}
+
+				int ccoef = coefList[listPos];
+				const int mode = modeList[listPos];
+
+				if (mode == 0 || mode == 2) {
+					if (mode == 0) {
+						coefList[listPos] = ccoef + 4;
+						modeList[listPos] = 1;
+					} else {
+						coefList[listPos]   = 0;
+						modeList[listPos++] = 0;
+					}
+
+					for (int i = 0; i < 4; i++, ccoef++) {
+						if (putRandomBits(bits, seed, 1)) {
+							coefList[--listStart] = ccoef;
+							modeList[  listStart] = 3;
+						} else {
+							putRandomBits(bits, seed, b ? b + 1 : 1);	// value and sign
+						}
+					}
+				} else if (mode == 1) {
+					modeList[listPos] = 2;
+					for (int i = 0; i < 3; i++) {
+						ccoef += 4;
+						coefList[listEnd]   = ccoef;
+						modeList[listEnd++] = 2;
+					}
+				} else {
+					putRandomBits(bits, seed, b ? b + 1 : 1);	// value and sign
+					coefList[listPos]   = 0;
+					modeList[listPos++] = 0;
+				}
+			}
+		}
+
+		putRandomBits(bits, seed, 4);	// quantizer
+	}
+
+	/** Writes a random residue block, the same way as putDCTCoeffs(). */
+	static void putResidue(Bits &bits, uint32 &seed) {
+		int coefList[128], modeList[128];
+		int listStart = 64, listEnd = 64;
+		int nzCoeffCount = 0;
+
+		coefList[listEnd] =  4; modeList[listEnd++] = 0;
+		coefList[listEnd] = 24; modeList[listEnd++] = 0;
+		coefList[listEnd] = 44; modeList[listEnd++] = 0;
+		coefList[listEnd] =  0; modeList[listEnd++] = 2;
+
+		int masksCount = putRandomBits(bits, seed, 7);
+
+		for (int mask = 1 << putRandomBits(bits, seed, 3); mask; mask >>= 1) {
+			for (int i = 0; i < nzCoeffCount; i++) {
+				if (!putRandomBits(bits, seed, 1))
+					continue;
+				if (--masksCount < 0)
+					return;
+			}
+
+			int listPos = listStart;
+			while (listPos < listEnd) {
+				if (!(coefList[listPos] | modeList[listPos]) || !putRandomBits(bits, seed, 1)) {
+					listPos++;
+					continue;
+				}
+
+				int ccoef = coefList[listPos];
+				const int mode = modeList[listPos];
+
+				if (mode == 0 || mode == 2) {
+					if (mode == 0) {
+						coefList[listPos] = ccoef + 4;
+						modeList[listPos] = 1;
+					} else {
+						coefList[listPos]   = 0;
+						modeList[listPos++] = 0;
+					}
+
+					for (int i = 0; i < 4; i++, ccoef++) {
+						if (putRandomBits(bits, seed, 1)) {
+							coefList[--listStart] = ccoef;
+							modeList[  listStart] = 3;
+						} else {
+							nzCoeffCount++;
+							putRandomBits(bits, seed, 1);	// sign
+							if (--masksCount < 0)
+								return;
+						}
+					}
+				} else if (mode == 1) {
+					modeList[listPos] = 2;
+					for (int i = 0; i < 3; i++) {
+						ccoef += 4;
+						coefList[listEnd]   = ccoef;
+						modeList[listEnd++] = 2;
+					}
+				} else {
+					nzCoeffCount++;
+					putRandomBits(bits, seed, 1);	// sign
+					coefList[listPos]   = 0;
+					modeList[listPos++] = 0;
+					if (--masksCount < 0)
+						return;
+				}
+			}
+		}
+	}
+
+	static void putMotion(BinkRow &row, uint32 &seed, int x, int y, int width, int height) {
+		// Keep the source block inside the plane
+		const int minX = MAX(-15, -x), maxX = MAX(minX, MIN(15, width - 8 - x));
+		const int minY = MAX(-15, -y), maxY = MAX(minY, MIN(15, height - 8 - y));
+
+		row.values[kBinkXOff].push_back(minX + (int)nextRandom(seed, maxX - minX + 1));
+		row.values[kBinkYOff].push_back(minY + (int)nextRandom(seed, maxY - minY + 1));
+	}
+
+	static void putBlock(BinkRow &row, uint32 &seed, int type, int x, int y, int width, int height) {
+		switch (type) {
+		case 2:	// motion
+			putMotion(row, seed, x, y, width, height);
+			break;
+		case 3: {	// run
+			putRandomBits(row.bits, seed, 4);	// scan order
+			int i = 0;
+			do {
+				const int run = 1 + nextRandom(seed, MIN(16, 64 - i));
+				i += run;
+				row.values[kBinkRun].push_back(run - 1);
+				if (putRandomBits(row.bits, seed, 1)) {
+					row.values[kBinkColors].push_back(nextRandom(seed, 256));
+				} else {
+					for (int j = 0; j < run; j++)
+						row.values[kBinkColors].push_back(nextRandom(seed, 256));
+				}
+			} while (i < 63);
+			if (i == 63)
+				row.values[kBinkColors].push_back(nextRandom(seed, 256));
+			break;
+		}
+		case 4:	// residue
+			putMotion(row, seed, x, y, width, height);
+			putResidue(row.bits, seed);
+			break;
+		case 5:	// intra
+			row.values[kBinkIntraDC].push_back(nextRandom(seed, 2048));
+			putDCTCoeffs(row.bits, seed);
+			break;
+		case 6:	// fill
+			row.values[kBinkColors].push_back(nextRandom(seed, 256));
+			break;
+		case 7:	// inter
+			putMotion(row, seed, x, y, width, height);
+			row.values[kBinkInterDC].push_back((int)nextRandom(seed, 601) - 300);
+			putDCTCoeffs(row.bits, seed);
+			break;
+		case 8:	// pattern
+			for (int i = 0; i < 2; i++)
+				row.values[kBinkColors].push_back(nextRandom(seed, 256));
+			for (int i = 0; i < 8; i++)
+				row.values[kBinkPattern].push_back(nextRandom(seed, 256));
+			break;
+		case 9:	// raw
+			for (int i = 0; i < 64; i++)
+				row.values[kBinkColors].push_back(nextRandom(seed, 256));
+			break;
+		default:	// skip
+			break;
+		}
+	}
+
+	/** Writes the values of a bundle read at the start of a row, without any of the shortcuts. */
+	static void putValues(Bits &bits, int source, const Common::Array<int> &values, int countLength) {
+		putBits(bits, values.size(), countLength);
+
+		switch (source) {
+		case kBinkColors:
+			putBits(bits, 0, 1);
+			for (uint i = 0; i < values.size(); i++) {
+				putBits(bits, values[i] >> 4, 4);
+				putBits(bits, values[i] & 15, 4);
+			}
+			break;
+		case kBinkPattern:
+			for (uint i = 0; i < values.size(); i++) {
+				putBits(bits, values[i] & 15, 4);
+				putBits(bits, values[i] >> 4, 4);
+			}
+			break;
+		case kBinkXOff:
+		case kBinkYOff:
+			putBits(bits, 0, 1);
+			for (uint i = 0; i < values.size(); i++) {
+				putBits(bits, ABS(values[i]), 4);
+				if (values[i])
+					putBits(bits, values[i] < 0, 1);
+			}
+			break;
+		case kBinkIntraDC:
+		case kBinkInterDC:
+			if (source == kBinkInterDC) {
+				putBits(bits, ABS(values[0]), 10);
+				if (values[0])
+					putBits(bits, values[0] < 0, 1);
+			} else {
+				putBits(bits, values[0], 11);
+			}
+
+			// The other values are differences, in groups of eight
+			for (uint i = 1; i < values.size(); i += 8) {
+				const uint end = MIN<uint>(i + 8, values.size());
+
+				int maxDiff = 0;
+				for (uint j = i; j < end; j++)
+					maxDiff = MAX(maxDiff, ABS(values[j] - values[j - 1]));
+
+				int size = 0;
+				while ((1 << size) <= maxDiff)
+					size++;
+
+				putBits(bits, size, 4);
+				if (!size)
+					continue;
+
+				for (uint j = i; j < end; j++) {
+					const int diff = values[j] - values[j - 1];
+					putBits(bits, ABS(diff), size);
+					if (diff)
+						putBits(bits, diff < 0, 1);
+				}
+			}
+			break;
+		default:
+			putBits(bits, 0, 1);
+			for (uint i = 0; i < values.size(); i++)
+				putBits(bits, values[i], 4);
+			break;
+		}
+	}
+
+	/**
+	 * Writes a plane of random blocks. With intraOnly, no block depends on
+	 * the previous frame.
+	 */
+	static void putPlane(Bits &bits, uint32 &seed, int width, int height, bool isChroma, bool intraOnly) {
+		static const int intraTypes[] = { 1, 3, 5, 6, 8, 9 };
+		static const int interTypes[] = { 0, 0, 0, 1, 2, 2, 3, 4, 5, 6, 7, 7, 8, 9 };
+		static const int scaledTypes[] = { 3, 5, 6, 8, 9 };
+
+		const int blockWidth  = isChroma ? (width + 15) >> 4 : (width + 7) >> 3;
+		const int blockHeight = isChroma ? (height + 15) >> 4 : (height + 7) >> 3;
+		if (isChroma) {
+			width  >>= 1;
+			height >>= 1;
+		}
+
+		// The same lengths of the value counts as the decoder uses
+		const int w = MAX(width, 8);
+		const int cbw = blockWidth;
+		int countLengths[kBinkSources];
+		countLengths[kBinkBlockTypes]    = Common::intLog2((w >> 3) + 511) + 1;
+		countLengths[kBinkSubBlockTypes] = Common::intLog2(((w + 7) >> 4) + 511) + 1;
+		countLengths[kBinkColors]        = Common::intLog2(cbw * 64 + 511) + 1;
+		countLengths[kBinkIntraDC]       = Common::intLog2((w >> 3) + 511) + 1;
+		countLengths[kBinkInterDC]       = Common::intLog2((w >> 3) + 511) + 1;
+		countLengths[kBinkXOff]          = Common::intLog2((w >> 3) + 511) + 1;
+		countLengths[kBinkYOff]          = Common::intLog2((w >> 3) + 511) + 1;
+		countLengths[kBinkPattern]       = Common::intLog2((cbw << 3) + 511) + 1;
+		countLengths[kBinkRun]           = Common::intLog2(cbw * 48 + 511) + 1;
+
+		Common::Array<BinkRow> rows;
+		rows.resize(blockHeight);
+
+		Common::Array<bool> scaled;
+		scaled.resize(blockWidth);
+
+		for (int by = 0; by < blockHeight; by++) {
+			BinkRow &row = rows[by];
+
+			for (int bx = 0; bx < blockWidth; bx++) {
+				// The odd rows repeat the 16x16 blocks, which are skipped
+				if (by & 1) {
+					if (scaled[bx]) {
+						row.values[kBinkBlockTypes].push_back(1);
+						bx++;
+						continue;
+					}
+				} else {
+					scaled[bx] = false;
+				}
+
+				int type = intraOnly ? intraTypes[nextRandom(seed, ARRAYSIZE(intraTypes))] : interTypes[nextRandom(seed, ARRAYSIZE(interTypes))];
+				if (type == 1 && ((by & 1) || by + 1 >= blockHeight || bx + 1 >= blockWidth))
+					type = 5;
+
+				row.values[kBinkBlockTypes].push_back(type);
+
+				if (type == 1) {
+					const int subType = scaledTypes[nextRandom(seed, ARRAYSIZE(scaledTypes))];
+					row.values[kBinkSubBlockTypes].push_back(subType);
+					putBlock(row, seed, subType, bx * 8, by * 8, width, height);
+
+					scaled[bx] = true;
+					bx++;
+				} else {
+					putBlock(row, seed, type, bx * 8, by * 8, width, height);
+				}
+			}
+		}
+
+		// Raw nibbles for all Huffman codes
+		for (int i = 0; i < kBinkSources; i++) {
+			if (i == kBinkColors)
+				putBits(bits, 0, 16 * 4);
+			if (i != kBinkIntraDC && i != kBinkInterDC)
+				putBits(bits, 0, 4);
+		}
+
+		// The decoder reads new values of a bundle at the start of a row once
+		// it used up all it read before, so they are read for the next row
+		// needing any.
+		uint pending[kBinkSources];
+		bool done[kBinkSources];
+		for (int i = 0; i < kBinkSources; i++) {
+			pending[i] = 0;
+			done[i] = false;
+		}
+
+		for (uint by = 0; by < rows.size(); by++) {
+			for (int i = 0; i < kBinkSources; i++) {
+				if (!done[i] && !pending[i]) {
+					uint next = by;
+					while (next < rows.size() && rows[next].values[i].empty())
+						next++;
+
+					if (next == rows.size()) {
+						putBits(bits, 0, countLengths[i]);
+						done[i] = true;
+					} else {
+						putValues(bits, i, rows[next].values[i], countLengths[i]);
+						pending[i] = rows[next].values[i].size();
+					}
+				}
+				pending[i] -= rows[by].values[i].size();
+			}
+
+			for (uint i = 0; i < rows[by].bits.size(); i++)
+				bits.push_back(rows[by].bits[i]);
+		}
+
+		// The next plane starts at a 32-bit boundary
+		while (bits.size() & 31)
+			bits.push_back(0);
+	}
+
+	/**
+	 * A BIKi video of random blocks of all types, using none of the
+	 * shortcuts of the bitstream.
+	 */
+	static byte *createBink(int width, int height, int frames, uint32 &size) {
+		Common::MemoryWriteStreamDynamic stream(DisposeAfterUse::NO);
+		uint32 seed = 1;
+
+		stream.writeUint32BE(MKTAG('B', 'I', 'K', 'i'));
+		stream.writeUint32LE(0);	// size, patched below
+		stream.writeUint32LE(frames);
+		stream.writeUint32LE(0);	// largest frame, patched below
+		stream.writeUint32LE(0);
+		stream.writeUint32LE(width);
+		stream.writeUint32LE(height);
+		stream.writeUint32LE(15);	// frame rate
+		stream.writeUint32LE(1);
+		stream.writeUint32LE(0);	// flags
+		stream.writeUint32LE(0);	// audio tracks
+
+		const uint32 offsets = stream.pos();
+		for (int frame = 0; frame < frames; ++frame)
+			stream.writeUint32LE(0);	// offset, patched below
+
+		uint32 largest = 0;
+		for (int frame = 0; frame < frames; ++frame) {
+			WRITE_LE_UINT32(stream.getData() + offsets + frame * 4, stream.pos() | (frame == 0 ? 1 : 0));
+
+			Bits bits;
+			putBits(bits, 0, 32);	// skipped by BIKi
+			for (int plane = 0; plane < 3; ++plane)
+				putPlane(bits, seed, width, height, plane != 0, frame == 0);
+
+			for (uint i = 0; i < bits.size(); i += 32) {
+				uint32 word = 0;
+				for (int j = 0; j < 32; j++)
+					word |= bits[i + j] << j;
+				stream.writeUint32LE(word);
+			}
+
+			largest = MAX<uint32>(largest, bits.size() / 8);
+		}
+
+		size = stream.size();
+		WRITE_LE_UINT32(stream.getData() + 4, size - 8);
+		WRITE_LE_UINT32(stream.getData() + 12, largest);
+		return stream.getData();
+	}
+
+	/**
+	 * Decodes a Bink video with the plain C++ code, with the vector paths
+	 * and with worker threads, which must all give the same frames.
+	 */
+	static void reportBink(const char *name, const byte *data, uint32 size) {
+		Video::BinkDecoder decoder;
+		Measurement scalar, vector, threads;
+
+		Common::setCPUFeatureMask(0);
+		decoder.setDecodeThreads(1);
+		if (!measure(&decoder, data, size, 0, 0, scalar)) {
+			benchmarkReport(Common::String::format("%-12s could not be loaded", name));
+			Common::setCPUFeatureMask(Common::kCPUFeatureAll);
+			return;
+		}
+
+		Common::setCPUFeatureMask(Common::kCPUFeatureAll);
+		measure(&decoder, data, size, 0, 0, vector);
+
+		decoder.setDecodeThreads(kBinkThreads);
+		measure(&decoder, data, size, 0, 0, threads);
+
+		TS_ASSERT_EQUALS(vector.frames, scalar.frames);
+		TS_ASSERT_EQUALS(vector.hash, scalar.hash);
+		TS_ASSERT_EQUALS(threads.frames, scalar.frames);
+		TS_ASSERT_EQUALS(threads.hash, scalar.hash);
+
+		benchmarkReport(Common::String::format("%-12s %4u frames  scalar: %7.1f  vector: %7.1f  %d threads: %7.1f  (hash %08X)",
+			name, scalar.frames, scalar.fps, vector.fps, kBinkThreads, threads.fps, scalar.hash));
+	}
+
+	/** Writes a code, most significant bit first, like Common::BitStream32BEMSB reads it. */
+	static void putCode(Bits &bits, uint32 code, int length) {
+		for (int i = length - 1; i >= 0; --i)
+			bits.push_back((code >> i) & 1);
+	}
+
+	/**
+	 * Writes an SVQ1 plane. Key frames have flat blocks of random colors.
+	 * The other frames move all blocks by the given vector, and add a
+	 * small random value to them. Only the first block has to give the
+	 * vector, since the others predict it from their neighbours.
+	 */
+	static void putSVQ1Plane(Bits &bits, uint32 &seed, int width, int height, bool key, int mvX, int mvY) {
+		using namespace Image;
+
+		for (int y = 0; y < height; y += 16) {
+			for (int x = 0; x < width; x += 16) {
+				if (key) {
+					putCode(bits, 0, 1);	// not split
+					putCode(bits, s_svq1IntraMultistageCodes[5][1], s_svq1IntraMultistageLengths[5][1]);	// mean only
+					const int mean = nextRandom(seed, 256);
+					putCode(bits, s_svq1IntraMeanCodes[mean], s_svq1IntraMeanLengths[mean]);
+					continue;
+				}
+
+				putCode(bits, s_svq1BlockTypeCodes[1], s_svq1BlockTypeLengths[1]);	// inter
+
+				const int mv[2] = { mvX, mvY };
+				for (int i = 0; i < 2; i++) {
+					const int diff = (x == 0 && y == 0) ? ABS(mv[i]) : 0;
+					putCode(bits, s_svq1MotionComponentCodes[diff], s_svq1MotionComponentLengths[diff]);
+					if (diff)
+						putCode(bits, mv[i] < 0, 1);
+				}
+
+				putCode(bits, 0, 1);	// not split
+				putCode(bits, s_svq1InterMultistageCodes[5][1], s_svq1InterMultistageLengths[5][1]);	// mean only
+				const int mean = 256 + nextRandom(seed, 17) - 8;
+				putCode(bits, s_svq1InterMeanCodes[mean], s_svq1InterMeanLengths[mean]);
+			}
+		}
+	}
+
+	/**
+	 * SVQ1 frames: a key frame, followed by frames which move everything by
+	 * half a pixel to the left, up or both, or by a whole pixel. The vectors
+	 * point up and left, so the blocks never reach past the planes.
+	 */
+	static void createSVQ1(int width, int height, int frames, Common::Array<Common::Array<byte> > &data) {
+		static const int vectors[4][2] = { { -1, 0 }, { 0, -1 }, { -1, -1 }, { -2, -2 } };
+		const int yWidth = (width + 15) & ~15;
+		const int yHeight = (height + 15) & ~15;
+		const int uvWidth = (yWidth / 4 + 15) & ~15;
+		const int uvHeight = (yHeight / 4 + 15) & ~15;
+		uint32 seed = 1;
+
+		data.resize(frames);
+		for (int frame = 0; frame < frames; ++frame) {
+			const bool key = frame == 0;
+			const int *mv = vectors[frame % 4];
+
+			Bits bits;
+			putCode(bits, 0x20, 22);	// frame code
+			putCode(bits, frame & 0xFF, 8);	// temporal reference
+			putCode(bits, key ? 0 : 1, 2);	// I or P frame
+			if (key) {
+				putCode(bits, 0, 5);
+				putCode(bits, 7, 3);	// custom size
+				putCode(bits, width, 12);
+				putCode(bits, height, 12);
+			}
+			putCode(bits, 0, 1);	// no checksum
+			putCode(bits, 0, 1);	// no extra data
+
+			putSVQ1Plane(bits, seed, yWidth, yHeight, key, mv[0], mv[1]);
+			putSVQ1Plane(bits, seed, uvWidth, uvHeight, key, mv[0], mv[1]);
+			putSVQ1Plane(bits, seed, uvWidth, uvHeight, key, mv[0], mv[1]);
+
+			while (bits.size() & 31)
+				bits.push_back(0);
+
+			for (uint i = 0; i < bits.size(); i += 8) {
+				byte value = 0;
+				for (int j = 0; j < 8; j++)
+					value |= bits[i + j] << (7 - j);
+				data[frame].push_back(value);
+			}
+		}
+	}
+
+	static void measureSVQ1(const Common::Array<Common::Array<byte> > &data, int width, int height, Measurement &result) {
+		Image::SVQ1Decoder decoder(width, height);
+
+		result.frames = 0;
+		result.hash = 2166136261U;
+
+		const unsigned long long start = benchmarkMicros();
+		for (uint i = 0; i < data.size(); ++i) {
+			Common::MemoryReadStream stream(data[i].begin(), data[i].size());
+			const Graphics::Surface *frame = decoder.decodeFrame(stream);
+			if (frame)
+				result.hash = hashFrame(result.hash, frame);
+			result.frames++;
+		}
+		const unsigned long long elapsed = benchmarkMicros() - start;
+
+		result.fps = result.frames * 1000000.0 / MAX<unsigned long long>(elapsed, 1);
+	}
+
+	/**
+	 * Decodes SVQ1 frames with the plain C++ code and with the vector
+	 * paths, which must give the same frames.
+	 */
+	static void reportSVQ1(const char *name, int width, int height) {
+		Common::Array<Common::Array<byte> > data;
+		Measurement scalar, vector;
+
+		createSVQ1(width, height, kSVQ1Frames, data);
+
+		Common::setCPUFeatureMask(0);
+		measureSVQ1(data, width, height, scalar);
+		Common::setCPUFeatureMask(Common::kCPUFeatureAll);
+		measureSVQ1(data, width, height, vector);
+
+		TS_ASSERT_EQUALS(vector.hash, scalar.hash);
+
+		benchmarkReport(Common::String::format("%-12s %4u frames  scalar: %7.1f  vector: %7.1f  (hash %08X)",
+			name, scalar.frames, scalar.fps, vector.fps, scalar.hash));
+	}
+
+	/**
+	 * Decodes a video with the plain C++ code and with the vector paths,
+	 * which must give exactly the same frames.
+	 */
+	static void reportVector(const char *name, Video::VideoDecoder *decoder, const byte *data, uint32 size) {
+		Measurement scalar, vector;
+
+		Common::setCPUFeatureMask(0);
+		const bool loaded = measure(decoder, data, size, 0, 0, scalar);
+		Common::setCPUFeatureMask(Common::kCPUFeatureAll);
+
+		if (loaded && measure(decoder, data, size, 0, 0, vector)) {
+			TS_ASSERT_EQUALS(vector.frames, scalar.frames);
+			TS_ASSERT_EQUALS(vector.hash, scalar.hash);
+
+			benchmarkReport(Common::String::format("%-12s %4u frames  scalar: %7.1f  vector: %7.1f  (hash %08X)",
+				name, scalar.frames, scalar.fps, vector.fps, scalar.hash));
+		}
+
+		delete decoder;
+	}
+
+	/**
+	 * Creates the decoder for a sample video by its extension.
+	 */
+	static Video::VideoDecoder *createDecoder(const Common::String &path) {
+		Common::String name = path;
+		name.toLowercase();
+
+		if (name.hasSuffix(".avi"))
+			return new Video::AVIDecoder();
+#ifdef USE_BINK
+		if (name.hasSuffix(".bik"))
+			return new Video::BinkDecoder();
+#endif
+		if (name.hasSuffix(".dxa"))
+			return new Video::DXADecoder();
+		if (name.hasSuffix(".flc") || name.hasSuffix(".fli"))
+			return new Video::FlicDecoder();
+		if (name.hasSuffix(".mpg") || name.hasSuffix(".vob"))
+			return new Video::MPEGPSDecoder();
+		if (name.hasSuffix(".str"))
+			return new Video::PSXStreamDecoder(Video::PSXStreamDecoder::kCD2x);
+		if (name.hasSuffix(".mov"))
+			return new Video::QuickTimeDecoder();
+		if (name.hasSuffix(".smk"))
+			return new Video::SmackerDecoder();
+		if (name.hasSuffix(".vmd"))
+			return new Video::AdvancedVMDDecoder();
+#ifdef USE_THEORADEC
+		if (name.hasSuffix(".ogv"))
+			return new Video::TheoraDecoder();
+#endif
+		return 0;
+	}
+
+	static void reportFile(const Common::String &path) {
+#if defined(POSIX)
+		Video::VideoDecoder *decoder = createDecoder(path);
+		if (!decoder) {
+			benchmarkReport(Common::String::format("%s: unknown video type", path.c_str()));
+			return;
+		}
+
+		StdioStream *file = StdioStream::makeFromPath(path, false);
+		if (!file) {
+			benchmarkReport(Common::String::format("%s: could not be opened", path.c_str()));
+			delete decoder;
+			return;
+		}
+
+		// Read it all first, so the disk does not get measured
+		const uint32 size = file->size();
+		byte *data = new byte[size];
+		file->read(data, size);
+		delete file;
+
+		const char *name = strrchr(path.c_str(), '/');
+		name = name ? name + 1 : path.c_str();
+		report(name, decoder, data, size);
+		reportVector(name, createDecoder(path), data, size);
+		delete[] data;
+#endif
+	}
+
+public:
+	void setUp() {
+		_system = new VideoBenchmarkSystem();
+		g_system = _system;
+	}
+
+	void tearDown() {
+		g_system = 0;
+		delete _system;
+	}
+
+	void test_synthetic_videos() {
+		uint32 size;
+		byte *data;
+
+		benchmarkReport(Common::String("Frames/s of a 640x480 video, the engine spending 5 ms on each frame with +work"));
+
+		data = createFlic(size);
+		report("flic", new Video::FlicDecoder(), data, size);
+		free(data);
+
+		data = createAVI(size);
+		report("avi msrle", new Video::AVIDecoder(), data, size);
+		free(data);
+	}
+
+	void test_bink() {
+#ifdef USE_BINK
+		uint32 size;
+		byte *data;
+
+		benchmarkReport(Common::String("Frames/s of Bink videos of random blocks"));
+
+		data = createBink(kWidth, kHeight, kBinkFrames, size);
+		reportBink("bink", data, size);
+		free(data);
+
+		// The blocks reach over the edge of the planes
+		data = createBink(200, 120, kBinkFrames, size);
+		reportBink("bink 200x120", data, size);
+		free(data);
+#endif
+	}
+
+	void test_svq1() {
+#ifdef USE_RGB_COLOR
+		benchmarkReport(Common::String("Frames/s of SVQ1 frames moved by half pixels"));
+
+		reportSVQ1("svq1", kWidth, kHeight);
+		reportSVQ1("svq1 200x120", 200, 120);
+#else
+		// SVQ1 decodes into the screen format, which is CLUT8 without RGB color
+		benchmarkReport(Common::String("SVQ1 needs RGB color support"));
+#endif
+	}
+
+	/**
+	 * The other formats are too involved to be made up here, so sample
+	 * videos can be passed in, separated by spaces:
+	 *
+	 *   SCUMMVM_BENCH_VIDEOS="intro.smk logo.dxa" make benchmark
+	 *
+	 * Each one is also decoded with and without the vector paths of its
+	 * codecs, such as the SVQ1 ones in QuickTime videos.
+	 */
+	void test_sample_videos() {
+		const char *videos = getenv("SCUMMVM_BENCH_VIDEOS");
+		if (!videos || !*videos) {
+			benchmarkReport(Common::String("Set SCUMMVM_BENCH_VIDEOS to measure sample videos of the other decoders"));
+			return;
+		}
+
+		Common::String path;
+		for (const char *c = videos; ; ++c) {
+			if (*c == ' ' || *c == 0) {
+				if (!path.empty())
+					reportFile(path);
+				path.clear();
+				if (*c == 0)
+					break;
+			} else {
+				path += *c;
+			}
+		}
+	}
+};
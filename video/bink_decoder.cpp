@@ -27,6 +27,7 @@
 #include "audio/audiostream.h"
 #include "audio/decoders/raw.h"
 
+#include "common/config-manager.h"
 #include "common/util.h"
 #include "common/textconsole.h"
 #include "common/math.h"
@@ -39,12 +40,14 @@
 #include "common/rdft.h"
 #include "common/dct.h"
 #include "common/system.h"
+#include "common/thread.h"
 
 #include "graphics/yuv_to_rgb.h"
 #include "graphics/surface.h"
 
 #include "video/binkdata.h"
 #include "video/bink_decoder.h"
+#include "video/bink_dsp.h"
 
 static const uint32 kBIKfID = MKTAG('B', 'I', 'K', 'f');
 static const uint32 kBIKgID = MKTAG('B', 'I', 'K', 'g');
@@ -59,10 +62,15 @@ static const uint16 kAudioFlagStereo = 0x2000;
 // Number of bits used to store first DC value in bundle
 static const uint32 kDCStartBits = 11;
 
+// Rows of blocks put together by one job when using threads. Must be even,
+// since 16x16 blocks span two rows.
+static const uint32 kSliceRows = 8;
+
 namespace Video {
 
 BinkDecoder::BinkDecoder() {
 	_bink = 0;
+	_decodeThreads = ConfMan.getInt("video_threads");
 }
 
 BinkDecoder::~BinkDecoder() {
@@ -102,8 +110,10 @@ bool BinkDecoder::loadStream(Common::SeekableReadStream *stream) {
 	uint32 videoFlags = _bink->readUint32LE();
 
 	// BIKh and BIKi swap the chroma planes
-	addTrack(new BinkVideoTrack(width, height, getDefaultHighColorFormat(), frameCount,
-			Common::Rational(frameRateNum, frameRateDen), (id == kBIKhID || id == kBIKiID), videoFlags & kVideoFlagAlpha, id));
+	BinkVideoTrack *videoTrack = new BinkVideoTrack(width, height, getDefaultHighColorFormat(), frameCount,
+			Common::Rational(frameRateNum, frameRateDen), (id == kBIKhID || id == kBIKiID), videoFlags & kVideoFlagAlpha, id);
+	videoTrack->setDecodeThreads(_decodeThreads);
+	addTrack(videoTrack);
 
 	uint32 audioTrackCount = _bink->readUint32LE();
 
@@ -154,6 +164,10 @@ void BinkDecoder::close() {
 	_frames.clear();
 }
 
+void BinkDecoder::setDecodeThreads(int threads) {
+	_decodeThreads = threads;
+}
+
 void BinkDecoder::readNextPacket() {
 	BinkVideoTrack *videoTrack = (BinkVideoTrack *)getTrack(0);
 
@@ -243,7 +257,7 @@ BinkDecoder::AudioInfo::~AudioInfo() {
 }
 
 BinkDecoder::BinkVideoTrack::BinkVideoTrack(uint32 width, uint32 height, const Graphics::PixelFormat &format, uint32 frameCount, const Common::Rational &frameRate, bool swapPlanes, bool hasAlpha, uint32 id) :
-		_frameCount(frameCount), _frameRate(frameRate), _swapPlanes(swapPlanes), _hasAlpha(hasAlpha), _id(id) {
+		_frameCount(frameCount), _frameRate(frameRate), _swapPlanes(swapPlanes), _hasAlpha(hasAlpha), _id(id), _pool(0) {
 	_curFrame = -1;
 
 	for (int i = 0; i < 16; i++)
@@ -314,6 +328,8 @@ BinkDecoder::BinkVideoTrack::BinkVideoTrack(uint32 width, uint32 height, const G
 }
 
 BinkDecoder::BinkVideoTrack::~BinkVideoTrack() {
+	delete _pool;
+
 	for (int i = 0; i < 4; i++) {
 		delete[] _curPlanes[i]; _curPlanes[i] = 0;
 		delete[] _oldPlanes[i]; _oldPlanes[i] = 0;
@@ -329,9 +345,48 @@ BinkDecoder::BinkVideoTrack::~BinkVideoTrack() {
 	_surface.free();
 }
 
+void BinkDecoder::BinkVideoTrack::setDecodeThreads(int threads) {
+	delete _pool;
+	_pool = 0;
+
+	if (threads <= 0)
+		threads = Common::getProcessorCount();
+	if (threads <= 1)
+		return;
+
+	_pool = new Common::WorkerPool(threads);
+	if (_pool->getThreadCount() <= 1) {
+		delete _pool;
+		_pool = 0;
+		return;
+	}
+
+	initPlaneBlocks();
+}
+
+void BinkDecoder::BinkVideoTrack::initPlaneBlocks() {
+	for (int i = 0; i < 4; i++) {
+		const bool isChroma = (i == 1) || (i == 2);
+
+		uint32 blockWidth  = isChroma ? ((_surface.w  + 15) >> 4) : ((_surface.w  + 7) >> 3);
+		uint32 blockHeight = isChroma ? ((_surface.h + 15) >> 4) : ((_surface.h + 7) >> 3);
+		if ((i == 3) && !_hasAlpha)
+			blockWidth = blockHeight = 0;
+
+		_planeBlocks[i].blocks.resize(blockWidth * blockHeight);
+		_planeBlocks[i].rowStarts.resize(blockHeight + 1);
+		_planeBlocks[i].blockCount = 0;
+		_planeBlocks[i].rowCount   = 0;
+		_planeBlocks[i].pitch      = 0;
+	}
+}
+
 void BinkDecoder::BinkVideoTrack::decodePacket(VideoFrame &frame) {
 	assert(frame.bits);
 
+	for (int i = 0; i < 4; i++)
+		_planeBlocks[i].rowCount = 0;
+
 	if (_hasAlpha) {
 		if (_id == kBIKiID)
 			frame.bits->skip(32);
@@ -351,6 +406,28 @@ void BinkDecoder::BinkVideoTrack::decodePacket(VideoFrame &frame) {
 			break;
 	}
 
+	if (_pool) {
+		// Cut the planes into slices, which only write to their own rows.
+		// The last blocks of a row reach into the next row when the plane
+		// width is not a multiple of the block size, so these planes are
+		// put together in one piece.
+		_slices.resize(0);
+		for (int i = 0; i < 4; i++) {
+			const PlaneBlocks &planeBlocks = _planeBlocks[i];
+			const uint32 sliceRows = (planeBlocks.pitch & 15) ? planeBlocks.rowCount : kSliceRows;
+
+			for (uint32 row = 0; row < planeBlocks.rowCount; row += sliceRows) {
+				Slice slice;
+				slice.planeIdx = i;
+				slice.firstRow = row;
+				slice.endRow   = MIN(row + sliceRows, planeBlocks.rowCount);
+				_slices.push_back(slice);
+			}
+		}
+
+		_pool->run(putSliceProc, this, _slices.size());
+	}
+
 	// Convert the YUV data we have to our format
 	// We're ignoring alpha for now
 	// The width used here is the surface-width, and not the video-width
@@ -382,13 +459,15 @@ void BinkDecoder::BinkVideoTrack::decodePlane(VideoFrame &video, int planeIdx, b
 	ctx.prevEnd   = _oldPlanes[planeIdx] + width * height;
 	ctx.pitch     = width;
 
-	for (int i = 0; i < 64; i++) {
-		ctx.coordMap[i] = (i & 7) + (i >> 3) * ctx.pitch;
+	// With worker threads, the blocks are only read here. They are put into
+	// the planes after all planes have been read.
+	PlaneBlocks *planeBlocks = _pool ? &_planeBlocks[planeIdx] : 0;
+	Block block;
 
-		ctx.coordScaledMap1[i] = ((i & 7) * 2 + 0) + (((i >> 3) * 2 + 0) * ctx.pitch);
-		ctx.coordScaledMap2[i] = ((i & 7) * 2 + 1) + (((i >> 3) * 2 + 0) * ctx.pitch);
-		ctx.coordScaledMap3[i] = ((i & 7) * 2 + 0) + (((i >> 3) * 2 + 1) * ctx.pitch);
-		ctx.coordScaledMap4[i] = ((i & 7) * 2 + 1) + (((i >> 3) * 2 + 1) * ctx.pitch);
+	if (planeBlocks) {
+		planeBlocks->blockCount = 0;
+		planeBlocks->rowCount   = blockHeight;
+		planeBlocks->pitch      = ctx.pitch;
 	}
 
 	for (int i = 0; i < kSourceMAX; i++) {
@@ -411,6 +490,9 @@ void BinkDecoder::BinkVideoTrack::decodePlane(VideoFrame &video, int planeIdx, b
 		ctx.dest = ctx.destStart + 8 * ctx.blockY * ctx.pitch;
 		ctx.prev = ctx.prevStart + 8 * ctx.blockY * ctx.pitch;
 
+		if (planeBlocks)
+			planeBlocks->rowStarts[ctx.blockY] = planeBlocks->blockCount;
+
 		for (ctx.blockX = 0; ctx.blockX < blockWidth; ctx.blockX++, ctx.dest += 8, ctx.prev += 8) {
 			BlockType blockType = (BlockType) getBundleValue(kSourceBlockTypes);
 
@@ -422,45 +504,59 @@ void BinkDecoder::BinkVideoTrack::decodePlane(VideoFrame &video, int planeIdx, b
 				continue;
 			}
 
+			Block &curBlock = planeBlocks ? planeBlocks->blocks[planeBlocks->blockCount++] : block;
+			curBlock.offset = ctx.dest - ctx.destStart;
+
 			switch (blockType) {
 			case kBlockSkip:
-				blockSkip(ctx);
+				blockSkip(ctx, curBlock);
 				break;
 			case kBlockScaled:
-				blockScaled(ctx);
+				blockScaled(ctx, curBlock);
 				break;
 			case kBlockMotion:
-				blockMotion(ctx);
+				blockMotion(ctx, curBlock);
 				break;
 			case kBlockRun:
-				blockRun(ctx);
+				blockRun(ctx, curBlock);
 				break;
 			case kBlockResidue:
-				blockResidue(ctx);
+				blockResidue(ctx, curBlock);
 				break;
 			case kBlockIntra:
-				blockIntra(ctx);
+				blockIntra(ctx, curBlock);
 				break;
 			case kBlockFill:
-				blockFill(ctx);
+				blockFill(ctx, curBlock);
 				break;
 			case kBlockInter:
-				blockInter(ctx);
+				blockInter(ctx, curBlock);
 				break;
 			case kBlockPattern:
-				blockPattern(ctx);
+				blockPattern(ctx, curBlock);
 				break;
 			case kBlockRaw:
-				blockRaw(ctx);
+				blockRaw(ctx, curBlock);
 				break;
 			default:
 				error("Unknown block type: %d", blockType);
 			}
 
+			if (!planeBlocks)
+				putBlock(curBlock, ctx.destStart, ctx.prevStart, ctx.pitch);
+
+			if (blockType == kBlockScaled) {
+				ctx.blockX += 1;
+				ctx.dest   += 8;
+				ctx.prev   += 8;
+			}
 		}
 
 	}
 
+	if (planeBlocks)
+		planeBlocks->rowStarts[blockHeight] = planeBlocks->blockCount;
+
 	if (video.bits->pos() & 0x1F) // next plane data starts at 32-bit boundary
 		video.bits->skip(32 - (video.bits->pos() & 0x1F));
 
@@ -623,160 +719,82 @@ uint32 BinkDecoder::BinkVideoTrack::readBundleCount(VideoFrame &video, Bundle &b
 	return n;
 }
 
-void BinkDecoder::BinkVideoTrack::blockSkip(DecodeContext &ctx) {
-	byte *dest = ctx.dest;
-	byte *prev = ctx.prev;
-
-	for (int j = 0; j < 8; j++, dest += ctx.pitch, prev += ctx.pitch)
-		memcpy(dest, prev, 8);
+void BinkDecoder::BinkVideoTrack::blockSkip(DecodeContext &ctx, Block &block) {
+	block.op = kOpCopy;
 }
 
-void BinkDecoder::BinkVideoTrack::blockScaledSkip(DecodeContext &ctx) {
-	byte *dest = ctx.dest;
-	byte *prev = ctx.prev;
-
-	for (int j = 0; j < 16; j++, dest += ctx.pitch, prev += ctx.pitch)
-		memcpy(dest, prev, 16);
+void BinkDecoder::BinkVideoTrack::blockScaledSkip(DecodeContext &ctx, Block &block) {
+	block.op = kOpScaledCopy;
 }
 
-void BinkDecoder::BinkVideoTrack::blockScaledRun(DecodeContext &ctx) {
-	const uint8 *scan = binkPatterns[ctx.video->bits->getBits(4)];
-
-	int i = 0;
-	do {
-		int run = getBundleValue(kSourceRun) + 1;
-
-		i += run;
-		if (i > 64)
-			error("Run went out of bounds");
-
-		if (ctx.video->bits->getBit()) {
+void BinkDecoder::BinkVideoTrack::blockScaledRun(DecodeContext &ctx, Block &block) {
+	blockRun(ctx, block);
 
-			byte v = getBundleValue(kSourceColors);
-			for (int j = 0; j < run; j++, scan++)
-				ctx.dest[ctx.coordScaledMap1[*scan]] =
-				ctx.dest[ctx.coordScaledMap2[*scan]] =
-				ctx.dest[ctx.coordScaledMap3[*scan]] =
-				ctx.dest[ctx.coordScaledMap4[*scan]] = v;
-
-		} else
-			for (int j = 0; j < run; j++, scan++)
-				ctx.dest[ctx.coordScaledMap1[*scan]] =
-				ctx.dest[ctx.coordScaledMap2[*scan]] =
-				ctx.dest[ctx.coordScaledMap3[*scan]] =
-				ctx.dest[ctx.coordScaledMap4[*scan]] = getBundleValue(kSourceColors);
-
-	} while (i < 63);
-
-	if (i == 63)
-		ctx.dest[ctx.coordScaledMap1[*scan]] =
-		ctx.dest[ctx.coordScaledMap2[*scan]] =
-		ctx.dest[ctx.coordScaledMap3[*scan]] =
-		ctx.dest[ctx.coordScaledMap4[*scan]] = getBundleValue(kSourceColors);
+	block.op = kOpScaledPixels;
 }
 
-void BinkDecoder::BinkVideoTrack::blockScaledIntra(DecodeContext &ctx) {
-	int16 block[64];
-	memset(block, 0, 64 * sizeof(int16));
+void BinkDecoder::BinkVideoTrack::blockScaledIntra(DecodeContext &ctx, Block &block) {
+	blockIntra(ctx, block);
 
-	block[0] = getBundleValue(kSourceIntraDC);
-
-	readDCTCoeffs(*ctx.video, block, true);
-
-	IDCT(block);
-
-	int16 *src   = block;
-	byte  *dest1 = ctx.dest;
-	byte  *dest2 = ctx.dest + ctx.pitch;
-	for (int j = 0; j < 8; j++, dest1 += (ctx.pitch << 1) - 16, dest2 += (ctx.pitch << 1) - 16, src += 8) {
-
-		for (int i = 0; i < 8; i++, dest1 += 2, dest2 += 2)
-			dest1[0] = dest1[1] = dest2[0] = dest2[1] = src[i];
-
-	}
+	block.op = kOpScaledIntra;
 }
 
-void BinkDecoder::BinkVideoTrack::blockScaledFill(DecodeContext &ctx) {
-	byte v = getBundleValue(kSourceColors);
+void BinkDecoder::BinkVideoTrack::blockScaledFill(DecodeContext &ctx, Block &block) {
+	blockFill(ctx, block);
 
-	byte *dest = ctx.dest;
-	for (int i = 0; i < 16; i++, dest += ctx.pitch)
-		memset(dest, v, 16);
+	block.op = kOpScaledFill;
 }
 
-void BinkDecoder::BinkVideoTrack::blockScaledPattern(DecodeContext &ctx) {
-	byte col[2];
-
-	for (int i = 0; i < 2; i++)
-		col[i] = getBundleValue(kSourceColors);
-
-	byte *dest1 = ctx.dest;
-	byte *dest2 = ctx.dest + ctx.pitch;
-	for (int j = 0; j < 8; j++, dest1 += (ctx.pitch << 1) - 16, dest2 += (ctx.pitch << 1) - 16) {
-		byte v = getBundleValue(kSourcePattern);
+void BinkDecoder::BinkVideoTrack::blockScaledPattern(DecodeContext &ctx, Block &block) {
+	blockPattern(ctx, block);
 
-		for (int i = 0; i < 8; i++, dest1 += 2, dest2 += 2, v >>= 1)
-			dest1[0] = dest1[1] = dest2[0] = dest2[1] = col[v & 1];
-	}
+	block.op = kOpScaledPattern;
 }
 
-void BinkDecoder::BinkVideoTrack::blockScaledRaw(DecodeContext &ctx) {
-	byte row[8];
-
-	byte *dest1 = ctx.dest;
-	byte *dest2 = ctx.dest + ctx.pitch;
-	for (int j = 0; j < 8; j++, dest1 += (ctx.pitch << 1) - 16, dest2 += (ctx.pitch << 1) - 16) {
-		memcpy(row, _bundles[kSourceColors].curPtr, 8);
+void BinkDecoder::BinkVideoTrack::blockScaledRaw(DecodeContext &ctx, Block &block) {
+	blockRaw(ctx, block);
 
-		for (int i = 0; i < 8; i++, dest1 += 2, dest2 += 2)
-			dest1[0] = dest1[1] = dest2[0] = dest2[1] = row[i];
-
-		_bundles[kSourceColors].curPtr += 8;
-	}
+	block.op = kOpScaledPixels;
 }
 
-void BinkDecoder::BinkVideoTrack::blockScaled(DecodeContext &ctx) {
+void BinkDecoder::BinkVideoTrack::blockScaled(DecodeContext &ctx, Block &block) {
 	BlockType blockType = (BlockType) getBundleValue(kSourceSubBlockTypes);
 
 	switch (blockType) {
 	case kBlockRun:
-		blockScaledRun(ctx);
+		blockScaledRun(ctx, block);
 		break;
 	case kBlockIntra:
-		blockScaledIntra(ctx);
+		blockScaledIntra(ctx, block);
 		break;
 	case kBlockFill:
-		blockScaledFill(ctx);
+		blockScaledFill(ctx, block);
 		break;
 	case kBlockPattern:
-		blockScaledPattern(ctx);
+		blockScaledPattern(ctx, block);
 		break;
 	case kBlockRaw:
-		blockScaledRaw(ctx);
+		blockScaledRaw(ctx, block);
 		break;
 	default:
 		error("Invalid 16x16 block type: %d", blockType);
 	}
-
-	ctx.blockX += 1;
-	ctx.dest   += 8;
-	ctx.prev   += 8;
 }
 
-void BinkDecoder::BinkVideoTrack::blockMotion(DecodeContext &ctx) {
+void BinkDecoder::BinkVideoTrack::blockMotion(DecodeContext &ctx, Block &block) {
 	int8 xOff = getBundleValue(kSourceXOff);
 	int8 yOff = getBundleValue(kSourceYOff);
 
-	byte *dest = ctx.dest;
 	byte *prev = ctx.prev + yOff * ((int32) ctx.pitch) + xOff;
 	if ((prev < ctx.prevStart) || (prev > ctx.prevEnd))
 		error("Copy out of bounds (%d | %d)", ctx.blockX * 8 + xOff, ctx.blockY * 8 + yOff);
 
-	for (int j = 0; j < 8; j++, dest += ctx.pitch, prev += ctx.pitch)
-		memcpy(dest, prev, 8);
+	block.op   = kOpMotion;
+	block.xOff = xOff;
+	block.yOff = yOff;
 }
 
-void BinkDecoder::BinkVideoTrack::blockRun(DecodeContext &ctx) {
+void BinkDecoder::BinkVideoTrack::blockRun(DecodeContext &ctx, Block &block) {
 	const uint8 *scan = binkPatterns[ctx.video->bits->getBits(4)];
 
 	int i = 0;
@@ -791,89 +809,162 @@ void BinkDecoder::BinkVideoTrack::blockRun(DecodeContext &ctx) {
 
 			byte v = getBundleValue(kSourceColors);
 			for (int j = 0; j < run; j++)
-				ctx.dest[ctx.coordMap[*scan++]] = v;
+				block.pixels[*scan++] = v;
 
 		} else
 			for (int j = 0; j < run; j++)
-				ctx.dest[ctx.coordMap[*scan++]] = getBundleValue(kSourceColors);
+				block.pixels[*scan++] = getBundleValue(kSourceColors);
 
 	} while (i < 63);
 
 	if (i == 63)
-		ctx.dest[ctx.coordMap[*scan++]] = getBundleValue(kSourceColors);
+		block.pixels[*scan++] = getBundleValue(kSourceColors);
+
+	block.op = kOpPixels;
 }
 
-void BinkDecoder::BinkVideoTrack::blockResidue(DecodeContext &ctx) {
-	blockMotion(ctx);
+void BinkDecoder::BinkVideoTrack::blockResidue(DecodeContext &ctx, Block &block) {
+	blockMotion(ctx, block);
 
 	byte v = ctx.video->bits->getBits(7);
 
-	int16 block[64];
-	memset(block, 0, 64 * sizeof(int16));
+	memset(block.coeffs, 0, 64 * sizeof(int16));
 
-	readResidue(*ctx.video, block, v);
+	readResidue(*ctx.video, block.coeffs, v);
 
-	byte  *dst = ctx.dest;
-	int16 *src = block;
-	for (int i = 0; i < 8; i++, dst += ctx.pitch, src += 8)
-		for (int j = 0; j < 8; j++)
-			dst[j] += src[j];
+	block.op = kOpResidue;
 }
 
-void BinkDecoder::BinkVideoTrack::blockIntra(DecodeContext &ctx) {
-	int16 block[64];
-	memset(block, 0, 64 * sizeof(int16));
+void BinkDecoder::BinkVideoTrack::blockIntra(DecodeContext &ctx, Block &block) {
+	memset(block.coeffs, 0, 64 * sizeof(int16));
 
-	block[0] = getBundleValue(kSourceIntraDC);
+	block.coeffs[0] = getBundleValue(kSourceIntraDC);
 
-	readDCTCoeffs(*ctx.video, block, true);
+	readDCTCoeffs(*ctx.video, block.coeffs, true);
 
-	IDCTPut(ctx, block);
+	block.op = kOpIntra;
 }
 
-void BinkDecoder::BinkVideoTrack::blockFill(DecodeContext &ctx) {
-	byte v = getBundleValue(kSourceColors);
+void BinkDecoder::BinkVideoTrack::blockFill(DecodeContext &ctx, Block &block) {
+	block.colors[0] = getBundleValue(kSourceColors);
 
-	byte *dest = ctx.dest;
-	for (int i = 0; i < 8; i++, dest += ctx.pitch)
-		memset(dest, v, 8);
+	block.op = kOpFill;
 }
 
-void BinkDecoder::BinkVideoTrack::blockInter(DecodeContext &ctx) {
-	blockMotion(ctx);
+void BinkDecoder::BinkVideoTrack::blockInter(DecodeContext &ctx, Block &block) {
+	blockMotion(ctx, block);
 
-	int16 block[64];
-	memset(block, 0, 64 * sizeof(int16));
+	memset(block.coeffs, 0, 64 * sizeof(int16));
 
-	block[0] = getBundleValue(kSourceInterDC);
+	block.coeffs[0] = getBundleValue(kSourceInterDC);
 
-	readDCTCoeffs(*ctx.video, block, false);
+	readDCTCoeffs(*ctx.video, block.coeffs, false);
 
-	IDCTAdd(ctx, block);
+	block.op = kOpInter;
 }
 
-void BinkDecoder::BinkVideoTrack::blockPattern(DecodeContext &ctx) {
-	byte col[2];
-
+void BinkDecoder::BinkVideoTrack::blockPattern(DecodeContext &ctx, Block &block) {
 	for (int i = 0; i < 2; i++)
-		col[i] = getBundleValue(kSourceColors);
+		block.colors[i] = getBundleValue(kSourceColors);
 
-	byte *dest = ctx.dest;
-	for (int i = 0; i < 8; i++, dest += ctx.pitch - 8) {
-		byte v = getBundleValue(kSourcePattern);
+	for (int i = 0; i < 8; i++)
+		block.pattern[i] = getBundleValue(kSourcePattern);
 
-		for (int j = 0; j < 8; j++, v >>= 1)
-			*dest++ = col[v & 1];
-	}
+	block.op = kOpPattern;
 }
 
-void BinkDecoder::BinkVideoTrack::blockRaw(DecodeContext &ctx) {
-	byte *dest = ctx.dest;
-	byte *data = _bundles[kSourceColors].curPtr;
-	for (int i = 0; i < 8; i++, dest += ctx.pitch, data += 8)
-		memcpy(dest, data, 8);
+void BinkDecoder::BinkVideoTrack::blockRaw(DecodeContext &ctx, Block &block) {
+	memcpy(block.pixels, _bundles[kSourceColors].curPtr, 64);
 
 	_bundles[kSourceColors].curPtr += 64;
+
+	block.op = kOpPixels;
+}
+
+void BinkDecoder::BinkVideoTrack::putBlock(const Block &block, byte *plane, const byte *prevPlane, uint32 pitch) {
+	byte *dest = plane + block.offset;
+	const byte *prev = prevPlane + block.offset;
+	byte pixels[64];
+
+	switch (block.op) {
+	case kOpCopy:
+		for (int j = 0; j < 8; j++, dest += pitch, prev += pitch)
+			memcpy(dest, prev, 8);
+		break;
+
+	case kOpScaledCopy:
+		for (int j = 0; j < 16; j++, dest += pitch, prev += pitch)
+			memcpy(dest, prev, 16);
+		break;
+
+	case kOpMotion:
+	case kOpResidue:
+	case kOpInter:
+		prev += block.yOff * ((int32) pitch) + block.xOff;
+		for (int j = 0; j < 8; j++, prev += pitch)
+			memcpy(dest + j * pitch, prev, 8);
+
+		if (block.op == kOpResidue)
+			binkAddResidue(dest, pitch, block.coeffs);
+		else if (block.op == kOpInter)
+			binkIDCTAdd(dest, pitch, block.coeffs);
+		break;
+
+	case kOpIntra:
+		binkIDCTPut(dest, pitch, block.coeffs);
+		break;
+
+	case kOpScaledIntra:
+		binkIDCTPut(pixels, 8, block.coeffs);
+		binkPutScaled(dest, pitch, pixels);
+		break;
+
+	case kOpFill:
+		for (int i = 0; i < 8; i++, dest += pitch)
+			memset(dest, block.colors[0], 8);
+		break;
+
+	case kOpScaledFill:
+		for (int i = 0; i < 16; i++, dest += pitch)
+			memset(dest, block.colors[0], 16);
+		break;
+
+	case kOpPattern:
+		binkPutPattern(dest, pitch, block.colors, block.pattern);
+		break;
+
+	case kOpScaledPattern:
+		binkPutPattern(pixels, 8, block.colors, block.pattern);
+		binkPutScaled(dest, pitch, pixels);
+		break;
+
+	case kOpPixels:
+		for (int i = 0; i < 8; i++, dest += pitch)
+			memcpy(dest, block.pixels + i * 8, 8);
+		break;
+
+	case kOpScaledPixels:
+		binkPutScaled(dest, pitch, block.pixels);
+		break;
+
+	default:
+		break;
+	}
+}
+
+void BinkDecoder::BinkVideoTrack::putSlice(const Slice &slice) {
+	const PlaneBlocks &planeBlocks = _planeBlocks[slice.planeIdx];
+	byte *plane = _curPlanes[slice.planeIdx];
+	const byte *prevPlane = _oldPlanes[slice.planeIdx];
+
+	const uint32 end = planeBlocks.rowStarts[slice.endRow];
+	for (uint32 i = planeBlocks.rowStarts[slice.firstRow]; i < end; i++)
+		putBlock(planeBlocks.blocks[i], plane, prevPlane, planeBlocks.pitch);
+}
+
+void BinkDecoder::BinkVideoTrack::putSliceProc(void *param, int index) {
+	BinkVideoTrack *track = (BinkVideoTrack *)param;
+	track->putSlice(track->_slices[index]);
 }
 
 void BinkDecoder::BinkVideoTrack::readRuns(VideoFrame &video, Bundle &bundle) {
@@ -1267,88 +1358,6 @@ void BinkDecoder::BinkVideoTrack::readResidue(VideoFrame &video, int16 *block, i
 	}
 }
 
-#define A1  2896 /* (1/sqrt(2))<<12 */
-#define A2  2217
-#define A3  3784
-#define A4 -5352
-
-#define IDCT_TRANSFORM(dest,s0,s1,s2,s3,s4,s5,s6,s7,d0,d1,d2,d3,d4,d5,d6,d7,munge,src) {\
-    const int a0 = (src)[s0] + (src)[s4]; \
-    const int a1 = (src)[s0] - (src)[s4]; \
-    const int a2 = (src)[s2] + (src)[s6]; \
-    const int a3 = (A1*((src)[s2] - (src)[s6])) >> 11; \
-    const int a4 = (src)[s5] + (src)[s3]; \
-    const int a5 = (src)[s5] - (src)[s3]; \
-    const int a6 = (src)[s1] + (src)[s7]; \
-    const int a7 = (src)[s1] - (src)[s7]; \
-    const int b0 = a4 + a6; \
-    const int b1 = (A3*(a5 + a7)) >> 11; \
-    const int b2 = ((A4*a5) >> 11) - b0 + b1; \
-    const int b3 = (A1*(a6 - a4) >> 11) - b2; \
-    const int b4 = ((A2*a7) >> 11) + b3 - b1; \
-    (dest)[d0] = munge(a0+a2   +b0); \
-    (dest)[d1] = munge(a1+a3-a2+b2); \
-    (dest)[d2] = munge(a1-a3+a2+b3); \
-    (dest)[d3] = munge(a0-a2   -b4); \
-    (dest)[d4] = munge(a0-a2   +b4); \
-    (dest)[d5] = munge(a1-a3+a2-b3); \
-    (dest)[d6] = munge(a1+a3-a2-b2); \
-    (dest)[d7] = munge(a0+a2   -b0); \
-}
-/* end IDCT_TRANSFORM macro */
-
-#define MUNGE_NONE(x) (x)
-#define IDCT_COL(dest,src) IDCT_TRANSFORM(dest,0,8,16,24,32,40,48,56,0,8,16,24,32,40,48,56,MUNGE_NONE,src)
-
-#define MUNGE_ROW(x) (((x) + 0x7F)>>8)
-#define IDCT_ROW(dest,src) IDCT_TRANSFORM(dest,0,1,2,3,4,5,6,7,0,1,2,3,4,5,6,7,MUNGE_ROW,src)
-
-static inline void IDCTCol(int16 *dest, const int16 *src) {
-	if ((src[8] | src[16] | src[24] | src[32] | src[40] | src[48] | src[56]) == 0) {
-		dest[ 0] =
-		dest[ 8] =
-		dest[16] =
-		dest[24] =
-		dest[32] =
-		dest[40] =
-		dest[48] =
-		dest[56] = src[0];
-	} else {
-		IDCT_COL(dest, src);
-	}
-}
-
-void BinkDecoder::BinkVideoTrack::IDCT(int16 *block) {
-	int i;
-	int16 temp[64];
-
-	for (i = 0; i < 8; i++)
-		IDCTCol(&temp[i], &block[i]);
-	for (i = 0; i < 8; i++) {
-		IDCT_ROW( (&block[8*i]), (&temp[8*i]) );
-	}
-}
-
-void BinkDecoder::BinkVideoTrack::IDCTAdd(DecodeContext &ctx, int16 *block) {
-	int i, j;
-
-	IDCT(block);
-	byte *dest = ctx.dest;
-	for (i = 0; i < 8; i++, dest += ctx.pitch, block += 8)
-		for (j = 0; j < 8; j++)
-			 dest[j] += block[j];
-}
-
-void BinkDecoder::BinkVideoTrack::IDCTPut(DecodeContext &ctx, int16 *block) {
-	int i;
-	int16 temp[64];
-	for (i = 0; i < 8; i++)
-		IDCTCol(&temp[i], &block[i]);
-	for (i = 0; i < 8; i++) {
-		IDCT_ROW( (&ctx.dest[i*ctx.pitch]), (&temp[8*i]) );
-	}
-}
-
 BinkDecoder::BinkAudioTrack::BinkAudioTrack(BinkDecoder::AudioInfo &audio) : _audioInfo(&audio) {
 	_audioStream = Audio::makeQueuingAudioStream(_audioInfo->outSampleRate, _audioInfo->outChannels == 2);
 }
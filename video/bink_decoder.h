@@ -45,6 +45,7 @@ class QueuingAudioStream;
 
 namespace Common {
 class SeekableReadStream;
+class WorkerPool;
 class BitStream;
 class Huffman;
 
@@ -72,6 +73,15 @@ public:
 	bool loadStream(Common::SeekableReadStream *stream);
 	void close();
 
+	/**
+	 * Set the number of threads the blocks of the video planes are put
+	 * together on. The bitstream is still read on the decoding thread.
+	 * 0 uses one thread per processor, 1 does everything on the decoding
+	 * thread. The default is the video_threads setting. The output is the
+	 * same in all cases. This takes effect when the next video is loaded.
+	 */
+	void setDecodeThreads(int threads);
+
 protected:
 	void readNextPacket();
 	bool supportsAudioTrackSwitching() const { return true; }
@@ -154,6 +164,9 @@ private:
 		/** Decode a video packet. */
 		void decodePacket(VideoFrame &frame);
 
+		/** Set the number of threads the blocks are put together on. */
+		void setDecodeThreads(int threads);
+
 	protected:
 		Common::Rational getFrameRate() const { return _frameRate; }
 
@@ -174,12 +187,6 @@ private:
 			byte *prevStart, *prevEnd;
 
 			uint32 pitch;
-
-			int coordMap[64];
-			int coordScaledMap1[64];
-			int coordScaledMap2[64];
-			int coordScaledMap3[64];
-			int coordScaledMap4[64];
 		};
 
 		/** IDs for different data types used in Bink video codec. */
@@ -211,6 +218,57 @@ private:
 			kBlockRaw           ///< Uncoded 8x8 block.
 		};
 
+		/** How a block is put into the plane. */
+		enum BlockOp {
+			kOpCopy,          ///< Copy the block from the previous frame.
+			kOpScaledCopy,    ///< Copy the 16x16 block from the previous frame.
+			kOpMotion,        ///< Copy the block from the previous frame with an offset.
+			kOpResidue,       ///< Motion copy, then add the residue.
+			kOpInter,         ///< Motion copy, then add the IDCT of the coefficients.
+			kOpIntra,         ///< Put the IDCT of the coefficients.
+			kOpScaledIntra,   ///< Put the IDCT of the coefficients scaled to 16x16.
+			kOpFill,          ///< Fill the block with colors[0].
+			kOpScaledFill,    ///< Fill the 16x16 block with colors[0].
+			kOpPattern,       ///< Fill the block with two colors.
+			kOpScaledPattern, ///< Fill the 16x16 block with two colors.
+			kOpPixels,        ///< Put the pixels.
+			kOpScaledPixels   ///< Put the pixels scaled to 16x16.
+		};
+
+		/** A block read from the bitstream, ready to be put into the plane. */
+		struct Block {
+			uint32 offset; ///< Offset of the top left pixel in the plane.
+
+			byte op;         ///< The BlockOp.
+			int8 xOff, yOff; ///< Motion vector.
+
+			byte colors[2];  ///< Colors of fill and pattern blocks.
+			byte pattern[8]; ///< Pattern rows, one bit per pixel.
+
+			union {
+				byte  pixels[64]; ///< Pixels of run and raw blocks.
+				int16 coeffs[64]; ///< DCT coefficients or residue.
+			};
+		};
+
+		/** The blocks read for a plane, which the worker threads put into it. */
+		struct PlaneBlocks {
+			Common::Array<Block> blocks;
+			/** Index of the first block of each row of blocks, plus the end. */
+			Common::Array<uint32> rowStarts;
+
+			uint32 blockCount; ///< Blocks read in this frame.
+			uint32 rowCount;   ///< Rows of blocks read in this frame.
+			uint32 pitch;
+		};
+
+		/** Some rows of blocks of a plane, put together by one job. */
+		struct Slice {
+			int planeIdx;
+			uint32 firstRow;
+			uint32 endRow;
+		};
+
 		/** Data structure for decoding and tranlating Huffman'd data. */
 		struct Huffman {
 			int  index;       ///< Index of the Huffman codebook to use.
@@ -257,6 +315,10 @@ private:
 		byte *_curPlanes[4]; ///< The 4 color planes, YUVA, current frame.
 		byte *_oldPlanes[4]; ///< The 4 color planes, YUVA, last frame.
 
+		Common::WorkerPool *_pool;      ///< Threads putting the blocks together, if any.
+		PlaneBlocks _planeBlocks[4];    ///< Blocks read for each plane, with threads.
+		Common::Array<Slice> _slices;   ///< Jobs of the current frame, with threads.
+
 		/** Initialize the bundles. */
 		void initBundles();
 		/** Deinitialize the bundles. */
@@ -284,23 +346,32 @@ private:
 		/** Read a count value out of a bundle. */
 		uint32 readBundleCount(VideoFrame &video, Bundle &bundle);
 
-		// Handle the block types
-		void blockSkip         (DecodeContext &ctx);
-		void blockScaledSkip   (DecodeContext &ctx);
-		void blockScaledRun    (DecodeContext &ctx);
-		void blockScaledIntra  (DecodeContext &ctx);
-		void blockScaledFill   (DecodeContext &ctx);
-		void blockScaledPattern(DecodeContext &ctx);
-		void blockScaledRaw    (DecodeContext &ctx);
-		void blockScaled       (DecodeContext &ctx);
-		void blockMotion       (DecodeContext &ctx);
-		void blockRun          (DecodeContext &ctx);
-		void blockResidue      (DecodeContext &ctx);
-		void blockIntra        (DecodeContext &ctx);
-		void blockFill         (DecodeContext &ctx);
-		void blockInter        (DecodeContext &ctx);
-		void blockPattern      (DecodeContext &ctx);
-		void blockRaw          (DecodeContext &ctx);
+		// Read the block types
+		void blockSkip         (DecodeContext &ctx, Block &block);
+		void blockScaledSkip   (DecodeContext &ctx, Block &block);
+		void blockScaledRun    (DecodeContext &ctx, Block &block);
+		void blockScaledIntra  (DecodeContext &ctx, Block &block);
+		void blockScaledFill   (DecodeContext &ctx, Block &block);
+		void blockScaledPattern(DecodeContext &ctx, Block &block);
+		void blockScaledRaw    (DecodeContext &ctx, Block &block);
+		void blockScaled       (DecodeContext &ctx, Block &block);
+		void blockMotion       (DecodeContext &ctx, Block &block);
+		void blockRun          (DecodeContext &ctx, Block &block);
+		void blockResidue      (DecodeContext &ctx, Block &block);
+		void blockIntra        (DecodeContext &ctx, Block &block);
+		void blockFill         (DecodeContext &ctx, Block &block);
+		void blockInter        (DecodeContext &ctx, Block &block);
+		void blockPattern      (DecodeContext &ctx, Block &block);
+		void blockRaw          (DecodeContext &ctx, Block &block);
+
+		/** Put a block into the plane. */
+		static void putBlock(const Block &block, byte *plane, const byte *prevPlane, uint32 pitch);
+		/** Put the blocks of a slice into its plane. */
+		void putSlice(const Slice &slice);
+		static void putSliceProc(void *param, int index);
+
+		/** Allocate the block queues for the worker threads. */
+		void initPlaneBlocks();
 
 		// Read the bundles
 		void readRuns        (VideoFrame &video, Bundle &bundle);
@@ -311,11 +382,6 @@ private:
 		void readDCS         (VideoFrame &video, Bundle &bundle, int startBits, bool hasSign);
 		void readDCTCoeffs   (VideoFrame &video, int16 *block, bool isIntra);
 		void readResidue     (VideoFrame &video, int16 *block, int masksCount);
-
-		// Bink video IDCT
-		void IDCT(int16 *block);
-		void IDCTPut(DecodeContext &ctx, int16 *block);
-		void IDCTAdd(DecodeContext &ctx, int16 *block);
 	};
 
 	class BinkAudioTrack : public AudioTrack {
@@ -349,6 +415,8 @@ private:
 
 	Common::SeekableReadStream *_bink;
 
+	int _decodeThreads;
+
 	Common::Array<AudioInfo> _audioTracks; ///< All audio tracks.
 	Common::Array<VideoFrame> _frames;      ///< All video frames.
 
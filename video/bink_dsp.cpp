@@ -0,0 +1,539 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+// The IDCT is based on the one of the Bink decoder found in FFmpeg.
+
+#include "video/bink_dsp.h"
+
+#include "common/cpudetect.h"
+
+#if defined(SCUMMVM_SSE2)
+#include <emmintrin.h>
+#endif
+
+#if defined(SCUMMVM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace Video {
+
+#define A1  2896 /* (1/sqrt(2))<<12 */
+#define A2  2217
+#define A3  3784
+#define A4 -5352
+
+#define IDCT_TRANSFORM(dest,s0,s1,s2,s3,s4,s5,s6,s7,d0,d1,d2,d3,d4,d5,d6,d7,munge,src) {\
+    const int a0 = (src)[s0] + (src)[s4]; \
+    const int a1 = (src)[s0] - (src)[s4]; \
+    const int a2 = (src)[s2] + (src)[s6]; \
+    const int a3 = (A1*((src)[s2] - (src)[s6])) >> 11; \
+    const int a4 = (src)[s5] + (src)[s3]; \
+    const int a5 = (src)[s5] - (src)[s3]; \
+    const int a6 = (src)[s1] + (src)[s7]; \
+    const int a7 = (src)[s1] - (src)[s7]; \
+    const int b0 = a4 + a6; \
+    const int b1 = (A3*(a5 + a7)) >> 11; \
+    const int b2 = ((A4*a5) >> 11) - b0 + b1; \
+    const int b3 = (A1*(a6 - a4) >> 11) - b2; \
+    const int b4 = ((A2*a7) >> 11) + b3 - b1; \
+    (dest)[d0] = munge(a0+a2   +b0); \
+    (dest)[d1] = munge(a1+a3-a2+b2); \
+    (dest)[d2] = munge(a1-a3+a2+b3); \
+    (dest)[d3] = munge(a0-a2   -b4); \
+    (dest)[d4] = munge(a0-a2   +b4); \
+    (dest)[d5] = munge(a1-a3+a2-b3); \
+    (dest)[d6] = munge(a1+a3-a2-b2); \
+    (dest)[d7] = munge(a0+a2   -b0); \
+}
+/* end IDCT_TRANSFORM macro */
+
+#define MUNGE_NONE(x) (x)
+#define IDCT_COL(dest,src) IDCT_TRANSFORM(dest,0,8,16,24,32,40,48,56,0,8,16,24,32,40,48,56,MUNGE_NONE,src)
+
+#define MUNGE_ROW(x) (((x) + 0x7F)>>8)
+#define IDCT_ROW(dest,src) IDCT_TRANSFORM(dest,0,1,2,3,4,5,6,7,0,1,2,3,4,5,6,7,MUNGE_ROW,src)
+
+static inline void IDCTCol(int16 *dest, const int16 *src) {
+	if ((src[8] | src[16] | src[24] | src[32] | src[40] | src[48] | src[56]) == 0) {
+		dest[ 0] =
+		dest[ 8] =
+		dest[16] =
+		dest[24] =
+		dest[32] =
+		dest[40] =
+		dest[48] =
+		dest[56] = src[0];
+	} else {
+		IDCT_COL(dest, src);
+	}
+}
+
+static void IDCT(int16 *block, const int16 *coeffs) {
+	int i;
+	int16 temp[64];
+
+	for (i = 0; i < 8; i++)
+		IDCTCol(&temp[i], &coeffs[i]);
+	for (i = 0; i < 8; i++) {
+		IDCT_ROW( (&block[8*i]), (&temp[8*i]) );
+	}
+}
+
+static void IDCTPut(byte *dest, uint32 pitch, const int16 *coeffs) {
+	int i;
+	int16 temp[64];
+	for (i = 0; i < 8; i++)
+		IDCTCol(&temp[i], &coeffs[i]);
+	for (i = 0; i < 8; i++) {
+		IDCT_ROW( (&dest[i*pitch]), (&temp[8*i]) );
+	}
+}
+
+static void addResidue(byte *dest, uint32 pitch, const int16 *residue) {
+	for (int i = 0; i < 8; i++, dest += pitch, residue += 8)
+		for (int j = 0; j < 8; j++)
+			dest[j] += residue[j];
+}
+
+static void putPattern(byte *dest, uint32 pitch, const byte *colors, const byte *pattern) {
+	for (int i = 0; i < 8; i++, dest += pitch - 8) {
+		byte v = pattern[i];
+
+		for (int j = 0; j < 8; j++, v >>= 1)
+			*dest++ = colors[v & 1];
+	}
+}
+
+static void putScaled(byte *dest, uint32 pitch, const byte *pixels) {
+	byte *dest1 = dest;
+	byte *dest2 = dest + pitch;
+	for (int j = 0; j < 8; j++, dest1 += (pitch << 1) - 16, dest2 += (pitch << 1) - 16, pixels += 8) {
+
+		for (int i = 0; i < 8; i++, dest1 += 2, dest2 += 2)
+			dest1[0] = dest1[1] = dest2[0] = dest2[1] = pixels[i];
+
+	}
+}
+
+// The vector versions of the IDCT do all calculations on 32-bit values,
+// and cut the results of the column pass down to 16 bits, just like the
+// temporary block of the C++ code does. The row pass works on the
+// transposed block, so that both passes are the same vertical transform.
+
+#if defined(SCUMMVM_SSE2)
+
+/** Multiply 32-bit values, keeping the low 32 bits of the products. */
+static inline __m128i mulSSE2(__m128i a, int factor) {
+	const __m128i b = _mm_set1_epi32(factor);
+	const __m128i even = _mm_mul_epu32(a, b);
+	const __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), b);
+	return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+static inline void idctTransformSSE2(__m128i *d, const __m128i *s) {
+	const __m128i a0 = _mm_add_epi32(s[0], s[4]);
+	const __m128i a1 = _mm_sub_epi32(s[0], s[4]);
+	const __m128i a2 = _mm_add_epi32(s[2], s[6]);
+	const __m128i a3 = _mm_srai_epi32(mulSSE2(_mm_sub_epi32(s[2], s[6]), A1), 11);
+	const __m128i a4 = _mm_add_epi32(s[5], s[3]);
+	const __m128i a5 = _mm_sub_epi32(s[5], s[3]);
+	const __m128i a6 = _mm_add_epi32(s[1], s[7]);
+	const __m128i a7 = _mm_sub_epi32(s[1], s[7]);
+	const __m128i b0 = _mm_add_epi32(a4, a6);
+	const __m128i b1 = _mm_srai_epi32(mulSSE2(_mm_add_epi32(a5, a7), A3), 11);
+	const __m128i b2 = _mm_add_epi32(_mm_sub_epi32(_mm_srai_epi32(mulSSE2(a5, A4), 11), b0), b1);
+	const __m128i b3 = _mm_sub_epi32(_mm_srai_epi32(mulSSE2(_mm_sub_epi32(a6, a4), A1), 11), b2);
+	const __m128i b4 = _mm_sub_epi32(_mm_add_epi32(_mm_srai_epi32(mulSSE2(a7, A2), 11), b3), b1);
+
+	const __m128i a0a2 = _mm_add_epi32(a0, a2);
+	const __m128i a0a2n = _mm_sub_epi32(a0, a2);
+	const __m128i a1a3 = _mm_sub_epi32(_mm_add_epi32(a1, a3), a2);
+	const __m128i a1a3n = _mm_add_epi32(_mm_sub_epi32(a1, a3), a2);
+
+	d[0] = _mm_add_epi32(a0a2, b0);
+	d[1] = _mm_add_epi32(a1a3, b2);
+	d[2] = _mm_add_epi32(a1a3n, b3);
+	d[3] = _mm_sub_epi32(a0a2n, b4);
+	d[4] = _mm_add_epi32(a0a2n, b4);
+	d[5] = _mm_sub_epi32(a1a3n, b3);
+	d[6] = _mm_sub_epi32(a1a3, b2);
+	d[7] = _mm_sub_epi32(a0a2, b0);
+}
+
+/** Cut two vectors of 32-bit values down to one of 16-bit values. */
+static inline __m128i truncateSSE2(__m128i low, __m128i high) {
+	low = _mm_srai_epi32(_mm_slli_epi32(low, 16), 16);
+	high = _mm_srai_epi32(_mm_slli_epi32(high, 16), 16);
+	return _mm_packs_epi32(low, high);
+}
+
+static inline void transposeSSE2(__m128i *r) {
+	const __m128i a0 = _mm_unpacklo_epi16(r[0], r[1]);
+	const __m128i a1 = _mm_unpackhi_epi16(r[0], r[1]);
+	const __m128i a2 = _mm_unpacklo_epi16(r[2], r[3]);
+	const __m128i a3 = _mm_unpackhi_epi16(r[2], r[3]);
+	const __m128i a4 = _mm_unpacklo_epi16(r[4], r[5]);
+	const __m128i a5 = _mm_unpackhi_epi16(r[4], r[5]);
+	const __m128i a6 = _mm_unpacklo_epi16(r[6], r[7]);
+	const __m128i a7 = _mm_unpackhi_epi16(r[6], r[7]);
+
+	const __m128i b0 = _mm_unpacklo_epi32(a0, a2);
+	const __m128i b1 = _mm_unpackhi_epi32(a0, a2);
+	const __m128i b2 = _mm_unpacklo_epi32(a1, a3);
+	const __m128i b3 = _mm_unpackhi_epi32(a1, a3);
+	const __m128i b4 = _mm_unpacklo_epi32(a4, a6);
+	const __m128i b5 = _mm_unpackhi_epi32(a4, a6);
+	const __m128i b6 = _mm_unpacklo_epi32(a5, a7);
+	const __m128i b7 = _mm_unpackhi_epi32(a5, a7);
+
+	r[0] = _mm_unpacklo_epi64(b0, b4);
+	r[1] = _mm_unpackhi_epi64(b0, b4);
+	r[2] = _mm_unpacklo_epi64(b1, b5);
+	r[3] = _mm_unpackhi_epi64(b1, b5);
+	r[4] = _mm_unpacklo_epi64(b2, b6);
+	r[5] = _mm_unpackhi_epi64(b2, b6);
+	r[6] = _mm_unpacklo_epi64(b3, b7);
+	r[7] = _mm_unpackhi_epi64(b3, b7);
+}
+
+/**
+ * Run the inverse DCT on a block. The rows of the result are returned as
+ * 16-bit values.
+ */
+static void IDCTSSE2(__m128i *rows, const int16 *coeffs) {
+	__m128i low[8], high[8], lowOut[8], highOut[8];
+
+	for (int i = 0; i < 8; i++) {
+		const __m128i row = _mm_loadu_si128((const __m128i *)(coeffs + 8 * i));
+		low[i] = _mm_srai_epi32(_mm_unpacklo_epi16(row, row), 16);
+		high[i] = _mm_srai_epi32(_mm_unpackhi_epi16(row, row), 16);
+	}
+
+	idctTransformSSE2(lowOut, low);
+	idctTransformSSE2(highOut, high);
+
+	for (int i = 0; i < 8; i++)
+		rows[i] = truncateSSE2(lowOut[i], highOut[i]);
+
+	transposeSSE2(rows);
+
+	for (int i = 0; i < 8; i++) {
+		low[i] = _mm_srai_epi32(_mm_unpacklo_epi16(rows[i], rows[i]), 16);
+		high[i] = _mm_srai_epi32(_mm_unpackhi_epi16(rows[i], rows[i]), 16);
+	}
+
+	idctTransformSSE2(lowOut, low);
+	idctTransformSSE2(highOut, high);
+
+	const __m128i round = _mm_set1_epi32(0x7F);
+	for (int i = 0; i < 8; i++)
+		rows[i] = truncateSSE2(_mm_srai_epi32(_mm_add_epi32(lowOut[i], round), 8), _mm_srai_epi32(_mm_add_epi32(highOut[i], round), 8));
+
+	transposeSSE2(rows);
+}
+
+static void IDCTPutSSE2(byte *dest, uint32 pitch, const int16 *coeffs) {
+	__m128i rows[8];
+	IDCTSSE2(rows, coeffs);
+
+	const __m128i mask = _mm_set1_epi16(0xFF);
+	for (int i = 0; i < 8; i++, dest += pitch) {
+		const __m128i pixels = _mm_and_si128(rows[i], mask);
+		_mm_storel_epi64((__m128i *)dest, _mm_packus_epi16(pixels, pixels));
+	}
+}
+
+static inline void addRowSSE2(byte *dest, __m128i values) {
+	const __m128i pixels = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)dest), _mm_setzero_si128());
+	const __m128i sums = _mm_and_si128(_mm_add_epi16(pixels, values), _mm_set1_epi16(0xFF));
+	_mm_storel_epi64((__m128i *)dest, _mm_packus_epi16(sums, sums));
+}
+
+static void IDCTAddSSE2(byte *dest, uint32 pitch, const int16 *coeffs) {
+	__m128i rows[8];
+	IDCTSSE2(rows, coeffs);
+
+	for (int i = 0; i < 8; i++, dest += pitch)
+		addRowSSE2(dest, rows[i]);
+}
+
+static void addResidueSSE2(byte *dest, uint32 pitch, const int16 *residue) {
+	for (int i = 0; i < 8; i++, dest += pitch, residue += 8)
+		addRowSSE2(dest, _mm_loadu_si128((const __m128i *)residue));
+}
+
+static void putPatternSSE2(byte *dest, uint32 pitch, const byte *colors, const byte *pattern) {
+	const __m128i bits = _mm_set_epi8((char)0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01,
+	                                  (char)0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01);
+	const __m128i color0 = _mm_set1_epi8((char)colors[0]);
+	const __m128i color1 = _mm_set1_epi8((char)colors[1]);
+
+	// Repeat each pattern byte over the eight pixels of its row
+	const __m128i bytes = _mm_loadl_epi64((const __m128i *)pattern);
+	const __m128i pairs = _mm_unpacklo_epi8(bytes, bytes);
+	const __m128i quads[2] = { _mm_unpacklo_epi16(pairs, pairs), _mm_unpackhi_epi16(pairs, pairs) };
+
+	for (int i = 0; i < 4; i++, dest += pitch << 1) {
+		const __m128i rows = (i & 1) ? _mm_unpackhi_epi32(quads[i >> 1], quads[i >> 1]) : _mm_unpacklo_epi32(quads[i >> 1], quads[i >> 1]);
+		const __m128i set = _mm_cmpeq_epi8(_mm_and_si128(rows, bits), bits);
+		const __m128i pixels = _mm_or_si128(_mm_andnot_si128(set, color0), _mm_and_si128(set, color1));
+
+		_mm_storel_epi64((__m128i *)dest, pixels);
+		_mm_storel_epi64((__m128i *)(dest + pitch), _mm_unpackhi_epi64(pixels, pixels));
+	}
+}
+
+static void putScaledSSE2(byte *dest, uint32 pitch, const byte *pixels) {
+	for (int i = 0; i < 8; i++, dest += pitch << 1, pixels += 8) {
+		const __m128i row = _mm_loadl_epi64((const __m128i *)pixels);
+		const __m128i doubled = _mm_unpacklo_epi8(row, row);
+
+		_mm_storeu_si128((__m128i *)dest, doubled);
+		_mm_storeu_si128((__m128i *)(dest + pitch), doubled);
+	}
+}
+
+#endif // SCUMMVM_SSE2
+
+#if defined(SCUMMVM_NEON)
+
+static inline void idctTransformNEON(int32x4_t *d, const int32x4_t *s) {
+	const int32x4_t a0 = vaddq_s32(s[0], s[4]);
+	const int32x4_t a1 = vsubq_s32(s[0], s[4]);
+	const int32x4_t a2 = vaddq_s32(s[2], s[6]);
+	const int32x4_t a3 = vshrq_n_s32(vmulq_n_s32(vsubq_s32(s[2], s[6]), A1), 11);
+	const int32x4_t a4 = vaddq_s32(s[5], s[3]);
+	const int32x4_t a5 = vsubq_s32(s[5], s[3]);
+	const int32x4_t a6 = vaddq_s32(s[1], s[7]);
+	const int32x4_t a7 = vsubq_s32(s[1], s[7]);
+	const int32x4_t b0 = vaddq_s32(a4, a6);
+	const int32x4_t b1 = vshrq_n_s32(vmulq_n_s32(vaddq_s32(a5, a7), A3), 11);
+	const int32x4_t b2 = vaddq_s32(vsubq_s32(vshrq_n_s32(vmulq_n_s32(a5, A4), 11), b0), b1);
+	const int32x4_t b3 = vsubq_s32(vshrq_n_s32(vmulq_n_s32(vsubq_s32(a6, a4), A1), 11), b2);
+	const int32x4_t b4 = vsubq_s32(vaddq_s32(vshrq_n_s32(vmulq_n_s32(a7, A2), 11), b3), b1);
+
+	const int32x4_t a0a2 = vaddq_s32(a0, a2);
+	const int32x4_t a0a2n = vsubq_s32(a0, a2);
+	const int32x4_t a1a3 = vsubq_s32(vaddq_s32(a1, a3), a2);
+	const int32x4_t a1a3n = vaddq_s32(vsubq_s32(a1, a3), a2);
+
+	d[0] = vaddq_s32(a0a2, b0);
+	d[1] = vaddq_s32(a1a3, b2);
+	d[2] = vaddq_s32(a1a3n, b3);
+	d[3] = vsubq_s32(a0a2n, b4);
+	d[4] = vaddq_s32(a0a2n, b4);
+	d[5] = vsubq_s32(a1a3n, b3);
+	d[6] = vsubq_s32(a1a3, b2);
+	d[7] = vsubq_s32(a0a2, b0);
+}
+
+static inline int16x8_t combineHalvesNEON(int32x2_t low, int32x2_t high) {
+	return vcombine_s16(vreinterpret_s16_s32(low), vreinterpret_s16_s32(high));
+}
+
+static inline void transposeNEON(int16x8_t *r) {
+	const int16x8x2_t t01 = vtrnq_s16(r[0], r[1]);
+	const int16x8x2_t t23 = vtrnq_s16(r[2], r[3]);
+	const int16x8x2_t t45 = vtrnq_s16(r[4], r[5]);
+	const int16x8x2_t t67 = vtrnq_s16(r[6], r[7]);
+
+	const int32x4x2_t u02 = vtrnq_s32(vreinterpretq_s32_s16(t01.val[0]), vreinterpretq_s32_s16(t23.val[0]));
+	const int32x4x2_t u13 = vtrnq_s32(vreinterpretq_s32_s16(t01.val[1]), vreinterpretq_s32_s16(t23.val[1]));
+	const int32x4x2_t u46 = vtrnq_s32(vreinterpretq_s32_s16(t45.val[0]), vreinterpretq_s32_s16(t67.val[0]));
+	const int32x4x2_t u57 = vtrnq_s32(vreinterpretq_s32_s16(t45.val[1]), vreinterpretq_s32_s16(t67.val[1]));
+
+	r[0] = combineHalvesNEON(vget_low_s32(u02.val[0]), vget_low_s32(u46.val[0]));
+	r[1] = combineHalvesNEON(vget_low_s32(u13.val[0]), vget_low_s32(u57.val[0]));
+	r[2] = combineHalvesNEON(vget_low_s32(u02.val[1]), vget_low_s32(u46.val[1]));
+	r[3] = combineHalvesNEON(vget_low_s32(u13.val[1]), vget_low_s32(u57.val[1]));
+	r[4] = combineHalvesNEON(vget_high_s32(u02.val[0]), vget_high_s32(u46.val[0]));
+	r[5] = combineHalvesNEON(vget_high_s32(u13.val[0]), vget_high_s32(u57.val[0]));
+	r[6] = combineHalvesNEON(vget_high_s32(u02.val[1]), vget_high_s32(u46.val[1]));
+	r[7] = combineHalvesNEON(vget_high_s32(u13.val[1]), vget_high_s32(u57.val[1]));
+}
+
+static void IDCTNEON(int16x8_t *rows, const int16 *coeffs) {
+	int32x4_t low[8], high[8], lowOut[8], highOut[8];
+
+	for (int i = 0; i < 8; i++) {
+		const int16x8_t row = vld1q_s16(coeffs + 8 * i);
+		low[i] = vmovl_s16(vget_low_s16(row));
+		high[i] = vmovl_s16(vget_high_s16(row));
+	}
+
+	idctTransformNEON(lowOut, low);
+	idctTransformNEON(highOut, high);
+
+	for (int i = 0; i < 8; i++)
+		rows[i] = vcombine_s16(vmovn_s32(lowOut[i]), vmovn_s32(highOut[i]));
+
+	transposeNEON(rows);
+
+	for (int i = 0; i < 8; i++) {
+		low[i] = vmovl_s16(vget_low_s16(rows[i]));
+		high[i] = vmovl_s16(vget_high_s16(rows[i]));
+	}
+
+	idctTransformNEON(lowOut, low);
+	idctTransformNEON(highOut, high);
+
+	const int32x4_t round = vdupq_n_s32(0x7F);
+	for (int i = 0; i < 8; i++)
+		rows[i] = vcombine_s16(vmovn_s32(vshrq_n_s32(vaddq_s32(lowOut[i], round), 8)), vmovn_s32(vshrq_n_s32(vaddq_s32(highOut[i], round), 8)));
+
+	transposeNEON(rows);
+}
+
+static void IDCTPutNEON(byte *dest, uint32 pitch, const int16 *coeffs) {
+	int16x8_t rows[8];
+	IDCTNEON(rows, coeffs);
+
+	for (int i = 0; i < 8; i++, dest += pitch)
+		vst1_u8(dest, vmovn_u16(vreinterpretq_u16_s16(rows[i])));
+}
+
+static inline void addRowNEON(byte *dest, int16x8_t values) {
+	const int16x8_t pixels = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(dest)));
+	vst1_u8(dest, vmovn_u16(vreinterpretq_u16_s16(vaddq_s16(pixels, values))));
+}
+
+static void IDCTAddNEON(byte *dest, uint32 pitch, const int16 *coeffs) {
+	int16x8_t rows[8];
+	IDCTNEON(rows, coeffs);
+
+	for (int i = 0; i < 8; i++, dest += pitch)
+		addRowNEON(dest, rows[i]);
+}
+
+static void addResidueNEON(byte *dest, uint32 pitch, const int16 *residue) {
+	for (int i = 0; i < 8; i++, dest += pitch, residue += 8)
+		addRowNEON(dest, vld1q_s16(residue));
+}
+
+static void putPatternNEON(byte *dest, uint32 pitch, const byte *colors, const byte *pattern) {
+	static const uint8 bitValues[8] = { 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80 };
+	const uint8x8_t bits = vld1_u8(bitValues);
+	const uint8x8_t color0 = vdup_n_u8(colors[0]);
+	const uint8x8_t color1 = vdup_n_u8(colors[1]);
+
+	for (int i = 0; i < 8; i++, dest += pitch) {
+		const uint8x8_t set = vtst_u8(vdup_n_u8(pattern[i]), bits);
+		vst1_u8(dest, vbsl_u8(set, color1, color0));
+	}
+}
+
+static void putScaledNEON(byte *dest, uint32 pitch, const byte *pixels) {
+	for (int i = 0; i < 8; i++, dest += pitch << 1, pixels += 8) {
+		const uint8x8_t row = vld1_u8(pixels);
+		const uint8x8x2_t zipped = vzip_u8(row, row);
+		const uint8x16_t doubled = vcombine_u8(zipped.val[0], zipped.val[1]);
+
+		vst1q_u8(dest, doubled);
+		vst1q_u8(dest + pitch, doubled);
+	}
+}
+
+#endif // SCUMMVM_NEON
+
+void binkIDCTPut(byte *dest, uint32 pitch, const int16 *coeffs) {
+#if defined(SCUMMVM_SSE2)
+	if (Common::hasCPUFeature(Common::kCPUFeatureSSE2)) {
+		IDCTPutSSE2(dest, pitch, coeffs);
+		return;
+	}
+#elif defined(SCUMMVM_NEON)
+	if (Common::hasCPUFeature(Common::kCPUFeatureNEON)) {
+		IDCTPutNEON(dest, pitch, coeffs);
+		return;
+	}
+#endif
+
+	IDCTPut(dest, pitch, coeffs);
+}
+
+void binkIDCTAdd(byte *dest, uint32 pitch, const int16 *coeffs) {
+#if defined(SCUMMVM_SSE2)
+	if (Common::hasCPUFeature(Common::kCPUFeatureSSE2)) {
+		IDCTAddSSE2(dest, pitch, coeffs);
+		return;
+	}
+#elif defined(SCUMMVM_NEON)
+	if (Common::hasCPUFeature(Common::kCPUFeatureNEON)) {
+		IDCTAddNEON(dest, pitch, coeffs);
+		return;
+	}
+#endif
+
+	int16 block[64];
+	IDCT(block, coeffs);
+	addResidue(dest, pitch, block);
+}
+
+void binkAddResidue(byte *dest, uint32 pitch, const int16 *residue) {
+#if defined(SCUMMVM_SSE2)
+	if (Common::hasCPUFeature(Common::kCPUFeatureSSE2)) {
+		addResidueSSE2(dest, pitch, residue);
+		return;
+	}
+#elif defined(SCUMMVM_NEON)
+	if (Common::hasCPUFeature(Common::kCPUFeatureNEON)) {
+		addResidueNEON(dest, pitch, residue);
+		return;
+	}
+#endif
+
+	addResidue(dest, pitch, residue);
+}
+
+void binkPutPattern(byte *dest, uint32 pitch, const byte *colors, const byte *pattern) {
+#if defined(SCUMMVM_SSE2)
+	if (Common::hasCPUFeature(Common::kCPUFeatureSSE2)) {
+		putPatternSSE2(dest, pitch, colors, pattern);
+		return;
+	}
+#elif defined(SCUMMVM_NEON)
+	if (Common::hasCPUFeature(Common::kCPUFeatureNEON)) {
+		putPatternNEON(dest, pitch, colors, pattern);
+		return;
+	}
+#endif
+
+	putPattern(dest, pitch, colors, pattern);
+}
+
+void binkPutScaled(byte *dest, uint32 pitch, const byte *pixels) {
+#if defined(SCUMMVM_SSE2)
+	if (Common::hasCPUFeature(Common::kCPUFeatureSSE2)) {
+		putScaledSSE2(dest, pitch, pixels);
+		return;
+	}
+#elif defined(SCUMMVM_NEON)
+	if (Common::hasCPUFeature(Common::kCPUFeatureNEON)) {
+		putScaledNEON(dest, pitch, pixels);
+		return;
+	}
+#endif
+
+	putScaled(dest, pitch, pixels);
+}
+
+} // End of namespace Video
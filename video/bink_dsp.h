@@ -0,0 +1,60 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef VIDEO_BINK_DSP_H
+#define VIDEO_BINK_DSP_H
+
+#include "common/scummsys.h"
+
+namespace Video {
+
+// The pixel operations of the Bink video decoder. They all work on 8x8
+// blocks, or on 16x16 blocks scaled up from 8x8 ones, and use the vector
+// units when available. All paths give exactly the same result.
+
+/**
+ * Run the inverse DCT on a block of coefficients and store the result.
+ * Like the original decoder, only the low 8 bits of each value are kept.
+ */
+void binkIDCTPut(byte *dest, uint32 pitch, const int16 *coeffs);
+
+/**
+ * Run the inverse DCT on a block of coefficients and add the result to
+ * the pixels. The sums wrap around.
+ */
+void binkIDCTAdd(byte *dest, uint32 pitch, const int16 *coeffs);
+
+/** Add a block of residue values to the pixels. The sums wrap around. */
+void binkAddResidue(byte *dest, uint32 pitch, const int16 *residue);
+
+/**
+ * Fill a block with two colors. Bit i of pattern[y] selects the color of
+ * the pixel in column i of row y.
+ */
+void binkPutPattern(byte *dest, uint32 pitch, const byte *colors, const byte *pattern);
+
+/** Put a block of 8x8 pixels scaled up to 16x16. */
+void binkPutScaled(byte *dest, uint32 pitch, const byte *pixels);
+
+} // End of namespace Video
+
+#endif // VIDEO_BINK_DSP_H
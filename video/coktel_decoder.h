@@ -568,6 +568,10 @@ public:
 	bool loadStream(Common::SeekableReadStream *stream);
 	void close();
 
+protected:
+	// The wrapped decoder does its own timing and feeds the sound itself
+	bool canDecodeAhead() const { return false; }
+
 private:
 	class VMDVideoTrack : public FixedRateVideoTrack {
 	public:
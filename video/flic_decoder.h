@@ -55,6 +55,10 @@ public:
 	void clearDirtyRects();
 	void copyDirtyRectsToBuffer(uint8 *dst, uint pitch);
 
+protected:
+	// The dirty rects are taken straight from the track
+	bool canDecodeAhead() const { return false; }
+
 private:
 	class FlicVideoTrack : public VideoTrack {
 	public:
@@ -86,10 +86,6 @@ void QuickTimeDecoder::close() {
 const Graphics::Surface *QuickTimeDecoder::decodeNextFrame() {
 	const Graphics::Surface *frame = VideoDecoder::decodeNextFrame();
 
-	// Update audio buffers too
-	// (needs to be done after we find the next track)
-	updateAudioBuffer();
-
 	// We have to initialize the scaled surface
 	if (frame && (_scaleFactorX != 1 || _scaleFactorY != 1)) {
 		if (!_scaledSurface) {
@@ -235,6 +231,12 @@ void QuickTimeDecoder::init() {
 	}
 }
 
+void QuickTimeDecoder::afterDecodeFrame() {
+	// Update audio buffers too
+	// (needs to be done after we find the next track)
+	updateAudioBuffer();
+}
+
 void QuickTimeDecoder::updateAudioBuffer() {
 	// Updates the audio buffers for all audio tracks
 	for (TrackListIterator it = getTrackListBegin(); it != getTrackListEnd(); it++)
@@ -73,6 +73,7 @@ public:
 
 protected:
 	Common::QuickTimeParser::SampleDesc *readSampleDesc(Common::QuickTimeParser::Track *track, uint32 format, uint32 descSize);
+	void afterDecodeFrame();
 
 private:
 	void init();
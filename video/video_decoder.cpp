@@ -28,11 +28,54 @@
 #include "common/rational.h"
 #include "common/file.h"
 #include "common/system.h"
+#include "common/thread.h"
 
 #include "graphics/palette.h"
+#include "graphics/surface.h"
 
 namespace Video {
 
+/**
+ * The state of the video tracks after a frame was decoded, as far as the
+ * timing functions need it.
+ */
+struct VideoDecoder::FrameState {
+	int curFrame;
+	bool hasNextFrame;
+	bool nextFrameReversed;
+	uint32 nextFrameStartTime;
+};
+
+struct VideoDecoder::DecodedFrame {
+	Graphics::Surface surface;
+	bool hasSurface;
+	bool dirtyPalette;
+	byte palette[3 * 256];
+	FrameState state;
+};
+
+/**
+ * A ring of frames filled by the decoder thread. While the thread runs, it
+ * owns the video tracks, and the state of the last frame handed out by
+ * decodeNextFrame() stands in for them.
+ */
+struct VideoDecoder::DecodeAhead {
+	Common::Thread thread;
+	bool running;
+	volatile bool quit;
+
+	DecodedFrame *frames;
+	uint frameCount;
+	uint readIndex;
+	uint writeIndex;
+	Common::Semaphore *freeFrames;
+	Common::Semaphore *decodedFrames;
+
+	Graphics::Surface surface;
+	byte palette[3 * 256];
+	FrameState state;
+};
+
 VideoDecoder::VideoDecoder() {
 	_startTime = 0;
 	_dirtyPalette = false;
@@ -48,6 +91,8 @@ VideoDecoder::VideoDecoder() {
 	_nextVideoTrack = 0;
 	_mainAudioTrack = 0;
 	_canSetDither = true;
+	_decodeAheadFrames = 0;
+	_decodeAhead = 0;
 
 	// Find the best format for output
 	_defaultHighColorFormat = g_system->getScreenFormat();
@@ -56,7 +101,13 @@ VideoDecoder::VideoDecoder() {
 		_defaultHighColorFormat = Graphics::PixelFormat(4, 8, 8, 8, 8, 8, 16, 24, 0);
 }
 
+VideoDecoder::~VideoDecoder() {
+	deleteDecodeAhead();
+}
+
 void VideoDecoder::close() {
+	deleteDecodeAhead();
+
 	if (isPlaying())
 		stop();
 
@@ -175,12 +226,22 @@ const Graphics::Surface *VideoDecoder::decodeNextFrame() {
 	_needsUpdate = false;
 	_canSetDither = false;
 
+	if (_decodeAheadFrames && isVideoLoaded()) {
+		if (isDecodingAhead() || startDecodeAhead())
+			return pullDecodedFrame();
+
+		warning("Could not start decoding ahead");
+		_decodeAheadFrames = 0;
+	}
+
 	readNextPacket();
 
 	// If we have no next video track at this point, there shouldn't be
 	// any frame available for us to display.
-	if (!_nextVideoTrack)
+	if (!_nextVideoTrack) {
+		afterDecodeFrame();
 		return 0;
+	}
 
 	const Graphics::Surface *frame = _nextVideoTrack->decodeNextFrame();
 
@@ -191,6 +252,7 @@ const Graphics::Surface *VideoDecoder::decodeNextFrame() {
 
 	// Look for the next video track here for the next decode.
 	findNextVideoTrack();
+	afterDecodeFrame();
 
 	return frame;
 }
@@ -200,6 +262,15 @@ bool VideoDecoder::setReverse(bool reverse) {
 	if (reverse && hasAudio())
 		return false;
 
+	// The decoder thread owns the tracks, so leave them alone
+	if (isDecodingAhead()) {
+		for (TrackList::iterator it = _tracks.begin(); it != _tracks.end(); it++)
+			if ((*it)->getTrackType() == Track::kTrackTypeVideo && ((VideoTrack *)*it)->isReversed() != reverse)
+				return false;
+
+		return true;
+	}
+
 	// Attempt to make sure all the tracks are in the requested direction
 	for (TrackList::iterator it = _tracks.begin(); it != _tracks.end(); it++) {
 		if ((*it)->getTrackType() == Track::kTrackTypeVideo && ((VideoTrack *)*it)->isReversed() != reverse) {
@@ -220,6 +291,9 @@ const byte *VideoDecoder::getPalette() {
 }
 
 int VideoDecoder::getCurFrame() const {
+	if (isDecodingAhead())
+		return _decodeAhead->state.curFrame;
+
 	int32 frame = -1;
 
 	for (TrackList::const_iterator it = _tracks.begin(); it != _tracks.end(); it++)
@@ -261,13 +335,29 @@ uint32 VideoDecoder::getTime() const {
 }
 
 uint32 VideoDecoder::getTimeToNextFrame() const {
-	if (endOfVideo() || _needsUpdate || !_nextVideoTrack)
+	if (endOfVideo() || _needsUpdate)
 		return 0;
 
+	uint32 nextFrameStartTime;
+	bool reversed;
+
+	if (isDecodingAhead()) {
+		if (!_decodeAhead->state.hasNextFrame)
+			return 0;
+
+		nextFrameStartTime = _decodeAhead->state.nextFrameStartTime;
+		reversed = _decodeAhead->state.nextFrameReversed;
+	} else {
+		if (!_nextVideoTrack)
+			return 0;
+
+		nextFrameStartTime = _nextVideoTrack->getNextFrameStartTime();
+		reversed = _nextVideoTrack->isReversed();
+	}
+
 	uint32 currentTime = getTime();
-	uint32 nextFrameStartTime = _nextVideoTrack->getNextFrameStartTime();
 
-	if (_nextVideoTrack->isReversed()) {
+	if (reversed) {
 		// For reversed videos, we need to handle the time difference the opposite way.
 		if (nextFrameStartTime >= currentTime)
 			return 0;
@@ -283,6 +373,17 @@ uint32 VideoDecoder::getTimeToNextFrame() const {
 }
 
 bool VideoDecoder::endOfVideo() const {
+	if (isDecodingAhead()) {
+		if (hasFramesLeft())
+			return false;
+
+		for (TrackList::const_iterator it = _tracks.begin(); it != _tracks.end(); it++)
+			if ((*it)->getTrackType() != Track::kTrackTypeVideo && !(*it)->endOfTrack())
+				return false;
+
+		return true;
+	}
+
 	for (TrackList::const_iterator it = _tracks.begin(); it != _tracks.end(); it++)
 		if (!(*it)->endOfTrack() && (!isPlaying() || (*it)->getTrackType() != Track::kTrackTypeVideo || !_endTimeSet || ((VideoTrack *)*it)->getNextFrameStartTime() < (uint)_endTime.msecs()))
 			return false;
@@ -305,6 +406,9 @@ bool VideoDecoder::rewind() {
 	if (!isRewindable())
 		return false;
 
+	// Take the tracks back from the decoder thread
+	stopDecodeAhead();
+
 	// Stop all tracks so they can be rewound
 	if (isPlaying())
 		stopAudio();
@@ -339,6 +443,9 @@ bool VideoDecoder::seek(const Audio::Timestamp &time) {
 	if (!isSeekable())
 		return false;
 
+	// Take the tracks back from the decoder thread
+	stopDecodeAhead();
+
 	// Stop all tracks so they can be seeked
 	if (isPlaying())
 		stopAudio();
@@ -895,6 +1002,11 @@ bool VideoDecoder::hasFramesLeft() const {
 	// This is similar to endOfVideo(), except it doesn't take Audio into account (and returns true if not the end of the video)
 	// This is only used for needsUpdate() atm so that setEndTime() works properly
 	// And unlike endOfVideoTracks(), this takes into account _endTime
+	if (isDecodingAhead()) {
+		const FrameState &state = _decodeAhead->state;
+		return state.hasNextFrame && (!isPlaying() || !_endTimeSet || state.nextFrameStartTime < (uint)_endTime.msecs());
+	}
+
 	for (TrackList::const_iterator it = _tracks.begin(); it != _tracks.end(); it++)
 		if ((*it)->getTrackType() == Track::kTrackTypeVideo && !(*it)->endOfTrack() && (!isPlaying() || !_endTimeSet || ((VideoTrack *)*it)->getNextFrameStartTime() < (uint)_endTime.msecs()))
 			return true;
@@ -910,4 +1022,186 @@ bool VideoDecoder::hasAudio() const {
 	return false;
 }
 
+bool VideoDecoder::setDecodeAhead(uint frames) {
+	if (frames && (!Common::hasThreads() || !canDecodeAhead()))
+		return false;
+
+	if (frames != _decodeAheadFrames) {
+		stopDecodeAhead();
+		_decodeAheadFrames = frames;
+	}
+
+	return true;
+}
+
+bool VideoDecoder::isDecodingAhead() const {
+	return _decodeAhead && _decodeAhead->running;
+}
+
+bool VideoDecoder::startDecodeAhead() {
+	if (!_decodeAhead) {
+		_decodeAhead = new DecodeAhead();
+		_decodeAhead->running = false;
+		_decodeAhead->frames = 0;
+		_decodeAhead->frameCount = 0;
+		_decodeAhead->freeFrames = 0;
+		_decodeAhead->decodedFrames = 0;
+	}
+
+	DecodeAhead *ahead = _decodeAhead;
+
+	if (ahead->frameCount != _decodeAheadFrames) {
+		for (uint i = 0; i < ahead->frameCount; i++)
+			ahead->frames[i].surface.free();
+
+		delete[] ahead->frames;
+		ahead->frames = new DecodedFrame[_decodeAheadFrames];
+		ahead->frameCount = _decodeAheadFrames;
+	}
+
+	// The tracks are where they are, until the first decoded frame is
+	// handed out
+	getFrameState(ahead->state);
+
+	ahead->quit = false;
+	ahead->readIndex = 0;
+	ahead->writeIndex = 0;
+	ahead->freeFrames = new Common::Semaphore(ahead->frameCount);
+	ahead->decodedFrames = new Common::Semaphore();
+
+	if (!ahead->thread.start(decodeAheadThreadProc, this)) {
+		delete ahead->freeFrames;
+		delete ahead->decodedFrames;
+		ahead->freeFrames = ahead->decodedFrames = 0;
+		return false;
+	}
+
+	ahead->running = true;
+	return true;
+}
+
+void VideoDecoder::stopDecodeAhead() {
+	if (!isDecodingAhead())
+		return;
+
+	DecodeAhead *ahead = _decodeAhead;
+
+	// The thread either waits for a free frame or is about to, so one post
+	// is enough to let it see the quit flag. The frames it decoded are
+	// thrown away.
+	ahead->quit = true;
+	ahead->freeFrames->post();
+	ahead->thread.join();
+
+	delete ahead->freeFrames;
+	delete ahead->decodedFrames;
+	ahead->freeFrames = ahead->decodedFrames = 0;
+	ahead->running = false;
+}
+
+void VideoDecoder::deleteDecodeAhead() {
+	if (!_decodeAhead)
+		return;
+
+	stopDecodeAhead();
+
+	if (_palette == _decodeAhead->palette) {
+		_palette = 0;
+		_dirtyPalette = false;
+	}
+
+	for (uint i = 0; i < _decodeAhead->frameCount; i++)
+		_decodeAhead->frames[i].surface.free();
+
+	delete[] _decodeAhead->frames;
+	_decodeAhead->surface.free();
+	delete _decodeAhead;
+	_decodeAhead = 0;
+}
+
+const Graphics::Surface *VideoDecoder::pullDecodedFrame() {
+	DecodeAhead *ahead = _decodeAhead;
+
+	ahead->decodedFrames->wait();
+
+	DecodedFrame &frame = ahead->frames[ahead->readIndex];
+	ahead->readIndex = (ahead->readIndex + 1) % ahead->frameCount;
+
+	// Swap the buffers, so that the surface handed out last time gets
+	// reused by the decoder thread. Without a new surface, the caller keeps
+	// the last one on screen, so that one must stay intact.
+	const bool hasSurface = frame.hasSurface;
+	if (hasSurface)
+		SWAP(ahead->surface, frame.surface);
+
+	if (frame.dirtyPalette) {
+		memcpy(ahead->palette, frame.palette, sizeof(ahead->palette));
+		_palette = ahead->palette;
+		_dirtyPalette = true;
+	}
+
+	ahead->state = frame.state;
+	ahead->freeFrames->post();
+
+	return hasSurface ? &ahead->surface : 0;
+}
+
+void VideoDecoder::decodeAheadFrame(DecodedFrame &frame) {
+	frame.hasSurface = false;
+	frame.dirtyPalette = false;
+
+	readNextPacket();
+
+	if (_nextVideoTrack) {
+		const Graphics::Surface *surface = _nextVideoTrack->decodeNextFrame();
+
+		if (surface) {
+			if (frame.surface.w != surface->w || frame.surface.h != surface->h || frame.surface.format != surface->format) {
+				frame.surface.free();
+				frame.surface.create(surface->w, surface->h, surface->format);
+			}
+
+			frame.surface.copyRectToSurface(surface->getPixels(), surface->pitch, 0, 0, surface->w, surface->h);
+			frame.hasSurface = true;
+		}
+
+		if (_nextVideoTrack->hasDirtyPalette()) {
+			memcpy(frame.palette, _nextVideoTrack->getPalette(), sizeof(frame.palette));
+			frame.dirtyPalette = true;
+		}
+
+		findNextVideoTrack();
+	}
+
+	afterDecodeFrame();
+	getFrameState(frame.state);
+}
+
+void VideoDecoder::getFrameState(FrameState &state) const {
+	state.curFrame = -1;
+
+	for (TrackList::const_iterator it = _tracks.begin(); it != _tracks.end(); it++)
+		if ((*it)->getTrackType() == Track::kTrackTypeVideo)
+			state.curFrame += ((VideoTrack *)*it)->getCurFrame() + 1;
+
+	state.hasNextFrame = _nextVideoTrack != 0;
+	state.nextFrameReversed = _nextVideoTrack && _nextVideoTrack->isReversed();
+	state.nextFrameStartTime = _nextVideoTrack ? _nextVideoTrack->getNextFrameStartTime() : 0;
+}
+
+void VideoDecoder::decodeAheadThreadProc(void *param) {
+	VideoDecoder *decoder = (VideoDecoder *)param;
+	DecodeAhead *ahead = decoder->_decodeAhead;
+
+	while (true) {
+		ahead->freeFrames->wait();
+		if (ahead->quit)
+			break;
+
+		decoder->decodeAheadFrame(ahead->frames[ahead->writeIndex]);
+		ahead->writeIndex = (ahead->writeIndex + 1) % ahead->frameCount;
+		ahead->decodedFrames->post();
+	}
+}
+
 } // End of namespace Video
@@ -52,7 +52,7 @@ namespace Video {
 class VideoDecoder {
 public:
 	VideoDecoder();
-	virtual ~VideoDecoder() {}
+	virtual ~VideoDecoder();
 
 	/////////////////////////////////////////
 	// Opening/Closing a Video
@@ -396,6 +396,36 @@ public:
 	 */
 	bool setDitheringPalette(const byte *palette);
 
+	/**
+	 * Decode frames ahead on a separate thread.
+	 *
+	 * By default, decodeNextFrame() reads and decodes the next frame itself.
+	 * With a non-zero frame count, a decoder thread keeps up to that many
+	 * frames decoded in advance, and decodeNextFrame() only hands out the
+	 * oldest of them. The frame timing still comes from the video tracks,
+	 * so the audio sync is not affected.
+	 *
+	 * Seeking and rewinding discard the frames decoded so far. Reverse
+	 * playback cannot be enabled while frames are being decoded ahead.
+	 *
+	 * The setting survives close(), so it may be set before loading the
+	 * video. Changing it during playback drops the frames that were already
+	 * decoded.
+	 *
+	 * @param frames The number of frames to decode ahead, or 0 to decode
+	 *               synchronously
+	 * @return true on success, false if this platform has no threads or
+	 *         this decoder does not support decoding ahead
+	 */
+	bool setDecodeAhead(uint frames);
+
+	/**
+	 * Get the number of frames decoded ahead.
+	 *
+	 * @see setDecodeAhead()
+	 */
+	uint getDecodeAhead() const { return _decodeAheadFrames; }
+
 	/////////////////////////////////////////
 	// Audio Control
 	/////////////////////////////////////////
@@ -913,6 +943,25 @@ protected:
 	 */
 	virtual AudioTrack *getAudioTrack(int index) { return 0; }
 
+	/**
+	 * Can this video be decoded on a separate thread?
+	 *
+	 * A subclass needs to override this to return false if it accesses its
+	 * tracks from anywhere but readNextPacket(), afterDecodeFrame(), the
+	 * tracks' decodeNextFrame() and the seeking functions.
+	 *
+	 * @see setDecodeAhead()
+	 */
+	virtual bool canDecodeAhead() const { return true; }
+
+	/**
+	 * Called at the end of each decodeNextFrame(), after the next video
+	 * track has been found, whether there was a frame or not.
+	 *
+	 * When decoding ahead, this is called on the decoder thread.
+	 */
+	virtual void afterDecodeFrame() {}
+
 private:
 	// Tracks owned by this VideoDecoder
 	TrackList _tracks;
@@ -950,6 +999,23 @@ private:
 	int8 _audioBalance;
 
 	AudioTrack *_mainAudioTrack;
+
+	// Decoding ahead
+	struct FrameState;
+	struct DecodedFrame;
+	struct DecodeAhead;
+
+	uint _decodeAheadFrames;
+	DecodeAhead *_decodeAhead;
+
+	bool isDecodingAhead() const;
+	bool startDecodeAhead();
+	void stopDecodeAhead();
+	void deleteDecodeAhead();
+	const Graphics::Surface *pullDecodedFrame();
+	void decodeAheadFrame(DecodedFrame &frame);
+	void getFrameState(FrameState &state) const;
+	static void decodeAheadThreadProc(void *param);
 };
 
 } // End of namespace Video